@@ -117,6 +117,12 @@ CommandLineHandler::CommandLineHandler()
     m_samples.set_exact_value_count(2);
     parser().add_option_handler(&m_samples);
 
+    m_time_limit.add_name("--time-limit");
+    m_time_limit.set_description("render each frame in a given amount of time by choosing the sampling rate automatically");
+    m_time_limit.set_syntax("seconds");
+    m_time_limit.set_exact_value_count(1);
+    parser().add_option_handler(&m_time_limit);
+
     m_override_shading.add_name("--override-shading");
     m_override_shading.set_description("override shading with a diagnostic shader");
     m_override_shading.set_syntax("shader");
@@ -138,6 +144,12 @@ CommandLineHandler::CommandLineHandler()
     m_hrmanpipe_display.set_syntax("n");
     m_hrmanpipe_display.set_exact_value_count(1);
     parser().add_option_handler(&m_hrmanpipe_display);
+
+    m_shared_memory_display.add_name("--shared-memory-display");
+    m_shared_memory_display.set_description("publish rendered tiles to a shared memory segment that external viewers can attach to");
+    m_shared_memory_display.set_syntax("name");
+    m_shared_memory_display.set_exact_value_count(1);
+    parser().add_option_handler(&m_shared_memory_display);
    
     m_run_unit_tests.add_name("--run-unit-tests");
     m_run_unit_tests.set_description("run unit tests; filter them based on the optional regular expression argument");
@@ -159,6 +171,22 @@ CommandLineHandler::CommandLineHandler()
     m_benchmark_mode.set_description("enable benchmark mode");
     parser().add_option_handler(&m_benchmark_mode);
 
+    m_render_report.add_name("--render-report");
+    m_render_report.set_description("write rendering time and performance counters to a json file");
+    m_render_report.set_syntax("filename");
+    m_render_report.set_exact_value_count(1);
+    parser().add_option_handler(&m_render_report);
+
+    m_trace_events.add_name("--trace-events");
+    m_trace_events.set_description("write a timeline of rendering phases and jobs to a json file (chrome://tracing format)");
+    m_trace_events.set_syntax("filename");
+    m_trace_events.set_exact_value_count(1);
+    parser().add_option_handler(&m_trace_events);
+
+    m_track_memory.add_name("--track-memory");
+    m_track_memory.set_description("print a summary of the memory used by trees, textures, photons, frame and meshes after each frame");
+    parser().add_option_handler(&m_track_memory);
+
     m_dump_input_metadata.add_name("--dump-input-metadata");
     m_dump_input_metadata.set_description("dump the input metadata of all known entities to stderr (as xml)");
     parser().add_option_handler(&m_dump_input_metadata);
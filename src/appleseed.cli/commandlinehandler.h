@@ -71,6 +71,7 @@ class CommandLineHandler
     foundation::ValueOptionHandler<int>             m_resolution;
     foundation::ValueOptionHandler<int>             m_window;
     foundation::ValueOptionHandler<int>             m_samples;
+    foundation::ValueOptionHandler<double>          m_time_limit;
     foundation::ValueOptionHandler<std::string>     m_override_shading;
     foundation::ValueOptionHandler<std::string>     m_select_object_instances;
 
@@ -78,11 +79,17 @@ class CommandLineHandler
     foundation::FlagOptionHandler                   m_mplay_display;
     foundation::ValueOptionHandler<int>             m_hrmanpipe_display;
     
+    // Shared memory display options.
+    foundation::ValueOptionHandler<std::string>     m_shared_memory_display;
+
     // Developer-oriented options.
     foundation::ValueOptionHandler<std::string>     m_run_unit_tests;
     foundation::ValueOptionHandler<std::string>     m_run_unit_benchmarks;
     foundation::FlagOptionHandler                   m_verbose_unit_tests;
     foundation::FlagOptionHandler                   m_benchmark_mode;
+    foundation::ValueOptionHandler<std::string>     m_render_report;
+    foundation::ValueOptionHandler<std::string>     m_trace_events;
+    foundation::FlagOptionHandler                   m_track_memory;
     foundation::FlagOptionHandler                   m_dump_input_metadata;
 
     // Constructor.
@@ -46,6 +46,7 @@
 #include "renderer/api/environmentshader.h"
 #include "renderer/api/frame.h"
 #include "renderer/api/light.h"
+#include "renderer/api/log.h"
 #include "renderer/api/material.h"
 #include "renderer/api/project.h"
 #include "renderer/api/rendering.h"
@@ -65,6 +66,7 @@
 #include "foundation/utility/indenter.h"
 #include "foundation/utility/log.h"
 #include "foundation/utility/settings.h"
+#include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
 #include "foundation/utility/string.h"
 #include "foundation/utility/test.h"
@@ -80,6 +82,7 @@
 // Standard headers.
 #include <cstddef>
 #include <cstdlib>
+#include <fstream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -421,6 +424,14 @@ namespace
             params.insert_path(
                 "adaptive_pixel_renderer.max_samples",
                 g_cl.m_samples.string_values()[1]);
+
+            params.insert_path(
+                "adaptive_tile_renderer.min_samples",
+                g_cl.m_samples.string_values()[0]);
+
+            params.insert_path(
+                "adaptive_tile_renderer.max_samples",
+                g_cl.m_samples.string_values()[1]);
         }
     }
 
@@ -522,6 +533,14 @@ namespace
         // Apply --samples option.
         apply_samples_command_line_option(params);
 
+        // Apply --time-limit option.
+        if (g_cl.m_time_limit.is_set())
+        {
+            params.insert_path(
+                "generic_frame_renderer.time_limit",
+                g_cl.m_time_limit.string_values()[0]);
+        }
+
         // Apply --override-shading option.
         if (g_cl.m_override_shading.is_set())
         {
@@ -630,6 +649,32 @@ namespace
         return value == "progressive";        
     }
     
+    void write_render_report(
+        const string&           report_filename,
+        const string&           project_filename,
+        const double            render_time,
+        const StatisticsVector& stats)
+    {
+        ofstream file(report_filename.c_str());
+
+        if (!file.is_open())
+        {
+            LOG_ERROR(
+                g_logger,
+                "failed to write render report to %s.",
+                report_filename.c_str());
+            return;
+        }
+
+        file << "{" << endl;
+        file << "  \"project\": " << quote_json_string(project_filename) << "," << endl;
+        file << "  \"render_time\": " << foundation::to_string(render_time) << "," << endl;
+        file << "  \"statistics\": " << replace(stats.to_json(), "\n", "\n  ") << endl;
+        file << "}" << endl;
+
+        LOG_INFO(g_logger, "wrote render report to %s.", report_filename.c_str());
+    }
+
     void render(const string& project_filename)
     {
         // Load the project.
@@ -660,6 +705,12 @@ namespace
                     is_progressive_render(params),
                     g_logger));
         }
+        else if (g_cl.m_shared_memory_display.is_set())
+        {
+            tile_callback_factory.reset(
+                new SharedMemoryTileCallbackFactory(
+                    g_cl.m_shared_memory_display.values()[0].c_str()));
+        }
         else if (g_cl.m_output.is_set() && g_cl.m_continuous_saving.is_set())
         {
             tile_callback_factory.reset(
@@ -681,6 +732,20 @@ namespace
             &renderer_controller,
             tile_callback_factory.get());
 
+        // Start recording trace events.
+        if (g_cl.m_trace_events.is_set())
+        {
+            global_trace_event_recorder().clear();
+            global_trace_event_recorder().set_enabled(true);
+        }
+
+        // Start tracking memory usage.
+        if (g_cl.m_track_memory.is_set())
+        {
+            global_memory_tracker().clear();
+            global_memory_tracker().set_enabled(true);
+        }
+
         // Render the frame.
         LOG_INFO(g_logger, "rendering frame...");
         Stopwatch<DefaultWallclockTimer> stopwatch;
@@ -707,6 +772,16 @@ namespace
             "rendering finished in %s.",
             pretty_time(seconds, 3).c_str());
 
+        // Write the render report.
+        if (g_cl.m_render_report.is_set())
+        {
+            write_render_report(
+                g_cl.m_render_report.values()[0],
+                project_filename,
+                seconds,
+                renderer.get_statistics());
+        }
+
         // Archive the frame to disk.
         char* archive_path = 0;
         if (params.get_optional<bool>("autosave", true))
@@ -727,10 +802,23 @@ namespace
         if (g_cl.m_output.is_set() && !g_cl.m_continuous_saving.is_set())
         {
             LOG_INFO(g_logger, "writing frame to disk...");
+            TraceScope trace(global_trace_event_recorder(), "write images", "output");
             project->get_frame()->write_main_image(g_cl.m_output.values()[0].c_str());
             project->get_frame()->write_aov_images(g_cl.m_output.values()[0].c_str());
         }
 
+        // Write the recorded trace events.
+        if (g_cl.m_trace_events.is_set())
+        {
+            global_trace_event_recorder().set_enabled(false);
+
+            const string& filename = g_cl.m_trace_events.values()[0];
+
+            if (global_trace_event_recorder().write_chrome_trace(filename.c_str()))
+                LOG_INFO(g_logger, "wrote trace events to %s.", filename.c_str());
+            else LOG_ERROR(g_logger, "failed to write trace events to %s.", filename.c_str());
+        }
+
 #if defined __APPLE__ || defined _WIN32
 
         // Display the output image.
@@ -65,14 +65,18 @@ const char* Appleseed::get_lib_name()
 const char* Appleseed::get_lib_version()
 {
 #ifdef APPLESEED_USE_SSE
-    #ifdef USE_QMC_SAMPLER
+    #if defined USE_QMC_SAMPLER
         return APPLESEED_VERSION_STRING " (SSE, QMC)";
+    #elif defined USE_SOBOL_SAMPLER
+        return APPLESEED_VERSION_STRING " (SSE, Sobol)";
     #else
         return APPLESEED_VERSION_STRING " (SSE)";
     #endif
 #else
-    #ifdef USE_QMC_SAMPLER
+    #if defined USE_QMC_SAMPLER
         return APPLESEED_VERSION_STRING " (QMC)";
+    #elif defined USE_SOBOL_SAMPLER
+        return APPLESEED_VERSION_STRING " (Sobol)";
     #else
         return APPLESEED_VERSION_STRING;
     #endif
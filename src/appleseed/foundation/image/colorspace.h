@@ -244,6 +244,12 @@ Color<T, 3> ciexyz_to_linear_rgb(const Color<T, 3>& xyz);
 template <typename T>
 Color<T, 3> linear_rgb_to_ciexyz(const Color<T, 3>& linear_rgb);
 
+#ifdef APPLESEED_USE_SSE
+// Variant of the above function operating on the first three components of a SSE vector.
+// The value of the fourth component of the result is undefined.
+inline __m128 linear_rgb_to_ciexyz(const __m128 linear_rgb);
+#endif
+
 
 //
 // CIE XYZ <-> CIE xyY transformations.
@@ -591,6 +597,25 @@ inline Color<T, 3> linear_rgb_to_ciexyz(const Color<T, 3>& linear_rgb)
             T(0.0));
 }
 
+#ifdef APPLESEED_USE_SSE
+
+inline __m128 linear_rgb_to_ciexyz(const __m128 linear_rgb)
+{
+    // Broadcast each component of the input color.
+    const __m128 r = _mm_shuffle_ps(linear_rgb, linear_rgb, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128 g = _mm_shuffle_ps(linear_rgb, linear_rgb, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128 b = _mm_shuffle_ps(linear_rgb, linear_rgb, _MM_SHUFFLE(2, 2, 2, 2));
+
+    // Multiply by the columns of the transformation matrix.
+    __m128 xyz = _mm_mul_ps(r, _mm_set_ps(0.0f, 0.019334f, 0.212671f, 0.412453f));
+    xyz = _mm_add_ps(xyz, _mm_mul_ps(g, _mm_set_ps(0.0f, 0.119193f, 0.715160f, 0.357580f)));
+    xyz = _mm_add_ps(xyz, _mm_mul_ps(b, _mm_set_ps(0.0f, 0.950227f, 0.072169f, 0.180423f)));
+
+    return _mm_max_ps(xyz, _mm_setzero_ps());
+}
+
+#endif  // APPLESEED_USE_SSE
+
 
 //
 // CIE XYZ <-> CIE xyY transformations implementation.
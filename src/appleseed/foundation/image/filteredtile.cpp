@@ -37,12 +37,34 @@
 
 // Standard headers.
 #include <cmath>
+#include <cstddef>
 
 using namespace std;
 
 namespace foundation
 {
 
+namespace
+{
+    // Linearly interpolate a filter table at a given fractional position.
+    inline float lookup(
+        const float*    table,
+        const size_t    size,
+        const double    position)
+    {
+        if (position <= 0.0)
+            return table[0];
+
+        const size_t i = truncate<size_t>(position);
+
+        if (i >= size - 1)
+            return table[size - 1];
+
+        const float t = static_cast<float>(position - i);
+        return table[i] + (table[i + 1] - table[i]) * t;
+    }
+}
+
 //
 // We use the discrete-to-continuous mapping described in:
 //
@@ -65,6 +87,7 @@ FilteredTile::FilteredTile(
   , m_crop_window(Vector2u(0, 0), Vector2u(width - 1, height - 1))
   , m_filter(filter)
 {
+    build_filter_tables();
 }
 
 FilteredTile::FilteredTile(
@@ -77,6 +100,7 @@ FilteredTile::FilteredTile(
   , m_crop_window(crop_window)
   , m_filter(filter)
 {
+    build_filter_tables();
 }
 
 void FilteredTile::clear()
@@ -106,20 +130,69 @@ void FilteredTile::add(
     // Don't affect pixels outside the crop window.
     footprint = AABB2i::intersect(footprint, m_crop_window);
 
-    for (int ry = footprint.min.y; ry <= footprint.max.y; ++ry)
+    if (footprint.min.x > footprint.max.x || footprint.min.y > footprint.max.y)
+        return;
+
+    const size_t footprint_width = static_cast<size_t>(footprint.max.x - footprint.min.x + 1);
+    const size_t footprint_height = static_cast<size_t>(footprint.max.y - footprint.min.y + 1);
+
+    // Look up the filter weights of the affected columns and rows.
+    const double xoffset = m_filter.get_xradius() - dx;
+    const double yoffset = m_filter.get_yradius() - dy;
+    for (size_t i = 0; i < footprint_width; ++i)
+    {
+        const double u = (footprint.min.x + i + xoffset) * m_filter_xscale;
+        m_xweights[i] = lookup(m_filter_xtable, FilterTableSize, u);
+    }
+    for (size_t i = 0; i < footprint_height; ++i)
+    {
+        const double v = (footprint.min.y + i + yoffset) * m_filter_yscale;
+        m_yweights[i] = lookup(m_filter_ytable, FilterTableSize, v);
+    }
+
+    const size_t value_count = m_channel_count - 1;
+
+    for (size_t j = 0; j < footprint_height; ++j)
     {
-        for (int rx = footprint.min.x; rx <= footprint.max.x; ++rx)
+        const float yweight = m_yweights[j];
+        float* RESTRICT ptr = pixel(footprint.min.x, footprint.min.y + j);
+
+        for (size_t i = 0; i < footprint_width; ++i)
         {
-            const float weight = static_cast<float>(m_filter.evaluate(rx - dx, ry - dy));
+            const float weight = m_xweights[i] * yweight;
 
-            float* RESTRICT ptr = reinterpret_cast<float*>(pixel(rx, ry));
+            ptr[0] += weight;
 
-            *ptr++ += weight;
+            for (size_t c = 0; c < value_count; ++c)
+                ptr[c + 1] += values[c] * weight;
 
-            for (size_t i = 0; i < m_channel_count - 1; ++i)
-                ptr[i] += values[i] * weight;
+            ptr += m_channel_count;
         }
     }
 }
 
+void FilteredTile::build_filter_tables()
+{
+    const double xradius = m_filter.get_xradius();
+    const double yradius = m_filter.get_yradius();
+
+    // Since the filter is separable, f(x, y) = f(x, 0) * f(0, y) / f(0, 0).
+    const double center = m_filter.evaluate(0.0, 0.0);
+    const double rcp_center = center == 0.0 ? 0.0 : 1.0 / center;
+
+    m_filter_xscale = (FilterTableSize - 1) / (2.0 * xradius);
+    m_filter_yscale = (FilterTableSize - 1) / (2.0 * yradius);
+
+    for (size_t i = 0; i < FilterTableSize; ++i)
+    {
+        const double x = i / m_filter_xscale - xradius;
+        const double y = i / m_filter_yscale - yradius;
+        m_filter_xtable[i] = static_cast<float>(m_filter.evaluate(x, 0.0) * rcp_center);
+        m_filter_ytable[i] = static_cast<float>(m_filter.evaluate(0.0, y));
+    }
+
+    m_xweights.resize(truncate<size_t>(2.0 * xradius) + 2);
+    m_yweights.resize(truncate<size_t>(2.0 * yradius) + 2);
+}
+
 }   // namespace foundation
@@ -39,6 +39,7 @@
 // Standard headers.
 #include <cassert>
 #include <cstddef>
+#include <vector>
 
 namespace foundation
 {
@@ -46,6 +47,10 @@ namespace foundation
 //
 // A 2D tile that supports filtered accumulation of values.
 //
+// The reconstruction filter is assumed to be separable. It is tabulated along
+// each axis when the tile is constructed, so that add() never needs to call
+// the filter's virtual evaluate() method.
+//
 
 class FilteredTile
   : public Tile
@@ -127,6 +132,19 @@ class FilteredTile
   protected:
     const AABB2u            m_crop_window;
     const Filter2d&         m_filter;
+
+  private:
+    enum { FilterTableSize = 256 };
+
+    float                   m_filter_xtable[FilterTableSize];
+    float                   m_filter_ytable[FilterTableSize];
+    double                  m_filter_xscale;
+    double                  m_filter_yscale;
+
+    std::vector<float>      m_xweights;
+    std::vector<float>      m_yweights;
+
+    void build_filter_tables();
 };
 
 
@@ -0,0 +1,310 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_BEZIERCURVE_H
+#define APPLESEED_FOUNDATION_MATH_BEZIERCURVE_H
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/minmax.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// Cubic Bezier curve in 3D with a width attached to each control point.
+//
+// The width is interpolated along the curve with the same basis as the
+// control points. Curves of this kind are used to represent hair and fur.
+//
+
+template <typename T>
+class BezierCurve3
+{
+  public:
+    // Types.
+    typedef T ValueType;
+    typedef Vector<T, 3> VectorType;
+    typedef AABB<T, 3> AABBType;
+    typedef BezierCurve3<T> BezierCurveType;
+
+    // Constructors.
+    BezierCurve3();                                 // leave all components uninitialized
+    BezierCurve3(
+        const VectorType    points[4],
+        const ValueType     widths[4]);
+
+    // Construct a curve from another curve of a different type.
+    template <typename U>
+    explicit BezierCurve3(const BezierCurve3<U>& rhs);
+
+    // Return the Bezier form of a segment of a uniform cubic B-spline.
+    static BezierCurveType from_bspline(
+        const VectorType    points[4],
+        const ValueType     widths[4]);
+
+    // Return the Bezier form of a straight segment.
+    static BezierCurveType from_linear(
+        const VectorType&   p0,
+        const VectorType&   p1,
+        const ValueType     w0,
+        const ValueType     w1);
+
+    // Access the control points and their widths.
+    const VectorType& get_control_point(const size_t i) const;
+    ValueType get_width(const size_t i) const;
+
+    // Return the largest width of the curve.
+    ValueType get_max_width() const;
+
+    // Evaluate the curve at a given parameter in [0,1].
+    VectorType evaluate_point(const ValueType t) const;
+    VectorType evaluate_tangent(const ValueType t) const;  // derivative wrt. t, not unit-length
+    ValueType evaluate_width(const ValueType t) const;
+
+    // Split the curve in two halves at t = 0.5.
+    void split(BezierCurveType& left, BezierCurveType& right) const;
+
+    // Compute the bounding box of the control points, enlarged by half the
+    // largest width. The curve is guaranteed to lie within this bounding box.
+    AABBType compute_bbox() const;
+
+  private:
+    template <typename U> friend class BezierCurve3;
+
+    VectorType  m_points[4];
+    ValueType   m_widths[4];
+};
+
+
+//
+// Full specializations for curves of type float and double.
+//
+
+typedef BezierCurve3<float>  BezierCurve3f;
+typedef BezierCurve3<double> BezierCurve3d;
+
+
+//
+// BezierCurve3 class implementation.
+//
+
+template <typename T>
+inline BezierCurve3<T>::BezierCurve3()
+{
+}
+
+template <typename T>
+inline BezierCurve3<T>::BezierCurve3(
+    const VectorType        points[4],
+    const ValueType         widths[4])
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        m_points[i] = points[i];
+        m_widths[i] = widths[i];
+    }
+}
+
+template <typename T>
+template <typename U>
+inline BezierCurve3<T>::BezierCurve3(const BezierCurve3<U>& rhs)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        m_points[i] = VectorType(rhs.m_points[i]);
+        m_widths[i] = static_cast<ValueType>(rhs.m_widths[i]);
+    }
+}
+
+template <typename T>
+inline BezierCurve3<T> BezierCurve3<T>::from_bspline(
+    const VectorType        points[4],
+    const ValueType         widths[4])
+{
+    const ValueType Rcp3 = ValueType(1.0 / 3.0);
+    const ValueType Rcp6 = ValueType(1.0 / 6.0);
+
+    BezierCurveType curve;
+
+    curve.m_points[0] = (points[0] + ValueType(4.0) * points[1] + points[2]) * Rcp6;
+    curve.m_points[1] = (ValueType(2.0) * points[1] + points[2]) * Rcp3;
+    curve.m_points[2] = (points[1] + ValueType(2.0) * points[2]) * Rcp3;
+    curve.m_points[3] = (points[1] + ValueType(4.0) * points[2] + points[3]) * Rcp6;
+
+    curve.m_widths[0] = (widths[0] + ValueType(4.0) * widths[1] + widths[2]) * Rcp6;
+    curve.m_widths[1] = (ValueType(2.0) * widths[1] + widths[2]) * Rcp3;
+    curve.m_widths[2] = (widths[1] + ValueType(2.0) * widths[2]) * Rcp3;
+    curve.m_widths[3] = (widths[1] + ValueType(4.0) * widths[2] + widths[3]) * Rcp6;
+
+    return curve;
+}
+
+template <typename T>
+inline BezierCurve3<T> BezierCurve3<T>::from_linear(
+    const VectorType&       p0,
+    const VectorType&       p1,
+    const ValueType         w0,
+    const ValueType         w1)
+{
+    const ValueType Rcp3 = ValueType(1.0 / 3.0);
+
+    BezierCurveType curve;
+
+    curve.m_points[0] = p0;
+    curve.m_points[1] = p0 + (p1 - p0) * Rcp3;
+    curve.m_points[2] = p1 + (p0 - p1) * Rcp3;
+    curve.m_points[3] = p1;
+
+    curve.m_widths[0] = w0;
+    curve.m_widths[1] = w0 + (w1 - w0) * Rcp3;
+    curve.m_widths[2] = w1 + (w0 - w1) * Rcp3;
+    curve.m_widths[3] = w1;
+
+    return curve;
+}
+
+template <typename T>
+inline const Vector<T, 3>& BezierCurve3<T>::get_control_point(const size_t i) const
+{
+    assert(i < 4);
+    return m_points[i];
+}
+
+template <typename T>
+inline T BezierCurve3<T>::get_width(const size_t i) const
+{
+    assert(i < 4);
+    return m_widths[i];
+}
+
+template <typename T>
+inline T BezierCurve3<T>::get_max_width() const
+{
+    return max(m_widths[0], m_widths[1], m_widths[2], m_widths[3]);
+}
+
+template <typename T>
+inline Vector<T, 3> BezierCurve3<T>::evaluate_point(const ValueType t) const
+{
+    const ValueType s = ValueType(1.0) - t;
+
+    return
+          m_points[0] * (s * s * s)
+        + m_points[1] * (ValueType(3.0) * s * s * t)
+        + m_points[2] * (ValueType(3.0) * s * t * t)
+        + m_points[3] * (t * t * t);
+}
+
+template <typename T>
+inline Vector<T, 3> BezierCurve3<T>::evaluate_tangent(const ValueType t) const
+{
+    const ValueType s = ValueType(1.0) - t;
+
+    return
+          (m_points[1] - m_points[0]) * (ValueType(3.0) * s * s)
+        + (m_points[2] - m_points[1]) * (ValueType(6.0) * s * t)
+        + (m_points[3] - m_points[2]) * (ValueType(3.0) * t * t);
+}
+
+template <typename T>
+inline T BezierCurve3<T>::evaluate_width(const ValueType t) const
+{
+    const ValueType s = ValueType(1.0) - t;
+
+    return
+          m_widths[0] * (s * s * s)
+        + m_widths[1] * (ValueType(3.0) * s * s * t)
+        + m_widths[2] * (ValueType(3.0) * s * t * t)
+        + m_widths[3] * (t * t * t);
+}
+
+template <typename T>
+void BezierCurve3<T>::split(BezierCurveType& left, BezierCurveType& right) const
+{
+    // De Casteljau subdivision at t = 0.5.
+
+    const VectorType p01 = (m_points[0] + m_points[1]) * ValueType(0.5);
+    const VectorType p12 = (m_points[1] + m_points[2]) * ValueType(0.5);
+    const VectorType p23 = (m_points[2] + m_points[3]) * ValueType(0.5);
+    const VectorType p012 = (p01 + p12) * ValueType(0.5);
+    const VectorType p123 = (p12 + p23) * ValueType(0.5);
+    const VectorType p0123 = (p012 + p123) * ValueType(0.5);
+
+    const ValueType w01 = (m_widths[0] + m_widths[1]) * ValueType(0.5);
+    const ValueType w12 = (m_widths[1] + m_widths[2]) * ValueType(0.5);
+    const ValueType w23 = (m_widths[2] + m_widths[3]) * ValueType(0.5);
+    const ValueType w012 = (w01 + w12) * ValueType(0.5);
+    const ValueType w123 = (w12 + w23) * ValueType(0.5);
+    const ValueType w0123 = (w012 + w123) * ValueType(0.5);
+
+    left.m_points[0] = m_points[0];
+    left.m_points[1] = p01;
+    left.m_points[2] = p012;
+    left.m_points[3] = p0123;
+
+    left.m_widths[0] = m_widths[0];
+    left.m_widths[1] = w01;
+    left.m_widths[2] = w012;
+    left.m_widths[3] = w0123;
+
+    right.m_points[0] = p0123;
+    right.m_points[1] = p123;
+    right.m_points[2] = p23;
+    right.m_points[3] = m_points[3];
+
+    right.m_widths[0] = w0123;
+    right.m_widths[1] = w123;
+    right.m_widths[2] = w23;
+    right.m_widths[3] = m_widths[3];
+}
+
+template <typename T>
+inline AABB<T, 3> BezierCurve3<T>::compute_bbox() const
+{
+    AABBType bbox;
+    bbox.invalidate();
+
+    for (size_t i = 0; i < 4; ++i)
+        bbox.insert(m_points[i]);
+
+    bbox.grow(VectorType(ValueType(0.5) * get_max_width()));
+
+    return bbox;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_BEZIERCURVE_H
@@ -41,6 +41,7 @@
 #include "foundation/math/bvh/bvh_sbvhpartitioner.h"
 #include "foundation/math/bvh/bvh_spatialbuilder.h"
 #include "foundation/math/bvh/bvh_statistics.h"
+#include "foundation/math/bvh/bvh_temporalbuilder.h"
 #include "foundation/math/bvh/bvh_tree.h"
 
 #endif  // !APPLESEED_FOUNDATION_MATH_BVH_H
@@ -107,7 +107,8 @@ class Intersector
 #endif
         ) const;
 
-    // Intersect a ray with a given BVH with motion.
+    // Intersect a ray with a given BVH with motion. 'ray_time' must be in [0,1].
+    // Temporal interior nodes are only allowed at the top of the tree.
     void intersect_motion(
         const Tree&             tree,
         const RayType&          ray,
@@ -288,6 +289,17 @@ void Intersector<Tree, Visitor, Ray, StackSize, N>::intersect_motion(
     FOUNDATION_BVH_TRAVERSAL_STATS(size_t intersected_bboxes = 0);
     FOUNDATION_BVH_TRAVERSAL_STATS(size_t discarded_nodes = 0);
 
+    // Descend through the temporal interior nodes at the top of the tree. Each of them
+    // halves the time interval, and the ray time is remapped to the selected half.
+    ValueType local_time = ray_time;
+    while (node_ptr->is_temporal_interior())
+    {
+        FOUNDATION_BVH_TRAVERSAL_STATS(++visited_nodes);
+        const size_t right = local_time >= ValueType(0.5) ? 1 : 0;
+        local_time = local_time * ValueType(2.0) - static_cast<ValueType>(right);
+        node_ptr = &tree.m_nodes[node_ptr->get_child_node_index() + right];
+    }
+
     // Traverse the tree and intersect leaf nodes.
     ValueType ray_tmax = ray.m_tmax;
     while (true)
@@ -306,14 +318,14 @@ void Intersector<Tree, Visitor, Ray, StackSize, N>::intersect_motion(
             const size_t left_motion_segment_count = node_ptr->get_left_bbox_count() - 1;
             if (left_motion_segment_count > 0)
             {
-                const size_t prev_index = truncate<size_t>(ray_time * left_motion_segment_count);
+                const size_t prev_index = truncate<size_t>(local_time * left_motion_segment_count);
                 const size_t base_index = node_ptr->get_left_bbox_index() + prev_index;
 
                 const typename NodeType::AABBType left_bbox =
                     lerp(
                         tree.m_node_bboxes[base_index],
                         tree.m_node_bboxes[base_index + 1],
-                        static_cast<ValueType>(ray_time * left_motion_segment_count - prev_index));
+                        static_cast<ValueType>(local_time * left_motion_segment_count - prev_index));
 
                 hit_left = (foundation::intersect(ray, ray_info, left_bbox, tmin[0]) && tmin[0] < ray_tmax) ? 1 : 0;
             }
@@ -327,14 +339,14 @@ void Intersector<Tree, Visitor, Ray, StackSize, N>::intersect_motion(
             const size_t right_motion_segment_count = node_ptr->get_right_bbox_count() - 1;
             if (right_motion_segment_count > 0)
             {
-                const size_t prev_index = truncate<size_t>(ray_time * right_motion_segment_count);
+                const size_t prev_index = truncate<size_t>(local_time * right_motion_segment_count);
                 const size_t base_index = node_ptr->get_right_bbox_index() + prev_index;
 
                 const typename NodeType::AABBType right_bbox =
                     lerp(
                         tree.m_node_bboxes[base_index],
                         tree.m_node_bboxes[base_index + 1],
-                        static_cast<ValueType>(ray_time * right_motion_segment_count - prev_index));
+                        static_cast<ValueType>(local_time * right_motion_segment_count - prev_index));
 
                 hit_right = (foundation::intersect(ray, ray_info, right_bbox, tmin[1]) && tmin[1] < ray_tmax) ? 1 : 0;
             }
@@ -444,7 +456,8 @@ class Intersector<Tree, Visitor, Ray, StackSize, 3>
 #endif
         ) const;
 
-    // Intersect a ray with a given BVH with motion.
+    // Intersect a ray with a given BVH with motion. 'ray_time' must be in [0,1].
+    // Temporal interior nodes are only allowed at the top of the tree.
     void intersect_motion(
         const Tree&             tree,
         const RayType&          ray,
@@ -637,7 +650,6 @@ void Intersector<Tree, Visitor, Ray, StackSize, 3>::intersect_motion(
     const __m128d rcp_dir_y = _mm_set1_pd(ray_info.m_rcp_dir.y);
     const __m128d rcp_dir_z = _mm_set1_pd(ray_info.m_rcp_dir.z);
     const __m128d ray_tmin = _mm_set1_pd(ray.m_tmin);
-    const __m128d mray_time = _mm_set1_pd(ray_time);
 
     // Load constants.
     const __m128d one = _mm_set1_pd(1.0);
@@ -656,6 +668,20 @@ void Intersector<Tree, Visitor, Ray, StackSize, 3>::intersect_motion(
     FOUNDATION_BVH_TRAVERSAL_STATS(size_t intersected_bboxes = 0);
     FOUNDATION_BVH_TRAVERSAL_STATS(size_t discarded_nodes = 0);
 
+    // Descend through the temporal interior nodes at the top of the tree. Each of them
+    // halves the time interval, and the ray time is remapped to the selected half.
+    ValueType local_time = ray_time;
+    while (node_ptr->is_temporal_interior())
+    {
+        FOUNDATION_BVH_TRAVERSAL_STATS(++visited_nodes);
+        const size_t right = local_time >= ValueType(0.5) ? 1 : 0;
+        local_time = local_time * ValueType(2.0) - static_cast<ValueType>(right);
+        node_ptr = &tree.m_nodes[node_ptr->get_child_node_index() + right];
+    }
+
+    // Load the ray time into SSE registers.
+    const __m128d mray_time = _mm_set1_pd(local_time);
+
     // Traverse the tree and intersect leaf nodes.
     ValueType rtmax = ray.m_tmax;
     while (true)
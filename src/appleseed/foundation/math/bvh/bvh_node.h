@@ -60,6 +60,12 @@ class APPLESEED_ALIGN(64) Node
     bool is_interior() const;
     bool is_leaf() const;
 
+    // Set/get the temporal interior node type. Temporal interior nodes are interior nodes
+    // whose left and right children cover the first and second halves of the time interval
+    // of the node. They have no child bounding boxes.
+    void make_temporal_interior();
+    bool is_temporal_interior() const;
+
     // Set/get the bounding boxes of the child nodes (interior nodes only, static case).
     void set_left_bbox(const AABBType& bbox);
     void set_right_bbox(const AABBType& bbox);
@@ -101,6 +107,9 @@ class APPLESEED_ALIGN(64) Node
     typedef typename AABBType::ValueType ValueType;
     static const size_t Dimension = AABBType::Dimension;
 
+    static const uint32 InteriorNodeTag = 0xFFFFFFFFUL;
+    static const uint32 TemporalInteriorNodeTag = 0xFFFFFFFEUL;
+
     uint32                  m_item_count;
     uint32                  m_index;
     uint32                  m_left_bbox_index;
@@ -119,26 +128,38 @@ class APPLESEED_ALIGN(64) Node
 template <typename AABB>
 inline void Node<AABB>::make_interior()
 {
-    m_item_count = ~0;
+    m_item_count = InteriorNodeTag;
 }
 
 template <typename AABB>
 inline void Node<AABB>::make_leaf()
 {
-    if (m_item_count == ~0)
+    if (m_item_count >= TemporalInteriorNodeTag)
         m_item_count = 0;
 }
 
 template <typename AABB>
 inline bool Node<AABB>::is_interior() const
 {
-    return m_item_count == ~0;
+    return m_item_count >= TemporalInteriorNodeTag;
 }
 
 template <typename AABB>
 inline bool Node<AABB>::is_leaf() const
 {
-    return m_item_count != ~0;
+    return m_item_count < TemporalInteriorNodeTag;
+}
+
+template <typename AABB>
+inline void Node<AABB>::make_temporal_interior()
+{
+    m_item_count = TemporalInteriorNodeTag;
+}
+
+template <typename AABB>
+inline bool Node<AABB>::is_temporal_interior() const
+{
+    return m_item_count == TemporalInteriorNodeTag;
 }
 
 template <typename AABB>
@@ -300,7 +321,7 @@ inline size_t Node<AABB>::get_item_index() const
 template <typename AABB>
 inline void Node<AABB>::set_item_count(const size_t count)
 {
-    assert(count < 0xFFFFFFFFUL);
+    assert(count < TemporalInteriorNodeTag);
     m_item_count = static_cast<uint32>(count);
 }
 
@@ -0,0 +1,226 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_BVH_BVH_TEMPORALBUILDER_H
+#define APPLESEED_FOUNDATION_MATH_BVH_BVH_TEMPORALBUILDER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/bvh/bvh_tree.h"
+#include "foundation/utility/stopwatch.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace foundation {
+namespace bvh {
+
+//
+// Temporal BVH builder.
+//
+// Builds a tree for motion blurred items by splitting the time interval [0,1] in 2^depth
+// intervals of equal length and building one spatial subtree per interval, using the
+// bounding boxes of the items over that interval only. The subtrees are joined by
+// temporal interior nodes at the top of the tree.
+//
+// Within a subtree, motion bounding boxes (if any) must span the time interval of
+// the subtree, not [0,1]: the intersector remaps the ray time accordingly.
+//
+// The SubtreeBuilder class must conform to the following prototype:
+//
+//      class SubtreeBuilder
+//        : public foundation::NonCopyable
+//      {
+//        public:
+//          // Build the subtree for the time interval [time_begin, time_end].
+//          // Leaf nodes must reference items starting at index 0.
+//          // Return the number of items referenced by the subtree
+//          // and the bounding box of the subtree.
+//          size_t build(
+//              SubtreeType&        subtree,
+//              const double        time_begin,
+//              const double        time_end,
+//              AABBType&           bbox);
+//      };
+//
+// Items referenced by the leaves of the final tree are numbered consecutively
+// from one subtree to the next, in the order of increasing time.
+//
+
+template <typename Tree>
+class TemporalBuilder
+  : public NonCopyable
+{
+  public:
+    typedef foundation::bvh::Tree<typename Tree::NodeVectorType> SubtreeType;
+
+    // Constructor.
+    TemporalBuilder();
+
+    // Build a tree.
+    template <typename Timer, typename SubtreeBuilder>
+    void build(
+        Tree&               tree,
+        SubtreeBuilder&     subtree_builder,
+        const size_t        depth);
+
+    // Return the construction time.
+    double get_build_time() const;
+
+  private:
+    typedef typename Tree::NodeType NodeType;
+    typedef typename NodeType::AABBType AABBType;
+
+    double m_build_time;
+
+    // Append the nodes of a subtree to the tree, with its root stored at a given index.
+    static void append_subtree(
+        Tree&               tree,
+        const SubtreeType&  subtree,
+        const size_t        root_index,
+        const size_t        item_offset);
+};
+
+
+//
+// TemporalBuilder class implementation.
+//
+
+template <typename Tree>
+TemporalBuilder<Tree>::TemporalBuilder()
+  : m_build_time(0.0)
+{
+}
+
+template <typename Tree>
+template <typename Timer, typename SubtreeBuilder>
+void TemporalBuilder<Tree>::build(
+    Tree&                   tree,
+    SubtreeBuilder&         subtree_builder,
+    const size_t            depth)
+{
+    // Start stopwatch.
+    Stopwatch<Timer> stopwatch;
+    stopwatch.start();
+
+    // Clear the tree.
+    tree.m_nodes.clear();
+
+    // Create the temporal interior nodes and the roots of the subtrees. They are stored
+    // in breadth-first order, so that the children of node i are nodes 2i+1 and 2i+2.
+    const size_t interval_count = size_t(1) << depth;
+    const size_t temporal_node_count = interval_count - 1;
+    tree.m_nodes.resize(temporal_node_count + interval_count);
+
+    for (size_t i = 0; i < temporal_node_count; ++i)
+    {
+        NodeType& node = tree.m_nodes[i];
+        node.make_temporal_interior();
+        node.set_child_node_index(2 * i + 1);
+    }
+
+    // Build the subtrees.
+    std::vector<AABBType> bboxes(temporal_node_count + interval_count);
+    size_t item_offset = 0;
+
+    for (size_t i = 0; i < interval_count; ++i)
+    {
+        const size_t root_index = temporal_node_count + i;
+
+        SubtreeType subtree(tree.m_nodes.get_allocator());
+        const size_t item_count =
+            subtree_builder.build(
+                subtree,
+                static_cast<double>(i) / interval_count,
+                static_cast<double>(i + 1) / interval_count,
+                bboxes[root_index]);
+
+        append_subtree(tree, subtree, root_index, item_offset);
+        item_offset += item_count;
+    }
+
+    // Temporal interior nodes don't need child bounding boxes to be traversed,
+    // but we store them anyway for the benefit of tree statistics.
+    for (size_t i = temporal_node_count; i-- > 0; )
+    {
+        const AABBType& left_bbox = bboxes[2 * i + 1];
+        const AABBType& right_bbox = bboxes[2 * i + 2];
+
+        NodeType& node = tree.m_nodes[i];
+        node.set_left_bbox(left_bbox);
+        node.set_right_bbox(right_bbox);
+
+        bboxes[i] = left_bbox;
+        bboxes[i].insert(right_bbox);
+    }
+
+    // Measure and save construction time.
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename Tree>
+inline double TemporalBuilder<Tree>::get_build_time() const
+{
+    return m_build_time;
+}
+
+template <typename Tree>
+void TemporalBuilder<Tree>::append_subtree(
+    Tree&                   tree,
+    const SubtreeType&      subtree,
+    const size_t            root_index,
+    const size_t            item_offset)
+{
+    assert(!subtree.m_nodes.empty());
+    assert(!subtree.m_nodes[0].is_temporal_interior());
+
+    // Node i > 0 of the subtree becomes node i + node_offset of the tree.
+    const size_t node_offset = tree.m_nodes.size() - 1;
+    const size_t node_count = subtree.m_nodes.size();
+
+    for (size_t i = 0; i < node_count; ++i)
+    {
+        NodeType node = subtree.m_nodes[i];
+
+        if (node.is_interior())
+            node.set_child_node_index(node.get_child_node_index() + node_offset);
+        else node.set_item_index(node.get_item_index() + item_offset);
+
+        if (i == 0)
+            tree.m_nodes[root_index] = node;
+        else tree.m_nodes.push_back(node);
+    }
+}
+
+}       // namespace bvh
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_BVH_BVH_TEMPORALBUILDER_H
@@ -69,6 +69,9 @@ class Tree
     template <typename Tree, typename Partitioner>
     friend class SpatialBuilder;
 
+    template <typename Tree>
+    friend class TemporalBuilder;
+
     template <typename Tree>
     friend class TreeStatistics;
 
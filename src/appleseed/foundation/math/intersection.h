@@ -33,6 +33,7 @@
 // Interface headers.
 #include "foundation/math/intersection/aabbtriangle.h"
 #include "foundation/math/intersection/rayaabb.h"
+#include "foundation/math/intersection/raycurve.h"
 #include "foundation/math/intersection/rayplane.h"
 #include "foundation/math/intersection/raysphere.h"
 #include "foundation/math/intersection/raytrianglehh.h"
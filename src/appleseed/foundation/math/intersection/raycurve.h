@@ -0,0 +1,255 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_INTERSECTION_RAYCURVE_H
+#define APPLESEED_FOUNDATION_MATH_INTERSECTION_RAYCURVE_H
+
+// appleseed.foundation headers.
+#include "foundation/math/basis.h"
+#include "foundation/math/beziercurve.h"
+#include "foundation/math/minmax.h"
+#include "foundation/math/ray.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// 3D ray-curve intersection.
+//
+// The curve is treated as a flat ribbon that always faces the ray. Its width
+// at any point is the width interpolated from the control points.
+//
+
+// Test the intersection between a ray and a curve.
+template <typename T>
+bool intersect(
+    const Ray<T, 3>&            ray,
+    const BezierCurve3<T>&      curve);
+
+// Test the intersection between a ray and a curve.
+// If the ray and the curve intersect, the distance to the closest
+// intersection is returned in 't', the curve parameter at the
+// intersection point in 'u', and the position across the ribbon,
+// in [0,1], in 'v'. Otherwise, 't', 'u' and 'v' are left unchanged.
+template <typename T>
+bool intersect(
+    const Ray<T, 3>&            ray,
+    const BezierCurve3<T>&      curve,
+    T&                          t,
+    T&                          u,
+    T&                          v);
+
+
+//
+// 3D ray-curve intersection functions implementation.
+//
+// The curve is transformed to a space where the ray starts at the origin and
+// runs along the Z axis, then recursively subdivided until each piece is flat
+// enough to be approximated by a line segment. Pieces whose bounding box does
+// not contain the origin are culled early.
+//
+// Reference:
+//
+//   Ray Tracing For Curves Primitive
+//   Koji Nakamaru, Yoshio Ohno
+//   WSCG 2002.
+//   http://wscg.zcu.cz/wscg2002/Papers_2002/A23.pdf
+//
+
+namespace impl
+{
+    // Maximum number of subdivisions of a curve segment.
+    const size_t RayCurveMaxSubdivisionDepth = 10;
+
+    template <typename T>
+    size_t compute_curve_subdivision_depth(const BezierCurve3<T>& curve)
+    {
+        // Bound the deviation of the curve from its chord.
+        T l0 = T(0.0);
+        for (size_t i = 0; i < 2; ++i)
+        {
+            const Vector<T, 3> d =
+                  curve.get_control_point(i)
+                - T(2.0) * curve.get_control_point(i + 1)
+                + curve.get_control_point(i + 2);
+            l0 = max(l0, std::abs(d.x), std::abs(d.y), std::abs(d.z));
+        }
+
+        // Subdivide until the deviation is a small fraction of the width.
+        const T eps = T(0.05) * curve.get_max_width();
+        if (l0 <= T(0.0) || eps <= T(0.0))
+            return 0;
+
+        const T r0 = std::log(T(1.41421356237) * T(6.0) * l0 / (T(8.0) * eps)) / std::log(T(4.0));
+        return r0 <= T(0.0) ? 0 : min(truncate<size_t>(r0) + 1, RayCurveMaxSubdivisionDepth);
+    }
+
+    template <typename T>
+    bool intersect_curve_piece(
+        const BezierCurve3<T>&  curve,          // in ray space
+        const T                 u0,             // curve parameter at the beginning of the piece
+        const T                 u1,             // curve parameter at the end of the piece
+        const size_t            depth,          // remaining number of subdivisions
+        const T                 zmin,
+        T&                      zmax,
+        T&                      u,
+        T&                      v)
+    {
+        // Cull the piece if its bounding box does not contain the ray.
+        const AABB<T, 3> bbox = curve.compute_bbox();
+        if (bbox.min.x > T(0.0) || bbox.max.x < T(0.0) ||
+            bbox.min.y > T(0.0) || bbox.max.y < T(0.0) ||
+            bbox.max.z < zmin || bbox.min.z > zmax)
+            return false;
+
+        if (depth > 0)
+        {
+            BezierCurve3<T> left, right;
+            curve.split(left, right);
+
+            const T um = T(0.5) * (u0 + u1);
+            const bool hit_left = intersect_curve_piece(left, u0, um, depth - 1, zmin, zmax, u, v);
+            const bool hit_right = intersect_curve_piece(right, um, u1, depth - 1, zmin, zmax, u, v);
+
+            return hit_left || hit_right;
+        }
+
+        const Vector<T, 3>& p0 = curve.get_control_point(0);
+        const Vector<T, 3>& p1 = curve.get_control_point(1);
+        const Vector<T, 3>& p2 = curve.get_control_point(2);
+        const Vector<T, 3>& p3 = curve.get_control_point(3);
+
+        // Reject hits beyond the perpendiculars to the tangents at both ends,
+        // they belong to the neighboring pieces.
+        if ((p1.y - p0.y) * -p0.y + p0.x * (p0.x - p1.x) < T(0.0))
+            return false;
+        if ((p2.y - p3.y) * -p3.y + p3.x * (p3.x - p2.x) < T(0.0))
+            return false;
+
+        // Find the point of the chord closest to the ray.
+        const T dx = p3.x - p0.x;
+        const T dy = p3.y - p0.y;
+        const T chord_square_length = dx * dx + dy * dy;
+        const T w =
+            chord_square_length > T(0.0)
+                ? saturate(-(p0.x * dx + p0.y * dy) / chord_square_length)
+                : T(0.0);
+
+        // Check the distance between the ray and the curve against the width.
+        const Vector<T, 3> pc = curve.evaluate_point(w);
+        const T square_distance = pc.x * pc.x + pc.y * pc.y;
+        const T width = curve.evaluate_width(w);
+        if (square_distance > T(0.25) * width * width)
+            return false;
+
+        // Check the distance along the ray.
+        if (pc.z < zmin || pc.z >= zmax)
+            return false;
+
+        // Compute the parametric coordinates of the hit.
+        const Vector<T, 3> tangent = curve.evaluate_tangent(w);
+        const T distance = std::sqrt(square_distance) / width;
+        zmax = pc.z;
+        u = u0 + w * (u1 - u0);
+        v = tangent.x * -pc.y + pc.x * tangent.y > T(0.0)
+            ? T(0.5) + distance
+            : T(0.5) - distance;
+
+        return true;
+    }
+}
+
+template <typename T>
+inline bool intersect(
+    const Ray<T, 3>&            ray,
+    const BezierCurve3<T>&      curve)
+{
+    T t, u, v;
+    return intersect(ray, curve, t, u, v);
+}
+
+template <typename T>
+bool intersect(
+    const Ray<T, 3>&            ray,
+    const BezierCurve3<T>&      curve,
+    T&                          t,
+    T&                          u,
+    T&                          v)
+{
+    // Build a basis whose Z axis runs along the ray.
+    const T dir_norm = norm(ray.m_dir);
+    assert(dir_norm > T(0.0));
+    const Basis3<T> basis(ray.m_dir / dir_norm);
+
+    // Transform the curve to ray space. The basis vectors of Basis3 form a
+    // left-handed frame, flip the Y axis to make ray space right-handed.
+    Vector<T, 3> points[4];
+    T widths[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const Vector<T, 3> p = curve.get_control_point(i) - ray.m_org;
+        points[i].x = dot(p, basis.get_tangent_u());
+        points[i].y = -dot(p, basis.get_tangent_v());
+        points[i].z = dot(p, basis.get_normal());
+        widths[i] = curve.get_width(i);
+    }
+    const BezierCurve3<T> local_curve(points, widths);
+
+    // Intersect the curve.
+    const T zmin = ray.m_tmin * dir_norm;
+    T zmax = ray.m_tmax * dir_norm;
+    T hit_u, hit_v;
+    if (!impl::intersect_curve_piece(
+            local_curve,
+            T(0.0),
+            T(1.0),
+            impl::compute_curve_subdivision_depth(local_curve),
+            zmin,
+            zmax,
+            hit_u,
+            hit_v))
+        return false;
+
+    t = zmax / dir_norm;
+    u = hit_u;
+    v = hit_v;
+
+    return true;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_INTERSECTION_RAYCURVE_H
@@ -0,0 +1,425 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#ifndef APPLESEED_FOUNDATION_MATH_KNN_KNN_HASHGRID_H
+#define APPLESEED_FOUNDATION_MATH_KNN_KNN_HASHGRID_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/knn/knn_answer.h"
+#include "foundation/math/distance.h"
+#include "foundation/math/hash.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/stopwatch.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace foundation {
+namespace knn {
+
+//
+// A spatial hash grid for fixed-radius nearest neighbor queries.
+//
+// Points are bucketed by the hash of the coordinates of the cell they fall in. When the
+// cell size is twice the query radius, a query visits at most 2^N cells, and building
+// the grid only requires a counting sort of the points, which makes it a good match for
+// photon maps that are rebuilt at every pass with a known lookup radius.
+//
+// Reference:
+//
+//   Optimized Spatial Hashing for Collision Detection of Deformable Objects
+//   Matthias Teschner, Bruno Heidelberger, Matthias Mueller, Danat Pomeranets, Markus Gross
+//   http://www.beosil.com/download/CollisionDetectionHashing_VMV03.pdf
+//
+
+template <typename T, size_t N>
+class HashGrid
+  : public NonCopyable
+{
+  public:
+    typedef T ValueType;
+    static const size_t Dimension = N;
+
+    typedef Vector<T, N> VectorType;
+
+    // Constructor, builds an empty grid.
+    HashGrid();
+
+    // Return true if the grid does not contain any point.
+    bool empty() const;
+
+    // Transform an internal index to a user-data index.
+    size_t remap(const size_t i) const;
+
+    // Return the i'th point, where i is an internal index.
+    const VectorType& get_point(const size_t i) const;
+
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
+  private:
+    template <typename, size_t> friend class HashGridBuilder;
+    template <typename, size_t> friend class HashGridQuery;
+
+    ValueType               m_rcp_cell_size;
+    size_t                  m_bucket_mask;
+    std::vector<VectorType> m_points;           // points, sorted by bucket
+    std::vector<size_t>     m_indices;          // user-data index of each point
+    std::vector<size_t>     m_buckets;          // index of the first point of each bucket, plus a sentinel
+
+    // Compute the integer coordinates of the cell containing a given point.
+    void compute_cell(const VectorType& point, int cell[N]) const;
+
+    // Return the bucket a given cell maps to.
+    size_t hash_cell(const int cell[N]) const;
+};
+
+typedef HashGrid<float, 2>  HashGrid2f;
+typedef HashGrid<double, 2> HashGrid2d;
+typedef HashGrid<float, 3>  HashGrid3f;
+typedef HashGrid<double, 3> HashGrid3d;
+
+
+template <typename T, size_t N>
+class HashGridBuilder
+  : public NonCopyable
+{
+  public:
+    typedef T ValueType;
+    static const size_t Dimension = N;
+
+    typedef Vector<T, N> VectorType;
+    typedef HashGrid<T, N> GridType;
+
+    // Constructor.
+    explicit HashGridBuilder(GridType& grid);
+
+    // Build a grid for a given set of points. The points are moved into the grid.
+    template <typename Timer>
+    void build_move_points(
+        std::vector<VectorType>&    points,
+        const ValueType             cell_size);
+
+    // Return the construction time.
+    double get_build_time() const;
+
+  private:
+    GridType&   m_grid;
+    double      m_build_time;
+};
+
+typedef HashGridBuilder<float, 2>  HashGridBuilder2f;
+typedef HashGridBuilder<double, 2> HashGridBuilder2d;
+typedef HashGridBuilder<float, 3>  HashGridBuilder3f;
+typedef HashGridBuilder<double, 3> HashGridBuilder3d;
+
+
+template <typename T, size_t N>
+class HashGridQuery
+  : public NonCopyable
+{
+  public:
+    typedef T ValueType;
+    static const size_t Dimension = N;
+
+    typedef Vector<T, N> VectorType;
+    typedef HashGrid<T, N> GridType;
+    typedef Answer<T> AnswerType;
+
+    HashGridQuery(
+        const GridType&     grid,
+        AnswerType&         answer);
+
+    // Find the nearest points within a given distance of a query point.
+    void run(
+        const VectorType&   query_point,
+        const ValueType     query_max_square_distance) const;
+
+  private:
+    const GridType&         m_grid;
+    AnswerType&             m_answer;
+
+    void visit_bucket(
+        const VectorType&   query_point,
+        const int           cell[N],
+        ValueType&          max_square_dist) const;
+};
+
+typedef HashGridQuery<float, 2>  HashGridQuery2f;
+typedef HashGridQuery<double, 2> HashGridQuery2d;
+typedef HashGridQuery<float, 3>  HashGridQuery3f;
+typedef HashGridQuery<double, 3> HashGridQuery3d;
+
+
+//
+// HashGrid class implementation.
+//
+
+template <typename T, size_t N>
+inline HashGrid<T, N>::HashGrid()
+  : m_rcp_cell_size(T(1.0))
+  , m_bucket_mask(0)
+{
+}
+
+template <typename T, size_t N>
+inline bool HashGrid<T, N>::empty() const
+{
+    return m_points.empty();
+}
+
+template <typename T, size_t N>
+inline size_t HashGrid<T, N>::remap(const size_t i) const
+{
+    assert(i < m_indices.size());
+    return m_indices[i];
+}
+
+template <typename T, size_t N>
+inline const Vector<T, N>& HashGrid<T, N>::get_point(const size_t i) const
+{
+    assert(i < m_points.size());
+    return m_points[i];
+}
+
+template <typename T, size_t N>
+inline size_t HashGrid<T, N>::get_memory_size() const
+{
+    size_t mem_size = sizeof(*this);
+    mem_size += m_points.capacity() * sizeof(VectorType);
+    mem_size += m_indices.capacity() * sizeof(size_t);
+    mem_size += m_buckets.capacity() * sizeof(size_t);
+    return mem_size;
+}
+
+template <typename T, size_t N>
+inline void HashGrid<T, N>::compute_cell(const VectorType& point, int cell[N]) const
+{
+    for (size_t i = 0; i < N; ++i)
+        cell[i] = static_cast<int>(std::floor(point[i] * m_rcp_cell_size));
+}
+
+template <typename T, size_t N>
+inline size_t HashGrid<T, N>::hash_cell(const int cell[N]) const
+{
+    // Large primes from the reference above.
+    static const uint32 Primes[] = { 73856093, 19349663, 83492791, 50331653 };
+
+    uint32 h = 0;
+
+    for (size_t i = 0; i < N; ++i)
+        h ^= static_cast<uint32>(cell[i]) * Primes[i % 4];
+
+    return static_cast<size_t>(hash_uint32(h)) & m_bucket_mask;
+}
+
+
+//
+// HashGridBuilder class implementation.
+//
+
+template <typename T, size_t N>
+inline HashGridBuilder<T, N>::HashGridBuilder(GridType& grid)
+  : m_grid(grid)
+  , m_build_time(0.0)
+{
+}
+
+template <typename T, size_t N>
+template <typename Timer>
+void HashGridBuilder<T, N>::build_move_points(
+    std::vector<VectorType>&    points,
+    const ValueType             cell_size)
+{
+    assert(cell_size > T(0.0));
+
+    Stopwatch<Timer> stopwatch;
+    stopwatch.start();
+
+    const size_t count = points.size();
+
+    // Use about one bucket per point.
+    const size_t bucket_count = next_pow2(static_cast<uint32>(std::max<size_t>(count, 1)));
+
+    m_grid.m_rcp_cell_size = T(1.0) / cell_size;
+    m_grid.m_bucket_mask = bucket_count - 1;
+    m_grid.m_points.resize(count);
+    m_grid.m_indices.resize(count);
+    m_grid.m_buckets.assign(bucket_count + 1, 0);
+
+    // Count the points in each bucket.
+    std::vector<size_t> point_buckets(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        int cell[N];
+        m_grid.compute_cell(points[i], cell);
+        point_buckets[i] = m_grid.hash_cell(cell);
+        ++m_grid.m_buckets[point_buckets[i] + 1];
+    }
+
+    // Compute the index of the first point of each bucket.
+    for (size_t i = 0; i < bucket_count; ++i)
+        m_grid.m_buckets[i + 1] += m_grid.m_buckets[i];
+
+    // Scatter the points into their buckets.
+    std::vector<size_t> next(m_grid.m_buckets.begin(), m_grid.m_buckets.end() - 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t dest = next[point_buckets[i]]++;
+        m_grid.m_points[dest] = points[i];
+        m_grid.m_indices[dest] = i;
+    }
+
+    // The points now belong to the grid.
+    std::vector<VectorType>().swap(points);
+
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename T, size_t N>
+inline double HashGridBuilder<T, N>::get_build_time() const
+{
+    return m_build_time;
+}
+
+
+//
+// HashGridQuery class implementation.
+//
+
+template <typename T, size_t N>
+inline HashGridQuery<T, N>::HashGridQuery(
+    const GridType&         grid,
+    AnswerType&             answer)
+  : m_grid(grid)
+  , m_answer(answer)
+{
+}
+
+template <typename T, size_t N>
+void HashGridQuery<T, N>::run(
+    const VectorType&       query_point,
+    const ValueType         query_max_square_distance) const
+{
+    assert(!m_grid.empty());
+
+    m_answer.clear();
+
+    // Compute the range of cells overlapped by the query sphere.
+    const ValueType query_radius = std::sqrt(query_max_square_distance);
+    int cell_begin[N], cell_end[N];
+    m_grid.compute_cell(query_point - VectorType(query_radius), cell_begin);
+    m_grid.compute_cell(query_point + VectorType(query_radius), cell_end);
+
+    ValueType max_square_dist = query_max_square_distance;
+
+    // Visit the cells in this range.
+    int cell[N];
+    for (size_t i = 0; i < N; ++i)
+        cell[i] = cell_begin[i];
+
+    while (true)
+    {
+        visit_bucket(query_point, cell, max_square_dist);
+
+        size_t d = 0;
+        while (d < N && cell[d] == cell_end[d])
+        {
+            cell[d] = cell_begin[d];
+            ++d;
+        }
+
+        if (d == N)
+            break;
+
+        ++cell[d];
+    }
+}
+
+template <typename T, size_t N>
+inline void HashGridQuery<T, N>::visit_bucket(
+    const VectorType&       query_point,
+    const int               cell[N],
+    ValueType&              max_square_dist) const
+{
+    const size_t bucket = m_grid.hash_cell(cell);
+    const size_t begin = m_grid.m_buckets[bucket];
+    const size_t end = m_grid.m_buckets[bucket + 1];
+    const size_t max_answer_size = m_answer.m_max_size;
+
+    for (size_t point_index = begin; point_index < end; ++point_index)
+    {
+        const VectorType& point = m_grid.m_points[point_index];
+        const ValueType square_dist = square_distance(point, query_point);
+
+        if (m_answer.m_size < max_answer_size ? square_dist > max_square_dist : square_dist >= max_square_dist)
+            continue;
+
+        // Other cells may hash to the same bucket: only consider points that belong to this cell.
+        int point_cell[N];
+        m_grid.compute_cell(point, point_cell);
+
+        bool same_cell = true;
+        for (size_t i = 0; i < N; ++i)
+            same_cell = same_cell && point_cell[i] == cell[i];
+
+        if (!same_cell)
+            continue;
+
+        if (m_answer.m_size < max_answer_size)
+        {
+            // Fill up the answer like an array.
+            m_answer.array_insert(point_index, square_dist);
+
+            // Once the answer is full, transform it into a heap.
+            if (m_answer.m_size == max_answer_size)
+            {
+                m_answer.make_heap();
+                max_square_dist = m_answer.top().m_square_dist;
+            }
+        }
+        else
+        {
+            m_answer.heap_insert(point_index, square_dist);
+            max_square_dist = m_answer.top().m_square_dist;
+        }
+    }
+}
+
+}       // namespace knn
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_KNN_KNN_HASHGRID_H
@@ -55,7 +55,6 @@ namespace foundation
 //   implement specializations of Halton and Hammersley sequences generators for bases (2,3).
 //   implement incremental radical inverse (for successive input values).
 //   implement vectorized radical inverse functions with SSE2.
-//   implement Sobol sequence generator.
 //
 
 
@@ -82,6 +81,62 @@ T folded_radical_inverse_base2(
     size_t              input);         // input digits
 
 
+//
+// Sobol (0,2)-sequence functions.
+//
+// The first component of the Sobol (0,2)-sequence is the base-2 radical inverse,
+// the second component is given by sobol2(). Unlike Halton sequences, every
+// component only requires bit operations, and any power-of-two number of
+// consecutive points starting at a multiple of that number is stratified in
+// all elementary intervals of [0, 1)^2.
+//
+// All return values are in the interval [0, 1).
+//
+// References:
+//
+//   Kollig and Keller, Efficient Multidimensional Sampling
+//   www.uni-kl.de/AG-Heinrich/EMS.pdf
+//
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
+
+// Reverse the order of the bits of a 32-bit integer.
+uint32 reverse_bits(uint32 x);
+
+// Second component of the Sobol (0,2)-sequence, as a 32-bit fixed point value.
+uint32 sobol2_uint32(uint32 input);
+
+// Nested uniform (Owen) scrambling of a 32-bit fixed point value in [0, 1).
+// The scrambled values of the 2^k first points of a (0,2)-sequence remain stratified.
+uint32 owen_scramble_uint32(
+    const uint32        seed,           // scrambling seed
+    const uint32        x);             // fixed point value
+
+// Second component of the Sobol (0,2)-sequence.
+template <typename T>
+T sobol2(
+    const uint32        input);         // input digits
+
+// Second component of the Sobol (0,2)-sequence with digits scrambling.
+template <typename T>
+T sobol2(
+    const uint32        scrambling,     // scrambling value
+    const uint32        input);         // input digits
+
+// Radical inverse in base 2 with nested uniform (Owen) scrambling.
+template <typename T>
+T owen_scrambled_radical_inverse_base2(
+    const uint32        seed,           // scrambling seed
+    const uint32        input);         // input digits
+
+// Second component of the Sobol (0,2)-sequence with nested uniform (Owen) scrambling.
+template <typename T>
+T owen_scrambled_sobol2(
+    const uint32        seed,           // scrambling seed
+    const uint32        input);         // input digits
+
+
 //
 // Arbitrary-base radical inverse functions.
 //
@@ -252,6 +307,98 @@ inline T folded_radical_inverse_base2(
 }
 
 
+//
+// Sobol (0,2)-sequence functions implementation.
+//
+
+namespace impl
+{
+    // Convert a 32-bit fixed point value to a floating point value in [0, 1).
+    template <typename T>
+    inline T uint32_to_unit(const uint32 x)
+    {
+        return static_cast<T>(x) / static_cast<T>(0x100000000LL);
+    }
+
+    // Single precision floats only have 24 bits of mantissa: drop the lowest bits
+    // so that values close to 1 don't get rounded up to 1.
+    template <>
+    inline float uint32_to_unit<float>(const uint32 x)
+    {
+        return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+inline uint32 reverse_bits(uint32 x)
+{
+    x = (x >> 16) | (x << 16);                                              // 16-bit swap
+    x = ((x & 0xFF00FF00) >> 8) | ((x & 0x00FF00FF) << 8);                  // 8-bit swap
+    x = ((x & 0xF0F0F0F0) >> 4) | ((x & 0x0F0F0F0F) << 4);                  // 4-bit swap
+    x = ((x & 0xCCCCCCCC) >> 2) | ((x & 0x33333333) << 2);                  // 2-bit swap
+    x = ((x & 0xAAAAAAAA) >> 1) | ((x & 0x55555555) << 1);                  // 1-bit swap
+    return x;
+}
+
+inline uint32 sobol2_uint32(uint32 input)
+{
+    uint32 result = 0;
+
+    for (uint32 v = 1UL << 31; input; input >>= 1, v ^= v >> 1)
+    {
+        if (input & 1)
+            result ^= v;
+    }
+
+    return result;
+}
+
+inline uint32 owen_scramble_uint32(
+    const uint32        seed,
+    const uint32        x)
+{
+    // Laine-Karras style hash operating on the reversed digits, as improved by Burley:
+    // each output bit only depends on the input bits of higher significance.
+    uint32 r = reverse_bits(x);
+    r ^= r * 0x3D20ADEAUL;
+    r += seed;
+    r *= (seed >> 16) | 1;
+    r ^= r * 0x05526C56UL;
+    r ^= r * 0x53A22864UL;
+    return reverse_bits(r);
+}
+
+template <typename T>
+inline T sobol2(
+    const uint32        input)
+{
+    return impl::uint32_to_unit<T>(sobol2_uint32(input));
+}
+
+template <typename T>
+inline T sobol2(
+    const uint32        scrambling,
+    const uint32        input)
+{
+    return impl::uint32_to_unit<T>(sobol2_uint32(input) ^ scrambling);
+}
+
+template <typename T>
+inline T owen_scrambled_radical_inverse_base2(
+    const uint32        seed,
+    const uint32        input)
+{
+    return impl::uint32_to_unit<T>(owen_scramble_uint32(seed, reverse_bits(input)));
+}
+
+template <typename T>
+inline T owen_scrambled_sobol2(
+    const uint32        seed,
+    const uint32        input)
+{
+    return impl::uint32_to_unit<T>(owen_scramble_uint32(seed, sobol2_uint32(input)));
+}
+
+
 //
 // Arbitrary-base radical inverse functions implementation.
 //
@@ -0,0 +1,418 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
+#define APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
+
+// appleseed.foundation headers.
+#include "foundation/math/hash.h"
+#include "foundation/math/qmc.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/test/helpers.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+// Unit test case declarations.
+DECLARE_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, InitialStateIsCorrect);
+DECLARE_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, TestAssignmentOperator);
+DECLARE_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, TestSplitting);
+DECLARE_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, TestDoubleSplitting);
+
+namespace foundation
+{
+
+//
+// A sampling context featuring:
+//
+//   - deterministic sampling based on the Sobol (0,2)-sequence
+//   - nested uniform (Owen) scrambling or random digit scrambling
+//   - decorrelation of consecutive pairs of dimensions by index shuffling
+//   - padding of the trajectory by hashing the dimension and instance numbers
+//   - per-pixel scrambling, keyed by the initial instance number of the root context
+//
+// The pixel renderers derive the initial instance number of their root sampling
+// context from the pixel coordinates (and the pass), so every pixel gets its own
+// scrambling and shuffling seeds, including for the dimensions of the root context.
+//
+// It is a drop-in replacement for foundation::QMCSamplingContext that neither relies
+// on large precomputed tables nor computes radical inverses in high prime bases.
+//
+// References:
+//
+//   Kollig and Keller, Efficient Multidimensional Sampling
+//   www.uni-kl.de/AG-Heinrich/EMS.pdf
+//
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
+
+template <typename RNG, bool OwenScrambling = true>
+class SobolSamplingContext
+{
+  public:
+    // Random number generator type.
+    typedef RNG RNGType;
+
+    // Construct a sampling context of dimension 0. It cannot be used
+    // directly; only child contexts obtained by splitting can.
+    explicit SobolSamplingContext(RNG& rng);
+
+    // Construct a sampling context for a given number of dimensions
+    // and samples. Set sample_count to 0 if the required number of
+    // samples is unknown or infinite. The initial instance number
+    // also keys the scrambling of the whole trajectory.
+    SobolSamplingContext(
+        RNG&            rng,
+        const size_t    dimension,
+        const size_t    sample_count,
+        const size_t    instance = 0);
+
+    // Assignment operator.
+    SobolSamplingContext& operator=(const SobolSamplingContext& rhs);
+
+    // Trajectory splitting: return a child sampling context for
+    // a given number of dimensions and samples.
+    SobolSamplingContext split(
+        const size_t    dimension,
+        const size_t    sample_count) const;
+
+    // In-place trajectory splitting.
+    void split_in_place(
+        const size_t    dimension,
+        const size_t    sample_count);
+
+    // Set the instance number.
+    void set_instance(const size_t instance);
+
+    // Return the next sample in [0,1].
+    double next_double1();
+
+    // Return the next sample in [0,1).
+    double next_double2();
+
+    // Return the next sample in [0,1]^N.
+    void next_vector1(const size_t n, double v[]);
+    template <size_t N> Vector<double, N> next_vector1();
+
+    // Return the next sample in [0,1)^N.
+    void next_vector2(const size_t n, double v[]);
+    template <size_t N> Vector<double, N> next_vector2();
+
+    // Return the total dimension of this sampler.
+    size_t get_total_dimension() const;
+
+    // Return the total instance number of this sampler.
+    size_t get_total_instance() const;
+
+  private:
+    GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, InitialStateIsCorrect);
+    GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, TestAssignmentOperator);
+    GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, TestSplitting);
+    GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_SobolSamplingContext, TestDoubleSplitting);
+
+    enum { MaxDimension = 4 };
+
+    RNG&        m_rng;
+
+    size_t      m_base_dimension;
+    size_t      m_base_instance;
+
+    size_t      m_dimension;
+    size_t      m_sample_count;
+
+    size_t      m_instance;
+
+    uint32      m_pixel_seed;                       // scrambling key of the trajectory
+    uint32      m_scrambling[MaxDimension];         // one scrambling seed per dimension
+    uint32      m_shuffling[MaxDimension / 2];      // one index shuffling seed per pair of dimensions
+
+    SobolSamplingContext(
+        RNG&            rng,
+        const uint32    pixel_seed,
+        const size_t    base_dimension,
+        const size_t    base_instance,
+        const size_t    dimension,
+        const size_t    sample_count);
+
+    void compute_seeds();
+
+    double sample(
+        const size_t    d,
+        const uint32    index) const;
+};
+
+
+//
+// SobolSamplingContext class implementation.
+//
+
+template <typename RNG, bool OwenScrambling>
+inline SobolSamplingContext<RNG, OwenScrambling>::SobolSamplingContext(RNG& rng)
+  : m_rng(rng)
+  , m_base_dimension(0)
+  , m_base_instance(0)
+  , m_dimension(0)
+  , m_sample_count(0)
+  , m_instance(0)
+  , m_pixel_seed(0)
+{
+    compute_seeds();
+}
+
+template <typename RNG, bool OwenScrambling>
+inline SobolSamplingContext<RNG, OwenScrambling>::SobolSamplingContext(
+    RNG&                rng,
+    const size_t        dimension,
+    const size_t        sample_count,
+    const size_t        instance)
+  : m_rng(rng)
+  , m_base_dimension(0)
+  , m_base_instance(0)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(instance)
+  , m_pixel_seed(hash_uint64_to_uint32(static_cast<uint64>(instance)))
+{
+    assert(dimension <= MaxDimension);
+
+    compute_seeds();
+}
+
+template <typename RNG, bool OwenScrambling>
+inline SobolSamplingContext<RNG, OwenScrambling>::SobolSamplingContext(
+    RNG&                rng,
+    const uint32        pixel_seed,
+    const size_t        base_dimension,
+    const size_t        base_instance,
+    const size_t        dimension,
+    const size_t        sample_count)
+  : m_rng(rng)
+  , m_base_dimension(base_dimension)
+  , m_base_instance(base_instance)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(0)
+  , m_pixel_seed(pixel_seed)
+{
+    assert(dimension <= MaxDimension);
+
+    compute_seeds();
+}
+
+template <typename RNG, bool OwenScrambling> inline
+SobolSamplingContext<RNG, OwenScrambling>&
+SobolSamplingContext<RNG, OwenScrambling>::operator=(const SobolSamplingContext& rhs)
+{
+    m_base_dimension = rhs.m_base_dimension;
+    m_base_instance = rhs.m_base_instance;
+    m_dimension = rhs.m_dimension;
+    m_sample_count = rhs.m_sample_count;
+    m_instance = rhs.m_instance;
+    m_pixel_seed = rhs.m_pixel_seed;
+
+    for (size_t i = 0; i < MaxDimension; ++i)
+        m_scrambling[i] = rhs.m_scrambling[i];
+
+    for (size_t i = 0; i < MaxDimension / 2; ++i)
+        m_shuffling[i] = rhs.m_shuffling[i];
+
+    return *this;
+}
+
+template <typename RNG, bool OwenScrambling>
+inline SobolSamplingContext<RNG, OwenScrambling> SobolSamplingContext<RNG, OwenScrambling>::split(
+    const size_t    dimension,
+    const size_t    sample_count) const
+{
+    return
+        SobolSamplingContext(
+            m_rng,
+            m_pixel_seed,
+            m_base_dimension + m_dimension,         // dimension allocation
+            m_base_instance + m_instance,           // decorrelation by generalization
+            dimension,
+            sample_count);
+}
+
+template <typename RNG, bool OwenScrambling>
+inline void SobolSamplingContext<RNG, OwenScrambling>::split_in_place(
+    const size_t    dimension,
+    const size_t    sample_count)
+{
+    assert(m_sample_count == 0 || m_instance == m_sample_count);    // can't split in the middle of a sequence
+    assert(dimension <= MaxDimension);
+
+    m_base_dimension += m_dimension;                // dimension allocation
+    m_base_instance += m_instance;                  // decorrelation by generalization
+    m_dimension = dimension;
+    m_sample_count = sample_count;
+    m_instance = 0;
+
+    compute_seeds();
+}
+
+template <typename RNG, bool OwenScrambling>
+inline void SobolSamplingContext<RNG, OwenScrambling>::compute_seeds()
+{
+    // The seeds only depend on the pixel and on the position of the context in the
+    // trajectory, which keeps sampling deterministic and independent of the RNG state.
+    const uint32 trajectory =
+        mix_uint32(
+            m_pixel_seed,
+            hash_uint64_to_uint32(static_cast<uint64>(m_base_instance)));
+
+    for (size_t i = 0; i < MaxDimension; ++i)
+    {
+        m_scrambling[i] =
+            hash_uint32(
+                mix_uint32(
+                    static_cast<uint32>(m_base_dimension + i),
+                    trajectory));
+    }
+
+    for (size_t i = 0; i < MaxDimension / 2; ++i)
+    {
+        m_shuffling[i] =
+            hash_uint32_alt(
+                mix_uint32(
+                    static_cast<uint32>(m_base_dimension + 2 * i),
+                    trajectory,
+                    0x9E3779B9UL));
+    }
+}
+
+template <typename RNG, bool OwenScrambling>
+inline void SobolSamplingContext<RNG, OwenScrambling>::set_instance(const size_t instance)
+{
+    m_instance = instance;
+}
+
+template <typename RNG, bool OwenScrambling>
+inline double SobolSamplingContext<RNG, OwenScrambling>::next_double1()
+{
+    return next_vector1<1>()[0];
+}
+
+template <typename RNG, bool OwenScrambling>
+inline double SobolSamplingContext<RNG, OwenScrambling>::next_double2()
+{
+    return next_vector2<1>()[0];
+}
+
+template <typename RNG, bool OwenScrambling>
+inline void SobolSamplingContext<RNG, OwenScrambling>::next_vector1(const size_t n, double v[])
+{
+    // Samples in [0,1) are also in [0,1].
+    next_vector2(n, v);
+}
+
+template <typename RNG, bool OwenScrambling>
+template <size_t N>
+inline Vector<double, N> SobolSamplingContext<RNG, OwenScrambling>::next_vector1()
+{
+    Vector<double, N> v;
+
+    next_vector1(N, &v[0]);
+
+    return v;
+}
+
+template <typename RNG, bool OwenScrambling>
+inline void SobolSamplingContext<RNG, OwenScrambling>::next_vector2(const size_t n, double v[])
+{
+    assert(m_sample_count == 0 || m_instance < m_sample_count);
+    assert(n == m_dimension);
+    assert(n <= MaxDimension);
+
+    const uint32 instance = static_cast<uint32>(m_instance);
+
+    for (size_t i = 0; i < n; i += 2)
+    {
+        // Each pair of dimensions is a (0,2)-sequence of its own, with shuffled indices.
+        const uint32 index = owen_scramble_uint32(m_shuffling[i / 2], instance);
+
+        v[i] = sample(i, index);
+
+        if (i + 1 < n)
+            v[i + 1] = sample(i + 1, index);
+    }
+
+    ++m_instance;
+}
+
+template <typename RNG, bool OwenScrambling>
+template <size_t N>
+inline Vector<double, N> SobolSamplingContext<RNG, OwenScrambling>::next_vector2()
+{
+    Vector<double, N> v;
+
+    next_vector2(N, &v[0]);
+
+    return v;
+}
+
+template <typename RNG, bool OwenScrambling>
+inline double SobolSamplingContext<RNG, OwenScrambling>::sample(
+    const size_t    d,
+    const uint32    index) const
+{
+    if (OwenScrambling)
+    {
+        return
+            (d & 1) == 0
+                ? owen_scrambled_radical_inverse_base2<double>(m_scrambling[d], index)
+                : owen_scrambled_sobol2<double>(m_scrambling[d], index);
+    }
+    else
+    {
+        return
+            (d & 1) == 0
+                ? radical_inverse_base2<double>(m_scrambling[d], index)
+                : sobol2<double>(m_scrambling[d], index);
+    }
+}
+
+template <typename RNG, bool OwenScrambling>
+inline size_t SobolSamplingContext<RNG, OwenScrambling>::get_total_dimension() const
+{
+    return m_base_dimension + m_dimension;
+}
+
+template <typename RNG, bool OwenScrambling>
+inline size_t SobolSamplingContext<RNG, OwenScrambling>::get_total_instance() const
+{
+    return m_base_instance + m_instance;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
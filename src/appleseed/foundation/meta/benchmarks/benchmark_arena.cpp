@@ -0,0 +1,90 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// appleseed.foundation headers.
+#include "foundation/utility/arena.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+BENCHMARK_SUITE(Foundation_Utility_Arena)
+{
+    using namespace foundation;
+    using namespace std;
+
+    // Number of temporaries allocated per simulated sample.
+    const size_t N = 16;
+
+    // Size of each temporary, in number of doubles.
+    const size_t Size = 32;
+
+    struct Fixture
+    {
+        Arena   m_arena;
+        double  m_dummy;
+
+        Fixture()
+          : m_dummy(0.0)
+        {
+        }
+    };
+
+    BENCHMARK_CASE_F(AllocateTemporaries_Heap, Fixture)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            double* values = new double[Size];
+            values[0] = static_cast<double>(i);
+            m_dummy += values[0];
+            delete [] values;
+        }
+    }
+
+    BENCHMARK_CASE_F(AllocateTemporaries_Vector, Fixture)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            vector<double> values(Size);
+            values[0] = static_cast<double>(i);
+            m_dummy += values[0];
+        }
+    }
+
+    BENCHMARK_CASE_F(AllocateTemporaries_Arena, Fixture)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            double* values = m_arena.allocate_array<double>(Size);
+            values[0] = static_cast<double>(i);
+            m_dummy += values[0];
+        }
+
+        m_arena.clear();
+    }
+}
@@ -0,0 +1,65 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// appleseed.foundation headers.
+#include "foundation/image/filteredtile.h"
+#include "foundation/math/filter.h"
+#include "foundation/utility/benchmark.h"
+
+using namespace foundation;
+
+BENCHMARK_SUITE(Foundation_Image_FilteredTile)
+{
+    struct Fixture
+    {
+        GaussianFilter2<double>     m_filter;
+        FilteredTile                m_tile;
+
+        Fixture()
+          : m_filter(2.0, 2.0, 8.0)
+          , m_tile(32, 32, 4, m_filter)
+        {
+            m_tile.clear();
+        }
+    };
+
+    BENCHMARK_CASE_F(Add_GaussianFilter, Fixture)
+    {
+        const float values[4] = { 0.1f, 0.2f, 0.3f, 1.0f };
+
+        for (size_t y = 0; y < 32; ++y)
+        {
+            for (size_t x = 0; x < 32; ++x)
+            {
+                m_tile.add(
+                    static_cast<double>(x) + 0.3,
+                    static_cast<double>(y) + 0.7,
+                    values);
+            }
+        }
+    }
+}
@@ -279,3 +279,81 @@ BENCHMARK_SUITE(Foundation_Math_Knn_Query)
     BENCHMARK_CASE_F(PhotonMap_K100, PhotonMapFixture<100>)  { run_queries(); }
     BENCHMARK_CASE_F(PhotonMap_K500, PhotonMapFixture<500>)  { run_queries(); }
 }
+
+BENCHMARK_SUITE(Foundation_Math_Knn_FixedRadiusQuery)
+{
+    const size_t PointCount = 100000;
+    const size_t QueryCount = 1000;
+    const size_t AnswerSize = 100;
+    const float QueryRadius = 0.03f;
+
+    struct Fixture
+    {
+        vector<Vector3f>    m_points;
+        vector<Vector3f>    m_query_points;
+        knn::Tree3f         m_tree;
+        knn::HashGrid3f     m_grid;
+        knn::Answer<float>  m_answer;
+        size_t              m_accumulator;
+
+        Fixture()
+          : m_answer(AnswerSize)
+          , m_accumulator(0)
+        {
+            MersenneTwister rng;
+
+            m_points.reserve(PointCount);
+            for (size_t i = 0; i < PointCount; ++i)
+                m_points.push_back(Vector3f(rand_float1(rng), rand_float1(rng), rand_float1(rng)));
+
+            m_query_points.reserve(QueryCount);
+            for (size_t i = 0; i < QueryCount; ++i)
+                m_query_points.push_back(Vector3f(rand_float1(rng), rand_float1(rng), rand_float1(rng)));
+
+            knn::Builder3f tree_builder(m_tree);
+            tree_builder.build<DefaultWallclockTimer>(&m_points[0], m_points.size());
+
+            vector<Vector3f> grid_points(m_points);
+            knn::HashGridBuilder3f grid_builder(m_grid);
+            grid_builder.build_move_points<DefaultWallclockTimer>(grid_points, 2.0f * QueryRadius);
+        }
+
+        template <typename Query, typename Structure>
+        void run_queries(const Structure& structure)
+        {
+            const Query query(structure, m_answer);
+
+            for (size_t i = 0; i < QueryCount; ++i)
+            {
+                query.run(m_query_points[i], QueryRadius * QueryRadius);
+                m_accumulator += m_answer.size();
+            }
+        }
+    };
+
+    BENCHMARK_CASE_F(BuildTree, Fixture)
+    {
+        vector<Vector3f> points(m_points);
+        knn::Tree3f tree;
+        knn::Builder3f builder(tree);
+        builder.build_move_points<DefaultWallclockTimer>(points);
+    }
+
+    BENCHMARK_CASE_F(BuildHashGrid, Fixture)
+    {
+        vector<Vector3f> points(m_points);
+        knn::HashGrid3f grid;
+        knn::HashGridBuilder3f builder(grid);
+        builder.build_move_points<DefaultWallclockTimer>(points, 2.0f * QueryRadius);
+    }
+
+    BENCHMARK_CASE_F(QueryTree, Fixture)
+    {
+        run_queries<knn::Query3f>(m_tree);
+    }
+
+    BENCHMARK_CASE_F(QueryHashGrid, Fixture)
+    {
+        run_queries<knn::HashGridQuery3f>(m_grid);
+    }
+}
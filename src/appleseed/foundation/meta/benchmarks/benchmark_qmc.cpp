@@ -32,6 +32,7 @@
 #include "foundation/math/primes.h"
 #include "foundation/math/qmc.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/benchmark.h"
 
 // Standard headers.
@@ -54,6 +55,22 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
                 m_x += radical_inverse_base2<T>(i);
         }
 
+        void sobol2_payload()
+        {
+            m_x = T(0.0);
+
+            for (uint32 i = 0; i < 128; ++i)
+                m_x += sobol2<T>(i);
+        }
+
+        void owen_scrambled_sobol2_payload()
+        {
+            m_x = T(0.0);
+
+            for (uint32 i = 0; i < 128; ++i)
+                m_x += owen_scrambled_sobol2<T>(0x12345678UL, i);
+        }
+
         void radical_inverse_payload()
         {
             m_x = T(0.0);
@@ -136,6 +153,28 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
                 m_x += halton_sequence<T, 2>(Bases, i);
         }
 
+        void sobol_payload()
+        {
+            m_x = Vector<T, 2>(0.0f);
+
+            for (uint32 i = 0; i < 64; ++i)
+            {
+                m_x[0] += radical_inverse_base2<T>(i);
+                m_x[1] += sobol2<T>(i);
+            }
+        }
+
+        void owen_scrambled_sobol_payload()
+        {
+            m_x = Vector<T, 2>(0.0f);
+
+            for (uint32 i = 0; i < 64; ++i)
+            {
+                m_x[0] += owen_scrambled_radical_inverse_base2<T>(0x12345678UL, i);
+                m_x[1] += owen_scrambled_sobol2<T>(0x9ABCDEF0UL, i);
+            }
+        }
+
         void hammersley_payload()
         {
             static const size_t Bases[] = { 2 };
@@ -154,6 +193,16 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
         radical_inverse_base2_payload();
     }
 
+    BENCHMARK_CASE_F(Sobol2_SinglePrecision, ScalarFixture<float>)
+    {
+        sobol2_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobol2_SinglePrecision, ScalarFixture<float>)
+    {
+        owen_scrambled_sobol2_payload();
+    }
+
     BENCHMARK_CASE_F(RadicalInverse_SinglePrecision, ScalarFixture<float>)
     {
         radical_inverse_payload();
@@ -181,6 +230,16 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
         radical_inverse_base2_payload();
     }
 
+    BENCHMARK_CASE_F(Sobol2_DoublePrecision, ScalarFixture<double>)
+    {
+        sobol2_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobol2_DoublePrecision, ScalarFixture<double>)
+    {
+        owen_scrambled_sobol2_payload();
+    }
+
     BENCHMARK_CASE_F(RadicalInverse_DoublePrecision, ScalarFixture<double>)
     {
         radical_inverse_payload();
@@ -213,6 +272,28 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
         halton_payload();
     }
 
+    // Sobol (0,2)-sequence.
+
+    BENCHMARK_CASE_F(SobolSequence_SinglePrecision, Vector2Fixture<float>)
+    {
+        sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(SobolSequence_DoublePrecision, Vector2Fixture<double>)
+    {
+        sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_SinglePrecision, Vector2Fixture<float>)
+    {
+        owen_scrambled_sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_DoublePrecision, Vector2Fixture<double>)
+    {
+        owen_scrambled_sobol_payload();
+    }
+
     // Hammersley sequence.
 
     BENCHMARK_CASE_F(HammersleySequence_Base2_SinglePrecision, Vector2Fixture<float>)
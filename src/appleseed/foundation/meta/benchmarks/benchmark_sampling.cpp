@@ -69,6 +69,35 @@ BENCHMARK_SUITE(Foundation_Math_Sampling_QMCSamplingContext)
     }
 }
 
+BENCHMARK_SUITE(Foundation_Math_Sampling_SobolSamplingContext)
+{
+    struct Fixture
+    {
+        typedef MersenneTwister RNG;
+        typedef SobolSamplingContext<RNG> SobolSamplingContextType;
+
+        RNG         m_rng;
+        Vector2d    m_v;
+
+        Fixture()
+          : m_v(0.0)
+        {
+        }
+    };
+
+    BENCHMARK_CASE_F(BenchmarkTrajectory, Fixture)
+    {
+        const size_t InitialInstance = 1234567;
+        SobolSamplingContextType context(m_rng, 1, InitialInstance, InitialInstance);
+
+        for (size_t i = 0; i < 32; ++i)
+        {
+            context.split_in_place(2, 1);
+            m_v += context.next_vector2<2>();
+        }
+    }
+}
+
 BENCHMARK_SUITE(Foundation_Math_Sampling_Mappings)
 {
     const size_t SampleCount = 16;
@@ -0,0 +1,133 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// appleseed.foundation headers.
+#include "foundation/utility/arena.h"
+#include "foundation/utility/memory.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Utility_Arena)
+{
+    TEST_CASE(Allocate_ReturnsAlignedMemory)
+    {
+        Arena arena(1024);
+
+        void* p1 = arena.allocate(1);
+        void* p2 = arena.allocate(3);
+
+        EXPECT_TRUE(is_aligned(p1, Arena::Alignment));
+        EXPECT_TRUE(is_aligned(p2, Arena::Alignment));
+        EXPECT_NEQ(p1, p2);
+    }
+
+    TEST_CASE(Allocate_GivenSmallBlocks_ServesThemFromArena)
+    {
+        Arena arena(1024);
+
+        arena.allocate(10);
+        arena.allocate(20);
+
+        EXPECT_EQ(48, arena.get_size());
+        EXPECT_EQ(0, arena.get_overflow_count());
+    }
+
+    TEST_CASE(Allocate_GivenBlockLargerThanRemainingSpace_ServesItFromHeap)
+    {
+        Arena arena(64);
+
+        arena.allocate(48);
+        void* p = arena.allocate(32);
+
+        EXPECT_TRUE(is_aligned(p, Arena::Alignment));
+        EXPECT_EQ(48, arena.get_size());
+        EXPECT_EQ(1, arena.get_overflow_count());
+    }
+
+    TEST_CASE(GetHeapAllocationCount_IsNotResetByClear)
+    {
+        Arena arena(64);
+
+        arena.allocate(128);
+        arena.clear();
+        arena.allocate(128);
+
+        EXPECT_EQ(1, arena.get_overflow_count());
+        EXPECT_EQ(2, arena.get_heap_allocation_count());
+    }
+
+    TEST_CASE(Clear_ReleasesAllAllocations)
+    {
+        Arena arena(64);
+
+        void* p1 = arena.allocate(48);
+        arena.allocate(32);
+        arena.clear();
+
+        EXPECT_EQ(0, arena.get_size());
+        EXPECT_EQ(0, arena.get_overflow_count());
+
+        void* p2 = arena.allocate(48);
+
+        EXPECT_EQ(p1, p2);
+    }
+
+    TEST_CASE(Release_ReleasesAllocationsMadeSinceMarker)
+    {
+        Arena arena(64);
+
+        arena.allocate(16);
+        const Arena::Marker marker = arena.get_marker();
+        void* p1 = arena.allocate(16);
+        arena.allocate(64);
+        arena.release(marker);
+
+        EXPECT_EQ(16, arena.get_size());
+        EXPECT_EQ(0, arena.get_overflow_count());
+
+        void* p2 = arena.allocate(16);
+
+        EXPECT_EQ(p1, p2);
+    }
+
+    TEST_CASE(AllocateArray_ReturnsWritableArray)
+    {
+        Arena arena(1024);
+
+        double* values = arena.allocate_array<double>(10);
+
+        for (size_t i = 0; i < 10; ++i)
+            values[i] = static_cast<double>(i);
+
+        EXPECT_EQ(9.0, values[9]);
+        EXPECT_EQ(80, arena.get_size());
+    }
+}
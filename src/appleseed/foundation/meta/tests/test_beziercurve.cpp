@@ -0,0 +1,108 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/beziercurve.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Math_BezierCurve3)
+{
+    TEST_CASE(FromLinear_EvaluatesToStraightSegment)
+    {
+        const BezierCurve3d curve =
+            BezierCurve3d::from_linear(
+                Vector3d(0.0, 0.0, 0.0),
+                Vector3d(4.0, 2.0, 0.0),
+                1.0,
+                3.0);
+
+        EXPECT_FEQ(Vector3d(1.0, 0.5, 0.0), curve.evaluate_point(0.25));
+        EXPECT_FEQ(Vector3d(4.0, 2.0, 0.0), curve.evaluate_tangent(0.25));
+        EXPECT_FEQ(1.5, curve.evaluate_width(0.25));
+    }
+
+    TEST_CASE(FromBSpline_ConsecutiveSegmentsJoinContinuously)
+    {
+        const Vector3d Points[5] =
+        {
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 2.0, 0.0),
+            Vector3d(2.0, -1.0, 1.0),
+            Vector3d(3.0, 0.0, 2.0),
+            Vector3d(4.0, 1.0, 0.0)
+        };
+        const double Widths[5] = { 0.1, 0.2, 0.3, 0.2, 0.1 };
+
+        const BezierCurve3d curve1 = BezierCurve3d::from_bspline(&Points[0], &Widths[0]);
+        const BezierCurve3d curve2 = BezierCurve3d::from_bspline(&Points[1], &Widths[1]);
+
+        EXPECT_FEQ(curve1.evaluate_point(1.0), curve2.evaluate_point(0.0));
+        EXPECT_FEQ(curve1.evaluate_tangent(1.0), curve2.evaluate_tangent(0.0));
+        EXPECT_FEQ(curve1.evaluate_width(1.0), curve2.evaluate_width(0.0));
+    }
+
+    TEST_CASE(Split_HalvesMatchOriginalCurve)
+    {
+        const Vector3d Points[4] =
+        {
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 2.0, 0.0),
+            Vector3d(2.0, -1.0, 1.0),
+            Vector3d(3.0, 0.0, 2.0)
+        };
+        const double Widths[4] = { 0.1, 0.2, 0.3, 0.4 };
+        const BezierCurve3d curve(Points, Widths);
+
+        BezierCurve3d left, right;
+        curve.split(left, right);
+
+        EXPECT_FEQ(curve.evaluate_point(0.25), left.evaluate_point(0.5));
+        EXPECT_FEQ(curve.evaluate_point(0.75), right.evaluate_point(0.5));
+        EXPECT_FEQ(curve.evaluate_width(0.75), right.evaluate_width(0.5));
+    }
+
+    TEST_CASE(ComputeBBox_EnclosesCurveEnlargedByHalfWidth)
+    {
+        const BezierCurve3d curve =
+            BezierCurve3d::from_linear(
+                Vector3d(0.0, 0.0, 0.0),
+                Vector3d(1.0, 0.0, 0.0),
+                0.2,
+                0.4);
+
+        const AABB3d bbox = curve.compute_bbox();
+
+        EXPECT_FEQ(AABB3d(Vector3d(-0.2, -0.2, -0.2), Vector3d(1.2, 0.2, 0.2)), bbox);
+    }
+}
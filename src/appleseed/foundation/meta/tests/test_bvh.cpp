@@ -149,3 +149,111 @@ TEST_SUITE(Foundation_Math_BVH_Intersector_2D)
         > intersector;
     }
 }
+
+TEST_SUITE(Foundation_Math_BVH_TemporalBuilder)
+{
+    typedef bvh::Node<AABB3d> NodeType;
+    typedef bvh::Tree<AlignedVector<NodeType> > Tree;
+    typedef bvh::TemporalBuilder<Tree> TemporalBuilder;
+    typedef TemporalBuilder::SubtreeType Subtree;
+
+    // Build subtrees made of a single item whose position depends on the time interval.
+    struct SubtreeBuilder
+    {
+        size_t build(
+            Subtree&                    subtree,
+            const double                time_begin,
+            const double                time_end,
+            AABB3d&                     bbox)
+        {
+            vector<AABB3d> bboxes;
+            bboxes.push_back(AABB3d(Vector3d(4.0 * time_begin, 0.0, 0.0), Vector3d(4.0 * time_end, 1.0, 1.0)));
+
+            typedef bvh::SAHPartitioner<vector<AABB3d> > Partitioner;
+            Partitioner partitioner(bboxes);
+
+            bvh::Builder<Subtree, Partitioner> builder;
+            builder.build<DefaultWallclockTimer>(subtree, partitioner, bboxes.size(), 1);
+
+            bbox = bboxes[0];
+
+            return bboxes.size();
+        }
+    };
+
+    struct Visitor
+    {
+        size_t m_item_index;
+
+        Visitor()
+          : m_item_index(~0)
+        {
+        }
+
+        bool visit(
+            const NodeType&             node,
+            const Ray3d&                ray,
+            const RayInfo3d&            ray_info,
+            double&                     distance
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+            , bvh::TraversalStatistics& stats
+#endif
+            )
+        {
+            m_item_index = node.get_item_index();
+            return false;
+        }
+    };
+
+    size_t find_item(const Tree& tree, const double time)
+    {
+        const Ray3d ray(Vector3d(-1.0, 0.5, 0.5), Vector3d(1.0, 0.0, 0.0));
+        const RayInfo3d ray_info(ray);
+
+        Visitor visitor;
+        bvh::Intersector<Tree, Visitor, Ray3d> intersector;
+
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+        bvh::TraversalStatistics stats;
+        intersector.intersect_motion(tree, ray, ray_info, time, visitor, stats);
+#else
+        intersector.intersect_motion(tree, ray, ray_info, time, visitor);
+#endif
+
+        return visitor.m_item_index;
+    }
+
+    TEST_CASE(TemporalInteriorNode_IsInteriorNode)
+    {
+        NodeType node;
+        node.make_temporal_interior();
+
+        EXPECT_TRUE(node.is_temporal_interior());
+        EXPECT_TRUE(node.is_interior());
+        EXPECT_FALSE(node.is_leaf());
+    }
+
+    TEST_CASE(InteriorNode_IsNotTemporalInteriorNode)
+    {
+        NodeType node;
+        node.make_interior();
+
+        EXPECT_FALSE(node.is_temporal_interior());
+        EXPECT_TRUE(node.is_interior());
+    }
+
+    TEST_CASE(IntersectMotion_VisitsSubtreeOfRayTimeInterval)
+    {
+        Tree tree;
+        SubtreeBuilder subtree_builder;
+        TemporalBuilder builder;
+        builder.build<DefaultWallclockTimer>(tree, subtree_builder, 2);
+
+        EXPECT_EQ(0, find_item(tree, 0.0));
+        EXPECT_EQ(0, find_item(tree, 0.2));
+        EXPECT_EQ(1, find_item(tree, 0.3));
+        EXPECT_EQ(2, find_item(tree, 0.6));
+        EXPECT_EQ(3, find_item(tree, 0.9));
+        EXPECT_EQ(3, find_item(tree, 1.0));
+    }
+}
@@ -111,6 +111,21 @@ TEST_SUITE(Foundation_Image_ColorSpace)
             1.0e-5);
     }
 
+#ifdef APPLESEED_USE_SSE
+
+    TEST_CASE(TestLinearRGBToCIEXYZConversion_SSE)
+    {
+        SSE_ALIGN float transfer[4] = { 0.44452747f, 0.83687690f, 0.09645611f, 1.0f };
+        _mm_store_ps(transfer, linear_rgb_to_ciexyz(_mm_load_ps(transfer)));
+
+        EXPECT_FEQ_EPS(
+            Color3f(0.5f, 0.7f, 0.2f),
+            Color3f(transfer[0], transfer[1], transfer[2]),
+            1.0e-5f);
+    }
+
+#endif
+
     TEST_CASE(TestCIEXYZToCIExyYConversion)
     {
         const Color3d ciexyz(0.5, 0.7, 0.2);
@@ -30,9 +30,11 @@
 // appleseed.foundation headers.
 #include "foundation/image/filteredtile.h"
 #include "foundation/math/filter.h"
+#include "foundation/math/scalar.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
 
@@ -101,4 +103,46 @@ TEST_SUITE(Foundation_Image_FilteredTile)
         const BoxFilter2<double> filter(2.0, 2.0);
         test("unit tests/outputs/test_filteredtile_boxfilter_radius2dot0.txt", filter);
     }
+
+    template <typename Filter>
+    bool weights_match_filter(const Filter& filter)
+    {
+        FilteredTile tile(8, 8, 1, filter);
+        tile.clear();
+
+        const double x = 4.3, y = 3.8;
+        const float values[1] = { 1.0f };
+        tile.add(x, y, values);
+
+        for (size_t py = 0; py < tile.get_height(); ++py)
+        {
+            for (size_t px = 0; px < tile.get_width(); ++px)
+            {
+                const double fx = px - (x - 0.5);
+                const double fy = py - (y - 0.5);
+
+                const double expected =
+                    std::abs(fx) <= filter.get_xradius() && std::abs(fy) <= filter.get_yradius()
+                        ? filter.evaluate(fx, fy)
+                        : 0.0;
+
+                if (!feq(expected, static_cast<double>(tile.pixel(px, py)[0]), 1.0e-3))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(Add_GaussianFilter_WeightsMatchFilter)
+    {
+        const GaussianFilter2<double> filter(2.0, 1.5, 8.0);
+        EXPECT_TRUE(weights_match_filter(filter));
+    }
+
+    TEST_CASE(Add_MitchellFilter_WeightsMatchFilter)
+    {
+        const MitchellFilter2<double> filter(2.0, 2.0, 1.0 / 3, 1.0 / 3);
+        EXPECT_TRUE(weights_match_filter(filter));
+    }
 }
@@ -29,6 +29,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/aabb.h"
+#include "foundation/math/beziercurve.h"
 #include "foundation/math/intersection.h"
 #include "foundation/math/ray.h"
 #include "foundation/math/vector.h"
@@ -552,3 +553,75 @@ TEST_SUITE(Foundation_Math_Intersection_RayTriangleSSK)
         EXPECT_FEQ(0.5, v);
     }
 }
+
+TEST_SUITE(Foundation_Math_Intersection_RayCurve)
+{
+    struct Fixture
+    {
+        BezierCurve3d m_curve;
+
+        Fixture()
+          : m_curve(
+                BezierCurve3d::from_linear(
+                    Vector3d(-1.0, 0.0, 0.0),
+                    Vector3d(1.0, 0.0, 0.0),
+                    0.2,
+                    0.2))
+        {
+        }
+    };
+
+    TEST_CASE_F(Intersect_GivenRayPiercingTheRibbon_ReturnsHit, Fixture)
+    {
+        const Ray3d ray(Vector3d(0.5, 0.05, 2.0), Vector3d(0.0, 0.0, -1.0));
+
+        double t, u, v;
+        const bool hit = intersect(ray, m_curve, t, u, v);
+
+        ASSERT_TRUE(hit);
+        EXPECT_FEQ(2.0, t);
+        EXPECT_FEQ(0.75, u);
+        EXPECT_FEQ(0.25, v);
+    }
+
+    TEST_CASE_F(Intersect_GivenRayPassingBesideTheRibbon_ReturnsFalse, Fixture)
+    {
+        const Ray3d ray(Vector3d(0.5, 0.2, 2.0), Vector3d(0.0, 0.0, -1.0));
+
+        const bool hit = intersect(ray, m_curve);
+
+        EXPECT_FALSE(hit);
+    }
+
+    TEST_CASE_F(Intersect_GivenRayWithTMaxEqualToHitDistance_ReturnsFalse, Fixture)
+    {
+        const Ray3d ray(Vector3d(0.5, 0.0, 2.0), Vector3d(0.0, 0.0, -1.0), 0.0, 2.0);
+
+        const bool hit = intersect(ray, m_curve);
+
+        EXPECT_FALSE(hit);
+    }
+
+    TEST_CASE(Intersect_GivenRayAimedAtPointOfCubicCurve_ReturnsHitAtThisPoint)
+    {
+        const Vector3d Points[4] =
+        {
+            Vector3d(-1.0, 0.0, 0.0),
+            Vector3d(-0.5, 1.0, 0.0),
+            Vector3d(0.5, -1.0, 0.5),
+            Vector3d(1.0, 0.0, 0.0)
+        };
+        const double Widths[4] = { 0.01, 0.01, 0.01, 0.01 };
+        const BezierCurve3d curve(Points, Widths);
+        const Vector3d target = curve.evaluate_point(0.3);
+        const Ray3d ray(target + Vector3d(0.0, 0.0, 2.0), Vector3d(0.0, 0.0, -1.0));
+
+        double t, u, v;
+        const bool hit = intersect(ray, curve, t, u, v);
+
+        ASSERT_TRUE(hit);
+        EXPECT_FEQ_EPS(2.0, t, 1.0e-3);
+        EXPECT_FEQ_EPS(0.3, u, 1.0e-2);
+        EXPECT_FEQ_EPS(0.5, v, 1.0e-1);
+    }
+}
@@ -53,7 +53,9 @@
 #include "sfcnn.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 using namespace foundation;
@@ -398,4 +400,128 @@ TEST_SUITE(Foundation_Math_Knn_Query)
     }
 }
 
+TEST_SUITE(Foundation_Math_Knn_HashGrid)
+{
+    TEST_CASE(Empty_GivenDefaultConstructedGrid_ReturnsTrue)
+    {
+        knn::HashGrid3d grid;
+
+        EXPECT_TRUE(grid.empty());
+    }
+
+    TEST_CASE(Build_GivenZeroPoint_BuildsEmptyGrid)
+    {
+        vector<Vector3d> points;
+
+        knn::HashGrid3d grid;
+        knn::HashGridBuilder3d builder(grid);
+        builder.build_move_points<DefaultWallclockTimer>(points, 1.0);
+
+        EXPECT_TRUE(grid.empty());
+    }
+
+    TEST_CASE(Build_GivenThreePoints_MovesPointsIntoGrid)
+    {
+        const Vector3d Points[] =
+        {
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 2.0, 3.0),
+            Vector3d(-4.0, 0.5, 0.5)
+        };
+
+        vector<Vector3d> points(Points, Points + 3);
+
+        knn::HashGrid3d grid;
+        knn::HashGridBuilder3d builder(grid);
+        builder.build_move_points<DefaultWallclockTimer>(points, 1.0);
+
+        EXPECT_TRUE(points.empty());
+
+        for (size_t i = 0; i < 3; ++i)
+            EXPECT_EQ(Points[grid.remap(i)], grid.get_point(i));
+    }
+
+    size_t count_mismatches_against_brute_force(
+        const vector<Vector3d>& points,
+        const double            cell_size,
+        const double            query_radius,
+        const size_t            answer_size)
+    {
+        vector<Vector3d> grid_points(points);
+        knn::HashGrid3d grid;
+        knn::HashGridBuilder3d builder(grid);
+        builder.build_move_points<DefaultWallclockTimer>(grid_points, cell_size);
+
+        knn::Answer<double> answer(answer_size);
+        knn::HashGridQuery3d query(grid, answer);
+
+        MersenneTwister rng(42);
+        size_t mismatch_count = 0;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const Vector3d q(rand_double1(rng), rand_double1(rng), rand_double1(rng));
+
+            query.run(q, square(query_radius));
+            answer.sort();
+
+            // Find the expected neighbors by brute force.
+            vector<pair<double, size_t> > expected;
+            for (size_t j = 0; j < points.size(); ++j)
+            {
+                const double d = square_distance(points[j], q);
+                if (d <= square(query_radius))
+                    expected.push_back(make_pair(d, j));
+            }
+            sort(expected.begin(), expected.end());
+            expected.resize(min(expected.size(), answer_size));
+
+            if (answer.size() != expected.size())
+            {
+                ++mismatch_count;
+                continue;
+            }
+
+            for (size_t j = 0; j < expected.size(); ++j)
+            {
+                if (grid.remap(answer.get(j).m_index) != expected[j].second)
+                {
+                    ++mismatch_count;
+                    break;
+                }
+            }
+        }
+
+        return mismatch_count;
+    }
+
+    struct Fixture
+    {
+        vector<Vector3d> m_points;
+
+        Fixture()
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < 1000; ++i)
+                m_points.push_back(Vector3d(rand_double1(rng), rand_double1(rng), rand_double1(rng)));
+        }
+    };
+
+    TEST_CASE_F(Run_GivenCellSizeTwiceQueryRadius_ReturnsNearestNeighbors, Fixture)
+    {
+        EXPECT_EQ(0, count_mismatches_against_brute_force(m_points, 0.2, 0.1, 100));
+    }
+
+    TEST_CASE_F(Run_GivenSmallAnswerSize_ReturnsNearestNeighbors, Fixture)
+    {
+        EXPECT_EQ(0, count_mismatches_against_brute_force(m_points, 0.3, 0.15, 5));
+    }
+
+    TEST_CASE_F(Run_GivenCellSizeSmallerThanQueryRadius_ReturnsNearestNeighbors, Fixture)
+    {
+        EXPECT_EQ(0, count_mismatches_against_brute_force(m_points, 0.03, 0.1, 100));
+    }
+}
+
 #pragma warning (pop)
@@ -0,0 +1,131 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// appleseed.foundation headers.
+#include "foundation/utility/memorytracker.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Utility_MemoryTracker)
+{
+    TEST_CASE(RecordAllocation_GivenDisabledTracker_DoesNotRecordAllocation)
+    {
+        MemoryTracker tracker;
+
+        tracker.record_allocation("tag", 100);
+
+        EXPECT_EQ(0, tracker.get_current_size());
+    }
+
+    TEST_CASE(RecordAllocation_GivenEnabledTracker_UpdatesCurrentAndPeakSizes)
+    {
+        MemoryTracker tracker;
+        tracker.set_enabled();
+
+        tracker.record_allocation("tag1", 100);
+        tracker.record_allocation("tag2", 50);
+        tracker.record_deallocation("tag1", 100);
+
+        EXPECT_EQ(50, tracker.get_current_size());
+        EXPECT_EQ(150, tracker.get_peak_size());
+        EXPECT_EQ(0, tracker.get_current_size("tag1"));
+        EXPECT_EQ(100, tracker.get_peak_size("tag1"));
+        EXPECT_EQ(50, tracker.get_current_size("tag2"));
+    }
+
+    TEST_CASE(RecordDeallocation_GivenBlockAllocatedBeforeTrackingWasEnabled_KeepsSizesPositive)
+    {
+        MemoryTracker tracker;
+        tracker.set_enabled();
+
+        tracker.record_deallocation("tag", 100);
+
+        EXPECT_EQ(0, tracker.get_current_size());
+        EXPECT_EQ(0, tracker.get_current_size("tag"));
+    }
+
+    TEST_CASE(BeginFrame_ResetsFrameAllocationCountsButNotSizes)
+    {
+        MemoryTracker tracker;
+        tracker.set_enabled();
+
+        tracker.record_allocation("tag", 100);
+        tracker.begin_frame();
+        tracker.record_allocation("tag", 50);
+
+        EXPECT_EQ(1, tracker.get_frame_allocation_count("tag"));
+        EXPECT_EQ(150, tracker.get_current_size("tag"));
+    }
+
+    TEST_CASE(GetStatistics_ReturnsOneEntryPerTagPlusTotal)
+    {
+        MemoryTracker tracker;
+        tracker.set_enabled();
+
+        tracker.record_allocation("tag1", 100);
+        tracker.record_allocation("tag2", 50);
+
+        const string summary = tracker.get_statistics().to_string();
+
+        EXPECT_NEQ(string::npos, summary.find("memory used by tag1"));
+        EXPECT_NEQ(string::npos, summary.find("memory used by tag2"));
+        EXPECT_NEQ(string::npos, summary.find("total memory used"));
+    }
+
+    TEST_CASE(TrackedMemorySize_GivenEnabledTracker_TracksSizeUntilDestruction)
+    {
+        MemoryTracker tracker;
+        tracker.set_enabled();
+
+        {
+            TrackedMemorySize tracked(tracker, "tag");
+            tracked.set(100);
+            tracked.set(300);
+
+            EXPECT_EQ(300, tracker.get_current_size("tag"));
+            EXPECT_EQ(300, tracker.get_peak_size("tag"));
+        }
+
+        EXPECT_EQ(0, tracker.get_current_size("tag"));
+    }
+
+    TEST_CASE(TrackedMemorySize_GivenDisabledTracker_DoesNotRecordAnything)
+    {
+        MemoryTracker tracker;
+
+        TrackedMemorySize tracked(tracker, "tag");
+        tracker.set_enabled();
+        tracked.set(100);
+
+        EXPECT_EQ(0, tracker.get_current_size());
+    }
+}
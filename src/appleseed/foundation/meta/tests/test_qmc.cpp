@@ -32,12 +32,14 @@
 #include "foundation/image/color.h"
 #include "foundation/image/genericimagefilewriter.h"
 #include "foundation/image/image.h"
+#include "foundation/math/hash.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/primes.h"
 #include "foundation/math/qmc.h"
 #include "foundation/math/rng.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/maplefile.h"
 #include "foundation/utility/string.h"
@@ -119,6 +121,111 @@ TEST_SUITE(Foundation_Math_QMC)
         EXPECT_FEQ(7.0 / 9, permuted_radical_inverse<double>(3, Perm, 7));
     }
 
+    TEST_CASE(Sobol2)
+    {
+        EXPECT_FEQ(0.0,     sobol2<double>(0));
+        EXPECT_FEQ(0.5,     sobol2<double>(1));
+        EXPECT_FEQ(0.75,    sobol2<double>(2));
+        EXPECT_FEQ(0.25,    sobol2<double>(3));
+        EXPECT_FEQ(0.625,   sobol2<double>(4));
+        EXPECT_FEQ(0.125,   sobol2<double>(5));
+        EXPECT_FEQ(0.375,   sobol2<double>(6));
+        EXPECT_FEQ(0.875,   sobol2<double>(7));
+    }
+
+    TEST_CASE(ReverseBits)
+    {
+        EXPECT_EQ(0x80000000UL, reverse_bits(1));
+        EXPECT_EQ(0x00000001UL, reverse_bits(0x80000000UL));
+        EXPECT_EQ(0x0F0F0F0FUL, reverse_bits(0xF0F0F0F0UL));
+    }
+
+    // Return true if the 2^m points are a (0,m,2)-net in base 2, i.e. if every elementary
+    // interval of area 2^-m contains exactly one point.
+    bool is_02_net(const vector<Vector2d>& points, const size_t m)
+    {
+        const size_t n = points.size();
+        assert(n == size_t(1) << m);
+
+        for (size_t a = 0; a <= m; ++a)
+        {
+            const size_t nx = size_t(1) << a;
+            const size_t ny = size_t(1) << (m - a);
+
+            vector<size_t> counts(n, 0);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const size_t x = static_cast<size_t>(points[i].x * nx);
+                const size_t y = static_cast<size_t>(points[i].y * ny);
+
+                if (x >= nx || y >= ny || ++counts[y * nx + x] > 1)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(Sobol02Sequence_First256Points_FormA02Net)
+    {
+        vector<Vector2d> points;
+
+        for (uint32 i = 0; i < 256; ++i)
+            points.push_back(Vector2d(radical_inverse_base2<double>(i), sobol2<double>(i)));
+
+        EXPECT_TRUE(is_02_net(points, 8));
+    }
+
+    TEST_CASE(Sobol02Sequence_SecondBatchOf256Points_FormA02Net)
+    {
+        vector<Vector2d> points;
+
+        for (uint32 i = 256; i < 512; ++i)
+            points.push_back(Vector2d(radical_inverse_base2<double>(i), sobol2<double>(i)));
+
+        EXPECT_TRUE(is_02_net(points, 8));
+    }
+
+    TEST_CASE(OwenScrambledSobol02Sequence_First256Points_FormA02Net)
+    {
+        MersenneTwister rng;
+
+        for (size_t s = 0; s < 16; ++s)
+        {
+            const uint32 seed_x = rng.rand_uint32();
+            const uint32 seed_y = rng.rand_uint32();
+
+            vector<Vector2d> points;
+
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                points.push_back(
+                    Vector2d(
+                        owen_scrambled_radical_inverse_base2<double>(seed_x, i),
+                        owen_scrambled_sobol2<double>(seed_y, i)));
+            }
+
+            EXPECT_TRUE(is_02_net(points, 8));
+        }
+    }
+
+    TEST_CASE(OwenScrambleUInt32_MapsAlignedBlockOfIndicesToAlignedBlock)
+    {
+        const uint32 Seed = 0x12345678UL;
+        const uint32 Block = owen_scramble_uint32(Seed, 0) >> 6;
+
+        vector<bool> seen(64, false);
+
+        for (uint32 i = 0; i < 64; ++i)
+        {
+            const uint32 j = owen_scramble_uint32(Seed, i);
+            EXPECT_EQ(Block, j >> 6);
+            EXPECT_FALSE(seen[j & 63]);
+            seen[j & 63] = true;
+        }
+    }
+
     static const size_t PointCount = 256;
 
     TEST_CASE(Generate2DRandomSequenceImage)
@@ -225,6 +332,39 @@ TEST_SUITE(Foundation_Math_QMC)
             points);
     }
 
+    void generate_sobol_sequence_image(
+        const bool      owen_scrambling,
+        const uint32    seed = 0)
+    {
+        vector<Vector2d> points;
+
+        for (uint32 i = 0; i < PointCount; ++i)
+        {
+            points.push_back(
+                owen_scrambling
+                    ? Vector2d(
+                          owen_scrambled_radical_inverse_base2<double>(seed, i),
+                          owen_scrambled_sobol2<double>(hash_uint32(seed), i))
+                    : Vector2d(
+                          radical_inverse_base2<double>(i),
+                          sobol2<double>(i)));
+        }
+
+        const string filename =
+            owen_scrambling
+                ? "unit tests/outputs/test_qmc_sobol_owen_scrambled_" + to_string(seed) + ".png"
+                : "unit tests/outputs/test_qmc_sobol.png";
+
+        write_point_cloud_image(filename, points);
+    }
+
+    TEST_CASE(Generate2DSobolSequenceImages)
+    {
+        generate_sobol_sequence_image(false);
+        generate_sobol_sequence_image(true, 1);
+        generate_sobol_sequence_image(true, 2);
+    }
+
     TEST_CASE(Generate2DHammersleySequenceImages)
     {
         generate_hammersley_sequence_image(2, "identity");
@@ -169,6 +169,163 @@ TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext_DirectIlluminationSimulat
     }
 }
 
+TEST_SUITE(Foundation_Math_Sampling_SobolSamplingContext)
+{
+    typedef MersenneTwister RNG;
+    typedef SobolSamplingContext<RNG> SamplingContext;
+
+    TEST_CASE(InitialStateIsCorrect)
+    {
+        RNG rng;
+        SamplingContext context(rng, 2, 64, 7);
+
+        EXPECT_EQ(0, context.m_base_dimension);
+        EXPECT_EQ(0, context.m_base_instance);
+        EXPECT_EQ(2, context.m_dimension);
+        EXPECT_EQ(7, context.m_instance);
+    }
+
+    TEST_CASE(TestAssignmentOperator)
+    {
+        RNG rng;
+        SamplingContext original_parent(rng, 2, 64, 7);
+        SamplingContext original = original_parent.split(3, 16);
+        original.set_instance(6);
+
+        SamplingContext copy(rng, 4, 16, 9);
+        copy = original;
+
+        EXPECT_EQ(2, copy.m_base_dimension);
+        EXPECT_EQ(7, copy.m_base_instance);
+        EXPECT_EQ(3, copy.m_dimension);
+        EXPECT_EQ(6, copy.m_instance);
+        EXPECT_EQ(original.next_vector2<3>(), copy.next_vector2<3>());
+    }
+
+    TEST_CASE(TestSplitting)
+    {
+        RNG rng;
+        SamplingContext context(rng, 2, 64, 7);
+        SamplingContext child_context = context.split(3, 16);
+
+        EXPECT_EQ(2, child_context.m_base_dimension);
+        EXPECT_EQ(7, child_context.m_base_instance);
+        EXPECT_EQ(3, child_context.m_dimension);
+        EXPECT_EQ(0, child_context.m_instance);
+    }
+
+    TEST_CASE(TestDoubleSplitting)
+    {
+        RNG rng;
+        SamplingContext context(rng, 2, 64, 7);
+        SamplingContext child_context = context.split(3, 16);
+        SamplingContext child_child_context = child_context.split(4, 8);
+
+        EXPECT_EQ(5, child_child_context.m_base_dimension);
+        EXPECT_EQ(7, child_child_context.m_base_instance);
+        EXPECT_EQ(4, child_child_context.m_dimension);
+        EXPECT_EQ(0, child_child_context.m_instance);
+    }
+
+    TEST_CASE(NextVector2_GivenRootContextsOfDifferentPixels_ScramblesDimensionsDifferently)
+    {
+        RNG rng;
+        SamplingContext context1(rng, 2, 0, 1234);
+        SamplingContext context2(rng, 2, 0, 5678);
+        context1.set_instance(0);
+        context2.set_instance(0);
+
+        EXPECT_NEQ(context1.next_vector2<2>(), context2.next_vector2<2>());
+    }
+
+    TEST_CASE(NextVector2_ReturnsSamplesInUnitHypercube)
+    {
+        RNG rng;
+        SamplingContext context(rng, 4, 0, 12345);
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const Vector4d v = context.next_vector2<4>();
+
+            for (size_t d = 0; d < 4; ++d)
+            {
+                EXPECT_TRUE(v[d] >= 0.0);
+                EXPECT_TRUE(v[d] < 1.0);
+            }
+        }
+    }
+
+    // Integrate exp(-(x^2 + y^2)) over [0,1)^2 in a number of "pixels" using a given
+    // pair of dimensions of a child sampling context, and return the RMS error.
+    template <typename SamplingContextType>
+    double compute_integration_rms_error(
+        const size_t    sample_count,
+        const size_t    first_dimension)
+    {
+        const double Exact = 0.5577462853510335;
+        const size_t PixelCount = 64;
+
+        RNG rng;
+        double squared_error = 0.0;
+
+        for (size_t p = 0; p < PixelCount; ++p)
+        {
+            SamplingContextType pixel_context(rng, 2, 0, p * 7919 + 13);
+            pixel_context.template next_vector2<2>();
+
+            SamplingContextType context = pixel_context.split(4, sample_count);
+
+            double sum = 0.0;
+
+            for (size_t i = 0; i < sample_count; ++i)
+            {
+                const Vector4d v = context.template next_vector2<4>();
+                const double x = v[first_dimension];
+                const double y = v[first_dimension + 1];
+                sum += exp(-(x * x + y * y));
+            }
+
+            const double error = sum / sample_count - Exact;
+            squared_error += error * error;
+        }
+
+        return sqrt(squared_error / PixelCount);
+    }
+
+    TEST_CASE(Integrate2DFunction_ConvergesFasterThanRandomSampling)
+    {
+        const double rng_error = compute_integration_rms_error<RNGSamplingContext<RNG> >(256, 0);
+        const double sobol_error = compute_integration_rms_error<SamplingContext>(256, 0);
+
+        EXPECT_LT(rng_error / 10.0, sobol_error);
+    }
+
+    TEST_CASE(Integrate2DFunction_PaddedDimensionsConvergeFasterThanRandomSampling)
+    {
+        const double rng_error = compute_integration_rms_error<RNGSamplingContext<RNG> >(256, 2);
+        const double sobol_error = compute_integration_rms_error<SamplingContext>(256, 2);
+
+        EXPECT_LT(rng_error / 10.0, sobol_error);
+    }
+
+    TEST_CASE(Integrate2DFunction_ConvergesFasterThanQMCSamplingContext)
+    {
+        const double qmc_error = compute_integration_rms_error<QMCSamplingContext<RNG> >(256, 0);
+        const double sobol_error = compute_integration_rms_error<SamplingContext>(256, 0);
+
+        EXPECT_LT(qmc_error, sobol_error);
+    }
+
+    TEST_CASE(Integrate2DFunction_ErrorDecreasesWithSampleCount)
+    {
+        const double error_64 = compute_integration_rms_error<SamplingContext>(64, 0);
+        const double error_1024 = compute_integration_rms_error<SamplingContext>(1024, 0);
+
+        // Random sampling would only divide the error by 4.
+        EXPECT_LT(error_64 / 16.0, error_1024);
+    }
+}
+
 TEST_SUITE(Foundation_Math_Sampling_Mappings)
 {
     TEST_CASE(SampleHemisphereUniform_GivenZeroZero_ReturnsSampleWithYComponentGreaterThanZero)
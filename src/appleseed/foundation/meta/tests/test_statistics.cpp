@@ -28,6 +28,7 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/math/fp.h"
 #include "foundation/math/population.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/statistics.h"
@@ -185,6 +186,38 @@ TEST_SUITE(Foundation_Utility_Statistics)
 
         EXPECT_EQ("  existing value   17,042", stats.to_string());
     }
+
+    TEST_CASE(ToJSON_GivenEmptyStatistics)
+    {
+        Statistics stats;
+
+        EXPECT_EQ("{}", stats.to_json());
+    }
+
+    TEST_CASE(ToJSON_GivenMultipleStatistics)
+    {
+        Statistics stats;
+
+        stats.insert<uint64>("first value", 17000);
+        stats.insert("second value", 42.5);
+        stats.insert<string>("third value", "bunny");
+
+        EXPECT_EQ(
+            "{ \"first value\": 17000, \"second value\": 42.5, \"third value\": \"bunny\" }",
+            stats.to_json());
+    }
+
+    TEST_CASE(ToJSON_GivenNonFiniteFloatingPointStatistics_WritesNull)
+    {
+        Statistics stats;
+
+        stats.insert("infinite value", FP<double>::pos_inf());
+        stats.insert("nan value", FP<double>::qnan());
+
+        EXPECT_EQ(
+            "{ \"infinite value\": null, \"nan value\": null }",
+            stats.to_json());
+    }
 }
 
 TEST_SUITE(Foundation_Utility_StatisticsVector)
@@ -203,4 +236,21 @@ TEST_SUITE(Foundation_Utility_StatisticsVector)
 
         EXPECT_EQ("stats 1:\n  counter 1        17\nstats 2:\n  counter 2        42", vec.to_string());
     }
+
+    TEST_CASE(ToJSON_GivenTwoItems)
+    {
+        Statistics stats1;
+        stats1.insert<uint64>("counter 1", 17);
+
+        Statistics stats2;
+        stats2.insert<uint64>("counter 2", 42);
+
+        StatisticsVector vec;
+        vec.insert("stats 1", stats1);
+        vec.insert("stats 2", stats2);
+
+        EXPECT_EQ(
+            "{\n  \"stats 1\": { \"counter 1\": 17 },\n  \"stats 2\": { \"counter 2\": 42 }\n}",
+            vec.to_json());
+    }
 }
@@ -591,6 +591,20 @@ TEST_SUITE(Foundation_Utility_String)
         EXPECT_EQ("aa&amp;amp;bb", result);
     }
 
+    TEST_CASE(QuoteJSONString_GivenEmptyString_ReturnsEmptyStringLiteral)
+    {
+        const string result = quote_json_string("");
+
+        EXPECT_EQ("\"\"", result);
+    }
+
+    TEST_CASE(QuoteJSONString_GivenStringWithSpecialCharacters_EscapesThem)
+    {
+        const string result = quote_json_string("a\"b\\c\nd\x01");
+
+        EXPECT_EQ("\"a\\\"b\\\\c\\nd\\u0001\"", result);
+    }
+
     bool fast_strtod_ok(const char* str)
     {
         const double ref = strtod(str, 0);
@@ -0,0 +1,90 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+#include "foundation/utility/traceeventrecorder.h"
+
+// Standard headers.
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Utility_TraceEventRecorder)
+{
+    TEST_CASE(TraceScope_GivenDisabledRecorder_DoesNotRecordEvent)
+    {
+        TraceEventRecorder recorder;
+
+        {
+            TraceScope scope(recorder, "event", "test");
+        }
+
+        EXPECT_EQ(0, recorder.get_event_count());
+    }
+
+    TEST_CASE(TraceScope_GivenEnabledRecorder_RecordsEventOnce)
+    {
+        TraceEventRecorder recorder;
+        recorder.set_enabled();
+
+        {
+            TraceScope scope(recorder, "event", "test");
+            scope.end();
+        }
+
+        EXPECT_EQ(1, recorder.get_event_count());
+    }
+
+    TEST_CASE(Clear_RemovesAllEvents)
+    {
+        TraceEventRecorder recorder;
+        recorder.set_enabled();
+        recorder.record("event", "test", recorder.read_time(), recorder.read_time());
+
+        recorder.clear();
+
+        EXPECT_EQ(0, recorder.get_event_count());
+    }
+
+    TEST_CASE(WriteChromeTrace_WritesCompleteEvent)
+    {
+        TraceEventRecorder recorder;
+        recorder.set_enabled();
+        recorder.record("event", "test", recorder.read_time(), recorder.read_time());
+
+        stringstream sstr;
+        recorder.write_chrome_trace(sstr);
+        const string trace = sstr.str();
+
+        EXPECT_TRUE(trace.find("\"name\": \"event\", \"cat\": \"test\", \"ph\": \"X\"") != string::npos);
+    }
+}
@@ -33,6 +33,7 @@
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/casts.h"
 
 // appleseed.main headers.
 #include "main/dllsymbol.h"
@@ -206,6 +207,9 @@ DLLSYMBOL void sleep(const uint32 ms);
 // Give up the remainder of the current thread's time slice, to allow other threads to run.
 DLLSYMBOL void yield();
 
+// Atomically add a value to a single precision floating-point variable.
+void atomic_add(volatile float* ptr, const float operand);
+
 
 //
 // Spinlock class implementation.
@@ -238,6 +242,26 @@ inline Spinlock::ScopedLock::ScopedLock(Spinlock& spinlock)
 {
 }
 
+
+//
+// Utility free functions implementation.
+//
+
+inline void atomic_add(volatile float* ptr, const float operand)
+{
+    volatile uint32* iptr = reinterpret_cast<volatile uint32*>(ptr);
+
+    // Retry until no other thread modified the variable between our read and our write.
+    while (true)
+    {
+        const uint32 expected = *iptr;
+        const uint32 desired = binary_cast<uint32>(binary_cast<float>(expected) + operand);
+
+        if (boost_atomic::atomic_cas32(iptr, desired, expected) == expected)
+            break;
+    }
+}
+
 }       // namespace foundation
 
 #endif  // !APPLESEED_FOUNDATION_PLATFORM_THREAD_H
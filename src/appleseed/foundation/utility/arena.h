@@ -0,0 +1,216 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#ifndef APPLESEED_FOUNDATION_UTILITY_ARENA_H
+#define APPLESEED_FOUNDATION_UTILITY_ARENA_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/memory.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace foundation
+{
+
+//
+// A per-thread arena allocator for short-lived temporaries.
+//
+// Allocations are carved out of a single memory block by bumping a pointer
+// and are all released at once by clear(). Requests that don't fit in the
+// block are served from the heap; they are counted so that callers can size
+// the arena appropriately, and are released by clear() as well.
+//
+// Allocations can also be released in LIFO order by saving a marker with
+// get_marker() and later passing it to release().
+//
+// This class is not thread-safe.
+//
+
+class Arena
+  : public NonCopyable
+{
+  public:
+    // Alignment of all allocations, in bytes.
+    enum { Alignment = 16 };
+
+    // State of the arena at a given point in time.
+    struct Marker
+    {
+        size_t  m_size;
+        size_t  m_overflow_count;
+    };
+
+    // Constructor.
+    explicit Arena(const size_t capacity = 64 * 1024);
+
+    // Destructor.
+    ~Arena();
+
+    // Allocate a block of memory. The returned memory is uninitialized.
+    void* allocate(const size_t size);
+
+    // Allocate memory for an array of objects. The objects are not constructed.
+    template <typename T>
+    T* allocate_array(const size_t count);
+
+    // Release all allocations at once.
+    void clear();
+
+    // Return the current state of the arena.
+    Marker get_marker() const;
+
+    // Release all allocations made since a given marker was obtained.
+    void release(const Marker& marker);
+
+    // Return the size in bytes of the arena's memory block.
+    size_t get_capacity() const;
+
+    // Return the number of bytes allocated from the arena's memory block since the last call to clear().
+    size_t get_size() const;
+
+    // Return the number of allocations served from the heap since the last call to clear().
+    size_t get_overflow_count() const;
+
+    // Return the number of allocations served from the heap since the arena was constructed.
+    uint64 get_heap_allocation_count() const;
+
+  private:
+    uint8* const        m_base;
+    const size_t        m_capacity;
+    size_t              m_size;
+    std::vector<void*>  m_overflow;
+    uint64              m_heap_allocation_count;
+
+    void* allocate_overflow(const size_t size);
+};
+
+
+//
+// Arena class implementation.
+//
+
+inline Arena::Arena(const size_t capacity)
+  : m_base(static_cast<uint8*>(aligned_malloc(capacity, Alignment)))
+  , m_capacity(capacity)
+  , m_size(0)
+  , m_heap_allocation_count(0)
+{
+}
+
+inline Arena::~Arena()
+{
+    clear();
+    aligned_free(m_base);
+}
+
+inline void* Arena::allocate(const size_t size)
+{
+    const size_t aligned_size = align(size, Alignment);
+
+    if (m_size + aligned_size > m_capacity)
+        return allocate_overflow(aligned_size);
+
+    void* ptr = m_base + m_size;
+    m_size += aligned_size;
+
+    assert(is_aligned(ptr, Alignment));
+    return ptr;
+}
+
+template <typename T>
+inline T* Arena::allocate_array(const size_t count)
+{
+    return static_cast<T*>(allocate(count * sizeof(T)));
+}
+
+inline void Arena::clear()
+{
+    m_size = 0;
+
+    for (size_t i = 0; i < m_overflow.size(); ++i)
+        aligned_free(m_overflow[i]);
+
+    m_overflow.clear();
+}
+
+inline Arena::Marker Arena::get_marker() const
+{
+    Marker marker;
+    marker.m_size = m_size;
+    marker.m_overflow_count = m_overflow.size();
+    return marker;
+}
+
+inline void Arena::release(const Marker& marker)
+{
+    assert(marker.m_size <= m_size);
+    assert(marker.m_overflow_count <= m_overflow.size());
+
+    m_size = marker.m_size;
+
+    for (size_t i = marker.m_overflow_count; i < m_overflow.size(); ++i)
+        aligned_free(m_overflow[i]);
+
+    m_overflow.resize(marker.m_overflow_count);
+}
+
+inline size_t Arena::get_capacity() const
+{
+    return m_capacity;
+}
+
+inline size_t Arena::get_size() const
+{
+    return m_size;
+}
+
+inline size_t Arena::get_overflow_count() const
+{
+    return m_overflow.size();
+}
+
+inline uint64 Arena::get_heap_allocation_count() const
+{
+    return m_heap_allocation_count;
+}
+
+inline void* Arena::allocate_overflow(const size_t size)
+{
+    void* ptr = aligned_malloc(size, Alignment);
+    m_overflow.push_back(ptr);
+    ++m_heap_allocation_count;
+    return ptr;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_ARENA_H
@@ -1097,6 +1097,7 @@ namespace cache_impl
         virtual std::auto_ptr<Entry> clone() const OVERRIDE;
         virtual void merge(const Entry* other) OVERRIDE;
         virtual std::string to_string() const OVERRIDE;
+        virtual std::string to_json() const OVERRIDE;
     };
 }
 
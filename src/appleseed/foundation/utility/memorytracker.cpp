@@ -0,0 +1,241 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Interface header.
+#include "memorytracker.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/foreach.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace foundation
+{
+
+//
+// MemoryTracker class implementation.
+//
+
+namespace
+{
+    struct TagRecord
+    {
+        const char*     m_tag;
+        uint64          m_allocation_count;
+        uint64          m_deallocation_count;
+        uint64          m_frame_allocation_count;
+        uint64          m_frame_deallocation_count;
+        uint64          m_current_size;
+        uint64          m_peak_size;
+
+        explicit TagRecord(const char* tag)
+          : m_tag(tag)
+          , m_allocation_count(0)
+          , m_deallocation_count(0)
+          , m_frame_allocation_count(0)
+          , m_frame_deallocation_count(0)
+          , m_current_size(0)
+          , m_peak_size(0)
+        {
+        }
+    };
+}
+
+struct MemoryTracker::Impl
+{
+    typedef vector<TagRecord> TagRecordVector;
+
+    mutable boost::mutex    m_mutex;
+    TagRecordVector         m_records;
+    uint64                  m_current_size;
+    uint64                  m_peak_size;
+
+    Impl()
+      : m_current_size(0)
+      , m_peak_size(0)
+    {
+    }
+
+    // Tags are compared by value since the same literal may have different
+    // addresses in different translation units.
+    const TagRecord* find_record(const char* tag) const
+    {
+        for (const_each<TagRecordVector> i = m_records; i; ++i)
+        {
+            if (strcmp(i->m_tag, tag) == 0)
+                return &*i;
+        }
+
+        return 0;
+    }
+
+    TagRecord& get_record(const char* tag)
+    {
+        TagRecord* record = const_cast<TagRecord*>(find_record(tag));
+
+        if (record)
+            return *record;
+
+        m_records.push_back(TagRecord(tag));
+        return m_records.back();
+    }
+};
+
+MemoryTracker::MemoryTracker()
+  : impl(new Impl())
+{
+    set_enabled(false);
+}
+
+MemoryTracker::~MemoryTracker()
+{
+    delete impl;
+}
+
+void MemoryTracker::clear()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    impl->m_records.clear();
+    impl->m_current_size = 0;
+    impl->m_peak_size = 0;
+}
+
+void MemoryTracker::begin_frame()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    for (each<Impl::TagRecordVector> i = impl->m_records; i; ++i)
+    {
+        i->m_frame_allocation_count = 0;
+        i->m_frame_deallocation_count = 0;
+    }
+}
+
+void MemoryTracker::record_allocation(const char* tag, const size_t size)
+{
+    if (!is_enabled())
+        return;
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    TagRecord& record = impl->get_record(tag);
+    ++record.m_allocation_count;
+    ++record.m_frame_allocation_count;
+    record.m_current_size += size;
+    record.m_peak_size = max(record.m_peak_size, record.m_current_size);
+
+    impl->m_current_size += size;
+    impl->m_peak_size = max(impl->m_peak_size, impl->m_current_size);
+}
+
+void MemoryTracker::record_deallocation(const char* tag, const size_t size)
+{
+    if (!is_enabled())
+        return;
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    TagRecord& record = impl->get_record(tag);
+    ++record.m_deallocation_count;
+    ++record.m_frame_deallocation_count;
+
+    // Tracking may have been enabled after the block was allocated.
+    const uint64 tag_size = min<uint64>(size, record.m_current_size);
+    record.m_current_size -= tag_size;
+
+    const uint64 total_size = min<uint64>(size, impl->m_current_size);
+    impl->m_current_size -= total_size;
+}
+
+uint64 MemoryTracker::get_current_size() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    return impl->m_current_size;
+}
+
+uint64 MemoryTracker::get_peak_size() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    return impl->m_peak_size;
+}
+
+uint64 MemoryTracker::get_current_size(const char* tag) const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    const TagRecord* record = impl->find_record(tag);
+    return record ? record->m_current_size : 0;
+}
+
+uint64 MemoryTracker::get_peak_size(const char* tag) const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    const TagRecord* record = impl->find_record(tag);
+    return record ? record->m_peak_size : 0;
+}
+
+uint64 MemoryTracker::get_frame_allocation_count(const char* tag) const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    const TagRecord* record = impl->find_record(tag);
+    return record ? record->m_frame_allocation_count : 0;
+}
+
+StatisticsVector MemoryTracker::get_statistics() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    StatisticsVector stats;
+
+    for (const_each<Impl::TagRecordVector> i = impl->m_records; i; ++i)
+    {
+        Statistics tag_stats;
+        tag_stats.insert_size("current size", i->m_current_size);
+        tag_stats.insert_size("peak size", i->m_peak_size);
+        tag_stats.insert("allocations", i->m_allocation_count);
+        tag_stats.insert("deallocations", i->m_deallocation_count);
+        tag_stats.insert("allocations this frame", i->m_frame_allocation_count);
+        tag_stats.insert("deallocations this frame", i->m_frame_deallocation_count);
+        stats.insert(string("memory used by ") + i->m_tag, tag_stats);
+    }
+
+    Statistics total_stats;
+    total_stats.insert_size("current size", impl->m_current_size);
+    total_stats.insert_size("peak size", impl->m_peak_size);
+    stats.insert("total memory used", total_stats);
+
+    return stats;
+}
+
+}   // namespace foundation
@@ -0,0 +1,186 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#ifndef APPLESEED_FOUNDATION_UTILITY_MEMORYTRACKER_H
+#define APPLESEED_FOUNDATION_UTILITY_MEMORYTRACKER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/statistics.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// boost headers.
+#include "boost/cstdint.hpp"
+
+// Standard headers.
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// Keeps track of the memory used by the subsystems of an application (acceleration
+// structures, texture cache, photon maps, etc.). Each allocation and deallocation is
+// recorded against a tag identifying a subsystem; for each tag, the tracker counts
+// allocations and deallocations, in total and since the beginning of the current
+// frame, and maintains the current and peak memory sizes.
+//
+// Subsystems report their large, long-lived memory blocks, not individual heap
+// allocations. Recording takes a lock and should not be done on rendering hot paths.
+// Tags are not copied and must be string literals.
+//
+
+class DLLSYMBOL MemoryTracker
+  : public NonCopyable
+{
+  public:
+    // Constructor. Tracking is initially disabled.
+    MemoryTracker();
+
+    // Destructor.
+    ~MemoryTracker();
+
+    // Enable/disable tracking. This method is thread-safe.
+    void set_enabled(const bool enabled = true);
+    bool is_enabled() const;
+
+    // Forget everything that was recorded.
+    void clear();
+
+    // Reset the per-frame allocation and deallocation counts.
+    void begin_frame();
+
+    // Record the allocation or deallocation of a block of memory by a given subsystem.
+    void record_allocation(const char* tag, const size_t size);
+    void record_deallocation(const char* tag, const size_t size);
+
+    // Return the current and peak memory sizes over all subsystems.
+    uint64 get_current_size() const;
+    uint64 get_peak_size() const;
+
+    // Return the current and peak memory sizes of a given subsystem.
+    uint64 get_current_size(const char* tag) const;
+    uint64 get_peak_size(const char* tag) const;
+
+    // Return the number of allocations made by a given subsystem since the last call to begin_frame().
+    uint64 get_frame_allocation_count(const char* tag) const;
+
+    // Return a summary of the memory used by each subsystem, in the order in which
+    // subsystems were first seen. Memory still in use shows up as the current size.
+    StatisticsVector get_statistics() const;
+
+  private:
+    struct Impl;
+    Impl* impl;
+
+    mutable volatile boost::uint32_t m_enabled;
+};
+
+
+//
+// Tracks the size of a resizable block of memory owned by a subsystem, for instance a
+// photon map that is rebuilt at every pass. The tracked memory is deallocated when
+// this object is destructed. Nothing is recorded if tracking was disabled when the
+// object was constructed.
+//
+
+class TrackedMemorySize
+  : public NonCopyable
+{
+  public:
+    // Constructor. The initial size is zero.
+    TrackedMemorySize(
+        MemoryTracker&      tracker,
+        const char*         tag);
+
+    // Destructor.
+    ~TrackedMemorySize();
+
+    // Update the size of the tracked memory block.
+    void set(const size_t size);
+
+  private:
+    MemoryTracker*          m_tracker;
+    const char*             m_tag;
+    size_t                  m_size;
+};
+
+
+//
+// MemoryTracker class implementation.
+//
+
+inline void MemoryTracker::set_enabled(const bool enabled)
+{
+    boost_atomic::atomic_write32(&m_enabled, enabled ? 1 : 0);
+}
+
+inline bool MemoryTracker::is_enabled() const
+{
+    return boost_atomic::atomic_read32(&m_enabled) == 1;
+}
+
+
+//
+// TrackedMemorySize class implementation.
+//
+
+inline TrackedMemorySize::TrackedMemorySize(
+    MemoryTracker&          tracker,
+    const char*             tag)
+  : m_tracker(tracker.is_enabled() ? &tracker : 0)
+  , m_tag(tag)
+  , m_size(0)
+{
+}
+
+inline TrackedMemorySize::~TrackedMemorySize()
+{
+    set(0);
+}
+
+inline void TrackedMemorySize::set(const size_t size)
+{
+    if (m_tracker == 0 || size == m_size)
+        return;
+
+    if (m_size > 0)
+        m_tracker->record_deallocation(m_tag, m_size);
+
+    if (size > 0)
+        m_tracker->record_allocation(m_tag, size);
+
+    m_size = size;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_MEMORYTRACKER_H
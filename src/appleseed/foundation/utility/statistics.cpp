@@ -121,6 +121,28 @@ string Statistics::to_string(const size_t max_header_length) const
     return sstr.str();
 }
 
+string Statistics::to_json() const
+{
+    if (m_entries.empty())
+        return "{}";
+
+    stringstream sstr;
+    sstr << "{ ";
+
+    for (const_each<EntryVector> i = m_entries; i; ++i)
+    {
+        const Entry* entry = *i;
+
+        if (i.it() > m_entries.begin())
+            sstr << ", ";
+
+        sstr << quote_json_string(entry->m_name) << ": " << entry->to_json();
+    }
+
+    sstr << " }";
+    return sstr.str();
+}
+
 
 //
 // Statistics::ExceptionDuplicateName class implementation.
@@ -159,6 +181,11 @@ Statistics::Entry::Entry(
 {
 }
 
+string Statistics::Entry::to_json() const
+{
+    return quote_json_string(to_string());
+}
+
 
 //
 // Statistics::IntegerEntry class implementation.
@@ -188,6 +215,11 @@ string Statistics::IntegerEntry::to_string() const
     return pretty_int(m_value);
 }
 
+string Statistics::IntegerEntry::to_json() const
+{
+    return foundation::to_string(m_value);
+}
+
 
 //
 // Statistics::UnsignedIntegerEntry class implementation.
@@ -217,6 +249,11 @@ string Statistics::UnsignedIntegerEntry::to_string() const
     return pretty_uint(m_value);
 }
 
+string Statistics::UnsignedIntegerEntry::to_json() const
+{
+    return foundation::to_string(m_value);
+}
+
 
 //
 // Statistics::FloatingPointEntry class implementation.
@@ -246,6 +283,11 @@ string Statistics::FloatingPointEntry::to_string() const
     return pretty_scalar(m_value);
 }
 
+string Statistics::FloatingPointEntry::to_json() const
+{
+    return impl::to_json_number(m_value);
+}
+
 
 //
 // Statistics::StringEntry class implementation.
@@ -335,4 +377,21 @@ string StatisticsVector::to_string(const size_t max_header_length) const
     return sstr.str();
 }
 
+string StatisticsVector::to_json() const
+{
+    stringstream sstr;
+    sstr << "{" << endl;
+
+    for (const_each<NamedStatisticsVector> i = m_stats; i; ++i)
+    {
+        if (i.it() > m_stats.begin())
+            sstr << "," << endl;
+
+        sstr << "  " << quote_json_string(i->m_name) << ": " << i->m_stats.to_json();
+    }
+
+    sstr << endl << "}";
+    return sstr.str();
+}
+
 }   // namespace foundation
@@ -32,11 +32,15 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/exceptions/stringexception.h"
+#include "foundation/math/fp.h"
 #include "foundation/math/population.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/string.h"
 
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
 // Standard headers.
 #include <cassert>
 #include <cstddef>
@@ -55,7 +59,7 @@ namespace foundation
 // A named collection of statistics.
 //
 
-class Statistics
+class DLLSYMBOL Statistics
 {
   public:
     struct ExceptionDuplicateName
@@ -89,6 +93,10 @@ class Statistics
         virtual std::auto_ptr<Entry> clone() const = 0;
         virtual void merge(const Entry* other) = 0;
         virtual std::string to_string() const = 0;
+
+        // Return the value of this entry as a JSON value.
+        // The default implementation returns to_string() as a JSON string.
+        virtual std::string to_json() const;
     };
 
     struct IntegerEntry
@@ -104,6 +112,7 @@ class Statistics
         virtual std::auto_ptr<Entry> clone() const OVERRIDE;
         virtual void merge(const Entry* other) OVERRIDE;
         virtual std::string to_string() const OVERRIDE;
+        virtual std::string to_json() const OVERRIDE;
     };
 
     struct UnsignedIntegerEntry
@@ -119,6 +128,7 @@ class Statistics
         virtual std::auto_ptr<Entry> clone() const OVERRIDE;
         virtual void merge(const Entry* other) OVERRIDE;
         virtual std::string to_string() const OVERRIDE;
+        virtual std::string to_json() const OVERRIDE;
     };
 
     struct FloatingPointEntry
@@ -134,6 +144,7 @@ class Statistics
         virtual std::auto_ptr<Entry> clone() const OVERRIDE;
         virtual void merge(const Entry* other) OVERRIDE;
         virtual std::string to_string() const OVERRIDE;
+        virtual std::string to_json() const OVERRIDE;
     };
 
     struct StringEntry
@@ -165,6 +176,7 @@ class Statistics
         virtual std::auto_ptr<Entry> clone() const OVERRIDE;
         virtual void merge(const Entry* other) OVERRIDE;
         virtual std::string to_string() const OVERRIDE;
+        virtual std::string to_json() const OVERRIDE;
     };
 
     Statistics();
@@ -219,6 +231,9 @@ class Statistics
 
     std::string to_string(const size_t max_header_length = 16) const;
 
+    // Return the statistics as a JSON object.
+    std::string to_json() const;
+
   private:
     typedef std::vector<Entry*> EntryVector;
     typedef std::map<std::string, Entry*> EntryIndex;
@@ -235,7 +250,7 @@ class Statistics
 // A vector of foundation::Statistics objects.
 //
 
-class StatisticsVector
+class DLLSYMBOL StatisticsVector
 {
   public:
     static StatisticsVector make(
@@ -250,6 +265,9 @@ class StatisticsVector
 
     std::string to_string(const size_t max_header_length = 16) const;
 
+    // Return the statistics as a JSON object with one member per named collection.
+    std::string to_json() const;
+
   private:
     struct NamedStatistics
     {
@@ -269,6 +287,17 @@ class StatisticsVector
 // Statistics class implementation.
 //
 
+namespace impl
+{
+    // JSON has no representation for NaN and infinite values: write them as null.
+    template <typename T>
+    std::string to_json_number(const T value)
+    {
+        const double x = static_cast<double>(value);
+        return FP<double>::is_nan(x) || FP<double>::is_inf(x) ? "null" : to_string(value);
+    }
+}
+
 template <typename T>
 void Statistics::insert(std::auto_ptr<T> entry)
 {
@@ -452,6 +481,20 @@ std::string Statistics::PopulationEntry<T>::to_string() const
     return sstr.str();
 }
 
+template <typename T>
+std::string Statistics::PopulationEntry<T>::to_json() const
+{
+    std::stringstream sstr;
+
+    sstr << "{ \"avg\": " << impl::to_json_number(m_value.get_mean());
+    sstr << ", \"min\": " << impl::to_json_number(m_value.get_min());
+    sstr << ", \"max\": " << impl::to_json_number(m_value.get_max());
+    sstr << ", \"dev\": " << impl::to_json_number(m_value.get_dev());
+    sstr << " }";
+
+    return sstr.str();
+}
+
 }       // namespace foundation
 
 #endif  // !APPLESEED_FOUNDATION_UTILITY_STATISTICS_H
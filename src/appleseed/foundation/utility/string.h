@@ -195,6 +195,9 @@ std::string get_time_stamp_string();
 // Replace all special characters of a string by the corresponding XML entities.
 std::string replace_special_xml_characters(const std::string& s);
 
+// Return a double-quoted JSON string literal with the contents of a given string.
+std::string quote_json_string(const std::string& s);
+
 
 //
 // Fast alternative to std::strtol().
@@ -790,6 +793,42 @@ inline std::string replace_special_xml_characters(const std::string& s)
     return result;
 }
 
+inline std::string quote_json_string(const std::string& s)
+{
+    // Reference: http://www.json.org/
+
+    std::stringstream sstr;
+    sstr << '"';
+
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        const char c = s[i];
+
+        switch (c)
+        {
+          case '"':  sstr << "\\\""; break;
+          case '\\': sstr << "\\\\"; break;
+          case '\b': sstr << "\\b"; break;
+          case '\f': sstr << "\\f"; break;
+          case '\n': sstr << "\\n"; break;
+          case '\r': sstr << "\\r"; break;
+          case '\t': sstr << "\\t"; break;
+
+          default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                sstr << "\\u" << std::hex << std::setw(4) << std::setfill('0');
+                sstr << static_cast<int>(c) << std::dec;
+            }
+            else sstr << c;
+            break;
+        }
+    }
+
+    sstr << '"';
+    return sstr.str();
+}
+
 
 //
 // Fast string-to-number functions implementation.
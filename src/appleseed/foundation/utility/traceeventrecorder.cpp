@@ -0,0 +1,250 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "traceeventrecorder.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/foreach.h"
+#include "foundation/utility/string.h"
+
+// boost headers.
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/tss.hpp"
+
+// Standard headers.
+#include <fstream>
+#include <ios>
+#include <iomanip>
+#include <vector>
+
+using namespace std;
+
+namespace foundation
+{
+
+//
+// TraceEventRecorder class implementation.
+//
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char*     m_name;
+        const char*     m_category;
+        uint64          m_begin_time;
+        uint64          m_end_time;
+    };
+
+    struct ThreadBuffer
+    {
+        size_t              m_thread_index;
+        boost::mutex        m_mutex;            // protects m_events
+        vector<TraceEvent>  m_events;
+    };
+
+    void release_thread_buffer(ThreadBuffer*)
+    {
+        // Thread buffers are owned by the recorder and outlive their thread.
+    }
+}
+
+struct TraceEventRecorder::Impl
+{
+    typedef vector<ThreadBuffer*> ThreadBufferVector;
+
+    mutable DefaultWallclockTimer               m_timer;
+    double                                      m_rcp_timer_frequency_us;
+    uint64                                      m_origin_time;
+
+    boost::mutex                                m_mutex;            // protects m_thread_buffers
+    ThreadBufferVector                          m_thread_buffers;
+    boost::thread_specific_ptr<ThreadBuffer>    m_current_thread_buffer;
+
+    Impl()
+      : m_current_thread_buffer(&release_thread_buffer)
+    {
+        m_rcp_timer_frequency_us = 1.0e6 / m_timer.frequency();
+        m_origin_time = m_timer.read();
+    }
+
+    ~Impl()
+    {
+        for (const_each<ThreadBufferVector> i = m_thread_buffers; i; ++i)
+            delete *i;
+    }
+
+    ThreadBuffer& get_current_thread_buffer()
+    {
+        ThreadBuffer* buffer = m_current_thread_buffer.get();
+
+        if (buffer == 0)
+        {
+            buffer = new ThreadBuffer();
+
+            boost::mutex::scoped_lock lock(m_mutex);
+            buffer->m_thread_index = m_thread_buffers.size();
+            m_thread_buffers.push_back(buffer);
+            m_current_thread_buffer.reset(buffer);
+        }
+
+        return *buffer;
+    }
+
+    double to_microseconds(const uint64 time) const
+    {
+        return time > m_origin_time ? (time - m_origin_time) * m_rcp_timer_frequency_us : 0.0;
+    }
+};
+
+TraceEventRecorder::TraceEventRecorder()
+  : impl(new Impl())
+  , m_enabled(false)
+{
+}
+
+TraceEventRecorder::~TraceEventRecorder()
+{
+    delete impl;
+}
+
+void TraceEventRecorder::clear()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    for (const_each<Impl::ThreadBufferVector> i = impl->m_thread_buffers; i; ++i)
+    {
+        boost::mutex::scoped_lock buffer_lock((*i)->m_mutex);
+        (*i)->m_events.clear();
+    }
+
+    impl->m_origin_time = impl->m_timer.read();
+}
+
+uint64 TraceEventRecorder::read_time() const
+{
+    return impl->m_timer.read();
+}
+
+void TraceEventRecorder::record(
+    const char*     name,
+    const char*     category,
+    const uint64    begin_time,
+    const uint64    end_time)
+{
+    TraceEvent event;
+    event.m_name = name;
+    event.m_category = category;
+    event.m_begin_time = begin_time;
+    event.m_end_time = end_time;
+
+    ThreadBuffer& buffer = impl->get_current_thread_buffer();
+
+    boost::mutex::scoped_lock lock(buffer.m_mutex);
+    buffer.m_events.push_back(event);
+}
+
+size_t TraceEventRecorder::get_event_count() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    size_t count = 0;
+
+    for (const_each<Impl::ThreadBufferVector> i = impl->m_thread_buffers; i; ++i)
+    {
+        boost::mutex::scoped_lock buffer_lock((*i)->m_mutex);
+        count += (*i)->m_events.size();
+    }
+
+    return count;
+}
+
+void TraceEventRecorder::write_chrome_trace(ostream& output) const
+{
+    //
+    // Reference:
+    //
+    //   Trace Event Format
+    //   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    //
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    output << fixed << setprecision(3);
+    output << "{ \"traceEvents\": [" << endl;
+
+    bool first = true;
+
+    for (const_each<Impl::ThreadBufferVector> i = impl->m_thread_buffers; i; ++i)
+    {
+        ThreadBuffer& buffer = **i;
+        boost::mutex::scoped_lock buffer_lock(buffer.m_mutex);
+
+        // Name the thread.
+        if (!first)
+            output << "," << endl;
+        output
+            << "  { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer.m_thread_index
+            << ", \"args\": { \"name\": \"thread " << buffer.m_thread_index << "\" } }";
+        first = false;
+
+        // Write the events of the thread as complete events.
+        for (const_each<vector<TraceEvent> > e = buffer.m_events; e; ++e)
+        {
+            const double begin = impl->to_microseconds(e->m_begin_time);
+            const double end = impl->to_microseconds(e->m_end_time);
+
+            output << "," << endl;
+            output
+                << "  { \"name\": " << quote_json_string(e->m_name)
+                << ", \"cat\": " << quote_json_string(e->m_category)
+                << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer.m_thread_index
+                << ", \"ts\": " << begin
+                << ", \"dur\": " << (end > begin ? end - begin : 0.0) << " }";
+        }
+    }
+
+    output << endl << "], \"displayTimeUnit\": \"ms\" }" << endl;
+}
+
+bool TraceEventRecorder::write_chrome_trace(const char* filename) const
+{
+    ofstream file(filename);
+
+    if (!file.is_open())
+        return false;
+
+    write_chrome_trace(file);
+
+    return file.good();
+}
+
+}   // namespace foundation
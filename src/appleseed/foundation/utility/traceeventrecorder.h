@@ -0,0 +1,174 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_UTILITY_TRACEEVENTRECORDER_H
+#define APPLESEED_FOUNDATION_UTILITY_TRACEEVENTRECORDER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+#include <ostream>
+
+namespace foundation
+{
+
+//
+// Records timed events (such as rendering phases or jobs) into per-thread buffers
+// and writes them in the Chrome trace event format, which can be inspected with
+// chrome://tracing.
+//
+// Recording an event appends to a buffer owned by the calling thread. Each buffer
+// has its own lock which is only contended while the recorded events are being
+// counted, cleared or written, so all methods may be called at any time from any
+// thread. Event names and categories are not copied and must be string literals.
+//
+
+class DLLSYMBOL TraceEventRecorder
+  : public NonCopyable
+{
+  public:
+    // Constructor. Recording is initially disabled.
+    TraceEventRecorder();
+
+    // Destructor.
+    ~TraceEventRecorder();
+
+    // Enable/disable recording.
+    void set_enabled(const bool enabled = true);
+    bool is_enabled() const;
+
+    // Remove all recorded events.
+    void clear();
+
+    // Return the current time, in timer ticks.
+    uint64 read_time() const;
+
+    // Record an event that started and ended at given times (as returned by read_time()).
+    void record(
+        const char*     name,
+        const char*     category,
+        const uint64    begin_time,
+        const uint64    end_time);
+
+    // Return the number of recorded events.
+    size_t get_event_count() const;
+
+    // Write all recorded events in the Chrome trace event format.
+    void write_chrome_trace(std::ostream& output) const;
+    bool write_chrome_trace(const char* filename) const;
+
+  private:
+    struct Impl;
+    Impl* impl;
+
+    bool m_enabled;
+};
+
+
+//
+// Records an event spanning the lifetime of this object, or until end() is called.
+// Nothing is recorded if recording was disabled when the object was constructed.
+//
+
+class TraceScope
+  : public NonCopyable
+{
+  public:
+    // Constructor, starts the event.
+    TraceScope(
+        TraceEventRecorder& recorder,
+        const char*         name,
+        const char*         category);
+
+    // Destructor, ends the event if end() was not called.
+    ~TraceScope();
+
+    // End the event.
+    void end();
+
+  private:
+    TraceEventRecorder*     m_recorder;
+    const char*             m_name;
+    const char*             m_category;
+    const uint64            m_begin_time;
+};
+
+
+//
+// TraceEventRecorder class implementation.
+//
+
+inline void TraceEventRecorder::set_enabled(const bool enabled)
+{
+    m_enabled = enabled;
+}
+
+inline bool TraceEventRecorder::is_enabled() const
+{
+    return m_enabled;
+}
+
+
+//
+// TraceScope class implementation.
+//
+
+inline TraceScope::TraceScope(
+    TraceEventRecorder& recorder,
+    const char*         name,
+    const char*         category)
+  : m_recorder(recorder.is_enabled() ? &recorder : 0)
+  , m_name(name)
+  , m_category(category)
+  , m_begin_time(m_recorder ? recorder.read_time() : 0)
+{
+}
+
+inline TraceScope::~TraceScope()
+{
+    end();
+}
+
+inline void TraceScope::end()
+{
+    if (m_recorder)
+    {
+        m_recorder->record(m_name, m_category, m_begin_time, m_recorder->read_time());
+        m_recorder = 0;
+    }
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_TRACEEVENTRECORDER_H
@@ -32,5 +32,7 @@
 
 // API headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemorytracker.h"
+#include "renderer/global/globaltraceeventrecorder.h"
 
 #endif  // !APPLESEED_RENDERER_API_LOG_H
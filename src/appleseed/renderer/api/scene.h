@@ -36,6 +36,7 @@
 #include "renderer/modeling/scene/assemblyinstancetraits.h"
 #include "renderer/modeling/scene/basegroup.h"
 #include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/instancearray.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/objectinstancetraits.h"
 #include "renderer/modeling/scene/scene.h"
@@ -58,10 +58,14 @@ typedef foundation::RegularSpectrum<float, 31> Spectrum;
 typedef foundation::Color<float, 1> Alpha;
 
 // Sampling context.
-#ifdef USE_QMC_SAMPLER
+#if defined USE_QMC_SAMPLER
     typedef foundation::QMCSamplingContext<
         foundation::MersenneTwister
     > SamplingContext;
+#elif defined USE_SOBOL_SAMPLER
+    typedef foundation::SobolSamplingContext<
+        foundation::MersenneTwister
+    > SamplingContext;
 #else
     typedef foundation::RNGSamplingContext<
         foundation::MersenneTwister
@@ -42,6 +42,7 @@
 // appleseed.foundation headers.
 #include "foundation/math/intersection.h"
 #include "foundation/math/permutation.h"
+#include "foundation/math/transform.h"
 #include "foundation/platform/system.h"
 #include "foundation/platform/timer.h"
 #include "foundation/utility/statistics.h"
@@ -64,6 +65,7 @@ namespace renderer
 AssemblyTree::AssemblyTree(const Scene& scene)
   : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
   , m_scene(scene)
+  , m_temporal_split_depth(0)
 {
     update();
 }
@@ -82,6 +84,11 @@ AssemblyTree::~AssemblyTree()
     for (each<TriangleTreeContainer> i = m_triangle_trees; i; ++i)
         delete i->second;
     m_triangle_trees.clear();
+
+    // Delete curve trees.
+    for (each<CurveTreeContainer> i = m_curve_trees; i; ++i)
+        delete i->second;
+    m_curve_trees.clear();
 }
 
 void AssemblyTree::update()
@@ -96,14 +103,29 @@ size_t AssemblyTree::get_memory_size() const
           TreeType::get_memory_size()
         - sizeof(*static_cast<const TreeType*>(this))
         + sizeof(*this)
-        + m_items.capacity() * sizeof(AssemblyInstance*)
+        + m_items.capacity() * sizeof(Item)
+        + m_transform_sequences.size() * sizeof(TransformSequence)
         + m_assembly_versions.size() * sizeof(pair<UniqueID, VersionID>);
 }
 
+const Transformd& AssemblyTree::Item::evaluate_transform(
+    const double        time,
+    Transformd&         tmp) const
+{
+    const Transformd& transform = m_transform_sequence->evaluate(time, tmp);
+
+    if (m_instance_array_index == InstanceArray::InvalidIndex)
+        return transform;
+
+    // Decode the transform of the element of the instance array.
+    tmp = m_assembly_instance->instance_array().get_transform(m_instance_array_index) * transform;
+    return tmp;
+}
+
 void AssemblyTree::collect_assembly_instances(
     const AssemblyInstanceContainer&    assembly_instances,
     const TransformSequence&            parent_transform_seq,
-    AABBVector&                         assembly_instance_bboxes)
+    AABBVector&                         item_bboxes)
 {
     for (const_each<AssemblyInstanceContainer> i = assembly_instances; i; ++i)
     {
@@ -113,88 +135,323 @@ void AssemblyTree::collect_assembly_instances(
         // Retrieve the assembly.
         const Assembly& assembly = assembly_instance.get_assembly();
 
-        // Compute the cumulated transform sequence of this assembly instance.
-        TransformSequence cumulated_transform_seq =
-            assembly_instance.transform_sequence() * parent_transform_seq;
+        // Compute and store the cumulated transform sequence of this assembly instance.
+        // Items only keep a pointer to it, the deque guarantees that it won't move.
+        m_transform_sequences.push_back(
+            assembly_instance.transform_sequence() * parent_transform_seq);
+        TransformSequence& cumulated_transform_seq = m_transform_sequences.back();
         cumulated_transform_seq.prepare();
 
-        // Recurse into child assembly instances.
-        collect_assembly_instances(
-            assembly.assembly_instances(),
-            cumulated_transform_seq,
-            assembly_instance_bboxes);
+        const InstanceArray& instance_array = assembly_instance.instance_array();
+        const size_t instance_count = instance_array.size();
+
+        // Recurse into child assembly instances, once per element of the instance array if any.
+        if (instance_array.empty())
+        {
+            collect_assembly_instances(
+                assembly.assembly_instances(),
+                cumulated_transform_seq,
+                item_bboxes);
+        }
+        else if (!assembly.assembly_instances().empty())
+        {
+            for (size_t j = 0; j < instance_count; ++j)
+            {
+                collect_assembly_instances(
+                    assembly.assembly_instances(),
+                    instance_array.get_transform_sequence(j, cumulated_transform_seq),
+                    item_bboxes);
+            }
+        }
 
         // Skip empty assemblies.
         if (assembly.object_instances().empty())
             continue;
 
-        // Create and store an item for this assembly instance.
-        m_items.push_back(
-            Item(
-                &assembly,
-                &assembly_instance,
-                cumulated_transform_seq));
-
-        // Compute and store the assembly instance bounding box.
-        AABB3d assembly_instance_bbox(
-            cumulated_transform_seq.to_parent(
-                assembly.compute_non_hierarchical_local_bbox()));
-        assembly_instance_bbox.robust_grow(1.0e-15);
-        assembly_instance_bboxes.push_back(assembly_instance_bbox);
+        const AABB3d assembly_bbox(assembly.compute_non_hierarchical_local_bbox());
+
+        if (instance_array.empty())
+        {
+            // Create and store an item for this assembly instance.
+            m_items.push_back(
+                Item(
+                    &assembly,
+                    &assembly_instance,
+                    &cumulated_transform_seq,
+                    InstanceArray::InvalidIndex));
+            item_bboxes.push_back(assembly_bbox);
+        }
+        else
+        {
+            // Create and store one item per element of the instance array.
+            m_items.reserve(m_items.size() + instance_count);
+            item_bboxes.reserve(item_bboxes.size() + instance_count);
+
+            for (size_t j = 0; j < instance_count; ++j)
+            {
+                m_items.push_back(
+                    Item(
+                        &assembly,
+                        &assembly_instance,
+                        &cumulated_transform_seq,
+                        static_cast<uint32>(j)));
+                item_bboxes.push_back(instance_array.get_transform(j).to_parent(assembly_bbox));
+            }
+        }
     }
 }
 
+namespace
+{
+    typedef vector<const TransformSequence*> TransformSequenceVector;
+
+    // Compute the bounding boxes of assembly instances over a given time interval.
+    void compute_assembly_instance_bboxes(
+        const TransformSequenceVector&  transform_seqs,
+        const vector<AABB3d>&           item_bboxes,
+        const double                    time_begin,
+        const double                    time_end,
+        vector<AABB3d>&                 assembly_instance_bboxes)
+    {
+        const size_t item_count = transform_seqs.size();
+
+        assembly_instance_bboxes.resize(item_count);
+
+        for (size_t i = 0; i < item_count; ++i)
+        {
+            AABB3d assembly_instance_bbox(
+                transform_seqs[i]->to_parent(item_bboxes[i], time_begin, time_end));
+            assembly_instance_bbox.robust_grow(1.0e-15);
+            assembly_instance_bboxes[i] = assembly_instance_bbox;
+        }
+    }
+
+    // Return the ratio between the surface area swept by the assembly instances during
+    // time intervals of a given length, and the surface area they cover in the middle
+    // of these intervals.
+    double compute_motion_ratio(
+        const TransformSequenceVector&  transform_seqs,
+        const vector<AABB3d>&           item_bboxes,
+        const size_t                    interval_count)
+    {
+        const size_t item_count = transform_seqs.size();
+
+        double swept_area = 0.0;
+        double instant_area = 0.0;
+
+        for (size_t i = 0; i < item_count; ++i)
+        {
+            const TransformSequence& transform_seq = *transform_seqs[i];
+
+            for (size_t j = 0; j < interval_count; ++j)
+            {
+                const double time_begin = static_cast<double>(j) / interval_count;
+                const double time_end = static_cast<double>(j + 1) / interval_count;
+
+                Transformd tmp;
+                const Transformd& transform = transform_seq.evaluate(0.5 * (time_begin + time_end), tmp);
+
+                swept_area += half_surface_area(transform_seq.to_parent(item_bboxes[i], time_begin, time_end));
+                instant_area += half_surface_area(transform.to_parent(item_bboxes[i]));
+            }
+        }
+
+        return instant_area > 0.0 ? swept_area / instant_area : 1.0;
+    }
+
+    // Return the number of times the time interval of the tree should be halved.
+    size_t compute_temporal_split_depth(
+        const TransformSequenceVector&  transform_seqs,
+        const vector<AABB3d>&           item_bboxes)
+    {
+        size_t depth = 0;
+
+        while (depth < AssemblyTreeMaxTemporalSplitDepth &&
+               compute_motion_ratio(
+                   transform_seqs,
+                   item_bboxes,
+                   size_t(1) << depth) > AssemblyTreeTemporalSplitThreshold)
+            ++depth;
+
+        return depth;
+    }
+
+    typedef bvh::TemporalBuilder<AssemblyTree> AssemblyTreeTemporalBuilder;
+    typedef AssemblyTreeTemporalBuilder::SubtreeType AssemblySubtree;
+
+    //
+    // Build the subtrees of a temporal assembly tree.
+    //
+
+    class AssemblySubtreeBuilder
+      : public NonCopyable
+    {
+      public:
+        AssemblySubtreeBuilder(
+            const TransformSequenceVector&  transform_seqs,
+            const vector<AABB3d>&           item_bboxes,
+            vector<size_t>&                 item_ordering)
+          : m_transform_seqs(transform_seqs)
+          , m_item_bboxes(item_bboxes)
+          , m_item_ordering(item_ordering)
+        {
+        }
+
+        size_t build(
+            AssemblySubtree&                subtree,
+            const double                    time_begin,
+            const double                    time_end,
+            AABB3d&                         bbox)
+        {
+            vector<AABB3d> assembly_instance_bboxes;
+            compute_assembly_instance_bboxes(
+                m_transform_seqs,
+                m_item_bboxes,
+                time_begin,
+                time_end,
+                assembly_instance_bboxes);
+
+            typedef bvh::SAHPartitioner<vector<AABB3d> > Partitioner;
+            Partitioner partitioner(
+                assembly_instance_bboxes,
+                AssemblyTreeMaxLeafSize,
+                AssemblyTreeInteriorNodeTraversalCost,
+                AssemblyTreeTriangleIntersectionCost);
+
+            const size_t item_count = assembly_instance_bboxes.size();
+
+            typedef bvh::Builder<AssemblySubtree, Partitioner> Builder;
+            Builder builder;
+            builder.build<DefaultWallclockTimer>(subtree, partitioner, item_count, AssemblyTreeMaxLeafSize);
+
+            const vector<size_t>& ordering = partitioner.get_item_ordering();
+            m_item_ordering.insert(m_item_ordering.end(), ordering.begin(), ordering.end());
+
+            bbox = partitioner.compute_bbox(0, item_count);
+
+            return item_count;
+        }
+
+      private:
+        const TransformSequenceVector&      m_transform_seqs;
+        const vector<AABB3d>&               m_item_bboxes;
+        vector<size_t>&                     m_item_ordering;
+    };
+}
+
 void AssemblyTree::rebuild_assembly_tree()
 {
     // Clear the current tree.
     clear();
     m_items.clear();
+    m_transform_sequences.clear();
+    m_temporal_split_depth = 0;
 
     Statistics statistics;
 
     // Collect all assembly instances of the scene.
-    AABBVector assembly_instance_bboxes;
+    AABBVector item_bboxes;
     collect_assembly_instances(
         m_scene.assembly_instances(),
         TransformSequence(),
-        assembly_instance_bboxes);
+        item_bboxes);
+
+    const size_t item_count = m_items.size();
+    assert(item_bboxes.size() == item_count);
+
+    // Compute the parent space bounding boxes of the items.
+    TransformSequenceVector transform_seqs(item_count);
+    AABBVector assembly_instance_bboxes(item_count);
+    bool moving_items = false;
+    for (size_t i = 0; i < item_count; ++i)
+    {
+        const TransformSequence& transform_seq = *m_items[i].m_transform_sequence;
+        transform_seqs[i] = &transform_seq;
+
+        assembly_instance_bboxes[i] = transform_seq.to_parent(item_bboxes[i]);
+        assembly_instance_bboxes[i].robust_grow(1.0e-15);
+
+        if (transform_seq.size() > 1)
+            moving_items = true;
+    }
+
+    // Decide whether the tree should be split in time.
+    if (moving_items)
+        m_temporal_split_depth = compute_temporal_split_depth(transform_seqs, item_bboxes);
 
     RENDERER_LOG_INFO(
-        "building assembly tree (%s %s)...",
+        "building assembly tree (%s %s, %s %s)...",
         pretty_int(m_items.size()).c_str(),
-        plural(m_items.size(), "assembly instance").c_str());
-
-    // Create the partitioner.
-    typedef bvh::SAHPartitioner<AABBVector> Partitioner;
-    Partitioner partitioner(
-        assembly_instance_bboxes,
-        AssemblyTreeMaxLeafSize,
-        AssemblyTreeInteriorNodeTraversalCost,
-        AssemblyTreeTriangleIntersectionCost);
-
-    // Build the assembly tree.
-    typedef bvh::Builder<AssemblyTree, Partitioner> Builder;
-    Builder builder;
-    builder.build<DefaultWallclockTimer>(*this, partitioner, m_items.size(), AssemblyTreeMaxLeafSize);
-    statistics.insert_time("build time", builder.get_build_time());
-    statistics.merge(bvh::TreeStatistics<AssemblyTree>(*this, AABB3d(m_scene.compute_bbox())));
-
-    if (!m_items.empty())
+        plural(m_items.size(), "assembly instance").c_str(),
+        pretty_uint(size_t(1) << m_temporal_split_depth).c_str(),
+        plural(size_t(1) << m_temporal_split_depth, "time interval").c_str());
+
+    if (m_temporal_split_depth > 0)
     {
-        const vector<size_t>& ordering = partitioner.get_item_ordering();
-        assert(m_items.size() == ordering.size());
+        // Build one subtree per time interval.
+        vector<size_t> ordering;
+        AssemblySubtreeBuilder subtree_builder(transform_seqs, item_bboxes, ordering);
+        AssemblyTreeTemporalBuilder builder;
+        builder.build<DefaultWallclockTimer>(*this, subtree_builder, m_temporal_split_depth);
+        statistics.insert_time("build time", builder.get_build_time());
+        statistics.merge(bvh::TreeStatistics<AssemblyTree>(*this, AABB3d(m_scene.compute_bbox())));
+        statistics.insert("temporal split depth", m_temporal_split_depth);
+
+        // The tree is traversed with motion: each child of a spatial interior node has a single bounding box.
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            NodeType& node = m_nodes[i];
 
-        // Reorder the items according to the tree ordering.
-        ItemVector temp_assembly_instances(ordering.size());
-        small_item_reorder(
-            &m_items[0],
-            &temp_assembly_instances[0],
-            &ordering[0],
-            ordering.size());
+            if (node.is_interior() && !node.is_temporal_interior())
+            {
+                node.set_left_bbox_count(1);
+                node.set_right_bbox_count(1);
+            }
+        }
+
+        // Items are duplicated in each subtree, store them in tree order.
+        ItemVector items(ordering.size());
+        for (size_t i = 0; i < ordering.size(); ++i)
+            items[i] = m_items[ordering[i]];
+        m_items.swap(items);
 
         // Store the items in the tree leaves whenever possible.
         store_items_in_leaves(statistics);
     }
+    else
+    {
+        // Create the partitioner.
+        typedef bvh::SAHPartitioner<AABBVector> Partitioner;
+        Partitioner partitioner(
+            assembly_instance_bboxes,
+            AssemblyTreeMaxLeafSize,
+            AssemblyTreeInteriorNodeTraversalCost,
+            AssemblyTreeTriangleIntersectionCost);
+
+        // Build the assembly tree.
+        typedef bvh::Builder<AssemblyTree, Partitioner> Builder;
+        Builder builder;
+        builder.build<DefaultWallclockTimer>(*this, partitioner, m_items.size(), AssemblyTreeMaxLeafSize);
+        statistics.insert_time("build time", builder.get_build_time());
+        statistics.merge(bvh::TreeStatistics<AssemblyTree>(*this, AABB3d(m_scene.compute_bbox())));
+
+        if (!m_items.empty())
+        {
+            const vector<size_t>& ordering = partitioner.get_item_ordering();
+            assert(m_items.size() == ordering.size());
+
+            // Reorder the items according to the tree ordering.
+            ItemVector temp_assembly_instances(ordering.size());
+            small_item_reorder(
+                &m_items[0],
+                &temp_assembly_instances[0],
+                &ordering[0],
+                ordering.size());
+
+            // Store the items in the tree leaves whenever possible.
+            store_items_in_leaves(statistics);
+        }
+    }
 
     // Print assembly tree statistics.
     RENDERER_LOG_DEBUG("%s",
@@ -387,6 +644,13 @@ void AssemblyTree::update_child_trees()
                     delete it->second;
                     m_triangle_trees.erase(it);
                 }
+
+                const CurveTreeContainer::iterator it = m_curve_trees.find(assembly_uid);
+                if (it != m_curve_trees.end())
+                {
+                    delete it->second;
+                    m_curve_trees.erase(it);
+                }
             }
         }
 
@@ -404,6 +668,15 @@ void AssemblyTree::update_child_trees()
         {
             m_triangle_trees.insert(
                 make_pair(assembly_uid, create_triangle_tree(m_scene, assembly)));
+
+            // Curve trees are built right away since they are needed by the first ray.
+            if (CurveTree::has_curves(assembly))
+            {
+                CurveTree* curve_tree = new CurveTree(CurveTree::Arguments(assembly_uid, assembly));
+                if (curve_tree->get_curve_piece_count() > 0)
+                    m_curve_trees.insert(make_pair(assembly_uid, curve_tree));
+                else delete curve_tree;
+            }
         }
 
         // Store the current version ID of the assembly.
@@ -413,13 +686,28 @@ void AssemblyTree::update_child_trees()
 
 
 //
-// Utility function to transform a ray to the space of an assembly instance.
+// Utility functions to transform a ray to the space of an assembly instance.
 //
 
 namespace
 {
+    // Return the previous intersection if it lies in a given assembly instance, 0 otherwise.
+    const ShadingPoint* get_parent_shading_point_in(
+        const AssemblyInstance&     assembly_instance,
+        const size_t                instance_array_index,
+        const ShadingPoint*         parent_sp)
+    {
+        return
+            parent_sp &&
+            parent_sp->get_assembly_instance().get_uid() == assembly_instance.get_uid() &&
+            parent_sp->get_instance_array_index() == instance_array_index
+                ? parent_sp
+                : 0;
+    }
+
     void compute_assembly_instance_ray(
         const AssemblyInstance&     assembly_instance,
+        const size_t                instance_array_index,
         const Transformd&           assembly_instance_transform,
         const ShadingPoint*         parent_sp,
         const ShadingRay&           input_ray,
@@ -429,15 +717,17 @@ namespace
         output_ray.m_dir = assembly_instance_transform.vector_to_local(input_ray.m_dir);
 
         // Compute the ray origin in assembly instance space.
-        if (parent_sp &&
-            parent_sp->get_assembly_instance().get_uid() == assembly_instance.get_uid() &&
-            parent_sp->get_object_instance().get_ray_bias_method() == ObjectInstance::RayBiasMethodNone)
+        const ShadingPoint* local_parent_sp =
+            get_parent_shading_point_in(assembly_instance, instance_array_index, parent_sp);
+
+        if (local_parent_sp &&
+            local_parent_sp->get_object_instance().get_ray_bias_method() == ObjectInstance::RayBiasMethodNone)
         {
             // The caller provided the previous intersection, and we are about
             // to intersect the assembly instance that contains the previous
             // intersection. Use the properly offset intersection point as the
             // origin of the child ray.
-            output_ray.m_org = parent_sp->get_offset_point(output_ray.m_dir);
+            output_ray.m_org = local_parent_sp->get_offset_point(output_ray.m_dir);
         }
         else
         {
@@ -454,6 +744,7 @@ namespace
         output_ray.m_time = input_ray.m_time;
         output_ray.m_type = input_ray.m_type;
         output_ray.m_depth = input_ray.m_depth;
+        output_ray.m_has_differentials = false;
     }
 }
 
@@ -472,6 +763,9 @@ bool AssemblyLeafVisitor::visit(
 #endif
     )
 {
+    // Update traversal counters.
+    ++m_counters.m_assembly_leaf_visits;
+
     // Retrieve the assembly instances for this leaf.
     const size_t assembly_instance_index = node.get_item_index();
     const size_t assembly_instance_count = node.get_item_count();
@@ -488,12 +782,13 @@ bool AssemblyLeafVisitor::visit(
         // Evaluate the transformation of the assembly instance.
         Transformd tmp;
         const Transformd& assembly_instance_transform =
-            item.m_transform_sequence.evaluate(ray.m_time, tmp);
+            item.evaluate_transform(ray.m_time, tmp);
 
         // Transform the ray to assembly instance space.
         ShadingPoint local_shading_point;
         compute_assembly_instance_ray(
             *item.m_assembly_instance,
+            item.m_instance_array_index,
             assembly_instance_transform,
             m_parent_shading_point,
             ray,
@@ -513,7 +808,8 @@ bool AssemblyLeafVisitor::visit(
             // Check the intersection between the ray and the region tree.
             RegionLeafVisitor visitor(
                 local_shading_point,
-                m_triangle_tree_cache
+                m_triangle_tree_cache,
+                m_counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
                 , m_triangle_tree_stats
 #endif
@@ -537,7 +833,7 @@ bool AssemblyLeafVisitor::visit(
             {
                 // Check the intersection between the ray and the triangle tree.
                 TriangleTreeIntersector intersector;
-                TriangleLeafVisitor visitor(*triangle_tree, local_shading_point);
+                TriangleLeafVisitor visitor(*triangle_tree, local_shading_point, m_counters);
                 if (triangle_tree->get_moving_triangle_count() > 0)
                 {
                     intersector.intersect_motion(
@@ -565,6 +861,32 @@ bool AssemblyLeafVisitor::visit(
                 }
                 visitor.read_hit_triangle_data();
             }
+
+            // Check the intersection between the ray and the curve tree of this assembly.
+            const CurveTreeConstIterator curve_tree_it = m_tree.m_curve_trees.find(item.m_assembly_uid);
+            if (curve_tree_it != m_tree.m_curve_trees.end())
+            {
+                const CurveTree& curve_tree = *curve_tree_it->second;
+                CurveTreeIntersector intersector;
+                CurveLeafVisitor visitor(
+                    curve_tree,
+                    local_shading_point,
+                    get_parent_shading_point_in(
+                        *item.m_assembly_instance,
+                        item.m_instance_array_index,
+                        m_parent_shading_point),
+                    m_counters);
+                intersector.intersect_no_motion(
+                    curve_tree,
+                    local_shading_point.m_ray,
+                    local_ray_info,
+                    visitor
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+                    , m_triangle_tree_stats
+#endif
+                    );
+                visitor.read_hit_curve_data();
+            }
         }
 
         // Keep track of the closest hit.
@@ -574,10 +896,12 @@ bool AssemblyLeafVisitor::visit(
             m_shading_point.m_hit = true;
             m_shading_point.m_bary = local_shading_point.m_bary;
             m_shading_point.m_assembly_instance = item.m_assembly_instance;
+            m_shading_point.m_instance_array_index = item.m_instance_array_index;
             m_shading_point.m_assembly_instance_transform = assembly_instance_transform;
             m_shading_point.m_object_instance_index = local_shading_point.m_object_instance_index;
             m_shading_point.m_region_index = local_shading_point.m_region_index;
             m_shading_point.m_triangle_index = local_shading_point.m_triangle_index;
+            m_shading_point.m_primitive_type = local_shading_point.m_primitive_type;
             m_shading_point.m_triangle_support_plane = local_shading_point.m_triangle_support_plane;
         }
     }
@@ -602,6 +926,9 @@ bool AssemblyLeafProbeVisitor::visit(
 #endif
     )
 {
+    // Update traversal counters.
+    ++m_counters.m_assembly_leaf_visits;
+
     // Retrieve the assembly instances for this leaf.
     const size_t assembly_instance_count = node.get_item_count();
     const AssemblyTree::Item* items =
@@ -617,12 +944,13 @@ bool AssemblyLeafProbeVisitor::visit(
         // Evaluate the transformation of the assembly instance.
         Transformd tmp;
         const Transformd& assembly_instance_transform =
-            item.m_transform_sequence.evaluate(ray.m_time, tmp);
+            item.evaluate_transform(ray.m_time, tmp);
 
         // Transform the ray to assembly instance space.
         ShadingRay local_ray;
         compute_assembly_instance_ray(
             *item.m_assembly_instance,
+            item.m_instance_array_index,
             assembly_instance_transform,
             m_parent_shading_point,
             ray,
@@ -641,7 +969,8 @@ bool AssemblyLeafProbeVisitor::visit(
 
             // Check the intersection between the ray and the region tree.
             RegionLeafProbeVisitor visitor(
-                m_triangle_tree_cache
+                m_triangle_tree_cache,
+                m_counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
                 , m_triangle_tree_stats
 #endif
@@ -672,7 +1001,7 @@ bool AssemblyLeafProbeVisitor::visit(
             {
                 // Check the intersection between the ray and the triangle tree.
                 TriangleTreeProbeIntersector intersector;
-                TriangleLeafProbeVisitor visitor(*triangle_tree);
+                TriangleLeafProbeVisitor visitor(*triangle_tree, m_counters);
                 if (triangle_tree->get_moving_triangle_count() > 0)
                 {
                     intersector.intersect_motion(
@@ -706,6 +1035,37 @@ bool AssemblyLeafProbeVisitor::visit(
                     return false;
                 }
             }
+
+            // Check the intersection between the ray and the curve tree of this assembly.
+            const CurveTreeConstIterator curve_tree_it = m_tree.m_curve_trees.find(item.m_assembly_uid);
+            if (curve_tree_it != m_tree.m_curve_trees.end())
+            {
+                const CurveTree& curve_tree = *curve_tree_it->second;
+                CurveTreeProbeIntersector intersector;
+                CurveLeafProbeVisitor visitor(
+                    curve_tree,
+                    get_parent_shading_point_in(
+                        *item.m_assembly_instance,
+                        item.m_instance_array_index,
+                        m_parent_shading_point),
+                    m_counters);
+                intersector.intersect_no_motion(
+                    curve_tree,
+                    local_ray,
+                    local_ray_info,
+                    visitor
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+                    , m_triangle_tree_stats
+#endif
+                    );
+
+                // Terminate traversal if there was a hit.
+                if (visitor.hit())
+                {
+                    m_hit = true;
+                    return false;
+                }
+            }
         }
     }
 
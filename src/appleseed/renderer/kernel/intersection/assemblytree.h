@@ -32,10 +32,12 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/global.h"
+#include "renderer/kernel/intersection/curvetree.h"
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/probevisitorbase.h"
 #include "renderer/kernel/intersection/regioninfo.h"
 #include "renderer/kernel/intersection/regiontree.h"
+#include "renderer/kernel/intersection/traversalcounters.h"
 #include "renderer/kernel/intersection/triangletree.h"
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/scene/containers.h"
@@ -45,11 +47,14 @@
 // appleseed.foundation headers.
 #include "foundation/math/aabb.h"
 #include "foundation/math/bvh.h"
+#include "foundation/math/transform.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/alignedvector.h"
 #include "foundation/utility/lazy.h"
 #include "foundation/utility/version.h"
 
 // Standard headers.
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -86,6 +91,10 @@ class AssemblyTree
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
 
+    // Return the number of times the time interval of the tree was halved.
+    // The tree must be traversed with motion if this is not zero.
+    size_t get_temporal_split_depth() const;
+
   private:
     friend class AssemblyLeafVisitor;
     friend class AssemblyLeafProbeVisitor;
@@ -96,23 +105,32 @@ class AssemblyTree
         const renderer::Assembly*               m_assembly;
         foundation::UniqueID                    m_assembly_uid;
         const renderer::AssemblyInstance*       m_assembly_instance;
-        renderer::TransformSequence             m_transform_sequence;
+        const renderer::TransformSequence*      m_transform_sequence;       // cumulated transform sequence, owned by the tree
+        foundation::uint32                      m_instance_array_index;     // index in the instance array of the assembly instance
 
         Item() {}
 
         Item(
             const renderer::Assembly*           assembly,
             const renderer::AssemblyInstance*   assembly_instance,
-            renderer::TransformSequence         transform_sequence)
+            const renderer::TransformSequence*  transform_sequence,
+            const foundation::uint32            instance_array_index)
           : m_assembly(assembly)
           , m_assembly_uid(assembly->get_uid())
           , m_assembly_instance(assembly_instance)
           , m_transform_sequence(transform_sequence)
+          , m_instance_array_index(instance_array_index)
         {
         }
+
+        // Evaluate the transform of the item at a given time.
+        const foundation::Transformd& evaluate_transform(
+            const double                        time,
+            foundation::Transformd&             tmp) const;
     };
 
     typedef std::vector<Item> ItemVector;
+    typedef std::deque<TransformSequence> TransformSequenceDeque;
     typedef std::vector<foundation::AABB3d> AABBVector;
     typedef std::vector<const Assembly*> AssemblyVector;
     typedef std::map<foundation::UniqueID, foundation::VersionID> AssemblyVersionMap;
@@ -120,13 +138,16 @@ class AssemblyTree
     const Scene&            m_scene;
     RegionTreeContainer     m_region_trees;
     TriangleTreeContainer   m_triangle_trees;
+    CurveTreeContainer      m_curve_trees;
     ItemVector              m_items;
+    TransformSequenceDeque  m_transform_sequences;
     AssemblyVersionMap      m_assembly_versions;
+    size_t                  m_temporal_split_depth;
 
     void collect_assembly_instances(
         const AssemblyInstanceContainer&        assembly_instances,
         const TransformSequence&                parent_transform_seq,
-        AABBVector&                             assembly_instance_bboxes);
+        AABBVector&                             item_bboxes);
     void rebuild_assembly_tree();
     void store_items_in_leaves(foundation::Statistics& statistics);
 
@@ -149,7 +170,8 @@ class AssemblyLeafVisitor
         const AssemblyTree&                         tree,
         RegionTreeAccessCache&                      region_tree_cache,
         TriangleTreeAccessCache&                    triangle_tree_cache,
-        const ShadingPoint*                         parent_shading_point
+        const ShadingPoint*                         parent_shading_point,
+        TraversalCounters&                          counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
@@ -172,6 +194,7 @@ class AssemblyLeafVisitor
     RegionTreeAccessCache&                          m_region_tree_cache;
     TriangleTreeAccessCache&                        m_triangle_tree_cache;
     const ShadingPoint*                             m_parent_shading_point;
+    TraversalCounters&                              m_counters;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&           m_triangle_tree_stats;
 #endif
@@ -192,7 +215,8 @@ class AssemblyLeafProbeVisitor
         const AssemblyTree&                         tree,
         RegionTreeAccessCache&                      region_tree_cache,
         TriangleTreeAccessCache&                    triangle_tree_cache,
-        const ShadingPoint*                         parent_shading_point
+        const ShadingPoint*                         parent_shading_point,
+        TraversalCounters&                          counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
@@ -214,6 +238,7 @@ class AssemblyLeafProbeVisitor
     RegionTreeAccessCache&                          m_region_tree_cache;
     TriangleTreeAccessCache&                        m_triangle_tree_cache;
     const ShadingPoint*                             m_parent_shading_point;
+    TraversalCounters&                              m_counters;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&           m_triangle_tree_stats;
 #endif
@@ -237,6 +262,16 @@ typedef foundation::bvh::Intersector<
 > AssemblyTreeProbeIntersector;
 
 
+//
+// AssemblyTree class implementation.
+//
+
+inline size_t AssemblyTree::get_temporal_split_depth() const
+{
+    return m_temporal_split_depth;
+}
+
+
 //
 // AssemblyLeafVisitor class implementation.
 //
@@ -246,7 +281,8 @@ inline AssemblyLeafVisitor::AssemblyLeafVisitor(
     const AssemblyTree&                             tree,
     RegionTreeAccessCache&                          region_tree_cache,
     TriangleTreeAccessCache&                        triangle_tree_cache,
-    const ShadingPoint*                             parent_shading_point
+    const ShadingPoint*                             parent_shading_point,
+    TraversalCounters&                              counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&         triangle_tree_stats
 #endif
@@ -256,6 +292,7 @@ inline AssemblyLeafVisitor::AssemblyLeafVisitor(
   , m_region_tree_cache(region_tree_cache)
   , m_triangle_tree_cache(triangle_tree_cache)
   , m_parent_shading_point(parent_shading_point)
+  , m_counters(counters)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -271,7 +308,8 @@ inline AssemblyLeafProbeVisitor::AssemblyLeafProbeVisitor(
     const AssemblyTree&                             tree,
     RegionTreeAccessCache&                          region_tree_cache,
     TriangleTreeAccessCache&                        triangle_tree_cache,
-    const ShadingPoint*                             parent_shading_point
+    const ShadingPoint*                             parent_shading_point,
+    TraversalCounters&                              counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&         triangle_tree_stats
 #endif
@@ -280,6 +318,7 @@ inline AssemblyLeafProbeVisitor::AssemblyLeafProbeVisitor(
   , m_region_tree_cache(region_tree_cache)
   , m_triangle_tree_cache(triangle_tree_cache)
   , m_parent_shading_point(parent_shading_point)
+  , m_counters(counters)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -0,0 +1,331 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "curvetree.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemorytracker.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/platform/system.h"
+#include "foundation/platform/timer.h"
+#include "foundation/utility/foreach.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// CurveTree class implementation.
+//
+
+namespace
+{
+    const CurveObject* get_curve_object(const ObjectInstance& object_instance)
+    {
+        const Object& object = object_instance.get_object();
+
+        return
+            strcmp(object.get_model(), CurveObjectFactory::get_model()) == 0
+                ? static_cast<const CurveObject*>(&object)
+                : 0;
+    }
+
+    GCurve3 transform_curve(
+        const GCurve3&          curve,
+        const Transformd&       transform,
+        const GScalar           width_scale)
+    {
+        GVector3 points[4];
+        GScalar widths[4];
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            points[i] = transform.point_to_parent(curve.get_control_point(i));
+            widths[i] = curve.get_width(i) * width_scale;
+        }
+
+        return GCurve3(points, widths);
+    }
+
+    struct CurveCollector
+    {
+        const size_t            m_max_split_depth;
+        const GScalar           m_split_threshold;
+        vector<CurveKey>&       m_curve_keys;
+        vector<GCurve3>&        m_curves;
+        vector<GAABB3>&         m_curve_bboxes;
+
+        CurveCollector(
+            const size_t        max_split_depth,
+            const GScalar       split_threshold,
+            vector<CurveKey>&   curve_keys,
+            vector<GCurve3>&    curves,
+            vector<GAABB3>&     curve_bboxes)
+          : m_max_split_depth(max_split_depth)
+          , m_split_threshold(split_threshold)
+          , m_curve_keys(curve_keys)
+          , m_curves(curves)
+          , m_curve_bboxes(curve_bboxes)
+        {
+        }
+
+        // Store a curve piece, halving it first if that tightens its bounding box enough.
+        void collect(
+            const GCurve3&      curve,
+            const GAABB3&       bbox,
+            const size_t        object_instance_index,
+            const size_t        segment_index,
+            const GScalar       u_begin,
+            const GScalar       u_end,
+            const size_t        depth)
+        {
+            if (depth < m_max_split_depth)
+            {
+                GCurve3 left, right;
+                curve.split(left, right);
+
+                const GAABB3 left_bbox = left.compute_bbox();
+                const GAABB3 right_bbox = right.compute_bbox();
+
+                if (half_surface_area(left_bbox) + half_surface_area(right_bbox) <
+                    m_split_threshold * half_surface_area(bbox))
+                {
+                    const GScalar u_middle = GScalar(0.5) * (u_begin + u_end);
+                    collect(left, left_bbox, object_instance_index, segment_index, u_begin, u_middle, depth + 1);
+                    collect(right, right_bbox, object_instance_index, segment_index, u_middle, u_end, depth + 1);
+                    return;
+                }
+            }
+
+            m_curve_keys.push_back(CurveKey(object_instance_index, segment_index, u_begin, u_end));
+            m_curves.push_back(curve);
+            m_curve_bboxes.push_back(bbox);
+        }
+    };
+}
+
+CurveTree::Arguments::Arguments(
+    const UniqueID          curve_tree_uid,
+    const Assembly&         assembly)
+  : m_curve_tree_uid(curve_tree_uid)
+  , m_assembly(assembly)
+{
+}
+
+CurveTree::CurveTree(const Arguments& arguments)
+  : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
+  , m_arguments(arguments)
+{
+    // Retrieve construction parameters.
+    const ParamArray& params = m_arguments.m_assembly.get_parameters().child("acceleration_structure");
+
+    // Start stopwatch.
+    Stopwatch<DefaultWallclockTimer> stopwatch;
+    stopwatch.start();
+
+    // Build the tree.
+    Statistics statistics;
+    build_bvh(params, statistics);
+
+    // Print curve tree statistics.
+    statistics.insert_time("total time", stopwatch.measure().get_seconds());
+    RENDERER_LOG_DEBUG("%s",
+        StatisticsVector::make(
+            "curve tree #" + to_string(m_arguments.m_curve_tree_uid) + " statistics",
+            statistics).to_string().c_str());
+
+    global_memory_tracker().record_allocation("curve trees", get_memory_size());
+}
+
+CurveTree::~CurveTree()
+{
+    RENDERER_LOG_INFO(
+        "deleting curve tree #" FMT_UNIQUE_ID "...",
+        m_arguments.m_curve_tree_uid);
+
+    global_memory_tracker().record_deallocation("curve trees", get_memory_size());
+}
+
+size_t CurveTree::get_memory_size() const
+{
+    return
+          TreeType::get_memory_size()
+        - sizeof(*static_cast<const TreeType*>(this))
+        + sizeof(*this)
+        + m_curve_keys.capacity() * sizeof(CurveKey)
+        + m_curves.capacity() * sizeof(GCurve3);
+}
+
+bool CurveTree::has_curves(const Assembly& assembly)
+{
+    const ObjectInstanceContainer& object_instances = assembly.object_instances();
+
+    for (const_each<ObjectInstanceContainer> i = object_instances; i; ++i)
+    {
+        if (get_curve_object(*i))
+            return true;
+    }
+
+    return false;
+}
+
+void CurveTree::build_bvh(
+    const ParamArray&   params,
+    Statistics&         statistics)
+{
+    Stopwatch<DefaultWallclockTimer> stopwatch;
+    stopwatch.start();
+
+    // Retrieve the parameters.
+    const size_t max_leaf_size = params.get_optional<size_t>("curve_max_leaf_size", CurveTreeDefaultMaxLeafSize);
+    const GScalar interior_node_traversal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", CurveTreeDefaultInteriorNodeTraversalCost);
+    const GScalar curve_intersection_cost = params.get_optional<GScalar>("curve_intersection_cost", CurveTreeDefaultCurveIntersectionCost);
+    const size_t max_split_depth = params.get_optional<size_t>("curve_max_split_depth", CurveTreeDefaultMaxSplitDepth);
+    const GScalar split_threshold = params.get_optional<GScalar>("curve_split_threshold", CurveTreeDefaultSplitThreshold);
+
+    // Collect curve segments in assembly space, splitting them to tighten their bounding boxes.
+    vector<CurveKey> curve_keys;
+    vector<GCurve3> curves;
+    vector<GAABB3> curve_bboxes;
+    CurveCollector collector(max_split_depth, split_threshold, curve_keys, curves, curve_bboxes);
+    size_t segment_count = 0;
+
+    const ObjectInstanceContainer& object_instances = m_arguments.m_assembly.object_instances();
+    for (size_t obj_inst_index = 0; obj_inst_index < object_instances.size(); ++obj_inst_index)
+    {
+        // Retrieve the curve object, if any.
+        const ObjectInstance* object_instance = object_instances.get_by_index(obj_inst_index);
+        assert(object_instance);
+        const CurveObject* curve_object = get_curve_object(*object_instance);
+        if (curve_object == 0)
+            continue;
+
+        // Widths are scaled by the average scaling factor of the transform.
+        const Transformd& transform = object_instance->get_transform();
+        const GScalar width_scale =
+            static_cast<GScalar>(pow(abs(det(transform.get_local_to_parent())), 1.0 / 3.0));
+
+        const size_t object_segment_count = curve_object->get_segment_count();
+        for (size_t segment_index = 0; segment_index < object_segment_count; ++segment_index)
+        {
+            const GCurve3 curve =
+                transform_curve(
+                    curve_object->get_segment(segment_index),
+                    transform,
+                    width_scale);
+
+            collector.collect(
+                curve,
+                curve.compute_bbox(),
+                obj_inst_index,
+                segment_index,
+                GScalar(0.0),
+                GScalar(1.0),
+                0);
+        }
+
+        segment_count += object_segment_count;
+    }
+
+    const double collection_time = stopwatch.measure().get_seconds();
+
+    RENDERER_LOG_INFO(
+        "building bvh curve tree #" FMT_UNIQUE_ID " (%s %s, %s %s)...",
+        m_arguments.m_curve_tree_uid,
+        pretty_uint(segment_count).c_str(),
+        plural(segment_count, "curve segment").c_str(),
+        pretty_uint(curves.size()).c_str(),
+        plural(curves.size(), "piece").c_str());
+
+    // An empty tree is never intersected.
+    if (curves.empty())
+        return;
+
+    // Create the partitioner.
+    typedef bvh::SAHPartitioner<vector<GAABB3> > Partitioner;
+    Partitioner partitioner(
+        curve_bboxes,
+        max_leaf_size,
+        interior_node_traversal_cost,
+        curve_intersection_cost);
+
+    // Build the tree.
+    typedef bvh::Builder<CurveTree, Partitioner> Builder;
+    Builder builder;
+    builder.build<DefaultWallclockTimer>(*this, partitioner, curves.size(), max_leaf_size);
+
+    GAABB3 tree_bbox;
+    tree_bbox.invalidate();
+    for (size_t i = 0; i < curve_bboxes.size(); ++i)
+        tree_bbox.insert(curve_bboxes[i]);
+
+    statistics.merge(bvh::TreeStatistics<CurveTree>(*this, AABB3d(tree_bbox)));
+
+    stopwatch.start();
+
+    // Store curve pieces and curve keys in the order of the leaves.
+    const vector<size_t>& ordering = partitioner.get_item_ordering();
+    m_curve_keys.reserve(ordering.size());
+    m_curves.reserve(ordering.size());
+    for (size_t i = 0; i < ordering.size(); ++i)
+    {
+        m_curve_keys.push_back(curve_keys[ordering[i]]);
+        m_curves.push_back(curves[ordering[i]]);
+    }
+
+    const double storing_time = stopwatch.measure().get_seconds();
+
+    statistics.insert("curve segments", segment_count);
+    statistics.insert("curve pieces", curves.size());
+    statistics.insert_time("collection time", collection_time);
+    statistics.insert_time("partition time", builder.get_build_time());
+    statistics.insert_time("store time", storing_time);
+}
+
+}   // namespace renderer
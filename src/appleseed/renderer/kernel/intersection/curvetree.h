@@ -0,0 +1,454 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_CURVETREE_H
+#define APPLESEED_RENDERER_KERNEL_INTERSECTION_CURVETREE_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersectionsettings.h"
+#include "renderer/kernel/intersection/probevisitorbase.h"
+#include "renderer/kernel/intersection/traversalcounters.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/modeling/object/curveobject.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/basis.h"
+#include "foundation/math/bvh.h"
+#include "foundation/math/intersection.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/alignedvector.h"
+#include "foundation/utility/uid.h"
+
+// Standard headers.
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class Statistics; }
+namespace renderer      { class Assembly; }
+namespace renderer      { class ParamArray; }
+
+namespace renderer
+{
+
+//
+// Reference to the portion of a curve segment stored in a curve tree.
+//
+
+struct CurveKey
+{
+    foundation::uint32                          m_object_instance_index;
+    foundation::uint32                          m_segment_index;
+    GScalar                                     m_u_begin;      // segment parameter at the beginning of the piece
+    GScalar                                     m_u_end;        // segment parameter at the end of the piece
+
+    CurveKey() {}
+
+    CurveKey(
+        const size_t                            object_instance_index,
+        const size_t                            segment_index,
+        const GScalar                           u_begin,
+        const GScalar                           u_end)
+      : m_object_instance_index(static_cast<foundation::uint32>(object_instance_index))
+      , m_segment_index(static_cast<foundation::uint32>(segment_index))
+      , m_u_begin(u_begin)
+      , m_u_end(u_end)
+    {
+    }
+
+    // Return the key of the curve segment a given intersection lies on,
+    // or a key that matches no segment if it does not lie on a curve.
+    static CurveKey from_shading_point(const ShadingPoint* shading_point);
+
+    // Return true if two keys reference the same curve segment.
+    bool is_same_segment(const CurveKey& rhs) const;
+};
+
+
+//
+// Curve tree.
+//
+// Curve segments are halved until their bounding boxes fit them tightly,
+// and the resulting pieces are stored in assembly space in the leaves.
+//
+
+class CurveTree
+  : public foundation::bvh::Tree<
+               foundation::AlignedVector<
+                   foundation::bvh::Node<foundation::AABB3d>
+               >
+           >
+{
+  public:
+    // Construction arguments.
+    struct Arguments
+    {
+        const foundation::UniqueID              m_curve_tree_uid;
+        const Assembly&                         m_assembly;
+
+        // Constructor.
+        Arguments(
+            const foundation::UniqueID          curve_tree_uid,
+            const Assembly&                     assembly);
+    };
+
+    // Constructor, builds the tree for the curve objects of a given assembly.
+    explicit CurveTree(const Arguments& arguments);
+
+    // Destructor.
+    ~CurveTree();
+
+    // Return the number of curve pieces stored in the tree.
+    size_t get_curve_piece_count() const;
+
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
+    // Return true if a given assembly contains curve objects.
+    static bool has_curves(const Assembly& assembly);
+
+  private:
+    friend class CurveLeafVisitor;
+    friend class CurveLeafProbeVisitor;
+
+    const Arguments                             m_arguments;
+
+    std::vector<CurveKey>                       m_curve_keys;
+    std::vector<GCurve3>                        m_curves;
+
+    void build_bvh(
+        const ParamArray&                       params,
+        foundation::Statistics&                 statistics);
+};
+
+
+//
+// Some additional types.
+//
+
+// Curve tree container and iterator types.
+typedef std::map<
+    foundation::UniqueID,
+    CurveTree*
+> CurveTreeContainer;
+typedef CurveTreeContainer::iterator CurveTreeIterator;
+typedef CurveTreeContainer::const_iterator CurveTreeConstIterator;
+
+
+//
+// Curve leaf visitor, used during tree intersection.
+//
+
+class CurveLeafVisitor
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor. If the previous intersection is provided, the curve segment
+    // it lies on is ignored to prevent ribbons from intersecting themselves.
+    CurveLeafVisitor(
+        const CurveTree&                        tree,
+        ShadingPoint&                           shading_point,
+        const ShadingPoint*                     parent_shading_point,
+        TraversalCounters&                      counters);
+
+    // Visit a leaf.
+    bool visit(
+        const CurveTree::NodeType&              node,
+        const ShadingRay&                       ray,
+        const ShadingRay::RayInfoType&          ray_info,
+        double&                                 distance
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+        , foundation::bvh::TraversalStatistics& stats
+#endif
+        );
+
+    // Read additional data about the curve that was hit, if any.
+    void read_hit_curve_data() const;
+
+  private:
+    const CurveTree&        m_tree;
+    ShadingPoint&           m_shading_point;
+    TraversalCounters&      m_counters;
+    const CurveKey          m_skipped_curve_key;
+    const GCurve3*          m_hit_curve;
+    size_t                  m_hit_curve_index;
+    double                  m_hit_piece_u;
+};
+
+
+//
+// Curve leaf visitor for probe rays, only return boolean answers
+// (whether an intersection was found or not).
+//
+
+class CurveLeafProbeVisitor
+  : public ProbeVisitorBase
+{
+  public:
+    // Constructor. If the previous intersection is provided, the curve segment
+    // it lies on is ignored to prevent ribbons from intersecting themselves.
+    CurveLeafProbeVisitor(
+        const CurveTree&                        tree,
+        const ShadingPoint*                     parent_shading_point,
+        TraversalCounters&                      counters);
+
+    // Visit a leaf.
+    bool visit(
+        const CurveTree::NodeType&              node,
+        const ShadingRay&                       ray,
+        const ShadingRay::RayInfoType&          ray_info,
+        double&                                 distance
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+        , foundation::bvh::TraversalStatistics& stats
+#endif
+        );
+
+  private:
+    const CurveTree&        m_tree;
+    TraversalCounters&      m_counters;
+    const CurveKey          m_skipped_curve_key;
+};
+
+
+//
+// Curve tree intersectors.
+//
+
+typedef foundation::bvh::Intersector<
+    CurveTree,
+    CurveLeafVisitor,
+    ShadingRay,
+    CurveTreeStackSize
+> CurveTreeIntersector;
+
+typedef foundation::bvh::Intersector<
+    CurveTree,
+    CurveLeafProbeVisitor,
+    ShadingRay,
+    CurveTreeStackSize
+> CurveTreeProbeIntersector;
+
+
+//
+// CurveKey class implementation.
+//
+
+inline CurveKey CurveKey::from_shading_point(const ShadingPoint* shading_point)
+{
+    return
+        shading_point &&
+        shading_point->hit() &&
+        shading_point->get_primitive_type() == ShadingPoint::PrimitiveCurve
+            ? CurveKey(
+                  shading_point->get_object_instance_index(),
+                  shading_point->get_triangle_index(),
+                  GScalar(0.0),
+                  GScalar(1.0))
+            : CurveKey(~size_t(0), ~size_t(0), GScalar(0.0), GScalar(0.0));
+}
+
+inline bool CurveKey::is_same_segment(const CurveKey& rhs) const
+{
+    return
+        m_object_instance_index == rhs.m_object_instance_index &&
+        m_segment_index == rhs.m_segment_index;
+}
+
+
+//
+// CurveTree class implementation.
+//
+
+inline size_t CurveTree::get_curve_piece_count() const
+{
+    return m_curves.size();
+}
+
+
+//
+// CurveLeafVisitor class implementation.
+//
+
+inline CurveLeafVisitor::CurveLeafVisitor(
+    const CurveTree&                        tree,
+    ShadingPoint&                           shading_point,
+    const ShadingPoint*                     parent_shading_point,
+    TraversalCounters&                      counters)
+  : m_tree(tree)
+  , m_shading_point(shading_point)
+  , m_counters(counters)
+  , m_skipped_curve_key(CurveKey::from_shading_point(parent_shading_point))
+  , m_hit_curve(0)
+{
+}
+
+inline bool CurveLeafVisitor::visit(
+    const CurveTree::NodeType&              node,
+    const ShadingRay&                       ray,
+    const ShadingRay::RayInfoType&          ray_info,
+    double&                                 distance
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+    , foundation::bvh::TraversalStatistics& stats
+#endif
+    )
+{
+    const size_t curve_index = node.get_item_index();
+    const size_t curve_count = node.get_item_count();
+
+    // Update traversal counters.
+    ++m_counters.m_curve_leaf_visits;
+    m_counters.m_curve_tests += curve_count;
+
+    // Sequentially intersect all curve pieces of the leaf.
+    for (size_t i = 0; i < curve_count; ++i)
+    {
+        // Skip the segment the ray originates from.
+        const CurveKey& curve_key = m_tree.m_curve_keys[curve_index + i];
+        if (curve_key.is_same_segment(m_skipped_curve_key))
+            continue;
+
+        // Load the curve piece, converting it to the right format.
+        const GCurve3& curve = m_tree.m_curves[curve_index + i];
+        const CurveType reader(curve);
+
+        // Intersect the curve piece.
+        double t, u, v;
+        if (foundation::intersect(m_shading_point.m_ray, reader, t, u, v))
+        {
+            m_hit_curve = &curve;
+            m_hit_curve_index = curve_index + i;
+            m_hit_piece_u = u;
+            m_shading_point.m_ray.m_tmax = t;
+            m_shading_point.m_bary[0] = v;
+            m_shading_point.m_bary[1] = curve_key.m_u_begin + u * (curve_key.m_u_end - curve_key.m_u_begin);
+        }
+    }
+
+    FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(curve_count));
+
+    // Continue traversal.
+    distance = m_shading_point.m_ray.m_tmax;
+    return true;
+}
+
+inline void CurveLeafVisitor::read_hit_curve_data() const
+{
+    if (m_hit_curve)
+    {
+        // Record a hit.
+        m_shading_point.m_hit = true;
+        m_shading_point.m_primitive_type = ShadingPoint::PrimitiveCurve;
+
+        // Copy the curve key.
+        const CurveKey& curve_key = m_tree.m_curve_keys[m_hit_curve_index];
+        m_shading_point.m_object_instance_index = curve_key.m_object_instance_index;
+        m_shading_point.m_region_index = 0;
+        m_shading_point.m_triangle_index = curve_key.m_segment_index;
+
+        // Compute and store the support plane of the ribbon at the hit point.
+        const CurveType curve(*m_hit_curve);
+        const foundation::Vector3d& dir = m_shading_point.m_ray.m_dir;
+        const foundation::Vector3d p = m_shading_point.m_ray.point_at(m_shading_point.m_ray.m_tmax);
+        const foundation::Vector3d tangent = curve.evaluate_tangent(m_hit_piece_u);
+        foundation::Vector3d side = foundation::cross(dir, tangent);
+        if (foundation::square_norm(side) == 0.0)
+            side = foundation::Basis3d(foundation::normalize(dir)).get_tangent_u();
+        m_shading_point.m_triangle_support_plane.initialize(
+            TriangleType(p, p + side, p + tangent));
+    }
+}
+
+
+//
+// CurveLeafProbeVisitor class implementation.
+//
+
+inline CurveLeafProbeVisitor::CurveLeafProbeVisitor(
+    const CurveTree&                        tree,
+    const ShadingPoint*                     parent_shading_point,
+    TraversalCounters&                      counters)
+  : m_tree(tree)
+  , m_counters(counters)
+  , m_skipped_curve_key(CurveKey::from_shading_point(parent_shading_point))
+{
+}
+
+inline bool CurveLeafProbeVisitor::visit(
+    const CurveTree::NodeType&              node,
+    const ShadingRay&                       ray,
+    const ShadingRay::RayInfoType&          ray_info,
+    double&                                 distance
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+    , foundation::bvh::TraversalStatistics& stats
+#endif
+    )
+{
+    const size_t curve_index = node.get_item_index();
+    const size_t curve_count = node.get_item_count();
+
+    // Update traversal counters.
+    ++m_counters.m_curve_leaf_visits;
+
+    // Sequentially intersect curve pieces until a hit is found.
+    for (size_t i = 0; i < curve_count; ++i)
+    {
+        ++m_counters.m_curve_tests;
+
+        // Skip the segment the ray originates from.
+        if (m_tree.m_curve_keys[curve_index + i].is_same_segment(m_skipped_curve_key))
+            continue;
+
+        // Load the curve piece, converting it to the right format.
+        const CurveType reader(m_tree.m_curves[curve_index + i]);
+
+        // Intersect the curve piece.
+        if (foundation::intersect(ray, reader))
+        {
+            FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(i + 1));
+            m_hit = true;
+            return false;
+        }
+    }
+
+    FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(curve_count));
+
+    // Continue traversal.
+    distance = ray.m_tmax;
+    return true;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_CURVETREE_H
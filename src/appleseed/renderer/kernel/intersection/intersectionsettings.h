@@ -67,6 +67,13 @@ const double AssemblyTreeInteriorNodeTraversalCost = 1.0;
 // Relative cost of intersecting an assembly.
 const double AssemblyTreeTriangleIntersectionCost = 10.0;
 
+// Maximum depth of temporal splits, the tree is split in at most 2^depth time intervals.
+const size_t AssemblyTreeMaxTemporalSplitDepth = 2;
+
+// Split the tree in time when assembly instances sweep a surface this many times larger
+// than the one they cover at any instant.
+const double AssemblyTreeTemporalSplitThreshold = 2.0;
+
 
 //
 // Region tree settings.
@@ -102,6 +109,13 @@ const GScalar TriangleTreeDefaultTriangleIntersectionCost(1.0);
 // Number of bins used during SBVH construction.
 const size_t TriangleTreeDefaultBinCount = 256;
 
+// Maximum depth of temporal splits, the tree is split in at most 2^depth time intervals.
+const size_t TriangleTreeDefaultMaxTemporalSplitDepth = 3;
+
+// Split the tree in time when triangles sweep a surface this many times larger
+// than the one they cover at any instant.
+const GScalar TriangleTreeDefaultTemporalSplitThreshold(2.0);
+
 // Define this symbol to enable reordering the nodes of triangle trees for better
 // locality of reference. Requires a lot of temporary memory for minimal results.
 #undef RENDERER_TRIANGLE_TREE_REORDER_NODES
@@ -117,6 +131,33 @@ const size_t TriangleTreeAccessCacheWays = 2;
 const size_t TriangleTreeStackSize = 64;
 
 
+//
+// Curve tree settings.
+//
+
+// Curve format used for intersection.
+typedef foundation::BezierCurve3<double> CurveType;
+
+// Maximum number of curve pieces per leaf.
+const size_t CurveTreeDefaultMaxLeafSize = 2;
+
+// Relative cost of traversing an interior node.
+const GScalar CurveTreeDefaultInteriorNodeTraversalCost(1.0);
+
+// Relative cost of intersecting a curve piece.
+const GScalar CurveTreeDefaultCurveIntersectionCost(4.0);
+
+// Maximum number of times a curve segment is halved to tighten the bounding boxes of the tree.
+const size_t CurveTreeDefaultMaxSplitDepth = 3;
+
+// Halve a curve piece when the surface area of the bounding boxes of the halves is less
+// than this fraction of the surface area of the bounding box of the piece.
+const GScalar CurveTreeDefaultSplitThreshold(0.7);
+
+// Size of the stack (in number of nodes) used during traversal.
+const size_t CurveTreeStackSize = 64;
+
+
 //
 // Miscellaneous settings.
 //
@@ -39,6 +39,7 @@
 #include "renderer/modeling/scene/assemblyinstance.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/scalar.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/utility/casts.h"
 #include "foundation/utility/statistics.h"
@@ -65,6 +66,8 @@ Intersector::Intersector(
   , m_shading_ray_count(0)
   , m_probe_ray_count(0)
 {
+    for (size_t i = 0; i < ShadingRay::NumTypes; ++i)
+        m_ray_counts[i] = 0;
 }
 
 Vector3d Intersector::refine(
@@ -201,6 +204,17 @@ void Intersector::adaptive_offset(
 
 namespace
 {
+    // Return the index of the type of a ray, in [0, ShadingRay::NumTypes).
+    inline size_t ray_type_index(const ShadingRay& ray)
+    {
+        assert(ray.m_type != 0);
+
+        const size_t index = int_log2(static_cast<uint32>(ray.m_type));
+        assert(index < ShadingRay::NumTypes);
+
+        return index;
+    }
+
     // Return true if two shading points reference the same triangle.
     inline bool same_triangle(
         const ShadingPoint&         lhs,
@@ -213,7 +227,8 @@ namespace
             lhs.get_triangle_index() == rhs.get_triangle_index() &&
             lhs.get_region_index() == rhs.get_region_index() &&
             lhs.get_object_instance_index() == rhs.get_object_instance_index() &&
-            lhs.get_assembly_instance().get_uid() == rhs.get_assembly_instance().get_uid();
+            lhs.get_assembly_instance().get_uid() == rhs.get_assembly_instance().get_uid() &&
+            lhs.get_instance_array_index() == rhs.get_instance_array_index();
     }
 
     // Print a message if a self-intersection situation is detected.
@@ -244,6 +259,7 @@ bool Intersector::trace(
 
     // Update ray casting statistics.
     ++m_shading_ray_count;
+    ++m_ray_counts[ray_type_index(ray)];
 
     // Initialize the shading point.
     shading_point.m_region_kit_cache = &m_region_kit_cache;
@@ -271,20 +287,37 @@ bool Intersector::trace(
         assembly_tree,
         m_region_tree_cache,
         m_triangle_tree_cache,
-        parent_shading_point
+        parent_shading_point,
+        m_traversal_counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , m_triangle_tree_traversal_stats
 #endif
         );
-    intersector.intersect_no_motion(
-        assembly_tree,
-        shading_point.m_ray,
-        ray_info,
-        visitor
+    if (assembly_tree.get_temporal_split_depth() > 0)
+    {
+        intersector.intersect_motion(
+            assembly_tree,
+            shading_point.m_ray,
+            ray_info,
+            shading_point.m_ray.m_time,
+            visitor
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
-        , m_assembly_tree_traversal_stats
+            , m_assembly_tree_traversal_stats
 #endif
-        );
+            );
+    }
+    else
+    {
+        intersector.intersect_no_motion(
+            assembly_tree,
+            shading_point.m_ray,
+            ray_info,
+            visitor
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+            , m_assembly_tree_traversal_stats
+#endif
+            );
+    }
 
     // Detect and report self-intersections.
     if (m_report_self_intersections)
@@ -301,6 +334,7 @@ bool Intersector::trace_probe(
 
     // Update ray casting statistics.
     ++m_probe_ray_count;
+    ++m_ray_counts[ray_type_index(ray)];
 
     // Compute ray info once for the entire traversal.
     const ShadingRay::RayInfoType ray_info(ray);
@@ -320,20 +354,37 @@ bool Intersector::trace_probe(
         assembly_tree,
         m_region_tree_cache,
         m_triangle_tree_cache,
-        parent_shading_point
+        parent_shading_point,
+        m_traversal_counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , m_triangle_tree_traversal_stats
 #endif
         );
-    intersector.intersect_no_motion(
-        assembly_tree,
-        ray,
-        ray_info,
-        visitor
+    if (assembly_tree.get_temporal_split_depth() > 0)
+    {
+        intersector.intersect_motion(
+            assembly_tree,
+            ray,
+            ray_info,
+            ray.m_time,
+            visitor
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
-        , m_assembly_tree_traversal_stats
+            , m_assembly_tree_traversal_stats
 #endif
-        );
+            );
+    }
+    else
+    {
+        intersector.intersect_no_motion(
+            assembly_tree,
+            ray,
+            ray_info,
+            visitor
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+            , m_assembly_tree_traversal_stats
+#endif
+            );
+    }
 
     return visitor.hit();
 }
@@ -342,6 +393,7 @@ void Intersector::manufacture_hit(
     ShadingPoint&                   shading_point,
     const ShadingRay&               shading_ray,
     const AssemblyInstance*         assembly_instance,
+    const size_t                    instance_array_index,
     const Transformd&               assembly_instance_transform,
     const size_t                    object_instance_index,
     const size_t                    region_index,
@@ -355,11 +407,14 @@ void Intersector::manufacture_hit(
     shading_point.m_ray = shading_ray;
     shading_point.m_hit = true;
     shading_point.m_assembly_instance = assembly_instance;
+    shading_point.m_instance_array_index = static_cast<uint32>(instance_array_index);
     shading_point.m_assembly_instance_transform = assembly_instance_transform;
-    shading_point.m_object_instance_index = object_instance_index;
-    shading_point.m_region_index = region_index;
-    shading_point.m_triangle_index = triangle_index;
+    shading_point.m_object_instance_index = static_cast<uint32>(object_instance_index);
+    shading_point.m_region_index = static_cast<uint32>(region_index);
+    shading_point.m_triangle_index = static_cast<uint32>(triangle_index);
+    shading_point.m_primitive_type = ShadingPoint::PrimitiveTriangle;
     shading_point.m_triangle_support_plane = triangle_support_plane;
+    shading_point.m_members = 0;
 }
 
 namespace
@@ -398,9 +453,19 @@ namespace
         {
             return pretty_uint(m_ray_count) + " (" + pretty_percent(m_ray_count, m_total_ray_count) + ")";
         }
+
+        virtual string to_json() const OVERRIDE
+        {
+            return foundation::to_string(m_ray_count);
+        }
     };
 }
 
+uint64 Intersector::get_ray_count() const
+{
+    return m_shading_ray_count + m_probe_ray_count;
+}
+
 StatisticsVector Intersector::get_statistics() const
 {
     const uint64 total_ray_count = m_shading_ray_count + m_probe_ray_count;
@@ -420,9 +485,33 @@ StatisticsVector Intersector::get_statistics() const
                 m_probe_ray_count,
                 total_ray_count)));
 
+    static const char* RayTypeNames[ShadingRay::NumTypes] =
+    {
+        "camera rays",
+        "light rays",
+        "shadow rays",
+        "probe-type rays",
+        "diffuse rays",
+        "glossy rays",
+        "specular rays"
+    };
+
+    Statistics ray_type_stats;
+    for (size_t i = 0; i < ShadingRay::NumTypes; ++i)
+    {
+        ray_type_stats.insert(
+            auto_ptr<RayCountStatisticsEntry>(
+                new RayCountStatisticsEntry(
+                    RayTypeNames[i],
+                    m_ray_counts[i],
+                    total_ray_count)));
+    }
+
     StatisticsVector vec;
 
     vec.insert("intersection statistics", intersection_stats);
+    vec.insert("ray type statistics", ray_type_stats);
+    vec.insert("traversal statistics", m_traversal_counters.get_statistics());
 
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     vec.insert(
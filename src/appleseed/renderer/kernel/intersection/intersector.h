@@ -33,7 +33,9 @@
 // appleseed.renderer headers.
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/regiontree.h"
+#include "renderer/kernel/intersection/traversalcounters.h"
 #include "renderer/kernel/intersection/triangletree.h"
+#include "renderer/kernel/shading/shadingray.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/modeling/object/regionkit.h"
 
@@ -51,7 +53,6 @@
 namespace foundation    { class StatisticsVector; }
 namespace renderer      { class AssemblyInstance; }
 namespace renderer      { class ShadingPoint; }
-namespace renderer      { class ShadingRay; }
 namespace renderer      { class TextureCache; }
 namespace renderer      { class TraceContext; }
 
@@ -107,12 +108,16 @@ class Intersector
         ShadingPoint&                   shading_point,
         const ShadingRay&               shading_ray,
         const AssemblyInstance*         assembly_instance,
+        const size_t                    instance_array_index,
         const foundation::Transformd&   assembly_instance_transform,
         const size_t                    object_instance_index,
         const size_t                    region_index,
         const size_t                    triangle_index,
         const TriangleSupportPlaneType& triangle_support_plane) const;
 
+    // Return the total number of rays traced so far by this intersector.
+    foundation::uint64 get_ray_count() const;
+
     // Retrieve performance statistics.
     foundation::StatisticsVector get_statistics() const;
 
@@ -130,6 +135,8 @@ class Intersector
     // Intersection statistics.
     mutable foundation::uint64                      m_shading_ray_count;
     mutable foundation::uint64                      m_probe_ray_count;
+    mutable foundation::uint64                      m_ray_counts[ShadingRay::NumTypes];
+    mutable TraversalCounters                       m_traversal_counters;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     mutable foundation::bvh::TraversalStatistics    m_assembly_tree_traversal_stats;
     mutable foundation::bvh::TraversalStatistics    m_triangle_tree_traversal_stats;
@@ -504,6 +504,9 @@ double RegionLeafVisitor::visit(
 {
     assert(leaf);
 
+    // Update traversal counters.
+    ++m_counters.m_region_leaf_visits;
+
     // Retrieve the triangle tree of this leaf.
     const TriangleTree* triangle_tree =
         m_triangle_tree_cache.access(
@@ -514,7 +517,7 @@ double RegionLeafVisitor::visit(
     {
         // Check the intersection between the ray and the triangle tree.
         TriangleTreeIntersector intersector;
-        TriangleLeafVisitor visitor(*triangle_tree, m_shading_point);
+        TriangleLeafVisitor visitor(*triangle_tree, m_shading_point, m_counters);
         if (triangle_tree->get_moving_triangle_count() > 0)
         {
             intersector.intersect_motion(
@@ -559,6 +562,9 @@ double RegionLeafProbeVisitor::visit(
 {
     assert(leaf);
 
+    // Update traversal counters.
+    ++m_counters.m_region_leaf_visits;
+
     // Retrieve the triangle tree of this leaf.
     const TriangleTree* triangle_tree =
         m_triangle_tree_cache.access(
@@ -569,7 +575,7 @@ double RegionLeafProbeVisitor::visit(
     {
         // Check the intersection between the ray and the triangle tree.
         TriangleTreeProbeIntersector intersector;
-        TriangleLeafProbeVisitor visitor(*triangle_tree);
+        TriangleLeafProbeVisitor visitor(*triangle_tree, m_counters);
         if (triangle_tree->get_moving_triangle_count() > 0)
         {
             intersector.intersect_motion(
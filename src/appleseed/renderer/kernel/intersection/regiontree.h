@@ -172,7 +172,8 @@ class RegionLeafVisitor
     // Constructor.
     RegionLeafVisitor(
         ShadingPoint&                           shading_point,
-        TriangleTreeAccessCache&                triangle_tree_cache
+        TriangleTreeAccessCache&                triangle_tree_cache,
+        TraversalCounters&                      counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics& triangle_tree_stats
 #endif
@@ -187,6 +188,7 @@ class RegionLeafVisitor
   private:
     ShadingPoint&                               m_shading_point;
     TriangleTreeAccessCache&                    m_triangle_tree_cache;
+    TraversalCounters&                          m_counters;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&       m_triangle_tree_stats;
 #endif
@@ -204,7 +206,8 @@ class RegionLeafProbeVisitor
   public:
     // Constructor.
     RegionLeafProbeVisitor(
-        TriangleTreeAccessCache&                triangle_tree_cache
+        TriangleTreeAccessCache&                triangle_tree_cache,
+        TraversalCounters&                      counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics& triangle_tree_stats
 #endif
@@ -218,6 +221,7 @@ class RegionLeafProbeVisitor
 
   private:
     TriangleTreeAccessCache&                    m_triangle_tree_cache;
+    TraversalCounters&                          m_counters;
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     foundation::bvh::TraversalStatistics&       m_triangle_tree_stats;
 #endif
@@ -272,13 +276,15 @@ inline foundation::UniqueID RegionLeaf::get_triangle_tree_uid() const
 
 inline RegionLeafVisitor::RegionLeafVisitor(
     ShadingPoint&                               shading_point,
-    TriangleTreeAccessCache&                    triangle_tree_cache
+    TriangleTreeAccessCache&                    triangle_tree_cache,
+    TraversalCounters&                          counters
   #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
     )
   : m_shading_point(shading_point)
   , m_triangle_tree_cache(triangle_tree_cache)
+  , m_counters(counters)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -291,12 +297,14 @@ inline RegionLeafVisitor::RegionLeafVisitor(
 //
 
 inline RegionLeafProbeVisitor::RegionLeafProbeVisitor(
-    TriangleTreeAccessCache&                    triangle_tree_cache
+    TriangleTreeAccessCache&                    triangle_tree_cache,
+    TraversalCounters&                          counters
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
     )
   : m_triangle_tree_cache(triangle_tree_cache)
+  , m_counters(counters)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -0,0 +1,100 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_TRAVERSALCOUNTERS_H
+#define APPLESEED_RENDERER_KERNEL_INTERSECTION_TRAVERSALCOUNTERS_H
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+#include "foundation/utility/statistics.h"
+
+namespace renderer
+{
+
+//
+// Lightweight per-thread traversal counters.
+//
+// Unlike foundation::bvh::TraversalStatistics, these counters are always compiled
+// in: each of them is a plain increment on thread-local memory, which costs less
+// than the branch that would be needed to switch them on and off at runtime.
+//
+
+struct TraversalCounters
+{
+    foundation::uint64  m_assembly_leaf_visits;     // number of assembly tree leaves visited
+    foundation::uint64  m_region_leaf_visits;       // number of region tree leaves visited
+    foundation::uint64  m_triangle_leaf_visits;     // number of triangle tree leaves visited
+    foundation::uint64  m_triangle_tests;           // number of ray-triangle intersection tests
+    foundation::uint64  m_curve_leaf_visits;        // number of curve tree leaves visited
+    foundation::uint64  m_curve_tests;              // number of ray-curve intersection tests
+
+    // Constructor, clears all counters.
+    TraversalCounters();
+
+    // Reset all counters to zero.
+    void clear();
+
+    // Retrieve the counters as statistics.
+    foundation::Statistics get_statistics() const;
+};
+
+
+//
+// TraversalCounters class implementation.
+//
+
+inline TraversalCounters::TraversalCounters()
+{
+    clear();
+}
+
+inline void TraversalCounters::clear()
+{
+    m_assembly_leaf_visits = 0;
+    m_region_leaf_visits = 0;
+    m_triangle_leaf_visits = 0;
+    m_triangle_tests = 0;
+    m_curve_leaf_visits = 0;
+    m_curve_tests = 0;
+}
+
+inline foundation::Statistics TraversalCounters::get_statistics() const
+{
+    foundation::Statistics stats;
+    stats.insert("assembly leaves", m_assembly_leaf_visits);
+    stats.insert("region leaves", m_region_leaf_visits);
+    stats.insert("triangle leaves", m_triangle_leaf_visits);
+    stats.insert("triangle tests", m_triangle_tests);
+    stats.insert("curve leaves", m_curve_leaf_visits);
+    stats.insert("curve tests", m_curve_tests);
+    return stats;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_TRAVERSALCOUNTERS_H
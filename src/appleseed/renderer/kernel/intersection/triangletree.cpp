@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemorytracker.h"
 #include "renderer/kernel/intersection/triangleencoder.h"
 #include "renderer/kernel/intersection/triangleitemhandler.h"
 #include "renderer/kernel/intersection/trianglevertexinfo.h"
@@ -52,6 +53,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/area.h"
+#include "foundation/math/bvh/bvh_temporalbuilder.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/treeoptimizer.h"
 #include "foundation/platform/system.h"
@@ -429,6 +431,8 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     // Create intersection filters.
     if (m_arguments.m_assembly.get_parameters().get_optional<bool>("enable_intersection_filters", true))
         update_intersection_filters();
+
+    global_memory_tracker().record_allocation("triangle trees", get_memory_size());
 }
 
 TriangleTree::~TriangleTree()
@@ -437,6 +441,8 @@ TriangleTree::~TriangleTree()
         "deleting triangle tree #" FMT_UNIQUE_ID "...",
         m_arguments.m_triangle_tree_uid);
 
+    global_memory_tracker().record_deallocation("triangle trees", get_memory_size());
+
     delete_intersection_filters();
 }
 
@@ -491,6 +497,321 @@ namespace
 
         return count;
     }
+
+    // Insert the vertices of a triangle at a given time value into a bounding box.
+    void insert_triangle(
+        GAABB3&                             bbox,
+        const TriangleVertexInfo&           vertex_info,
+        const vector<GVector3>&             triangle_vertices,
+        const double                        time)
+    {
+        const size_t motion_segment_count = vertex_info.m_motion_segment_count;
+
+        if (motion_segment_count == 0)
+        {
+            bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 0]);
+            bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 1]);
+            bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 2]);
+            return;
+        }
+
+        const double t = time * motion_segment_count;
+        const size_t prev_pose_index = min(truncate<size_t>(t), motion_segment_count - 1);
+        const size_t base_vertex_index = vertex_info.m_vertex_index + prev_pose_index * 3;
+        const GScalar k = static_cast<GScalar>(t - prev_pose_index);
+
+        bbox.insert(lerp(triangle_vertices[base_vertex_index + 0], triangle_vertices[base_vertex_index + 3], k));
+        bbox.insert(lerp(triangle_vertices[base_vertex_index + 1], triangle_vertices[base_vertex_index + 4], k));
+        bbox.insert(lerp(triangle_vertices[base_vertex_index + 2], triangle_vertices[base_vertex_index + 5], k));
+    }
+
+    // Evaluate a path of equidistant bounding boxes for a given time value in [0,1].
+    GAABB3 interpolate_bboxes(
+        const vector<GAABB3>&               bboxes,
+        const double                        time)
+    {
+        const size_t motion_segment_count = bboxes.size() - 1;
+
+        if (motion_segment_count == 0)
+            return bboxes[0];
+
+        const double t = time * motion_segment_count;
+        const size_t prev_index = min(truncate<size_t>(t), motion_segment_count - 1);
+        const GScalar k = static_cast<GScalar>(t - prev_index);
+
+        return lerp(bboxes[prev_index], bboxes[prev_index + 1], k);
+    }
+
+    // Return the ratio between the surface area swept by the triangles during time
+    // intervals of a given length, and the surface area they cover in the middle of
+    // these intervals.
+    double compute_motion_ratio(
+        const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+        const vector<GVector3>&             triangle_vertices,
+        const size_t                        interval_count)
+    {
+        const size_t triangle_count = triangle_vertex_infos.size();
+
+        double swept_area = 0.0;
+        double instant_area = 0.0;
+
+        for (size_t i = 0; i < triangle_count; ++i)
+        {
+            const TriangleVertexInfo& vertex_info = triangle_vertex_infos[i];
+            const size_t motion_segment_count = vertex_info.m_motion_segment_count;
+
+            for (size_t j = 0; j < interval_count; ++j)
+            {
+                const double time_begin = static_cast<double>(j) / interval_count;
+                const double time_end = static_cast<double>(j + 1) / interval_count;
+
+                GAABB3 instant_bbox;
+                instant_bbox.invalidate();
+                insert_triangle(instant_bbox, vertex_info, triangle_vertices, 0.5 * (time_begin + time_end));
+
+                instant_area += half_surface_area(instant_bbox);
+
+                if (motion_segment_count == 0)
+                {
+                    swept_area += half_surface_area(instant_bbox);
+                    continue;
+                }
+
+                // Vertices move linearly between poses: only the interval bounds
+                // and the poses within the interval need to be considered.
+                GAABB3 swept_bbox = instant_bbox;
+                insert_triangle(swept_bbox, vertex_info, triangle_vertices, time_begin);
+                insert_triangle(swept_bbox, vertex_info, triangle_vertices, time_end);
+
+                for (size_t m = 1; m < motion_segment_count; ++m)
+                {
+                    const double pose_time = static_cast<double>(m) / motion_segment_count;
+
+                    if (pose_time > time_begin && pose_time < time_end)
+                        insert_triangle(swept_bbox, vertex_info, triangle_vertices, pose_time);
+                }
+
+                swept_area += half_surface_area(swept_bbox);
+            }
+        }
+
+        return instant_area > 0.0 ? swept_area / instant_area : 1.0;
+    }
+
+    // Return the number of times the time interval of the tree should be halved.
+    size_t compute_temporal_split_depth(
+        const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+        const vector<GVector3>&             triangle_vertices,
+        const size_t                        max_depth,
+        const double                        threshold)
+    {
+        size_t depth = 0;
+
+        while (depth < max_depth &&
+               compute_motion_ratio(
+                   triangle_vertex_infos,
+                   triangle_vertices,
+                   size_t(1) << depth) > threshold)
+            ++depth;
+
+        return depth;
+    }
+
+    // Compute the bounding boxes of all triangles at a given time value.
+    template <typename AABBType>
+    void compute_triangle_bboxes(
+        const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+        const vector<GVector3>&             triangle_vertices,
+        const double                        time,
+        vector<AABBType>&                   triangle_bboxes)
+    {
+        const size_t triangle_count = triangle_vertex_infos.size();
+
+        triangle_bboxes.resize(triangle_count);
+
+        for (size_t i = 0; i < triangle_count; ++i)
+        {
+            GAABB3 bbox;
+            bbox.invalidate();
+            insert_triangle(bbox, triangle_vertex_infos[i], triangle_vertices, time);
+            triangle_bboxes[i] = AABBType(bbox);
+        }
+    }
+
+    typedef bvh::TemporalBuilder<TriangleTree> TriangleTreeTemporalBuilder;
+    typedef TriangleTreeTemporalBuilder::SubtreeType TriangleSubtree;
+
+    //
+    // Build the subtrees of a temporal triangle tree with the BVH algorithm.
+    //
+
+    class BVHSubtreeBuilder
+      : public NonCopyable
+    {
+      public:
+        BVHSubtreeBuilder(
+            const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+            const vector<GVector3>&             triangle_vertices,
+            const double                        time,
+            const size_t                        max_leaf_size,
+            const GScalar                       interior_node_traversal_cost,
+            const GScalar                       triangle_intersection_cost,
+            vector<size_t>&                     triangle_indices)
+          : m_triangle_vertex_infos(triangle_vertex_infos)
+          , m_triangle_vertices(triangle_vertices)
+          , m_time(time)
+          , m_max_leaf_size(max_leaf_size)
+          , m_interior_node_traversal_cost(interior_node_traversal_cost)
+          , m_triangle_intersection_cost(triangle_intersection_cost)
+          , m_triangle_indices(triangle_indices)
+        {
+        }
+
+        size_t build(
+            TriangleSubtree&                    subtree,
+            const double                        time_begin,
+            const double                        time_end,
+            AABB3d&                             bbox)
+        {
+            // Partition the triangles according to their bounding boxes within the interval.
+            vector<GAABB3> triangle_bboxes;
+            compute_triangle_bboxes(
+                m_triangle_vertex_infos,
+                m_triangle_vertices,
+                time_begin + m_time * (time_end - time_begin),
+                triangle_bboxes);
+
+            typedef bvh::SAHPartitioner<vector<GAABB3> > Partitioner;
+            Partitioner partitioner(
+                triangle_bboxes,
+                m_max_leaf_size,
+                m_interior_node_traversal_cost,
+                m_triangle_intersection_cost);
+
+            const size_t triangle_count = triangle_bboxes.size();
+
+            typedef bvh::Builder<TriangleSubtree, Partitioner> Builder;
+            Builder builder;
+            builder.build<DefaultWallclockTimer>(subtree, partitioner, triangle_count, m_max_leaf_size);
+
+            const vector<size_t>& ordering = partitioner.get_item_ordering();
+            m_triangle_indices.insert(m_triangle_indices.end(), ordering.begin(), ordering.end());
+
+            bbox = AABB3d(partitioner.compute_bbox(0, triangle_count));
+
+            return triangle_count;
+        }
+
+      private:
+        const vector<TriangleVertexInfo>&       m_triangle_vertex_infos;
+        const vector<GVector3>&                 m_triangle_vertices;
+        const double                            m_time;
+        const size_t                            m_max_leaf_size;
+        const GScalar                           m_interior_node_traversal_cost;
+        const GScalar                           m_triangle_intersection_cost;
+        vector<size_t>&                         m_triangle_indices;
+    };
+
+    //
+    // Build the subtrees of a temporal triangle tree with the SBVH algorithm.
+    //
+
+    class SBVHSubtreeBuilder
+      : public NonCopyable
+    {
+      public:
+        SBVHSubtreeBuilder(
+            const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+            const vector<GVector3>&             triangle_vertices,
+            const double                        time,
+            const size_t                        max_leaf_size,
+            const size_t                        bin_count,
+            const GScalar                       interior_node_traversal_cost,
+            const GScalar                       triangle_intersection_cost,
+            vector<size_t>&                     triangle_indices)
+          : m_triangle_vertex_infos(triangle_vertex_infos)
+          , m_triangle_vertices(triangle_vertices)
+          , m_time(time)
+          , m_max_leaf_size(max_leaf_size)
+          , m_bin_count(bin_count)
+          , m_interior_node_traversal_cost(interior_node_traversal_cost)
+          , m_triangle_intersection_cost(triangle_intersection_cost)
+          , m_triangle_indices(triangle_indices)
+          , m_spatial_split_count(0)
+          , m_object_split_count(0)
+        {
+        }
+
+        size_t build(
+            TriangleSubtree&                    subtree,
+            const double                        time_begin,
+            const double                        time_end,
+            AABB3d&                             bbox)
+        {
+            // Partition the triangles according to their bounding boxes within the interval.
+            vector<AABB3d> triangle_bboxes;
+            compute_triangle_bboxes(
+                m_triangle_vertex_infos,
+                m_triangle_vertices,
+                time_begin + m_time * (time_end - time_begin),
+                triangle_bboxes);
+
+            typedef bvh::SBVHPartitioner<TriangleItemHandler, vector<AABB3d> > Partitioner;
+            TriangleItemHandler triangle_handler(
+                m_triangle_vertex_infos,
+                m_triangle_vertices,
+                triangle_bboxes);
+            Partitioner partitioner(
+                triangle_handler,
+                triangle_bboxes,
+                m_max_leaf_size,
+                m_bin_count,
+                m_interior_node_traversal_cost,
+                m_triangle_intersection_cost);
+
+            Partitioner::LeafType* root_leaf = partitioner.create_root_leaf();
+            bbox = partitioner.compute_leaf_bbox(*root_leaf);
+
+            typedef bvh::SpatialBuilder<TriangleSubtree, Partitioner> Builder;
+            Builder builder;
+            builder.build<DefaultWallclockTimer>(
+                subtree,
+                partitioner,
+                root_leaf,
+                bbox);
+
+            m_spatial_split_count += partitioner.get_spatial_split_count();
+            m_object_split_count += partitioner.get_object_split_count();
+
+            // Spatial splits may reference triangles multiple times.
+            const vector<size_t>& ordering = partitioner.get_item_ordering();
+            m_triangle_indices.insert(m_triangle_indices.end(), ordering.begin(), ordering.end());
+
+            return ordering.size();
+        }
+
+        size_t get_spatial_split_count() const
+        {
+            return m_spatial_split_count;
+        }
+
+        size_t get_object_split_count() const
+        {
+            return m_object_split_count;
+        }
+
+      private:
+        const vector<TriangleVertexInfo>&       m_triangle_vertex_infos;
+        const vector<GVector3>&                 m_triangle_vertices;
+        const double                            m_time;
+        const size_t                            m_max_leaf_size;
+        const size_t                            m_bin_count;
+        const GScalar                           m_interior_node_traversal_cost;
+        const GScalar                           m_triangle_intersection_cost;
+        vector<size_t>&                         m_triangle_indices;
+        size_t                                  m_spatial_split_count;
+        size_t                                  m_object_split_count;
+    };
 }
 
 void TriangleTree::build_bvh(
@@ -520,39 +841,95 @@ void TriangleTree::build_bvh(
         &triangle_vertex_infos,
         0,
         &triangle_bboxes);
-    const double collection_time = stopwatch.measure().get_seconds();
 
     // Store the number of static and moving triangles.
     m_static_triangle_count = count_static_triangles(triangle_vertex_infos);
     m_moving_triangle_count = triangle_vertex_infos.size() - m_static_triangle_count;
 
+    // Retrieving the partitioner parameters.
+    const size_t max_leaf_size = params.get_optional<size_t>("max_leaf_size", TriangleTreeDefaultMaxLeafSize);
+    const GScalar interior_node_travesal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", TriangleTreeDefaultInteriorNodeTraversalCost);
+    const GScalar triangle_intersection_cost = params.get_optional<GScalar>("triangle_intersection_cost", TriangleTreeDefaultTriangleIntersectionCost);
+    const size_t max_temporal_split_depth = params.get_optional<size_t>("max_temporal_split_depth", TriangleTreeDefaultMaxTemporalSplitDepth);
+    const GScalar temporal_split_threshold = params.get_optional<GScalar>("temporal_split_threshold", TriangleTreeDefaultTemporalSplitThreshold);
+
+    // Decide whether the tree should be split in time. The triangle vertices are
+    // needed to take that decision, otherwise they are collected after the build.
+    vector<GVector3> triangle_vertices;
+    size_t temporal_split_depth = 0;
+    if (m_moving_triangle_count > 0 && max_temporal_split_depth > 0)
+    {
+        collect_triangles<GAABB3>(
+            m_arguments,
+            time,
+            save_memory,
+            0,
+            0,
+            &triangle_vertices,
+            0);
+
+        temporal_split_depth =
+            compute_temporal_split_depth(
+                triangle_vertex_infos,
+                triangle_vertices,
+                max_temporal_split_depth,
+                temporal_split_threshold);
+    }
+
+    const double collection_time = stopwatch.measure().get_seconds();
+
     // Print statistics about the input geometry.
     RENDERER_LOG_INFO(
-        "building bvh triangle tree #" FMT_UNIQUE_ID " (%s %s, %s %s)...",
+        "building bvh triangle tree #" FMT_UNIQUE_ID " (%s %s, %s %s, %s %s)...",
         m_arguments.m_triangle_tree_uid,
         pretty_uint(m_static_triangle_count).c_str(),
         plural(m_static_triangle_count, "static triangle").c_str(),
         pretty_uint(m_moving_triangle_count).c_str(),
-        plural(m_moving_triangle_count, "moving triangle").c_str());
-
-    // Retrieving the partitioner parameters.
-    const size_t max_leaf_size = params.get_optional<size_t>("max_leaf_size", TriangleTreeDefaultMaxLeafSize);
-    const GScalar interior_node_travesal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", TriangleTreeDefaultInteriorNodeTraversalCost);
-    const GScalar triangle_intersection_cost = params.get_optional<GScalar>("triangle_intersection_cost", TriangleTreeDefaultTriangleIntersectionCost);
-
-    // Create the partitioner.
-    typedef bvh::SAHPartitioner<vector<GAABB3> > Partitioner;
-    Partitioner partitioner(
-        triangle_bboxes,
-        max_leaf_size,
-        interior_node_travesal_cost,
-        triangle_intersection_cost);
+        plural(m_moving_triangle_count, "moving triangle").c_str(),
+        pretty_uint(size_t(1) << temporal_split_depth).c_str(),
+        plural(size_t(1) << temporal_split_depth, "time interval").c_str());
 
     // Build the tree.
-    typedef bvh::Builder<TriangleTree, Partitioner> Builder;
-    Builder builder;
-    builder.build<DefaultWallclockTimer>(*this, partitioner, triangle_keys.size(), max_leaf_size);
+    vector<size_t> triangle_indices;
+    double build_time;
+    if (temporal_split_depth > 0)
+    {
+        // Bounding boxes are recomputed for each time interval.
+        clear_release_memory(triangle_bboxes);
+
+        BVHSubtreeBuilder subtree_builder(
+            triangle_vertex_infos,
+            triangle_vertices,
+            time,
+            max_leaf_size,
+            interior_node_travesal_cost,
+            triangle_intersection_cost,
+            triangle_indices);
+
+        TriangleTreeTemporalBuilder builder;
+        builder.build<DefaultWallclockTimer>(*this, subtree_builder, temporal_split_depth);
+        build_time = builder.get_build_time();
+    }
+    else
+    {
+        // Create the partitioner.
+        typedef bvh::SAHPartitioner<vector<GAABB3> > Partitioner;
+        Partitioner partitioner(
+            triangle_bboxes,
+            max_leaf_size,
+            interior_node_travesal_cost,
+            triangle_intersection_cost);
+
+        // Build the tree.
+        typedef bvh::Builder<TriangleTree, Partitioner> Builder;
+        Builder builder;
+        builder.build<DefaultWallclockTimer>(*this, partitioner, triangle_keys.size(), max_leaf_size);
+        build_time = builder.get_build_time();
+
+        triangle_indices = partitioner.get_item_ordering();
+    }
     statistics.merge(bvh::TreeStatistics<TriangleTree>(*this, AABB3d(m_arguments.m_bbox)));
+    statistics.insert("temporal split depth", temporal_split_depth);
 
     stopwatch.start();
 
@@ -560,26 +937,30 @@ void TriangleTree::build_bvh(
     clear_release_memory(triangle_bboxes);
 
     // Collect triangle vertices.
-    vector<GVector3> triangle_vertices;
-    collect_triangles<GAABB3>(
-        m_arguments,
-        time,
-        save_memory,
-        0,
-        0,
-        &triangle_vertices,
-        0);
+    if (triangle_vertices.empty())
+    {
+        collect_triangles<GAABB3>(
+            m_arguments,
+            time,
+            save_memory,
+            0,
+            0,
+            &triangle_vertices,
+            0);
+    }
 
     // Compute and propagate motion bounding boxes.
     compute_motion_bboxes(
-        partitioner.get_item_ordering(),
+        triangle_indices,
         triangle_vertex_infos,
         triangle_vertices,
-        0);
+        0,
+        0.0,
+        1.0);
 
     // Store triangles and triangle keys into the tree.
     store_triangles(
-        partitioner.get_item_ordering(),
+        triangle_indices,
         triangle_vertex_infos,
         triangle_vertices,
         triangle_keys,
@@ -588,7 +969,7 @@ void TriangleTree::build_bvh(
     const double storing_time = stopwatch.measure().get_seconds();
 
     statistics.insert_time("collection time", collection_time);
-    statistics.insert_time("partition time", builder.get_build_time());
+    statistics.insert_time("partition time", build_time);
     statistics.insert_time("store time", storing_time);
 }
 
@@ -620,58 +1001,108 @@ void TriangleTree::build_sbvh(
         &triangle_vertex_infos,
         &triangle_vertices,
         &triangle_bboxes);
-    const double collection_time = stopwatch.measure().get_seconds();
 
     // Store the number of static and moving triangles.
     m_static_triangle_count = count_static_triangles(triangle_vertex_infos);
     m_moving_triangle_count = triangle_vertex_infos.size() - m_static_triangle_count;
 
-    // Print statistics about the input geometry.
-    RENDERER_LOG_INFO(
-        "building sbvh triangle tree #" FMT_UNIQUE_ID " (%s %s, %s %s)...",
-        m_arguments.m_triangle_tree_uid,
-        pretty_uint(m_static_triangle_count).c_str(),
-        plural(m_static_triangle_count, "static triangle").c_str(),
-        pretty_uint(m_moving_triangle_count).c_str(),
-        plural(m_moving_triangle_count, "moving triangle").c_str());
-
     // Retrieving the partitioner parameters.
     const size_t max_leaf_size = params.get_optional<size_t>("max_leaf_size", TriangleTreeDefaultMaxLeafSize);
     const size_t bin_count = params.get_optional<size_t>("bin_count", TriangleTreeDefaultBinCount);
     const GScalar interior_node_travesal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", TriangleTreeDefaultInteriorNodeTraversalCost);
     const GScalar triangle_intersection_cost = params.get_optional<GScalar>("triangle_intersection_cost", TriangleTreeDefaultTriangleIntersectionCost);
+    const size_t max_temporal_split_depth = params.get_optional<size_t>("max_temporal_split_depth", TriangleTreeDefaultMaxTemporalSplitDepth);
+    const GScalar temporal_split_threshold = params.get_optional<GScalar>("temporal_split_threshold", TriangleTreeDefaultTemporalSplitThreshold);
+
+    // Decide whether the tree should be split in time.
+    const size_t temporal_split_depth =
+        m_moving_triangle_count > 0
+            ? compute_temporal_split_depth(
+                  triangle_vertex_infos,
+                  triangle_vertices,
+                  max_temporal_split_depth,
+                  temporal_split_threshold)
+            : 0;
 
-    // Create the partitioner.
-    typedef bvh::SBVHPartitioner<TriangleItemHandler, vector<AABB3d> > Partitioner;
-    TriangleItemHandler triangle_handler(
-        triangle_vertex_infos,
-        triangle_vertices,
-        triangle_bboxes);
-    Partitioner partitioner(
-        triangle_handler,
-        triangle_bboxes,
-        max_leaf_size,
-        bin_count,
-        interior_node_travesal_cost,
-        triangle_intersection_cost);
-
-    // Create the root leaf.
-    Partitioner::LeafType* root_leaf = partitioner.create_root_leaf();
-    const AABB3d root_leaf_bbox = partitioner.compute_leaf_bbox(*root_leaf);
+    const double collection_time = stopwatch.measure().get_seconds();
+
+    // Print statistics about the input geometry.
+    RENDERER_LOG_INFO(
+        "building sbvh triangle tree #" FMT_UNIQUE_ID " (%s %s, %s %s, %s %s)...",
+        m_arguments.m_triangle_tree_uid,
+        pretty_uint(m_static_triangle_count).c_str(),
+        plural(m_static_triangle_count, "static triangle").c_str(),
+        pretty_uint(m_moving_triangle_count).c_str(),
+        plural(m_moving_triangle_count, "moving triangle").c_str(),
+        pretty_uint(size_t(1) << temporal_split_depth).c_str(),
+        plural(size_t(1) << temporal_split_depth, "time interval").c_str());
 
     // Build the tree.
-    typedef bvh::SpatialBuilder<TriangleTree, Partitioner> Builder;
-    Builder builder;
-    builder.build<DefaultWallclockTimer>(
-        *this,
-        partitioner,
-        root_leaf,
-        root_leaf_bbox);
+    vector<size_t> triangle_indices;
+    double build_time;
+    size_t spatial_splits;
+    size_t object_splits;
+    if (temporal_split_depth > 0)
+    {
+        // Bounding boxes are recomputed for each time interval.
+        clear_release_memory(triangle_bboxes);
+
+        SBVHSubtreeBuilder subtree_builder(
+            triangle_vertex_infos,
+            triangle_vertices,
+            time,
+            max_leaf_size,
+            bin_count,
+            interior_node_travesal_cost,
+            triangle_intersection_cost,
+            triangle_indices);
+
+        TriangleTreeTemporalBuilder builder;
+        builder.build<DefaultWallclockTimer>(*this, subtree_builder, temporal_split_depth);
+        build_time = builder.get_build_time();
+
+        spatial_splits = subtree_builder.get_spatial_split_count();
+        object_splits = subtree_builder.get_object_split_count();
+    }
+    else
+    {
+        // Create the partitioner.
+        typedef bvh::SBVHPartitioner<TriangleItemHandler, vector<AABB3d> > Partitioner;
+        TriangleItemHandler triangle_handler(
+            triangle_vertex_infos,
+            triangle_vertices,
+            triangle_bboxes);
+        Partitioner partitioner(
+            triangle_handler,
+            triangle_bboxes,
+            max_leaf_size,
+            bin_count,
+            interior_node_travesal_cost,
+            triangle_intersection_cost);
+
+        // Create the root leaf.
+        Partitioner::LeafType* root_leaf = partitioner.create_root_leaf();
+        const AABB3d root_leaf_bbox = partitioner.compute_leaf_bbox(*root_leaf);
+
+        // Build the tree.
+        typedef bvh::SpatialBuilder<TriangleTree, Partitioner> Builder;
+        Builder builder;
+        builder.build<DefaultWallclockTimer>(
+            *this,
+            partitioner,
+            root_leaf,
+            root_leaf_bbox);
+        build_time = builder.get_build_time();
+
+        spatial_splits = partitioner.get_spatial_split_count();
+        object_splits = partitioner.get_object_split_count();
+
+        triangle_indices = partitioner.get_item_ordering();
+    }
     statistics.merge(bvh::TreeStatistics<TriangleTree>(*this, AABB3d(m_arguments.m_bbox)));
+    statistics.insert("temporal split depth", temporal_split_depth);
 
     // Add splits statistics.
-    const size_t spatial_splits = partitioner.get_spatial_split_count();
-    const size_t object_splits = partitioner.get_object_split_count();
     const size_t total_splits = spatial_splits + object_splits; 
     statistics.insert(
         "splits",
@@ -685,14 +1116,16 @@ void TriangleTree::build_sbvh(
 
     // Compute and propagate motion bounding boxes.
     compute_motion_bboxes(
-        partitioner.get_item_ordering(),
+        triangle_indices,
         triangle_vertex_infos,
         triangle_vertices,
-        0);
+        0,
+        0.0,
+        1.0);
 
     // Store triangles and triangle keys into the tree.
     store_triangles(
-        partitioner.get_item_ordering(),
+        triangle_indices,
         triangle_vertex_infos,
         triangle_vertices,
         triangle_keys,
@@ -701,7 +1134,7 @@ void TriangleTree::build_sbvh(
     const double storing_time = stopwatch.measure().get_seconds();
 
     statistics.insert_time("collection time", collection_time);
-    statistics.insert_time("partition time", builder.get_build_time());
+    statistics.insert_time("partition time", build_time);
     statistics.insert_time("store time", storing_time);
 }
 
@@ -754,25 +1187,55 @@ vector<GAABB3> TriangleTree::compute_motion_bboxes(
     const vector<size_t>&               triangle_indices,
     const vector<TriangleVertexInfo>&   triangle_vertex_infos,
     const vector<GVector3>&             triangle_vertices,
-    const size_t                        node_index)
+    const size_t                        node_index,
+    const double                        time_begin,
+    const double                        time_end)
 {
     NodeType& node = m_nodes[node_index];
 
-    if (node.is_interior())
+    if (node.is_temporal_interior())
+    {
+        // The children of temporal interior nodes cover each half of the time interval.
+        const double time_middle = 0.5 * (time_begin + time_end);
+
+        compute_motion_bboxes(
+            triangle_indices,
+            triangle_vertex_infos,
+            triangle_vertices,
+            node.get_child_node_index() + 0,
+            time_begin,
+            time_middle);
+
+        compute_motion_bboxes(
+            triangle_indices,
+            triangle_vertex_infos,
+            triangle_vertices,
+            node.get_child_node_index() + 1,
+            time_middle,
+            time_end);
+
+        // Temporal interior nodes have no motion bounding boxes.
+        return vector<GAABB3>();
+    }
+    else if (node.is_interior())
     {
         const vector<GAABB3> left_bboxes =
             compute_motion_bboxes(
                 triangle_indices,
                 triangle_vertex_infos,
                 triangle_vertices,
-                node.get_child_node_index() + 0);
+                node.get_child_node_index() + 0,
+                time_begin,
+                time_end);
 
         const vector<GAABB3> right_bboxes =
             compute_motion_bboxes(
                 triangle_indices,
                 triangle_vertex_infos,
                 triangle_vertices,
-                node.get_child_node_index() + 1);
+                node.get_child_node_index() + 1,
+                time_begin,
+                time_end);
 
         node.set_left_bbox_count(left_bboxes.size());
         node.set_right_bbox_count(right_bboxes.size());
@@ -793,83 +1256,19 @@ vector<GAABB3> TriangleTree::compute_motion_bboxes(
                 m_node_bboxes.push_back(swizzle(AABB3d(*i)));
         }
 
-        const size_t bbox_count = max(left_bboxes.size(), right_bboxes.size());
-        vector<GAABB3> bboxes(bbox_count);
-
-        for (size_t i = 0; i < bbox_count; ++i)
-        {
-            bboxes[i] = left_bboxes[i * left_bboxes.size() / bbox_count];
-            bboxes[i].insert(right_bboxes[i * right_bboxes.size() / bbox_count]);
-        }
-
-        return bboxes;
+        return merge_motion_bboxes(left_bboxes, right_bboxes);
     }
     else
     {
-        const size_t item_begin = node.get_item_index();
-        const size_t item_count = node.get_item_count();
-
-        size_t max_motion_segment_count = 0;
-
-        GAABB3 base_pose_bbox;
-        base_pose_bbox.invalidate();
-
-        for (size_t i = 0; i < item_count; ++i)
-        {
-            const size_t triangle_index = triangle_indices[item_begin + i];
-            const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
-
-            assert(is_pow2(vertex_info.m_motion_segment_count + 1));
-
-            if (max_motion_segment_count < vertex_info.m_motion_segment_count)
-                max_motion_segment_count = vertex_info.m_motion_segment_count;
-
-            base_pose_bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 0]);
-            base_pose_bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 1]);
-            base_pose_bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 2]);
-        }
-
-        vector<GAABB3> bboxes(max_motion_segment_count + 1);
-        bboxes[0] = base_pose_bbox;
-
-        if (max_motion_segment_count > 0)
-        {
-            for (size_t m = 0; m < max_motion_segment_count - 1; ++m)
-            {
-                bboxes[m + 1].invalidate();
-
-                const double time = static_cast<double>(m + 1) / max_motion_segment_count;
-
-                for (size_t i = 0; i < item_count; ++i)
-                {
-                    const size_t triangle_index = triangle_indices[item_begin + i];
-                    const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
-
-                    const size_t prev_pose_index = truncate<size_t>(time * vertex_info.m_motion_segment_count);
-                    const size_t base_vertex_index = vertex_info.m_vertex_index + prev_pose_index * 3;
-                    const GScalar k = static_cast<GScalar>(time * vertex_info.m_motion_segment_count - prev_pose_index);
-
-                    bboxes[m + 1].insert(lerp(triangle_vertices[base_vertex_index + 0], triangle_vertices[base_vertex_index + 3], k));
-                    bboxes[m + 1].insert(lerp(triangle_vertices[base_vertex_index + 1], triangle_vertices[base_vertex_index + 4], k));
-                    bboxes[m + 1].insert(lerp(triangle_vertices[base_vertex_index + 2], triangle_vertices[base_vertex_index + 5], k));
-                }
-            }
-
-            bboxes[max_motion_segment_count].invalidate();
-
-            for (size_t i = 0; i < item_count; ++i)
-            {
-                const size_t triangle_index = triangle_indices[item_begin + i];
-                const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
-                const size_t base_vertex_index = vertex_info.m_vertex_index + vertex_info.m_motion_segment_count * 3;
-
-                bboxes[max_motion_segment_count].insert(triangle_vertices[base_vertex_index + 0]);
-                bboxes[max_motion_segment_count].insert(triangle_vertices[base_vertex_index + 1]);
-                bboxes[max_motion_segment_count].insert(triangle_vertices[base_vertex_index + 2]);
-            }
-        }
-
-        return bboxes;
+        return
+            compute_triangle_motion_bboxes(
+                triangle_indices,
+                node.get_item_index(),
+                node.get_item_count(),
+                triangle_vertex_infos,
+                triangle_vertices,
+                time_begin,
+                time_end);
     }
 }
 
@@ -1270,6 +1669,152 @@ void TriangleTree::delete_intersection_filters()
 }
 
 
+//
+// Motion bounding boxes implementation.
+//
+
+namespace
+{
+    // Insert a bounding box at a given time value in [0,1] into the two keys of a path
+    // of equidistant bounding boxes that surround this time value.
+    void insert_between_keys(
+        vector<GAABB3>&                     bboxes,
+        const double                        time,
+        const GAABB3&                       bbox)
+    {
+        const size_t motion_segment_count = bboxes.size() - 1;
+        const double t = time * motion_segment_count;
+        const size_t prev_index = min(truncate<size_t>(t), motion_segment_count - 1);
+
+        bboxes[prev_index].insert(bbox);
+        bboxes[prev_index + 1].insert(bbox);
+    }
+}
+
+vector<GAABB3> compute_triangle_motion_bboxes(
+    const vector<size_t>&               triangle_indices,
+    const size_t                        item_begin,
+    const size_t                        item_count,
+    const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+    const vector<GVector3>&             triangle_vertices,
+    const double                        time_begin,
+    const double                        time_end)
+{
+    // Bounding boxes are placed at the poses of the triangles falling within the
+    // time interval, or at its bounds if a single motion segment spans the interval.
+    const double time_length = time_end - time_begin;
+    size_t max_motion_segment_count = 0;
+
+    for (size_t i = 0; i < item_count; ++i)
+    {
+        const size_t triangle_index = triangle_indices[item_begin + i];
+        const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
+
+        assert(is_pow2(vertex_info.m_motion_segment_count + 1));
+
+        if (vertex_info.m_motion_segment_count > 0)
+        {
+            const size_t motion_segment_count =
+                max<size_t>(round<size_t>(vertex_info.m_motion_segment_count * time_length), 1);
+
+            if (max_motion_segment_count < motion_segment_count)
+                max_motion_segment_count = motion_segment_count;
+        }
+    }
+
+    vector<GAABB3> bboxes(max_motion_segment_count + 1);
+
+    for (size_t m = 0; m <= max_motion_segment_count; ++m)
+    {
+        const double time =
+            m < max_motion_segment_count
+                ? time_begin + time_length * m / max_motion_segment_count
+                : time_end;
+
+        bboxes[m].invalidate();
+
+        for (size_t i = 0; i < item_count; ++i)
+        {
+            const size_t triangle_index = triangle_indices[item_begin + i];
+
+            insert_triangle(
+                bboxes[m],
+                triangle_vertex_infos[triangle_index],
+                triangle_vertices,
+                time);
+        }
+    }
+
+    if (max_motion_segment_count == 0)
+        return bboxes;
+
+    // Poses that do not coincide with a bounding box would be missed by the linear
+    // interpolation of the bounding boxes: insert them into both surrounding boxes.
+    for (size_t i = 0; i < item_count; ++i)
+    {
+        const size_t triangle_index = triangle_indices[item_begin + i];
+        const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
+        const size_t motion_segment_count = vertex_info.m_motion_segment_count;
+
+        for (size_t m = 1; m < motion_segment_count; ++m)
+        {
+            const double pose_time = static_cast<double>(m) / motion_segment_count;
+
+            if (pose_time <= time_begin || pose_time >= time_end)
+                continue;
+
+            GAABB3 pose_bbox;
+            pose_bbox.invalidate();
+            insert_triangle(pose_bbox, vertex_info, triangle_vertices, pose_time);
+
+            insert_between_keys(bboxes, (pose_time - time_begin) / time_length, pose_bbox);
+        }
+    }
+
+    return bboxes;
+}
+
+vector<GAABB3> merge_motion_bboxes(
+    const vector<GAABB3>&               left_bboxes,
+    const vector<GAABB3>&               right_bboxes)
+{
+    // The bounding boxes of the child with the fewest motion segments are interpolated
+    // at the times of the bounding boxes of the other child.
+    const size_t bbox_count = max(left_bboxes.size(), right_bboxes.size());
+    vector<GAABB3> bboxes(bbox_count);
+
+    for (size_t i = 0; i < bbox_count; ++i)
+    {
+        const double time = bbox_count > 1 ? static_cast<double>(i) / (bbox_count - 1) : 0.0;
+        bboxes[i] = interpolate_bboxes(left_bboxes, time);
+        bboxes[i].insert(interpolate_bboxes(right_bboxes, time));
+    }
+
+    if (bbox_count == 1)
+        return bboxes;
+
+    // When the key counts of the children are not nested, some keys of the child with
+    // the fewest motion segments fall between two keys of the merged path: insert them
+    // into both surrounding keys.
+    const vector<GAABB3>& coarse_bboxes =
+        left_bboxes.size() < right_bboxes.size() ? left_bboxes : right_bboxes;
+    const size_t coarse_segment_count = coarse_bboxes.size() - 1;
+
+    for (size_t i = 1; i < coarse_segment_count; ++i)
+    {
+        if (i * (bbox_count - 1) % coarse_segment_count == 0)
+            continue;
+
+        insert_between_keys(
+            bboxes,
+            static_cast<double>(i) / coarse_segment_count,
+            coarse_bboxes[i]);
+    }
+
+    return bboxes;
+}
+
+
 //
 // TriangleTreeFactory class implementation.
 //
@@ -36,6 +36,7 @@
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/probevisitorbase.h"
 #include "renderer/kernel/intersection/regioninfo.h"
+#include "renderer/kernel/intersection/traversalcounters.h"
 #include "renderer/kernel/intersection/trianglekey.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/kernel/shading/shadingray.h"
@@ -148,7 +149,9 @@ class TriangleTree
         const std::vector<size_t>&              triangle_indices,
         const std::vector<TriangleVertexInfo>&  triangle_vertex_infos,
         const std::vector<GVector3>&            triangle_vertices,
-        const size_t                            node_index);
+        const size_t                            node_index,
+        const double                            time_begin,     // beginning of the time interval of the node
+        const double                            time_end);      // end of the time interval of the node
 
     void store_triangles(
         const std::vector<size_t>&              triangle_indices,
@@ -162,6 +165,30 @@ class TriangleTree
 };
 
 
+//
+// Motion bounding boxes.
+//
+// Paths of motion bounding boxes are equidistant in time and are linearly interpolated
+// during traversal. The functions below guarantee that the interpolated boxes contain
+// the triangles at all times, including at poses that fall between two boxes.
+//
+
+// Compute the motion bounding boxes of a range of triangles over a time interval.
+std::vector<GAABB3> compute_triangle_motion_bboxes(
+    const std::vector<size_t>&                  triangle_indices,
+    const size_t                                item_begin,
+    const size_t                                item_count,
+    const std::vector<TriangleVertexInfo>&      triangle_vertex_infos,
+    const std::vector<GVector3>&                triangle_vertices,
+    const double                                time_begin,
+    const double                                time_end);
+
+// Merge two paths of motion bounding boxes spanning the same time interval.
+std::vector<GAABB3> merge_motion_bboxes(
+    const std::vector<GAABB3>&                  left_bboxes,
+    const std::vector<GAABB3>&                  right_bboxes);
+
+
 //
 // Triangle tree factory.
 //
@@ -214,7 +241,8 @@ class TriangleLeafVisitor
     // Constructor.
     TriangleLeafVisitor(
         const TriangleTree&                     tree,
-        ShadingPoint&                           shading_point);
+        ShadingPoint&                           shading_point,
+        TraversalCounters&                      counters);
 
     // Visit a leaf.
     bool visit(
@@ -234,6 +262,7 @@ class TriangleLeafVisitor
     const TriangleTree&     m_tree;
     const bool              m_has_intersection_filters;
     ShadingPoint&           m_shading_point;
+    TraversalCounters&      m_counters;
     GTriangleType           m_interpolated_triangle;
     const GTriangleType*    m_hit_triangle;
     size_t                  m_hit_triangle_index;
@@ -250,8 +279,9 @@ class TriangleLeafProbeVisitor
 {
   public:
     // Constructor.
-    explicit TriangleLeafProbeVisitor(
-        const TriangleTree&                     tree);
+    TriangleLeafProbeVisitor(
+        const TriangleTree&                     tree,
+        TraversalCounters&                      counters);
 
     // Visit a leaf.
     bool visit(
@@ -267,6 +297,7 @@ class TriangleLeafProbeVisitor
   private:
     const TriangleTree&     m_tree;
     const bool              m_has_intersection_filters;
+    TraversalCounters&      m_counters;
 };
 
 
@@ -348,10 +379,12 @@ inline size_t TriangleTree::get_moving_triangle_count() const
 
 inline TriangleLeafVisitor::TriangleLeafVisitor(
     const TriangleTree&                     tree,
-    ShadingPoint&                           shading_point)
+    ShadingPoint&                           shading_point,
+    TraversalCounters&                      counters)
   : m_tree(tree)
   , m_has_intersection_filters(!tree.m_intersection_filters.empty())
   , m_shading_point(shading_point)
+  , m_counters(counters)
   , m_hit_triangle(0)
 {
 }
@@ -378,6 +411,10 @@ inline bool TriangleLeafVisitor::visit(
     const size_t triangle_index = node.get_item_index();
     const size_t triangle_count = node.get_item_count();
 
+    // Update traversal counters.
+    ++m_counters.m_triangle_leaf_visits;
+    m_counters.m_triangle_tests += triangle_count;
+
     // Sequentially intersect all triangles of the leaf.
     for (size_t i = 0; i < triangle_count; ++i)
     {
@@ -469,12 +506,13 @@ inline void TriangleLeafVisitor::read_hit_triangle_data() const
     {
         // Record a hit.
         m_shading_point.m_hit = true;
+        m_shading_point.m_primitive_type = ShadingPoint::PrimitiveTriangle;
 
         // Copy the triangle key.
         const TriangleKey& triangle_key = m_tree.m_triangle_keys[m_hit_triangle_index];
-        m_shading_point.m_object_instance_index = triangle_key.get_object_instance_index();
-        m_shading_point.m_region_index = triangle_key.get_region_index();
-        m_shading_point.m_triangle_index = triangle_key.get_triangle_index();
+        m_shading_point.m_object_instance_index = static_cast<foundation::uint32>(triangle_key.get_object_instance_index());
+        m_shading_point.m_region_index = static_cast<foundation::uint32>(triangle_key.get_region_index());
+        m_shading_point.m_triangle_index = static_cast<foundation::uint32>(triangle_key.get_triangle_index());
 
         // Compute and store the support plane of the hit triangle.
         const impl::TriangleReader reader(*m_hit_triangle);
@@ -488,9 +526,11 @@ inline void TriangleLeafVisitor::read_hit_triangle_data() const
 //
 
 inline TriangleLeafProbeVisitor::TriangleLeafProbeVisitor(
-    const TriangleTree&                     tree)
+    const TriangleTree&                     tree,
+    TraversalCounters&                      counters)
   : m_tree(tree)
   , m_has_intersection_filters(!tree.m_intersection_filters.empty())
+  , m_counters(counters)
 {
 }
 
@@ -515,9 +555,14 @@ inline bool TriangleLeafProbeVisitor::visit(
 
     const size_t triangle_count = node.get_item_count();
 
+    // Update traversal counters.
+    ++m_counters.m_triangle_leaf_visits;
+
     // Sequentially intersect triangles until a hit is found.
     for (size_t i = 0; i < triangle_count; ++i)
     {
+        ++m_counters.m_triangle_tests;
+
         // Retrieve the number of motion segments for this triangle.
         const foundation::uint32 motion_segment_count =
             *reinterpret_cast<const foundation::uint32*>(leaf_data);
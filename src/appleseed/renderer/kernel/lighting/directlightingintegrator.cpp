@@ -54,21 +54,12 @@ DirectLightingIntegrator::DirectLightingIntegrator(
     const bool                  indirect)
   : m_shading_context(shading_context)
   , m_light_sampler(light_sampler)
-  , m_shading_point(shading_point)
-  , m_point(shading_point.get_point())
-  , m_geometric_normal(shading_point.get_geometric_normal())
-  , m_shading_basis(shading_point.get_shading_basis())
-  , m_time(shading_point.get_time())
-  , m_outgoing(outgoing)
-  , m_bsdf(bsdf)
-  , m_bsdf_data(bsdf_data)
+  , m_scattering_point(shading_point, outgoing, bsdf, bsdf_data, light_sampling_modes)
   , m_bsdf_sampling_modes(bsdf_sampling_modes)
-  , m_light_sampling_modes(light_sampling_modes)
   , m_bsdf_sample_count(bsdf_sample_count)
   , m_light_sample_count(light_sample_count)
   , m_indirect(indirect)
 {
-    assert(is_normalized(outgoing));
 }
 
 DirectLightingIntegrator::DirectLightingIntegrator(
@@ -82,21 +73,34 @@ DirectLightingIntegrator::DirectLightingIntegrator(
     const bool                  indirect)
   : m_shading_context(shading_context)
   , m_light_sampler(light_sampler)
-  , m_shading_point(*vertex.m_shading_point)
-  , m_point(vertex.get_point())
-  , m_geometric_normal(vertex.get_geometric_normal())
-  , m_shading_basis(vertex.get_shading_basis())
-  , m_time(vertex.get_time())
-  , m_outgoing(vertex.m_outgoing)
-  , m_bsdf(*vertex.m_bsdf)
-  , m_bsdf_data(vertex.m_bsdf_data)
+  , m_scattering_point(
+        *vertex.m_shading_point,
+        vertex.m_outgoing,
+        *vertex.m_bsdf,
+        vertex.m_bsdf_data,
+        light_sampling_modes)
   , m_bsdf_sampling_modes(bsdf_sampling_modes)
-  , m_light_sampling_modes(light_sampling_modes)
   , m_bsdf_sample_count(bsdf_sample_count)
   , m_light_sample_count(light_sample_count)
   , m_indirect(indirect)
 {
-    assert(is_normalized(vertex.m_outgoing));
+}
+
+DirectLightingIntegrator::DirectLightingIntegrator(
+    const ShadingContext&       shading_context,
+    const LightSampler&         light_sampler,
+    const ScatteringPoint&      scattering_point,
+    const size_t                bsdf_sample_count,
+    const size_t                light_sample_count,
+    const bool                  indirect)
+  : m_shading_context(shading_context)
+  , m_light_sampler(light_sampler)
+  , m_scattering_point(scattering_point)
+  , m_bsdf_sampling_modes(BSDF::AllScatteringModes)
+  , m_bsdf_sample_count(bsdf_sample_count)
+  , m_light_sample_count(light_sample_count)
+  , m_indirect(indirect)
+{
 }
 
 void DirectLightingIntegrator::sample_bsdf_and_lights(
@@ -202,12 +206,14 @@ void DirectLightingIntegrator::add_non_physical_light_sample_contribution(
         return;
 
     // Evaluate the light.
-    InputEvaluator input_evaluator(m_shading_context.get_texture_cache());
+    InputEvaluator input_evaluator(
+        m_shading_context.get_texture_cache(),
+        m_shading_context.get_arena());
     Vector3d emission_position, emission_direction;
     Spectrum light_value;
     light->evaluate(
         input_evaluator,
-        sample.m_light_transform.point_to_local(m_point),
+        sample.m_light_transform.point_to_local(m_scattering_point.get_point()),
         emission_position,
         emission_direction,
         light_value);
@@ -220,41 +226,27 @@ void DirectLightingIntegrator::add_non_physical_light_sample_contribution(
     const Vector3d incoming = -emission_direction;
 
     // Cull light samples behind the shading surface.
-    double cos_in = dot(incoming, m_shading_basis.get_normal());
-    if (m_bsdf.get_type() == BSDF::Transmissive)
-        cos_in = -cos_in;
-    if (cos_in <= 0.0)
+    if (!m_scattering_point.is_lit_from(incoming))
         return;
 
     // Compute the transmission factor between the light sample and the shading point.
     const double transmission =
-        m_shading_context.get_tracer().trace_between(
-            m_shading_point,
-            emission_position,
-            ShadingRay::ShadowRay);
+        m_scattering_point.trace_between(
+            m_shading_context,
+            emission_position);
 
     // Discard occluded samples.
     if (transmission == 0.0)
         return;
 
-    // Evaluate the BSDF.
+    // Evaluate the BSDF or the phase function.
     Spectrum bsdf_value;
-    const double bsdf_prob =
-        m_bsdf.evaluate(
-            m_bsdf_data,
-            false,                          // not adjoint
-            true,                           // multiply by |cos(incoming, normal)|
-            m_geometric_normal,
-            m_shading_basis,
-            m_outgoing,
-            incoming,
-            m_light_sampling_modes,
-            bsdf_value);
+    const double bsdf_prob = m_scattering_point.evaluate(incoming, bsdf_value);
     if (bsdf_prob == 0.0)
         return;
 
     // Add the contribution of this sample to the illumination.
-    const double attenuation = light->compute_distance_attenuation(m_point, emission_position);
+    const double attenuation = light->compute_distance_attenuation(m_scattering_point.get_point(), emission_position);
     const double weight = (transmission * attenuation) / sample.m_probability;
     light_value *= static_cast<float>(weight);
     light_value *= bsdf_value;
@@ -34,6 +34,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/aov/spectrumstack.h"
 #include "renderer/kernel/lighting/lightsampler.h"
+#include "renderer/kernel/lighting/scatteringpoint.h"
 #include "renderer/kernel/lighting/tracer.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
@@ -73,6 +74,13 @@ namespace renderer
 //   The number of shadow rays cast by these functions may be as high as the number of light
 //   samples passed to the constructor plus the number of non-physical lights in the scene.
 //
+// Note about points inside participating media:
+//
+//   Direct lighting can also be estimated at a scattering point inside a participating medium
+//   where a phase function takes the place of the BSDF. Only the light sampling methods are
+//   available at such points; the phase function sample count passed to the constructor is
+//   only used for MIS weighting and may be zero when the path won't be extended from there.
+//
 
 class DirectLightingIntegrator
 {
@@ -120,6 +128,13 @@ class DirectLightingIntegrator
         const size_t                    bsdf_sample_count,          // number of samples in BSDF sampling
         const size_t                    light_sample_count,         // number of samples in light sampling
         const bool                      indirect);                  // are we computing indirect lighting?
+    DirectLightingIntegrator(
+        const ShadingContext&           shading_context,
+        const LightSampler&             light_sampler,
+        const ScatteringPoint&          scattering_point,
+        const size_t                    bsdf_sample_count,          // number of samples in BSDF or phase function sampling
+        const size_t                    light_sample_count,         // number of samples in light sampling
+        const bool                      indirect);                  // are we computing indirect lighting?
 
     // Evaluate direct lighting by sampling the BSDF only.
     template <typename WeightingFunction>
@@ -166,16 +181,8 @@ class DirectLightingIntegrator
   private:
     const ShadingContext&               m_shading_context;
     const LightSampler&                 m_light_sampler;
-    const ShadingPoint&                 m_shading_point;
-    const foundation::Vector3d&         m_point;
-    const foundation::Vector3d&         m_geometric_normal;
-    const foundation::Basis3d&          m_shading_basis;
-    const double                        m_time;
-    const foundation::Vector3d&         m_outgoing;
-    const BSDF&                         m_bsdf;
-    const void*                         m_bsdf_data;
+    const ScatteringPoint               m_scattering_point;
     const int                           m_bsdf_sampling_modes;
-    const int                           m_light_sampling_modes;
     const size_t                        m_bsdf_sample_count;
     const size_t                        m_light_sample_count;
     const bool                          m_indirect;
@@ -355,7 +362,7 @@ void DirectLightingIntegrator::sample_lights_low_variance(
             const foundation::Vector3d s = sampling_context.next_vector2<3>();
 
             LightSample sample;
-            m_light_sampler.sample_emitting_triangles(m_time, s, sample);
+            m_light_sampler.sample_emitting_triangles(m_scattering_point.get_time(), s, sample);
 
             add_emitting_triangle_sample_contribution(
                 sample,
@@ -383,7 +390,7 @@ void DirectLightingIntegrator::sample_lights_low_variance(
             const foundation::Vector2d s = sampling_context.next_vector2<2>();
 
             LightSample sample;
-            m_light_sampler.sample_non_physical_light(m_time, s, i, sample);
+            m_light_sampler.sample_non_physical_light(m_scattering_point.get_time(), s, i, sample);
 
             add_non_physical_light_sample_contribution(
                 sample,
@@ -401,20 +408,23 @@ void DirectLightingIntegrator::take_single_bsdf_sample(
     SpectrumStack&                      aovs)
 {
     assert(m_light_sampler.get_emitting_triangle_count() > 0);
+    assert(m_scattering_point.is_on_surface());
+
+    const ShadingPoint& shading_point = m_scattering_point.get_shading_point();
 
     // Sample the BSDF.
     foundation::Vector3d incoming;
     Spectrum bsdf_value;
     double bsdf_prob;
     const BSDF::Mode bsdf_mode =
-        m_bsdf.sample(
+        m_scattering_point.get_bsdf().sample(
             sampling_context,
-            m_bsdf_data,
+            m_scattering_point.get_bsdf_data(),
             false,                      // not adjoint
             true,                       // multiply by |cos(incoming, normal)|
-            m_geometric_normal,
-            m_shading_basis,
-            m_outgoing,
+            shading_point.get_geometric_normal(),
+            shading_point.get_shading_basis(),
+            m_scattering_point.get_outgoing(),
             incoming,
             bsdf_value,
             bsdf_prob);
@@ -428,7 +438,7 @@ void DirectLightingIntegrator::take_single_bsdf_sample(
     double weight;
     const ShadingPoint& light_shading_point =
         m_shading_context.get_tracer().trace(
-            m_shading_point,
+            shading_point,
             incoming,
             ShadingRay::ShadowRay,
             weight);
@@ -457,7 +467,9 @@ void DirectLightingIntegrator::take_single_bsdf_sample(
         return;
 
     // Evaluate the input values of the EDF.
-    InputEvaluator edf_input_evaluator(m_shading_context.get_texture_cache());
+    InputEvaluator edf_input_evaluator(
+        m_shading_context.get_texture_cache(),
+        m_shading_context.get_arena());
     const void* edf_data =
         edf_input_evaluator.evaluate(
             edf->get_inputs(),
@@ -524,7 +536,7 @@ void DirectLightingIntegrator::take_single_light_sample(
     const foundation::Vector3d s = sampling_context.next_vector2<3>();
 
     LightSample sample;
-    m_light_sampler.sample(m_time, s, sample);
+    m_light_sampler.sample(m_scattering_point.get_time(), s, sample);
 
     if (sample.m_triangle)
     {
@@ -557,13 +569,10 @@ void DirectLightingIntegrator::add_emitting_triangle_sample_contribution(
         return;
 
     // Compute the incoming direction in world space.
-    foundation::Vector3d incoming = sample.m_point - m_point;
+    foundation::Vector3d incoming = sample.m_point - m_scattering_point.get_point();
 
     // Cull light samples behind the shading surface.
-    double cos_in = foundation::dot(incoming, m_shading_basis.get_normal());
-    if (m_bsdf.get_type() == BSDF::Transmissive)
-        cos_in = -cos_in;
-    if (cos_in <= 0.0)
+    if (!m_scattering_point.is_lit_from(incoming))
         return;
 
     // Cull samples on lights emitting in the wrong direction.
@@ -573,10 +582,9 @@ void DirectLightingIntegrator::add_emitting_triangle_sample_contribution(
 
     // Compute the transmission factor between the light sample and the shading point.
     const double transmission =
-        m_shading_context.get_tracer().trace_between(
-            m_shading_point,
-            sample.m_point,
-            ShadingRay::ShadowRay);
+        m_scattering_point.trace_between(
+            m_shading_context,
+            sample.m_point);
 
     // Discard occluded samples.
     if (transmission == 0.0)
@@ -593,27 +601,18 @@ void DirectLightingIntegrator::add_emitting_triangle_sample_contribution(
 
     // Normalize the incoming direction.
     incoming *= rcp_sample_distance;
-    cos_in *= rcp_sample_distance;
     cos_on *= rcp_sample_distance;
 
-    // Evaluate the BSDF.
+    // Evaluate the BSDF or the phase function.
     Spectrum bsdf_value;
-    const double bsdf_prob =
-        m_bsdf.evaluate(
-            m_bsdf_data,
-            false,                          // not adjoint
-            true,                           // multiply by |cos(incoming, normal)|
-            m_geometric_normal,
-            m_shading_basis,
-            m_outgoing,
-            incoming,
-            m_light_sampling_modes,
-            bsdf_value);
+    const double bsdf_prob = m_scattering_point.evaluate(incoming, bsdf_value);
     if (bsdf_prob == 0.0)
         return;
 
     // Evaluate the input values of the EDF.
-    InputEvaluator edf_input_evaluator(m_shading_context.get_texture_cache());
+    InputEvaluator edf_input_evaluator(
+        m_shading_context.get_texture_cache(),
+        m_shading_context.get_arena());
     const void* edf_data = edf_input_evaluator.evaluate(edf->get_inputs(), sample.m_bary);
 
     // Evaluate the EDF.
@@ -32,12 +32,15 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/aov/spectrumstack.h"
+#include "renderer/kernel/intersection/intersector.h"
 #include "renderer/kernel/lighting/directlightingintegrator.h"
+#include "renderer/kernel/lighting/drt/irradiancecache.h"
 #include "renderer/kernel/lighting/imagebasedlighting.h"
 #include "renderer/kernel/lighting/lightsampler.h"
 #include "renderer/kernel/lighting/pathtracer.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/edf/edf.h"
 #include "renderer/modeling/environment/environment.h"
@@ -51,12 +54,17 @@
 #include "foundation/math/basis.h"
 #include "foundation/math/mis.h"
 #include "foundation/math/population.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/memory.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
 
 // Standard headers.
 #include <algorithm>
+#include <cstddef>
+#include <limits>
 
 // Forward declarations.
 namespace renderer  { class EnvironmentEDF; }
@@ -88,6 +96,12 @@ namespace
             const double    m_dl_light_sample_count;        // number of light samples used to estimate direct illumination
             const double    m_ibl_env_sample_count;         // number of environment samples used to estimate IBL
 
+            const bool      m_enable_irradiance_cache;      // is the irradiance cache enabled?
+            const double    m_ic_max_error;                 // maximum interpolation error of the irradiance cache
+            const size_t    m_ic_sample_count;              // number of hemisphere samples used to compute an irradiance record
+            const double    m_ic_min_spacing_percents;      // minimum distance between records, in percents of the scene diameter
+            const double    m_ic_max_spacing_percents;      // maximum distance between records, in percents of the scene diameter
+
             float           m_rcp_dl_light_sample_count;
             float           m_rcp_ibl_env_sample_count;
 
@@ -97,6 +111,11 @@ namespace
               , m_rr_min_path_length(nz(params.get_optional<size_t>("rr_min_path_length", 3)))
               , m_dl_light_sample_count(params.get_optional<double>("dl_light_samples", 1.0))
               , m_ibl_env_sample_count(params.get_optional<double>("ibl_env_samples", 1.0))
+              , m_enable_irradiance_cache(params.get_optional<bool>("enable_irradiance_cache", false))
+              , m_ic_max_error(params.get_optional<double>("irradiance_cache_max_error", 0.2))
+              , m_ic_sample_count(params.get_optional<size_t>("irradiance_cache_samples", 64))
+              , m_ic_min_spacing_percents(params.get_optional<double>("irradiance_cache_min_spacing", 0.5))
+              , m_ic_max_spacing_percents(params.get_optional<double>("irradiance_cache_max_spacing", 10.0))
             {
                 // Precompute the reciprocal of the number of light samples.
                 m_rcp_dl_light_sample_count =
@@ -124,21 +143,34 @@ namespace
                     "  max path length  %s\n"
                     "  rr min path len. %s\n"
                     "  dl light samples %s\n"
-                    "  ibl env samples  %s",
+                    "  ibl env samples  %s\n"
+                    "  irradiance cache %s\n"
+                    "  ic max error     %s\n"
+                    "  ic samples       %s\n"
+                    "  ic spacing       %s%% to %s%%",
                     m_enable_ibl ? "on" : "off",
                     m_max_path_length == ~0 ? "infinite" : pretty_uint(m_max_path_length).c_str(),
                     m_rr_min_path_length == ~0 ? "infinite" : pretty_uint(m_rr_min_path_length).c_str(),
                     pretty_scalar(m_dl_light_sample_count).c_str(),
-                    pretty_scalar(m_ibl_env_sample_count).c_str());
+                    pretty_scalar(m_ibl_env_sample_count).c_str(),
+                    m_enable_irradiance_cache ? "on" : "off",
+                    pretty_scalar(m_ic_max_error).c_str(),
+                    pretty_uint(m_ic_sample_count).c_str(),
+                    pretty_scalar(m_ic_min_spacing_percents).c_str(),
+                    pretty_scalar(m_ic_max_spacing_percents).c_str());
             }
         };
 
         DRTLightingEngine(
             const LightSampler&     light_sampler,
+            IrradianceCache*        irradiance_cache,
             const ParamArray&       params)
           : m_params(params)
           , m_light_sampler(light_sampler)
+          , m_irradiance_cache(irradiance_cache)
           , m_path_count(0)
+          , m_ic_lookup_count(0)
+          , m_ic_miss_count(0)
         {
         }
 
@@ -158,11 +190,15 @@ namespace
             PathVisitor path_visitor(
                 m_params,
                 m_light_sampler,
+                m_irradiance_cache,
                 sampling_context,
                 shading_context,
                 shading_point.get_scene(),
                 radiance,
-                aovs);
+                aovs,
+                m_ic_lookup_count,
+                m_ic_miss_count,
+                false);
 
             PathTracer<PathVisitor, false> path_tracer(     // false = not adjoint
                 path_visitor,
@@ -187,43 +223,64 @@ namespace
             stats.insert("path count", m_path_count);
             stats.insert("path length", m_path_length);
 
+            if (m_irradiance_cache)
+            {
+                stats.insert<uint64>("irradiance cache records", m_irradiance_cache->get_record_count());
+                stats.insert_percent("irradiance cache hit rate", m_ic_lookup_count - m_ic_miss_count, m_ic_lookup_count);
+            }
+
             return StatisticsVector::make("distribution ray tracing statistics", stats);
         }
 
       private:
         const Parameters        m_params;
         const LightSampler&     m_light_sampler;
+        IrradianceCache*        m_irradiance_cache;
 
         uint64                  m_path_count;
         Population<uint64>      m_path_length;
+        uint64                  m_ic_lookup_count;
+        uint64                  m_ic_miss_count;
 
         struct PathVisitor
         {
             const Parameters&           m_params;
             const LightSampler&         m_light_sampler;
+            IrradianceCache*            m_irradiance_cache;
             SamplingContext&            m_sampling_context;
             const ShadingContext&       m_shading_context;
-            TextureCache&               m_texture_cache;
+            const Scene&                m_scene;
             const EnvironmentEDF*       m_env_edf;
             Spectrum&                   m_path_radiance;
             SpectrumStack&              m_path_aovs;
+            uint64&                     m_ic_lookup_count;
+            uint64&                     m_ic_miss_count;
+            bool                        m_skip_emitted_light;
 
             PathVisitor(
                 const Parameters&       params,
                 const LightSampler&     light_sampler,
+                IrradianceCache*        irradiance_cache,
                 SamplingContext&        sampling_context,
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
                 Spectrum&               path_radiance,
-                SpectrumStack&          path_aovs)
+                SpectrumStack&          path_aovs,
+                uint64&                 ic_lookup_count,
+                uint64&                 ic_miss_count,
+                const bool              gathering)      // tracing a path to compute an irradiance record?
               : m_params(params)
               , m_light_sampler(light_sampler)
+              , m_irradiance_cache(irradiance_cache)
               , m_sampling_context(sampling_context)
               , m_shading_context(shading_context)
-              , m_texture_cache(shading_context.get_texture_cache())
+              , m_scene(scene)
               , m_env_edf(scene.get_environment()->get_environment_edf())
               , m_path_radiance(path_radiance)
               , m_path_aovs(path_aovs)
+              , m_ic_lookup_count(ic_lookup_count)
+              , m_ic_miss_count(ic_miss_count)
+              , m_skip_emitted_light(gathering)
             {
             }
 
@@ -261,10 +318,19 @@ namespace
                             vertex_radiance,
                             vertex_aovs);
                     }
+
+                    // Indirect diffuse lighting.
+                    if (m_irradiance_cache && vertex.m_path_length < m_params.m_max_path_length)
+                    {
+                        add_indirect_diffuse_contribution(
+                            vertex,
+                            vertex_radiance);
+                    }
                 }
 
-                // Emitted light.
-                if (vertex.m_edf && vertex.m_cos_on > 0.0)
+                // Emitted light. When gathering irradiance, light emitted at the first vertex
+                // was already accounted for by direct lighting at the origin of the path.
+                if (vertex.m_edf && vertex.m_cos_on > 0.0 && !m_skip_emitted_light)
                 {
                     add_emitted_light_contribution(
                         vertex,
@@ -277,6 +343,8 @@ namespace
                 m_path_radiance += vertex_radiance;
                 vertex_aovs *= vertex.m_throughput;
                 m_path_aovs += vertex_aovs;
+
+                m_skip_emitted_light = false;
             }
 
             void add_direct_lighting_contribution(
@@ -360,6 +428,136 @@ namespace
                 vertex_aovs.add(m_env_edf->get_render_layer_index(), ibl_radiance);
             }
 
+            void add_indirect_diffuse_contribution(
+                const PathVertex&       vertex,
+                Spectrum&               vertex_radiance)
+            {
+                // Evaluate the diffuse components of the BSDF. They don't depend on the
+                // incoming direction, so any direction in the upper hemisphere will do.
+                const Vector3d normal = vertex.get_shading_normal();
+                Spectrum diffuse_value;
+                const double diffuse_prob =
+                    vertex.m_bsdf->evaluate(
+                        vertex.m_bsdf_data,
+                        false,                          // not adjoint
+                        false,                          // do not multiply by |cos(incoming, normal)|
+                        vertex.get_geometric_normal(),
+                        vertex.get_shading_basis(),
+                        vertex.m_outgoing,
+                        normal,
+                        BSDF::Diffuse,
+                        diffuse_value);
+                if (diffuse_prob == 0.0 || is_zero(diffuse_value))
+                    return;
+
+                // Look up the irradiance cache, compute a new record if necessary.
+                Spectrum irradiance;
+                ++m_ic_lookup_count;
+                if (!m_irradiance_cache->lookup(vertex.get_point(), normal, irradiance))
+                {
+                    ++m_ic_miss_count;
+
+                    double mean_distance;
+                    compute_irradiance(vertex, irradiance, mean_distance);
+
+                    m_irradiance_cache->insert(
+                        vertex.get_point(),
+                        normal,
+                        mean_distance,
+                        irradiance);
+                }
+
+                // Add the indirect diffuse contribution.
+                diffuse_value *= irradiance;
+                vertex_radiance += diffuse_value;
+            }
+
+            // Compute the irradiance due to light that bounced at least once in the scene,
+            // as well as the harmonic mean distance to the surfaces seen from the vertex.
+            void compute_irradiance(
+                const PathVertex&       vertex,
+                Spectrum&               irradiance,
+                double&                 mean_distance)
+            {
+                const size_t sample_count = max<size_t>(m_params.m_ic_sample_count, 1);
+                const Basis3d basis(vertex.get_shading_normal());
+                const Vector3d& geometric_normal = vertex.get_geometric_normal();
+                const ShadingRay& parent_ray = vertex.get_ray();
+
+                irradiance.set(0.0f);
+                double rcp_distance_sum = 0.0;
+
+                SamplingContext child_sampling_context = vertex.m_sampling_context.split(2, sample_count);
+
+                for (size_t i = 0; i < sample_count; ++i)
+                {
+                    // Sample the hemisphere around the shading normal according to the cosine.
+                    const Vector3d local_dir = sample_hemisphere_cosine(child_sampling_context.next_vector2<2>());
+                    const Vector3d incoming = basis.transform_to_parent(local_dir);
+
+                    // Ignore directions below the surface.
+                    if (dot(incoming, geometric_normal) <= 0.0)
+                        continue;
+
+                    // Trace the gather ray.
+                    const ShadingRay ray(
+                        vertex.m_shading_point->get_biased_point(incoming),
+                        incoming,
+                        parent_ray.m_time,
+                        ShadingRay::DiffuseRay,
+                        parent_ray.m_depth + 1);
+                    ShadingPoint shading_point;
+                    m_shading_context.get_intersector().trace(
+                        ray,
+                        shading_point,
+                        vertex.m_shading_point);
+
+                    if (!shading_point.hit())
+                        continue;
+
+                    rcp_distance_sum += 1.0 / shading_point.get_distance();
+
+                    // Estimate the radiance reflected toward the vertex. Don't use the cache
+                    // recursively: a single diffuse bounce is cached.
+                    Spectrum radiance(0.0f);
+                    SpectrumStack aovs(m_path_aovs.size(), 0.0f);
+                    PathVisitor path_visitor(
+                        m_params,
+                        m_light_sampler,
+                        0,
+                        m_sampling_context,
+                        m_shading_context,
+                        m_scene,
+                        radiance,
+                        aovs,
+                        m_ic_lookup_count,
+                        m_ic_miss_count,
+                        true);
+
+                    PathTracer<PathVisitor, false> path_tracer(     // false = not adjoint
+                        path_visitor,
+                        m_params.m_rr_min_path_length,
+                        m_params.m_max_path_length - vertex.m_path_length,
+                        m_shading_context.get_max_iterations());
+
+                    SamplingContext path_sampling_context(child_sampling_context);
+                    path_tracer.trace(
+                        path_sampling_context,
+                        m_shading_context,
+                        shading_point);
+
+                    irradiance += radiance;
+                }
+
+                // Cosine-weighted sampling: E = Pi / N * sum(L).
+                irradiance *= static_cast<float>(Pi / sample_count);
+
+                mean_distance =
+                    rcp_distance_sum > 0.0
+                        ? sample_count / rcp_distance_sum
+                        : numeric_limits<double>::max();
+            }
+
             void add_emitted_light_contribution(
                 const PathVertex&       vertex,
                 Spectrum&               vertex_radiance,
@@ -367,7 +565,7 @@ namespace
             {
                 // Compute the emitted radiance.
                 Spectrum emitted_radiance;
-                vertex.compute_emitted_radiance(m_texture_cache, emitted_radiance);
+                vertex.compute_emitted_radiance(m_shading_context, emitted_radiance);
 
                 // Multiple importance sampling.
                 if (vertex.m_prev_bsdf_mode != BSDF::Specular)
@@ -385,6 +583,15 @@ namespace
                 vertex_aovs.add(vertex.m_edf->get_render_layer_index(), emitted_radiance);
             }
 
+            void visit_volume_vertex(
+                const ShadingRay&       ray,
+                const Vector3d&         point,
+                const size_t            path_length,
+                const Spectrum&         throughput)
+            {
+                // Direct lighting is not estimated in participating media.
+            }
+
             void visit_environment(
                 const ShadingPoint&     shading_point,
                 const Vector3d&         outgoing,
@@ -398,12 +605,19 @@ namespace
                 if (m_env_edf == 0)
                     return;
 
+                // When gathering irradiance, the environment seen directly from the origin
+                // of the path was already accounted for by image-based lighting there.
+                if (m_skip_emitted_light)
+                    return;
+
                 // When IBL is disabled, only specular reflections should contribute here.
                 if (!m_params.m_enable_ibl && prev_bsdf_mode != BSDF::Specular)
                     return;
 
                 // Evaluate the environment EDF.
-                InputEvaluator input_evaluator(m_texture_cache);
+                InputEvaluator input_evaluator(
+                    m_shading_context.get_texture_cache(),
+                    m_shading_context.get_arena());
                 Spectrum env_radiance;
                 double env_prob;
                 m_env_edf->evaluate(
@@ -439,12 +653,28 @@ namespace
 //
 
 DRTLightingEngineFactory::DRTLightingEngineFactory(
+    const Scene&        scene,
     const LightSampler& light_sampler,
     const ParamArray&   params)
   : m_light_sampler(light_sampler)
   , m_params(params)
 {
-    DRTLightingEngine::Parameters(params).print();
+    const DRTLightingEngine::Parameters engine_params(params);
+    engine_params.print();
+
+    if (engine_params.m_enable_irradiance_cache)
+    {
+        const double scene_diameter = 2.0 * scene.compute_radius();
+        m_irradiance_cache.reset(
+            new IrradianceCache(
+                engine_params.m_ic_max_error,
+                scene_diameter * engine_params.m_ic_min_spacing_percents / 100.0,
+                scene_diameter * engine_params.m_ic_max_spacing_percents / 100.0));
+    }
+}
+
+DRTLightingEngineFactory::~DRTLightingEngineFactory()
+{
 }
 
 void DRTLightingEngineFactory::release()
@@ -454,7 +684,7 @@ void DRTLightingEngineFactory::release()
 
 ILightingEngine* DRTLightingEngineFactory::create()
 {
-    return new DRTLightingEngine(m_light_sampler, m_params);
+    return new DRTLightingEngine(m_light_sampler, m_irradiance_cache.get(), m_params);
 }
 
 }   // namespace renderer
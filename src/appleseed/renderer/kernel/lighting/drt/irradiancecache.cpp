@@ -0,0 +1,191 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "irradiancecache.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/hash.h"
+#include "foundation/math/scalar.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// IrradianceCache class implementation.
+//
+
+IrradianceCache::IrradianceCache(
+    const double            max_error,
+    const double            min_spacing,
+    const double            max_spacing)
+  : m_max_error(max_error)
+  , m_min_spacing(min_spacing)
+  , m_max_spacing(max_spacing)
+  , m_rcp_cell_size(0.5 / (max_error * max_spacing))
+  , m_buckets(BucketCount)
+  , m_record_count(0)
+{
+    assert(max_error > 0.0);
+    assert(min_spacing > 0.0);
+    assert(min_spacing <= max_spacing);
+}
+
+bool IrradianceCache::lookup(
+    const Vector3d&         point,
+    const Vector3d&         normal,
+    Spectrum&               irradiance) const
+{
+    const Vector3i cell(
+        truncate<int>(floor(point.x * m_rcp_cell_size)),
+        truncate<int>(floor(point.y * m_rcp_cell_size)),
+        truncate<int>(floor(point.z * m_rcp_cell_size)));
+
+    const size_t bucket_index = find_bucket(cell);
+    const double rcp_max_error = 1.0 / m_max_error;
+
+    irradiance.set(0.0f);
+    double weight_sum = 0.0;
+
+    Spinlock::ScopedLock lock(m_locks[bucket_index % LockCount]);
+
+    const RecordVector& records = m_buckets[bucket_index];
+    const size_t record_count = records.size();
+
+    for (size_t i = 0; i < record_count; ++i)
+    {
+        const Record& record = records[i];
+
+        // Ignore records on surfaces with a different orientation.
+        const double cos_normals = dot(normal, record.m_normal);
+        if (cos_normals <= 0.0)
+            continue;
+
+        // Ignore records in front of the point, as they may see different surfaces.
+        const Vector3d offset = point - record.m_point;
+        if (dot(offset, normal + record.m_normal) < -0.01 / record.m_rcp_radius)
+            continue;
+
+        // Ward's error estimate.
+        const double error =
+            norm(offset) * record.m_rcp_radius +
+            sqrt(max(1.0 - cos_normals, 0.0));
+
+        if (error >= m_max_error)
+            continue;
+
+        const double weight = error > 0.0 ? 1.0 / error : 1.0e6 * rcp_max_error;
+
+        Spectrum weighted_irradiance = record.m_irradiance;
+        weighted_irradiance *= static_cast<float>(weight);
+        irradiance += weighted_irradiance;
+        weight_sum += weight;
+    }
+
+    if (weight_sum == 0.0)
+        return false;
+
+    irradiance /= static_cast<float>(weight_sum);
+
+    return true;
+}
+
+void IrradianceCache::insert(
+    const Vector3d&         point,
+    const Vector3d&         normal,
+    const double            mean_distance,
+    const Spectrum&         irradiance)
+{
+    Record record;
+    record.m_point = point;
+    record.m_normal = normal;
+    record.m_rcp_radius = 1.0 / clamp(mean_distance, m_min_spacing, m_max_spacing);
+    record.m_irradiance = irradiance;
+
+    // Find the cells overlapped by the region where the record is valid.
+    // This region is never wider than a cell, so it overlaps at most 8 cells.
+    const double radius = m_max_error / record.m_rcp_radius;
+    const Vector3d lo = (point - Vector3d(radius)) * m_rcp_cell_size;
+    const Vector3d hi = (point + Vector3d(radius)) * m_rcp_cell_size;
+    const Vector3i min_cell(
+        truncate<int>(floor(lo.x)),
+        truncate<int>(floor(lo.y)),
+        truncate<int>(floor(lo.z)));
+    const Vector3i max_cell(
+        truncate<int>(floor(hi.x)),
+        truncate<int>(floor(hi.y)),
+        truncate<int>(floor(hi.z)));
+
+    // Distinct cells may share a bucket: insert the record only once in each bucket.
+    size_t bucket_indices[8];
+    size_t bucket_count = 0;
+
+    for (int z = min_cell.z; z <= max_cell.z; ++z)
+    {
+        for (int y = min_cell.y; y <= max_cell.y; ++y)
+        {
+            for (int x = min_cell.x; x <= max_cell.x; ++x)
+            {
+                assert(bucket_count < 8);
+                bucket_indices[bucket_count++] = find_bucket(Vector3i(x, y, z));
+            }
+        }
+    }
+
+    sort(bucket_indices, bucket_indices + bucket_count);
+    bucket_count = unique(bucket_indices, bucket_indices + bucket_count) - bucket_indices;
+
+    for (size_t i = 0; i < bucket_count; ++i)
+    {
+        const size_t bucket_index = bucket_indices[i];
+        Spinlock::ScopedLock lock(m_locks[bucket_index % LockCount]);
+        m_buckets[bucket_index].push_back(record);
+    }
+
+    boost_atomic::atomic_inc32(&m_record_count);
+}
+
+size_t IrradianceCache::find_bucket(const Vector3i& cell) const
+{
+    const uint32 h =
+        static_cast<uint32>(cell.x) * 73856093u ^
+        static_cast<uint32>(cell.y) * 19349663u ^
+        static_cast<uint32>(cell.z) * 83492791u;
+
+    return hash_uint32(h) & (BucketCount - 1);
+}
+
+}   // namespace renderer
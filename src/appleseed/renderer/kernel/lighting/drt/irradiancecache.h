@@ -0,0 +1,129 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_DRT_IRRADIANCECACHE_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_DRT_IRRADIANCECACHE_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+namespace renderer
+{
+
+//
+// A world space cache of irradiance records with error-driven interpolation.
+//
+// Records are looked up and inserted concurrently by all rendering threads. They are
+// stored in a hash grid whose cells are as large as the largest region a record may
+// cover, and every record is stored in all the cells overlapped by the region it covers.
+//
+// Irradiance gradients are not stored: interpolation is done with Ward's weights only.
+//
+// Reference:
+//
+//   A Ray Tracing Solution for Diffuse Interreflection
+//   Gregory J. Ward, Francis M. Rubinstein, Robert D. Clear
+//   http://radsite.lbl.gov/radiance/papers/sg88/paper.html
+//
+
+class IrradianceCache
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    IrradianceCache(
+        const double                max_error,              // maximum interpolation error, between 0 and 1
+        const double                min_spacing,            // minimum distance between records, in world units
+        const double                max_spacing);           // maximum distance between records, in world units
+
+    // Interpolate the irradiance at a given point from the records that are valid there.
+    // Returns false if there is no such record. Thread-safe.
+    bool lookup(
+        const foundation::Vector3d& point,
+        const foundation::Vector3d& normal,                 // unit-length
+        Spectrum&                   irradiance) const;
+
+    // Insert a new record. Thread-safe.
+    void insert(
+        const foundation::Vector3d& point,
+        const foundation::Vector3d& normal,                 // unit-length
+        const double                mean_distance,          // harmonic mean distance to the surfaces seen from the point
+        const Spectrum&             irradiance);
+
+    // Return the number of records in the cache.
+    size_t get_record_count() const;
+
+  private:
+    enum { BucketCount = 1 << 16 };
+    enum { LockCount = 256 };
+
+    struct Record
+    {
+        foundation::Vector3d        m_point;
+        foundation::Vector3d        m_normal;
+        double                      m_rcp_radius;
+        Spectrum                    m_irradiance;
+    };
+
+    typedef std::vector<Record> RecordVector;
+
+    const double                    m_max_error;
+    const double                    m_min_spacing;
+    const double                    m_max_spacing;
+    const double                    m_rcp_cell_size;
+    std::vector<RecordVector>       m_buckets;
+    mutable foundation::Spinlock    m_locks[LockCount];
+    foundation::uint32              m_record_count;
+
+    size_t find_bucket(
+        const foundation::Vector3i& cell) const;
+};
+
+
+//
+// IrradianceCache class implementation.
+//
+
+inline size_t IrradianceCache::get_record_count() const
+{
+    return m_record_count;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_DRT_IRRADIANCECACHE_H
@@ -31,6 +31,7 @@
 #include "imagebasedlighting.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/lighting/scatteringpoint.h"
 #include "renderer/kernel/lighting/tracer.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingray.h"
@@ -153,7 +154,9 @@ void compute_ibl_bsdf_sampling(
             continue;
 
         // Evaluate the environment's EDF.
-        InputEvaluator input_evaluator(shading_context.get_texture_cache());
+        InputEvaluator input_evaluator(
+            shading_context.get_texture_cache(),
+            shading_context.get_arena());
         Spectrum env_value;
         double env_prob;
         environment_edf.evaluate(
@@ -196,11 +199,25 @@ void compute_ibl_environment_sampling(
     const size_t            env_sample_count,
     Spectrum&               radiance)
 {
-    assert(is_normalized(outgoing));
-
-    const Vector3d& geometric_normal = shading_point.get_geometric_normal();
-    const Basis3d& shading_basis = shading_point.get_shading_basis();
+    compute_ibl_environment_sampling(
+        sampling_context,
+        shading_context,
+        environment_edf,
+        ScatteringPoint(shading_point, outgoing, bsdf, bsdf_data, env_sampling_modes),
+        bsdf_sample_count,
+        env_sample_count,
+        radiance);
+}
 
+void compute_ibl_environment_sampling(
+    SamplingContext&        sampling_context,
+    const ShadingContext&   shading_context,
+    const EnvironmentEDF&   environment_edf,
+    const ScatteringPoint&  scattering_point,
+    const size_t            bsdf_sample_count,
+    const size_t            env_sample_count,
+    Spectrum&               radiance)
+{
     radiance.set(0.0f);
 
     // todo: if we had a way to know that a BSDF is purely specular, we could
@@ -215,7 +232,9 @@ void compute_ibl_environment_sampling(
         const Vector2d s = sampling_context.next_vector2<2>();
 
         // Sample the environment.
-        InputEvaluator input_evaluator(shading_context.get_texture_cache());
+        InputEvaluator input_evaluator(
+            shading_context.get_texture_cache(),
+            shading_context.get_arena());
         Vector3d incoming;
         Spectrum env_value;
         double env_prob;
@@ -228,32 +247,17 @@ void compute_ibl_environment_sampling(
 
         // Cull samples behind the shading surface.
         assert(is_normalized(incoming));
-        const double cos_in = dot(incoming, shading_basis.get_normal());
-        if (cos_in < 0.0)
+        if (!scattering_point.is_lit_from(incoming))
             continue;
 
         // Discard occluded samples.
-        const double transmission =
-            shading_context.get_tracer().trace(
-                shading_point,
-                incoming,
-                ShadingRay::ShadowRay);
+        const double transmission = scattering_point.trace(shading_context, incoming);
         if (transmission == 0.0)
             continue;
 
-        // Evaluate the BSDF.
+        // Evaluate the BSDF or the phase function.
         Spectrum bsdf_value;
-        const double bsdf_prob =
-            bsdf.evaluate(
-                bsdf_data,
-                false,                          // not adjoint
-                true,                           // multiply by |cos(incoming, normal)|
-                geometric_normal,
-                shading_basis,
-                outgoing,
-                incoming,
-                env_sampling_modes,
-                bsdf_value);
+        const double bsdf_prob = scattering_point.evaluate(incoming, bsdf_value);
         if (bsdf_prob == 0.0)
             continue;
 
@@ -43,6 +43,7 @@
 // Forward declarations.
 namespace renderer      { class BSDF; }
 namespace renderer      { class EnvironmentEDF; }
+namespace renderer      { class ScatteringPoint; }
 namespace renderer      { class ShadingContext; }
 namespace renderer      { class ShadingPoint; }
 
@@ -121,6 +122,18 @@ void compute_ibl_environment_sampling(
     const size_t                    env_sample_count,       // number of samples in environment sampling
     Spectrum&                       radiance);
 
+// Compute image-based lighting via environment sampling at a point on a surface or inside
+// a participating medium. The BSDF sample count is only used for MIS weighting and may be
+// zero when the path won't be extended from this point.
+void compute_ibl_environment_sampling(
+    SamplingContext&                sampling_context,
+    const ShadingContext&           shading_context,
+    const EnvironmentEDF&           environment_edf,
+    const ScatteringPoint&          scattering_point,
+    const size_t                    bsdf_sample_count,      // number of samples in BSDF or phase function sampling
+    const size_t                    env_sample_count,       // number of samples in environment sampling
+    Spectrum&                       radiance);
+
 
 //
 // Implementation.
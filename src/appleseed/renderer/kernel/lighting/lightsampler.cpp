@@ -45,6 +45,7 @@
 #include "renderer/modeling/object/regionkit.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/instancearray.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/scene.h"
 
@@ -79,11 +80,18 @@ void LightSample::make_shading_point(
 {
     assert(m_triangle && !m_light);
 
+    const AssemblyInstance* assembly_instance = m_triangle->m_assembly_instance;
+    const size_t instance_array_index = m_triangle->m_instance_array_index;
+    const Transformd& earliest_transform = assembly_instance->transform_sequence().get_earliest_transform();
+
     intersector.manufacture_hit(
         shading_point,
         ShadingRay(m_point, direction, 0.0, 0.0, 0.0, ShadingRay::CameraRay),
-        m_triangle->m_assembly_instance,
-        m_triangle->m_assembly_instance->transform_sequence().get_earliest_transform(),
+        assembly_instance,
+        instance_array_index,
+        instance_array_index == InstanceArray::InvalidIndex
+            ? earliest_transform
+            : assembly_instance->instance_array().get_transform(instance_array_index) * earliest_transform,
         m_triangle->m_object_instance_index,
         m_triangle->m_region_index,
         m_triangle->m_triangle_index,
@@ -164,15 +172,38 @@ void LightSampler::collect_non_physical_lights(
             assembly_instance.transform_sequence() * parent_transform_seq;
         cumulated_transform_seq.prepare();
 
-        // Recurse into child assembly instances.
-        collect_non_physical_lights(
-            assembly.assembly_instances(),
-            cumulated_transform_seq);
+        const InstanceArray& instance_array = assembly_instance.instance_array();
+
+        if (instance_array.empty())
+        {
+            // Recurse into child assembly instances.
+            collect_non_physical_lights(
+                assembly.assembly_instances(),
+                cumulated_transform_seq);
+
+            // Collect lights from this assembly.
+            collect_non_physical_lights(
+                assembly,
+                cumulated_transform_seq);
+        }
+        else if (!assembly.assembly_instances().empty() || !assembly.lights().empty())
+        {
+            // Collect lights once per element of the instance array.
+            const size_t instance_count = instance_array.size();
+            for (size_t j = 0; j < instance_count; ++j)
+            {
+                const TransformSequence instance_transform_seq =
+                    instance_array.get_transform_sequence(j, cumulated_transform_seq);
+
+                collect_non_physical_lights(
+                    assembly.assembly_instances(),
+                    instance_transform_seq);
 
-        // Collect lights from this assembly.
-        collect_non_physical_lights(
-            assembly,
-            cumulated_transform_seq);
+                collect_non_physical_lights(
+                    assembly,
+                    instance_transform_seq);
+            }
+        }
     }
 }
 
@@ -217,23 +248,54 @@ void LightSampler::collect_emitting_triangles(
             assembly_instance.transform_sequence() * parent_transform_seq;
         cumulated_transform_seq.prepare();
 
-        // Recurse into child assembly instances.
-        collect_emitting_triangles(
-            assembly.assembly_instances(),
-            cumulated_transform_seq);
+        const InstanceArray& instance_array = assembly_instance.instance_array();
+
+        if (instance_array.empty())
+        {
+            // Recurse into child assembly instances.
+            collect_emitting_triangles(
+                assembly.assembly_instances(),
+                cumulated_transform_seq);
+
+            // Collect emitting triangles from this assembly instance.
+            // todo: add support for moving light-emitters.
+            collect_emitting_triangles(
+                assembly,
+                assembly_instance,
+                InstanceArray::InvalidIndex,
+                cumulated_transform_seq.get_earliest_transform());
+        }
+        else
+        {
+            // Collect emitting triangles once per element of the instance array.
+            const size_t instance_count = instance_array.size();
+            for (size_t j = 0; j < instance_count; ++j)
+            {
+                const TransformSequence instance_transform_seq =
+                    instance_array.get_transform_sequence(j, cumulated_transform_seq);
+
+                if (!assembly.assembly_instances().empty())
+                {
+                    collect_emitting_triangles(
+                        assembly.assembly_instances(),
+                        instance_transform_seq);
+                }
 
-        // Collect emitting triangles from this assembly instance.
-        collect_emitting_triangles(
-            assembly,
-            assembly_instance,
-            cumulated_transform_seq);
+                collect_emitting_triangles(
+                    assembly,
+                    assembly_instance,
+                    j,
+                    instance_transform_seq.get_earliest_transform());
+            }
+        }
     }
 }
 
 void LightSampler::collect_emitting_triangles(
     const Assembly&                     assembly,
     const AssemblyInstance&             assembly_instance,
-    const TransformSequence&            transform_sequence)
+    const size_t                        instance_array_index,
+    const Transformd&                   assembly_instance_transform)
 {
     // Loop over the object instances of the assembly.
     const size_t object_instance_count = assembly.object_instances().size();
@@ -251,9 +313,7 @@ void LightSampler::collect_emitting_triangles(
             continue;
 
         // Compute the object space to world space transformation.
-        // todo: add support for moving light-emitters.
         const Transformd& object_instance_transform = object_instance->get_transform();
-        const Transformd& assembly_instance_transform = transform_sequence.get_earliest_transform();
         const Transformd global_transform = assembly_instance_transform * object_instance_transform;
 
         // Retrieve the object.
@@ -355,6 +415,7 @@ void LightSampler::collect_emitting_triangles(
                     // Create a light-emitting triangle.
                     EmittingTriangle emitting_triangle;
                     emitting_triangle.m_assembly_instance = &assembly_instance;
+                    emitting_triangle.m_instance_array_index = instance_array_index;
                     emitting_triangle.m_object_instance_index = object_instance_index;
                     emitting_triangle.m_region_index = region_index;
                     emitting_triangle.m_triangle_index = triangle_index;
@@ -395,6 +456,7 @@ void LightSampler::build_emitting_triangle_hash_table()
 
         const EmittingTriangleKey emitting_triangle_key(
             emitting_triangle.m_assembly_instance->get_uid(),
+            emitting_triangle.m_instance_array_index,
             emitting_triangle.m_object_instance_index,
             emitting_triangle.m_region_index,
             emitting_triangle.m_triangle_index);
@@ -486,6 +548,7 @@ double LightSampler::evaluate_pdf(const ShadingPoint& shading_point) const
 {
     const EmittingTriangleKey triangle_key(
         shading_point.get_assembly_instance().get_uid(),
+        shading_point.get_instance_array_index(),
         shading_point.get_object_instance_index(),
         shading_point.get_region_index(),
         shading_point.get_triangle_index());
@@ -82,6 +82,7 @@ class EmittingTriangle
 {
   public:
     const AssemblyInstance*     m_assembly_instance;
+    size_t                      m_instance_array_index;         // index in the instance array of the assembly instance
     size_t                      m_object_instance_index;
     size_t                      m_region_index;
     size_t                      m_triangle_index;
@@ -103,6 +104,7 @@ class EmittingTriangleKey
 {
   public:
     foundation::UniqueID            m_assembly_instance_uid;
+    foundation::uint32              m_instance_array_index;
     foundation::uint32              m_object_instance_index;
     foundation::uint32              m_region_index;
     foundation::uint32              m_triangle_index;
@@ -110,6 +112,7 @@ class EmittingTriangleKey
     EmittingTriangleKey();
     EmittingTriangleKey(
         const foundation::UniqueID  assembly_instance_uid,
+        const size_t                instance_array_index,
         const size_t                object_instance_index,
         const size_t                region_index,
         const size_t                triangle_index);
@@ -261,7 +264,8 @@ class LightSampler
     void collect_emitting_triangles(
         const Assembly&                     assembly,
         const AssemblyInstance&             assembly_instance,
-        const TransformSequence&            transform_sequence);
+        const size_t                        instance_array_index,
+        const foundation::Transformd&       assembly_instance_transform);
 
     // Build a hash table that allows to find the emitting triangle at a given shading point.
     void build_emitting_triangle_hash_table();
@@ -294,10 +298,12 @@ inline EmittingTriangleKey::EmittingTriangleKey()
 
 inline EmittingTriangleKey::EmittingTriangleKey(
     const foundation::UniqueID              assembly_instance_uid,
+    const size_t                            instance_array_index,
     const size_t                            object_instance_index,
     const size_t                            region_index,
     const size_t                            triangle_index)
   : m_assembly_instance_uid(static_cast<foundation::uint32>(assembly_instance_uid))
+  , m_instance_array_index(static_cast<foundation::uint32>(instance_array_index))
   , m_object_instance_index(static_cast<foundation::uint32>(object_instance_index))
   , m_region_index(static_cast<foundation::uint32>(region_index))
   , m_triangle_index(static_cast<foundation::uint32>(triangle_index))
@@ -310,6 +316,7 @@ inline bool EmittingTriangleKey::operator==(const EmittingTriangleKey& rhs) cons
         m_triangle_index == rhs.m_triangle_index &&
         m_object_instance_index == rhs.m_object_instance_index &&
         m_assembly_instance_uid == rhs.m_assembly_instance_uid &&
+        m_instance_array_index == rhs.m_instance_array_index &&
         m_region_index == rhs.m_region_index;
 }
 
@@ -322,7 +329,9 @@ inline size_t EmittingTriangleKeyHasher::operator()(const EmittingTriangleKey& k
 {
     return
         foundation::mix_uint32(
-            static_cast<foundation::uint32>(key.m_assembly_instance_uid),
+            foundation::mix_uint32(
+                static_cast<foundation::uint32>(key.m_assembly_instance_uid),
+                key.m_instance_array_index),
             key.m_object_instance_index,
             key.m_region_index,
             key.m_triangle_index);
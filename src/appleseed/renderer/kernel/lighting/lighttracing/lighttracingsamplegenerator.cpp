@@ -458,6 +458,15 @@ namespace
                 ++m_sample_count;
             }
 
+            void visit_volume_vertex(
+                const ShadingRay&           ray,
+                const Vector3d&             point,
+                const size_t                path_length,
+                const Spectrum&             throughput)
+            {
+                // Vertices in participating media are not connected to the camera.
+            }
+
             void visit_environment(
                 const ShadingPoint&         shading_point,
                 const Vector3d&             outgoing,
@@ -500,6 +509,9 @@ namespace
             const size_t                sequence_index,
             SampleVector&               samples) OVERRIDE
         {
+            // Release the temporaries allocated while tracing the previous light path.
+            m_shading_context.get_arena().clear();
+
             SamplingContext sampling_context(
                 m_rng,
                 0,
@@ -556,7 +568,9 @@ namespace
             const EDF* edf = light_sample.m_triangle->m_edf;
 
             // Evaluate the EDF inputs.
-            InputEvaluator input_evaluator(m_texture_cache);
+            InputEvaluator input_evaluator(
+                m_shading_context.get_texture_cache(),
+                m_shading_context.get_arena());
             const void* edf_data =
                 input_evaluator.evaluate(edf->get_inputs(), light_sample.m_bary);
 
@@ -641,7 +655,9 @@ namespace
             SampleVector&               samples)
         {
             // Sample the light.
-            InputEvaluator input_evaluator(m_texture_cache);
+            InputEvaluator input_evaluator(
+                m_shading_context.get_texture_cache(),
+                m_shading_context.get_arena());
             sampling_context.split_in_place(2, 1);
             Vector3d emission_position, emission_direction;
             Spectrum light_value;
@@ -714,7 +730,9 @@ namespace
         {
             // Sample the environment.
             sampling_context.split_in_place(2, 1);
-            InputEvaluator input_evaluator(m_texture_cache);
+            InputEvaluator input_evaluator(
+                m_shading_context.get_texture_cache(),
+                m_shading_context.get_arena());
             Vector3d outgoing;
             Spectrum env_edf_value;
             double env_edf_prob;
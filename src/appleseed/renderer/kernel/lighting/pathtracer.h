@@ -35,6 +35,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/intersection/intersector.h"
 #include "renderer/kernel/lighting/pathvertex.h"
+#include "renderer/kernel/lighting/sdtree.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/kernel/shading/shadingray.h"
@@ -43,15 +44,24 @@
 #include "renderer/modeling/input/inputevaluator.h"
 #include "renderer/modeling/input/source.h"
 #include "renderer/modeling/material/material.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
 #ifdef WITH_OSL
 #include "renderer/modeling/shadergroup/shadergroup.h"
 #endif
+#include "renderer/modeling/volume/volume.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/basis.h"
+#include "foundation/math/hash.h"
+#include "foundation/math/rng.h"
 #include "foundation/math/rr.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/foreach.h"
 #include "foundation/utility/string.h"
 
 // Standard headers.
@@ -79,7 +89,9 @@ class PathTracer
         const size_t            rr_min_path_length,
         const size_t            max_path_length,
         const size_t            max_iterations = 1000,
-        const double            near_start = 0.0);          // abort tracing if the first ray is shorter than this
+        const double            near_start = 0.0,           // abort tracing if the first ray is shorter than this
+        const SDTree*           sd_tree = 0,                // learned incoming radiance used to guide sampling, or 0
+        const double            bsdf_sampling_fraction = 0.5);  // probability of sampling the BSDF when guiding
 
     size_t trace(
         SamplingContext&        sampling_context,
@@ -98,15 +110,52 @@ class PathTracer
     const size_t                m_max_path_length;
     const size_t                m_max_iterations;
     const double                m_near_start;
+    const SDTree*               m_sd_tree;
+    const double                m_bsdf_sampling_fraction;
 
     // Determine the appropriate ray type for a given scattering mode.
     static ShadingRay::Type bsdf_mode_to_ray_type(
         const BSDF::Mode        mode);
 
+    // Compute the differentials of a scattered ray from those of the incoming ray.
+    static void compute_scattered_ray_differentials(
+        const ShadingPoint&     shading_point,
+        const ShadingRay&       ray,
+        ShadingRay&             scattered_ray);
+
+    // Sample either the BSDF or a learned distribution of incoming radiance, and combine
+    // both techniques with one-sample multiple importance sampling. Returns the BSDF value
+    // divided by the probability density of the combined techniques, and the probability
+    // density of the BSDF alone.
+    BSDF::Mode guided_sample(
+        SamplingContext&        sampling_context,
+        const PathVertex&       vertex,
+        const DTree&            dtree,
+        foundation::Vector3d&   incoming,
+        Spectrum&               value,
+        double&                 bsdf_prob) const;
+
+    // Return the non-specular scattering mode that contributes the most to the value
+    // of the BSDF of a given vertex in a given direction.
+    static BSDF::Mode dominant_scattering_mode(
+        const PathVertex&           vertex,
+        const foundation::Vector3d& incoming,
+        const Spectrum&             value);
+
     // Determine whether a ray can pass through a surface with a given alpha value.
     static bool pass_through(
         SamplingContext&        sampling_context,
         const Alpha             alpha);
+
+    // Sample a scattering event along a ray traveling through the volumes of the scene.
+    // Returns the volume in which the ray scatters before reaching tmax and the ray
+    // parameter of the event, or 0 if the ray does not scatter.
+    static const Volume* sample_medium(
+        SamplingContext&        sampling_context,
+        const VolumeContainer&  volumes,
+        const ShadingRay&       ray,
+        const double            tmax,
+        double&                 distance);
 };
 
 
@@ -120,12 +169,16 @@ inline PathTracer<PathVisitor, Adjoint>::PathTracer(
     const size_t                rr_min_path_length,
     const size_t                max_path_length,
     const size_t                max_iterations,
-    const double                near_start)
+    const double                near_start,
+    const SDTree*               sd_tree,
+    const double                bsdf_sampling_fraction)
   : m_path_visitor(path_visitor)
   , m_rr_min_path_length(rr_min_path_length)
   , m_max_path_length(max_path_length)
   , m_max_iterations(max_iterations)
   , m_near_start(near_start)
+  , m_sd_tree(sd_tree)
+  , m_bsdf_sampling_fraction(bsdf_sampling_fraction)
 {
 }
 
@@ -182,6 +235,88 @@ size_t PathTracer<PathVisitor, Adjoint>::trace(
         // Retrieve the ray.
         const ShadingRay& ray = vertex.get_ray();
 
+        // Handle scattering in the participating media.
+        double medium_distance;
+        const Volume* volume =
+            sample_medium(
+                sampling_context,
+                vertex.m_shading_point->get_scene().volumes(),
+                ray,
+                vertex.m_shading_point->hit() ? vertex.m_shading_point->get_distance() : ray.m_tmax,
+                medium_distance);
+        if (volume)
+        {
+            const foundation::Vector3d medium_point = ray.point_at(medium_distance);
+
+            // Account for absorption (the ratio of the scattering and extinction coefficients).
+            vertex.m_throughput *= volume->get_albedo();
+
+            // Compute radiance contribution at this vertex.
+            m_path_visitor.visit_volume_vertex(
+                ray,
+                medium_point,
+                vertex.m_path_length,
+                vertex.m_throughput);
+
+            // Terminate the path if this scattering event is not accepted.
+            if (!m_path_visitor.accept_scattering(vertex.m_prev_bsdf_mode, BSDF::Diffuse))
+                break;
+
+            // Use Russian Roulette to cut the path without introducing bias.
+            if (vertex.m_path_length >= m_rr_min_path_length)
+            {
+                // Generate a uniform sample in [0,1).
+                sampling_context.split_in_place(1, 1);
+                const double s = sampling_context.next_double2();
+
+                // Compute the probability of extending this path.
+                const double scattering_prob = std::min(static_cast<double>(volume->get_albedo()), 1.0);
+
+                // Russian Roulette.
+                if (!foundation::pass_rr(scattering_prob, s))
+                    break;
+
+                // Adjust throughput to account for terminated paths.
+                assert(scattering_prob > 0.0);
+                vertex.m_throughput /= static_cast<float>(scattering_prob);
+            }
+
+            // Honor the user bounce limit.
+            if (vertex.m_path_length >= m_max_path_length)
+                break;
+
+            // Keep track of the number of bounces.
+            ++vertex.m_path_length;
+
+            // Sample the isotropic phase function. Its value and its probability density
+            // cancel out, so the path throughput is left unchanged.
+            sampling_context.split_in_place(2, 1);
+            const foundation::Vector3d incoming =
+                foundation::sample_sphere_uniform(sampling_context.next_vector2<2>());
+            vertex.m_prev_bsdf_mode = BSDF::Diffuse;
+            vertex.m_prev_bsdf_prob = foundation::RcpFourPi;
+
+            // Construct the scattered ray.
+            const ShadingRay scattered_ray(
+                medium_point,
+                incoming,
+                ray.m_time,
+                ShadingRay::DiffuseRay,
+                ray.m_depth + 1);
+
+            // Trace the ray.
+            shading_points[shading_point_index].clear();
+            shading_context.get_intersector().trace(
+                scattered_ray,
+                shading_points[shading_point_index]);
+
+            // Update the pointers to the shading points.
+            vertex.m_shading_point = &shading_points[shading_point_index];
+            shading_point_index = 1 - shading_point_index;
+
+            continue;
+        }
+
         // Terminate the path if the ray didn't hit anything.
         if (!vertex.m_shading_point->hit())
         {
@@ -244,12 +379,13 @@ size_t PathTracer<PathVisitor, Adjoint>::trace(
                 if (pass_through(sampling_context, alpha))
                 {
                     // Construct a ray that continues in the same direction as the incoming ray.
-                    const ShadingRay cutoff_ray(
+                    ShadingRay cutoff_ray(
                         vertex.get_point(),
                         ray.m_dir,
                         ray.m_time,
                         ray.m_type,
                         ray.m_depth);   // ray depth does not increase when passing through an alpha-mapped surface
+                    cutoff_ray.copy_differentials(ray);
     
                     // Trace the ray.
                     shading_points[shading_point_index].clear();
@@ -282,7 +418,9 @@ size_t PathTracer<PathVisitor, Adjoint>::trace(
         vertex.m_bsdf = material->get_bsdf();
 
         // Evaluate the input values of the BSDF.
-        InputEvaluator bsdf_input_evaluator(shading_context.get_texture_cache());
+        InputEvaluator bsdf_input_evaluator(
+            shading_context.get_texture_cache(),
+            shading_context.get_arena());
         if (vertex.m_bsdf)
         {
             vertex.m_bsdf->evaluate_inputs(bsdf_input_evaluator, *vertex.m_shading_point);
@@ -300,22 +438,45 @@ size_t PathTracer<PathVisitor, Adjoint>::trace(
         if (vertex.m_bsdf == 0)
             break;
 
+        // Retrieve the learned distribution of incoming radiance at this vertex, if any.
+        // Purely specular BSDFs can only be sampled from the BSDF and are never guided.
+        const DTree* dtree =
+            m_sd_tree && (vertex.m_bsdf->get_modes() & (BSDF::Diffuse | BSDF::Glossy))
+                ? m_sd_tree->find_sampling_dtree(vertex.get_point())
+                : 0;
+
         // Sample the BSDF.
         foundation::Vector3d incoming;
         Spectrum bsdf_value;
         double bsdf_prob;
-        const BSDF::Mode bsdf_mode =
-            vertex.m_bsdf->sample(
-                sampling_context,
-                vertex.m_bsdf_data,
-                Adjoint,
-                true,       // multiply by |cos(incoming, normal)|
-                vertex.get_geometric_normal(),
-                vertex.get_shading_basis(),
-                vertex.m_outgoing,
-                incoming,
-                bsdf_value,
-                bsdf_prob);
+        BSDF::Mode bsdf_mode;
+        if (dtree)
+        {
+            // The returned value is already divided by the probability density.
+            bsdf_mode =
+                guided_sample(
+                    sampling_context,
+                    vertex,
+                    *dtree,
+                    incoming,
+                    bsdf_value,
+                    bsdf_prob);
+        }
+        else
+        {
+            bsdf_mode =
+                vertex.m_bsdf->sample(
+                    sampling_context,
+                    vertex.m_bsdf_data,
+                    Adjoint,
+                    true,       // multiply by |cos(incoming, normal)|
+                    vertex.get_geometric_normal(),
+                    vertex.get_shading_basis(),
+                    vertex.m_outgoing,
+                    incoming,
+                    bsdf_value,
+                    bsdf_prob);
+        }
         if (bsdf_mode == BSDF::Absorption)
             break;
 
@@ -326,7 +487,7 @@ size_t PathTracer<PathVisitor, Adjoint>::trace(
         vertex.m_prev_bsdf_prob = bsdf_prob;
         vertex.m_prev_bsdf_mode = bsdf_mode;
 
-        if (bsdf_prob != BSDF::DiracDelta)
+        if (!dtree && bsdf_prob != BSDF::DiracDelta)
             bsdf_value /= static_cast<float>(bsdf_prob);
 
         // Update the path throughput.
@@ -362,13 +523,17 @@ size_t PathTracer<PathVisitor, Adjoint>::trace(
         ++vertex.m_path_length;
 
         // Construct the scattered ray.
-        const ShadingRay scattered_ray(
+        ShadingRay scattered_ray(
             vertex.m_shading_point->get_biased_point(incoming),
             incoming,
             ray.m_time,
             bsdf_mode_to_ray_type(bsdf_mode),
             ray.m_depth + 1);
 
+        // Propagate the ray differentials through specular and glossy bounces.
+        if (ray.m_has_differentials && bsdf_mode != BSDF::Diffuse)
+            compute_scattered_ray_differentials(*vertex.m_shading_point, ray, scattered_ray);
+
         // Trace the ray.
         shading_points[shading_point_index].clear();
         shading_context.get_intersector().trace(
@@ -399,6 +564,162 @@ inline ShadingRay::Type PathTracer<PathVisitor, Adjoint>::bsdf_mode_to_ray_type(
     }
 }
 
+template <typename PathVisitor, bool Adjoint>
+void PathTracer<PathVisitor, Adjoint>::compute_scattered_ray_differentials(
+    const ShadingPoint&         shading_point,
+    const ShadingRay&           ray,
+    ShadingRay&                 scattered_ray)
+{
+    // The surface is assumed to be locally flat: the curvature of the shading
+    // normal is ignored, and glossy bounces are treated like specular ones.
+
+    scattered_ray.m_has_differentials = true;
+    scattered_ray.m_rx_org = scattered_ray.m_org + shading_point.get_dpdx();
+    scattered_ray.m_ry_org = scattered_ray.m_org + shading_point.get_dpdy();
+
+    const foundation::Vector3d dir = foundation::normalize(ray.m_dir);
+    const foundation::Vector3d ddirdx = foundation::normalize(ray.m_rx_dir) - dir;
+    const foundation::Vector3d ddirdy = foundation::normalize(ray.m_ry_dir) - dir;
+
+    const foundation::Vector3d& gn = shading_point.get_geometric_normal();
+    const bool reflection =
+        (foundation::dot(scattered_ray.m_dir, gn) > 0.0) != (foundation::dot(ray.m_dir, gn) > 0.0);
+
+    if (reflection)
+    {
+        // Mirror the angular offsets about the shading normal.
+        const foundation::Vector3d& sn = shading_point.get_shading_normal();
+        scattered_ray.m_rx_dir = scattered_ray.m_dir - foundation::reflect(ddirdx, sn);
+        scattered_ray.m_ry_dir = scattered_ray.m_dir - foundation::reflect(ddirdy, sn);
+    }
+    else
+    {
+        // Keep the angular offsets unchanged.
+        scattered_ray.m_rx_dir = scattered_ray.m_dir + ddirdx;
+        scattered_ray.m_ry_dir = scattered_ray.m_dir + ddirdy;
+    }
+}
+
+template <typename PathVisitor, bool Adjoint>
+BSDF::Mode PathTracer<PathVisitor, Adjoint>::guided_sample(
+    SamplingContext&            sampling_context,
+    const PathVertex&           vertex,
+    const DTree&                dtree,
+    foundation::Vector3d&       incoming,
+    Spectrum&                   value,
+    double&                     bsdf_prob) const
+{
+    // Choose a sampling technique.
+    sampling_context.split_in_place(1, 1);
+    const double s = sampling_context.next_double2();
+
+    const bool bsdf_sampling = s < m_bsdf_sampling_fraction;
+    BSDF::Mode mode = BSDF::Absorption;
+
+    if (bsdf_sampling)
+    {
+        // Sample the BSDF.
+        mode =
+            vertex.m_bsdf->sample(
+                sampling_context,
+                vertex.m_bsdf_data,
+                Adjoint,
+                true,       // multiply by |cos(incoming, normal)|
+                vertex.get_geometric_normal(),
+                vertex.get_shading_basis(),
+                vertex.m_outgoing,
+                incoming,
+                value,
+                bsdf_prob);
+        if (mode == BSDF::Absorption)
+            return mode;
+
+        // Dirac deltas can only be sampled from the BSDF.
+        if (bsdf_prob == BSDF::DiracDelta)
+        {
+            value /= static_cast<float>(m_bsdf_sampling_fraction);
+            return mode;
+        }
+    }
+    else
+    {
+        // Sample the learned distribution of incoming radiance.
+        sampling_context.split_in_place(2, 1);
+        incoming = dtree.sample(sampling_context.next_vector2<2>());
+    }
+
+    // Evaluate the BSDF and its probability density for all non-specular components,
+    // as sample() may only return those of the component it sampled.
+    bsdf_prob =
+        vertex.m_bsdf->evaluate(
+            vertex.m_bsdf_data,
+            Adjoint,
+            true,           // multiply by |cos(incoming, normal)|
+            vertex.get_geometric_normal(),
+            vertex.get_shading_basis(),
+            vertex.m_outgoing,
+            incoming,
+            BSDF::Diffuse | BSDF::Glossy,
+            value);
+
+    // Terminate the path if the sampled direction doesn't carry any contribution.
+    if (bsdf_prob == 0.0 || foundation::is_zero(value))
+        return BSDF::Absorption;
+
+    // Label directions sampled from the learned distribution with the mode of the lobe
+    // that would most likely have produced them, since path visitors base their path
+    // termination and caustics decisions on scattering modes.
+    if (!bsdf_sampling)
+        mode = dominant_scattering_mode(vertex, incoming, value);
+
+    // Probability density of the combined techniques (balance heuristic).
+    const double prob =
+        m_bsdf_sampling_fraction * bsdf_prob +
+        (1.0 - m_bsdf_sampling_fraction) * dtree.evaluate_pdf(incoming);
+    if (prob == 0.0)
+        return BSDF::Absorption;
+
+    value /= static_cast<float>(prob);
+
+    return mode;
+}
+
+template <typename PathVisitor, bool Adjoint>
+BSDF::Mode PathTracer<PathVisitor, Adjoint>::dominant_scattering_mode(
+    const PathVertex&           vertex,
+    const foundation::Vector3d& incoming,
+    const Spectrum&             value)
+{
+    const int modes = vertex.m_bsdf->get_modes();
+
+    if (!(modes & BSDF::Glossy))
+        return BSDF::Diffuse;
+
+    if (!(modes & BSDF::Diffuse))
+        return BSDF::Glossy;
+
+    // The BSDF has both diffuse and glossy lobes: compare the diffuse part of the value to the rest.
+    Spectrum diffuse_value;
+    const double diffuse_prob =
+        vertex.m_bsdf->evaluate(
+            vertex.m_bsdf_data,
+            Adjoint,
+            true,           // multiply by |cos(incoming, normal)|
+            vertex.get_geometric_normal(),
+            vertex.get_shading_basis(),
+            vertex.m_outgoing,
+            incoming,
+            BSDF::Diffuse,
+            diffuse_value);
+    if (diffuse_prob == 0.0)
+        return BSDF::Glossy;
+
+    return
+        2.0f * foundation::average_value(diffuse_value) >= foundation::average_value(value)
+            ? BSDF::Diffuse
+            : BSDF::Glossy;
+}
+
 template <typename PathVisitor, bool Adjoint>
 inline bool PathTracer<PathVisitor, Adjoint>::pass_through(
     SamplingContext&            sampling_context,
@@ -415,6 +736,42 @@ inline bool PathTracer<PathVisitor, Adjoint>::pass_through(
     return sampling_context.next_double2() >= alpha[0];
 }
 
+template <typename PathVisitor, bool Adjoint>
+inline const Volume* PathTracer<PathVisitor, Adjoint>::sample_medium(
+    SamplingContext&            sampling_context,
+    const VolumeContainer&      volumes,
+    const ShadingRay&           ray,
+    const double                tmax,
+    double&                     distance)
+{
+    if (volumes.empty())
+        return 0;
+
+    // Delta tracking consumes a variable number of random numbers: seed a
+    // private generator from a single sample of the sampling context.
+    sampling_context.split_in_place(1, 1);
+    const double s = sampling_context.next_double2();
+    foundation::LCG rng(
+        foundation::hash_uint32(static_cast<foundation::uint32>(s * 4294967295.0)));
+
+    // The volumes are independent media: the first collision in their union is the
+    // nearest of the first collisions in each of them.
+    const Volume* volume = 0;
+    distance = tmax;
+
+    for (foundation::const_each<VolumeContainer> i = volumes; i; ++i)
+    {
+        double volume_distance;
+        if (i->sample_distance(ray.m_org, ray.m_dir, ray.m_tmin, distance, rng, volume_distance))
+        {
+            volume = &*i;
+            distance = volume_distance;
+        }
+    }
+
+    return volume;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_PATHTRACER_H
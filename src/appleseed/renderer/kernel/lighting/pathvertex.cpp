@@ -31,6 +31,7 @@
 #include "pathvertex.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/modeling/edf/edf.h"
 #include "renderer/modeling/input/inputevaluator.h"
 
@@ -38,8 +39,8 @@ namespace renderer
 {
 
 void PathVertex::compute_emitted_radiance(
-    TextureCache&       texture_cache,
-    Spectrum&           radiance) const
+    const ShadingContext&   shading_context,
+    Spectrum&               radiance) const
 {
     assert(m_edf);
 
@@ -51,7 +52,9 @@ void PathVertex::compute_emitted_radiance(
     }
 
     // Evaluate the input values of the EDF.
-    InputEvaluator input_evaluator(texture_cache);
+    InputEvaluator input_evaluator(
+        shading_context.get_texture_cache(),
+        shading_context.get_arena());
     const void* edf_data =
         input_evaluator.evaluate(
             m_edf->get_inputs(),
@@ -37,8 +37,12 @@
 #include "renderer/kernel/lighting/lightsampler.h"
 #include "renderer/kernel/lighting/pathtracer.h"
 #include "renderer/kernel/lighting/pathvertex.h"
+#include "renderer/kernel/lighting/scatteringpoint.h"
+#include "renderer/kernel/lighting/sdtree.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/volume/phasefunction.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/edf/edf.h"
 #include "renderer/modeling/environment/environment.h"
@@ -52,12 +56,16 @@
 #include "foundation/math/basis.h"
 #include "foundation/math/mis.h"
 #include "foundation/math/population.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/memory.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
 
 // Standard headers.
 #include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
 
 // Forward declarations.
 namespace renderer  { class EnvironmentEDF; }
@@ -101,6 +109,9 @@ namespace
             const bool      m_has_max_ray_intensity;
             const float     m_max_ray_intensity;
 
+            const bool      m_enable_path_guiding;          // is path guiding enabled?
+            const double    m_bsdf_sampling_fraction;       // probability of sampling the BSDF rather than the guiding distribution
+
             float           m_rcp_dl_light_sample_count;
             float           m_rcp_ibl_env_sample_count;
 
@@ -115,6 +126,8 @@ namespace
               , m_ibl_env_sample_count(params.get_optional<double>("ibl_env_samples", 1.0))
               , m_has_max_ray_intensity(params.strings().exist("max_ray_intensity"))
               , m_max_ray_intensity(params.get_optional<float>("max_ray_intensity", 0.0f))
+              , m_enable_path_guiding(params.get_optional<bool>("enable_path_guiding", false))
+              , m_bsdf_sampling_fraction(params.get_optional<double>("guiding_bsdf_sampling_fraction", 0.5))
             {
                 // Precompute the reciprocal of the number of light samples.
                 m_rcp_dl_light_sample_count =
@@ -146,7 +159,8 @@ namespace
                     "  next event est.  %s\n"
                     "  dl light samples %s\n"
                     "  ibl env samples  %s\n"
-                    "  max ray intens.  %s",
+                    "  max ray intens.  %s\n"
+                    "  path guiding     %s",
                     m_enable_dl ? "on" : "off",
                     m_enable_ibl ? "on" : "off",
                     m_enable_caustics ? "on" : "off",
@@ -155,16 +169,22 @@ namespace
                     m_next_event_estimation ? "on" : "off",
                     pretty_scalar(m_dl_light_sample_count).c_str(),
                     pretty_scalar(m_ibl_env_sample_count).c_str(),
-                    m_has_max_ray_intensity ? pretty_scalar(m_max_ray_intensity).c_str() : "infinite");
+                    m_has_max_ray_intensity ? pretty_scalar(m_max_ray_intensity).c_str() : "infinite",
+                    m_enable_path_guiding
+                        ? ("on, bsdf sampling fraction " + pretty_scalar(m_bsdf_sampling_fraction)).c_str()
+                        : "off");
             }
         };
 
         PTLightingEngine(
             const LightSampler&     light_sampler,
+            SDTree*                 sd_tree,
             const ParamArray&       params)
           : m_params(params)
           , m_light_sampler(light_sampler)
+          , m_sd_tree(sd_tree)
           , m_path_count(0)
+          , m_guiding_record_count(0)
         {
         }
 
@@ -209,6 +229,8 @@ namespace
             Spectrum&               radiance,               // output radiance, in W.sr^-1.m^-2
             SpectrumStack&          aovs)
         {
+            const bool record_guiding = m_sd_tree && m_sd_tree->is_recording();
+
             PathVisitor path_visitor(
                 m_params,
                 m_light_sampler,
@@ -216,13 +238,17 @@ namespace
                 shading_context,
                 shading_point.get_scene(),
                 radiance,
-                aovs);
+                aovs,
+                record_guiding ? &m_guiding_records : 0);
 
             PathTracer<PathVisitor, false> path_tracer(     // false = not adjoint
                 path_visitor,
                 m_params.m_rr_min_path_length,
                 m_params.m_max_path_length,
-                shading_context.get_max_iterations());
+                shading_context.get_max_iterations(),
+                0.0,
+                m_sd_tree,
+                m_params.m_bsdf_sampling_fraction);
 
             const size_t path_length =
                 path_tracer.trace(
@@ -230,26 +256,73 @@ namespace
                     shading_context,
                     shading_point);
 
+            // Record the radiance arriving at each vertex of the path.
+            if (record_guiding)
+                record_guiding_radiance(radiance);
+
             // Update statistics.
             ++m_path_count;
             m_path_length.insert(path_length);
         }
 
+        void record_guiding_radiance(const Spectrum& path_radiance)
+        {
+            const size_t record_count = m_guiding_records.size();
+
+            for (size_t i = 0; i < record_count; ++i)
+            {
+                const GuidingRecord& record = m_guiding_records[i];
+
+                // The radiance gathered past the vertex, divided by the throughput
+                // of the path up to the vertex, is the radiance arriving there.
+                Spectrum incoming_radiance = path_radiance;
+                incoming_radiance -= record.m_path_radiance;
+
+                const float throughput = average_value(record.m_throughput);
+                if (throughput <= 0.0f)
+                    continue;
+
+                const float radiance = average_value(incoming_radiance) / throughput;
+                if (radiance > 0.0f && radiance < numeric_limits<float>::max())
+                    m_sd_tree->record(record.m_point, record.m_direction, radiance);
+            }
+
+            m_guiding_record_count += record_count;
+            clear_keep_memory(m_guiding_records);
+        }
+
         virtual StatisticsVector get_statistics() const OVERRIDE
         {
             Statistics stats;
             stats.insert("path count", m_path_count);
             stats.insert("path length", m_path_length);
 
+            if (m_sd_tree)
+                stats.insert("guiding records", m_guiding_record_count);
+
             return StatisticsVector::make("path tracing statistics", stats);
         }
 
       private:
+        // A path vertex whose incoming radiance will be recorded for path guiding.
+        struct GuidingRecord
+        {
+            Vector3d                    m_point;
+            Vector3d                    m_direction;            // direction of the incoming light, unit-length
+            Spectrum                    m_throughput;           // path throughput up to this vertex
+            Spectrum                    m_path_radiance;        // radiance gathered before this vertex
+        };
+
+        typedef vector<GuidingRecord> GuidingRecordVector;
+
         const Parameters                m_params;
         const LightSampler&             m_light_sampler;
+        SDTree*                         m_sd_tree;
+        GuidingRecordVector             m_guiding_records;
 
         uint64                          m_path_count;
         Population<uint64>              m_path_length;
+        uint64                          m_guiding_record_count;
 
         //
         // Base path visitor.
@@ -261,10 +334,10 @@ namespace
             const LightSampler&         m_light_sampler;
             SamplingContext&            m_sampling_context;
             const ShadingContext&       m_shading_context;
-            TextureCache&               m_texture_cache;
             const EnvironmentEDF*       m_env_edf;
             Spectrum&                   m_path_radiance;
             SpectrumStack&              m_path_aovs;
+            GuidingRecordVector*        m_guiding_records;
             bool                        m_omit_emitted_light;
 
             PathVisitorBase(
@@ -274,19 +347,38 @@ namespace
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
                 Spectrum&               path_radiance,
-                SpectrumStack&          path_aovs)
+                SpectrumStack&          path_aovs,
+                GuidingRecordVector*    guiding_records)
               : m_params(params)
               , m_light_sampler(light_sampler)
               , m_sampling_context(sampling_context)
               , m_shading_context(shading_context)
-              , m_texture_cache(shading_context.get_texture_cache())
               , m_env_edf(scene.get_environment()->get_environment_edf())
               , m_path_radiance(path_radiance)
               , m_path_aovs(path_aovs)
+              , m_guiding_records(guiding_records)
               , m_omit_emitted_light(false)
             {
             }
 
+            // Remember the origin and direction of a scattered ray before light arriving
+            // along it is added to the path radiance.
+            void add_guiding_record(
+                const ShadingRay&       ray,
+                const Spectrum&         throughput)
+            {
+                // Camera rays are not scattered rays.
+                if (m_guiding_records == 0 || ray.m_depth == 0)
+                    return;
+
+                GuidingRecord record;
+                record.m_point = ray.m_org;
+                record.m_direction = normalize(ray.m_dir);
+                record.m_throughput = throughput;
+                record.m_path_radiance = m_path_radiance;
+                m_guiding_records->push_back(record);
+            }
+
             bool accept_scattering(
                 const BSDF::Mode        prev_bsdf_mode,
                 const BSDF::Mode        bsdf_mode)
@@ -322,7 +414,8 @@ namespace
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
                 Spectrum&               path_radiance,
-                SpectrumStack&          path_aovs)
+                SpectrumStack&          path_aovs,
+                GuidingRecordVector*    guiding_records)
               : PathVisitorBase(
                     params,
                     light_sampler,
@@ -330,12 +423,15 @@ namespace
                     shading_context,
                     scene,
                     path_radiance,
-                    path_aovs)
+                    path_aovs,
+                    guiding_records)
             {
             }
 
             void visit_vertex(const PathVertex& vertex)
             {
+                add_guiding_record(vertex.get_ray(), vertex.m_throughput);
+
                 if ((!m_omit_emitted_light || m_params.m_enable_caustics) &&
                     vertex.m_edf &&
                     vertex.m_cos_on > 0.0 &&
@@ -344,7 +440,7 @@ namespace
                 {
                     // Compute the emitted radiance.
                     Spectrum emitted_radiance;
-                    vertex.compute_emitted_radiance(m_texture_cache, emitted_radiance);
+                    vertex.compute_emitted_radiance(m_shading_context, emitted_radiance);
 
                     // Update the path radiance.
                     emitted_radiance *= vertex.m_throughput;
@@ -353,6 +449,15 @@ namespace
                 }
             }
 
+            void visit_volume_vertex(
+                const ShadingRay&       ray,
+                const Vector3d&         point,
+                const size_t            path_length,
+                const Spectrum&         throughput)
+            {
+                // Without next event estimation, light is only gathered at surface vertices.
+            }
+
             void visit_environment(
                 const ShadingPoint&     shading_point,
                 const Vector3d&         outgoing,
@@ -362,6 +467,8 @@ namespace
             {
                 assert(prev_bsdf_mode != BSDF::Absorption);
 
+                add_guiding_record(shading_point.get_ray(), throughput);
+
                 // Can't look up the environment if there's no environment EDF.
                 if (m_env_edf == 0)
                     return;
@@ -371,7 +478,9 @@ namespace
                     return;
 
                 // Evaluate the environment EDF.
-                InputEvaluator input_evaluator(m_texture_cache);
+                InputEvaluator input_evaluator(
+                    m_shading_context.get_texture_cache(),
+                    m_shading_context.get_arena());
                 Spectrum env_radiance;
                 double env_prob;
                 m_env_edf->evaluate(
@@ -394,7 +503,8 @@ namespace
         struct PathVisitorNextEventEstimation
           : public PathVisitorBase
         {
-            bool m_is_indirect_lighting;
+            bool                        m_is_indirect_lighting;
+            IsotropicPhaseFunction      m_phase_function;
 
             PathVisitorNextEventEstimation(
                 const Parameters&       params,
@@ -403,7 +513,8 @@ namespace
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
                 Spectrum&               path_radiance,
-                SpectrumStack&          path_aovs)
+                SpectrumStack&          path_aovs,
+                GuidingRecordVector*    guiding_records)
               : PathVisitorBase(
                     params,
                     light_sampler,
@@ -411,13 +522,16 @@ namespace
                     shading_context,
                     scene,
                     path_radiance,
-                    path_aovs)
+                    path_aovs,
+                    guiding_records)
               , m_is_indirect_lighting(false)
             {
             }
 
             void visit_vertex(const PathVertex& vertex)
             {
+                add_guiding_record(vertex.get_ray(), vertex.m_throughput);
+
                 // Any light contribution after a diffuse or glossy bounce is considered indirect.
                 if (BSDF::has_diffuse_or_glossy(vertex.m_prev_bsdf_mode))
                     m_is_indirect_lighting = true;
@@ -597,7 +711,7 @@ namespace
             {
                 // Compute the emitted radiance.
                 Spectrum emitted_radiance;
-                vertex.compute_emitted_radiance(m_texture_cache, emitted_radiance);
+                vertex.compute_emitted_radiance(m_shading_context, emitted_radiance);
 
                 // Multiple importance sampling.
                 if (vertex.m_prev_bsdf_mode != BSDF::Specular)
@@ -615,6 +729,133 @@ namespace
                 vertex_aovs.add(vertex.m_edf->get_render_layer_index(), emitted_radiance);
             }
 
+            void visit_volume_vertex(
+                const ShadingRay&       ray,
+                const Vector3d&         point,
+                const size_t            path_length,
+                const Spectrum&         throughput)
+            {
+                Spectrum vertex_radiance(0.0f);
+                SpectrumStack vertex_aovs(m_path_aovs.size(), 0.0f);
+
+                // The path won't be extended by phase function sampling past the last vertex.
+                const bool last_vertex = path_length == m_params.m_max_path_length;
+
+                // Direct lighting.
+                if (m_params.m_enable_dl || path_length > 1)
+                {
+                    add_volume_direct_lighting_contribution(
+                        ray,
+                        point,
+                        last_vertex,
+                        vertex_radiance,
+                        vertex_aovs);
+                }
+
+                // Image-based lighting.
+                if (m_params.m_enable_ibl && m_env_edf)
+                {
+                    add_volume_image_based_lighting_contribution(
+                        ray,
+                        point,
+                        last_vertex,
+                        vertex_radiance,
+                        vertex_aovs);
+                }
+
+                // Optionally clamp secondary rays contribution.
+                if (m_params.m_has_max_ray_intensity && path_length > 1)
+                {
+                    clamp_contribution(vertex_radiance);
+                    clamp_contribution(vertex_aovs);
+                }
+
+                // Update the path radiance.
+                vertex_radiance *= throughput;
+                m_path_radiance += vertex_radiance;
+                vertex_aovs *= throughput;
+                m_path_aovs += vertex_aovs;
+            }
+
+            void add_volume_direct_lighting_contribution(
+                const ShadingRay&       ray,
+                const Vector3d&         point,
+                const bool              last_vertex,
+                Spectrum&               vertex_radiance,
+                SpectrumStack&          vertex_aovs)
+            {
+                Spectrum dl_radiance;
+                SpectrumStack dl_aovs(vertex_aovs.size());
+
+                const size_t light_sample_count =
+                    stochastic_cast<size_t>(
+                        m_sampling_context,
+                        m_params.m_dl_light_sample_count);
+
+                // Light samples get full weight when the path won't be extended by phase function sampling.
+                const size_t phase_sample_count = last_vertex ? 0 : 1;
+
+                DirectLightingIntegrator integrator(
+                    m_shading_context,
+                    m_light_sampler,
+                    ScatteringPoint(ray, point, m_phase_function),
+                    phase_sample_count,
+                    light_sample_count,
+                    m_is_indirect_lighting);
+
+                integrator.sample_lights_low_variance(
+                    m_sampling_context,
+                    DirectLightingIntegrator::mis_power2,
+                    dl_radiance,
+                    dl_aovs);
+
+                // Divide by the sample count when this number is less than 1.
+                if (m_params.m_rcp_dl_light_sample_count > 0.0f)
+                {
+                    dl_radiance *= m_params.m_rcp_dl_light_sample_count;
+                    dl_aovs *= m_params.m_rcp_dl_light_sample_count;
+                }
+
+                // Add the direct lighting contributions.
+                vertex_radiance += dl_radiance;
+                vertex_aovs += dl_aovs;
+            }
+
+            void add_volume_image_based_lighting_contribution(
+                const ShadingRay&       ray,
+                const Vector3d&         point,
+                const bool              last_vertex,
+                Spectrum&               vertex_radiance,
+                SpectrumStack&          vertex_aovs)
+            {
+                Spectrum ibl_radiance;
+
+                const size_t env_sample_count =
+                    stochastic_cast<size_t>(
+                        m_sampling_context,
+                        m_params.m_ibl_env_sample_count);
+
+                // Environment samples get full weight when the path won't be extended by phase function sampling.
+                const size_t phase_sample_count = last_vertex ? 0 : 1;
+
+                compute_ibl_environment_sampling(
+                    m_sampling_context,
+                    m_shading_context,
+                    *m_env_edf,
+                    ScatteringPoint(ray, point, m_phase_function),
+                    phase_sample_count,
+                    env_sample_count,
+                    ibl_radiance);
+
+                // Divide by the sample count when this number is less than 1.
+                if (m_params.m_rcp_ibl_env_sample_count > 0.0f)
+                    ibl_radiance *= m_params.m_rcp_ibl_env_sample_count;
+
+                // Add the image-based lighting contributions.
+                vertex_radiance += ibl_radiance;
+                vertex_aovs.add(m_env_edf->get_render_layer_index(), ibl_radiance);
+            }
+
             void visit_environment(
                 const ShadingPoint&     shading_point,
                 const Vector3d&         outgoing,
@@ -624,6 +865,8 @@ namespace
             {
                 assert(prev_bsdf_mode != BSDF::Absorption);
 
+                add_guiding_record(shading_point.get_ray(), throughput);
+
                 // Can't look up the environment if there's no environment EDF.
                 if (m_env_edf == 0)
                     return;
@@ -633,7 +876,9 @@ namespace
                     return;
 
                 // Evaluate the environment EDF.
-                InputEvaluator input_evaluator(m_texture_cache);
+                InputEvaluator input_evaluator(
+                    m_shading_context.get_texture_cache(),
+                    m_shading_context.get_arena());
                 Spectrum env_radiance;
                 double env_prob;
                 m_env_edf->evaluate(
@@ -686,9 +931,11 @@ namespace
 
 PTLightingEngineFactory::PTLightingEngineFactory(
     const LightSampler& light_sampler,
-    const ParamArray&   params)
+    const ParamArray&   params,
+    SDTree*             sd_tree)
   : m_light_sampler(light_sampler)
   , m_params(params)
+  , m_sd_tree(sd_tree)
 {
     PTLightingEngine::Parameters(params).print();
 }
@@ -700,7 +947,7 @@ void PTLightingEngineFactory::release()
 
 ILightingEngine* PTLightingEngineFactory::create()
 {
-    return new PTLightingEngine(m_light_sampler, m_params);
+    return new PTLightingEngine(m_light_sampler, m_sd_tree, m_params);
 }
 
 }   // namespace renderer
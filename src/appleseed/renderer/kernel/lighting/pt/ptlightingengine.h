@@ -36,6 +36,7 @@
 
 // Forward declarations.
 namespace renderer  { class LightSampler; }
+namespace renderer  { class SDTree; }
 
 namespace renderer
 {
@@ -48,10 +49,11 @@ class PTLightingEngineFactory
   : public ILightingEngineFactory
 {
   public:
-    // Constructor.
+    // Constructor. Path guiding is enabled when an SD-tree is provided.
     PTLightingEngineFactory(
         const LightSampler& light_sampler,
-        const ParamArray&   params);
+        const ParamArray&   params,
+        SDTree*             sd_tree = 0);
 
     // Delete this instance.
     virtual void release() OVERRIDE;
@@ -62,6 +64,7 @@ class PTLightingEngineFactory
   private:
     const LightSampler&     m_light_sampler;
     ParamArray              m_params;
+    SDTree*                 m_sd_tree;
 };
 
 }       // namespace renderer
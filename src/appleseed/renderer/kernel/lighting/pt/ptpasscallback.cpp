@@ -0,0 +1,116 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "ptpasscallback.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemorytracker.h"
+#include "renderer/modeling/scene/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/utility/string.h"
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// PTPassCallback class implementation.
+//
+
+PTPassCallback::PTPassCallback(
+    const Scene&            scene,
+    const ParamArray&       params)
+  : m_training_pass_count(params.get_optional<size_t>("guiding_training_passes", 4))
+  , m_spatial_threshold(params.get_optional<size_t>("guiding_spatial_threshold", 12000))
+  , m_directional_threshold(params.get_optional<float>("guiding_directional_threshold", 0.01f))
+  , m_pass_number(0)
+  , m_sd_tree(AABB3d(scene.compute_bbox()))
+  , m_sd_tree_memory_size(global_memory_tracker(), "path guiding")
+{
+    RENDERER_LOG_INFO(
+        "path guiding settings:\n"
+        "  training passes  %s\n"
+        "  spatial thresh.  %s\n"
+        "  direct. thresh.  %s",
+        pretty_uint(m_training_pass_count).c_str(),
+        pretty_uint(m_spatial_threshold).c_str(),
+        pretty_scalar(m_directional_threshold).c_str());
+
+    if (m_training_pass_count == 0)
+        m_sd_tree.stop_recording();
+
+    m_sd_tree_memory_size.set(m_sd_tree.get_memory_size());
+}
+
+void PTPassCallback::release()
+{
+    delete this;
+}
+
+void PTPassCallback::pre_render(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    AbortSwitch&            abort_switch)
+{
+}
+
+void PTPassCallback::post_render(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    AbortSwitch&            abort_switch)
+{
+    ++m_pass_number;
+
+    if (!m_sd_tree.is_recording())
+        return;
+
+    // Learn new guiding distributions from the radiance recorded during this pass.
+    m_sd_tree.update(m_spatial_threshold, m_directional_threshold);
+
+    // Keep the distributions unchanged for the remaining passes.
+    if (m_pass_number >= m_training_pass_count)
+        m_sd_tree.stop_recording();
+
+    m_sd_tree_memory_size.set(m_sd_tree.get_memory_size());
+
+    RENDERER_LOG_INFO(
+        "path guiding training pass %s completed: %s spatial %s, %s directional %s.",
+        pretty_uint(m_pass_number).c_str(),
+        pretty_uint(m_sd_tree.get_leaf_count()).c_str(),
+        m_sd_tree.get_leaf_count() > 1 ? "regions" : "region",
+        pretty_uint(m_sd_tree.get_sampling_node_count()).c_str(),
+        m_sd_tree.get_sampling_node_count() > 1 ? "nodes" : "node");
+}
+
+}   // namespace renderer
@@ -0,0 +1,106 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_PT_PTPASSCALLBACK_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_PT_PTPASSCALLBACK_H
+
+// appleseed.renderer headers.
+#include "renderer/global/global.h"
+#include "renderer/kernel/lighting/sdtree.h"
+#include "renderer/kernel/rendering/ipasscallback.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/memorytracker.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace foundation    { class AbortSwitch; }
+namespace foundation    { class JobQueue; }
+namespace renderer      { class Frame; }
+namespace renderer      { class Scene; }
+
+namespace renderer
+{
+
+//
+// This class is responsible for learning the path guiding distributions at the end
+// of the first passes, from the radiance recorded by the path tracing lighting engine.
+//
+
+class PTPassCallback
+  : public IPassCallback
+{
+  public:
+    // Constructor.
+    PTPassCallback(
+        const Scene&                scene,
+        const ParamArray&           params);
+
+    // Delete this instance.
+    virtual void release() OVERRIDE;
+
+    // This method is called at the beginning of a pass.
+    virtual void pre_render(
+        const Frame&                frame,
+        foundation::JobQueue&       job_queue,
+        foundation::AbortSwitch&    abort_switch) OVERRIDE;
+
+    // This method is called at the end of a pass.
+    virtual void post_render(
+        const Frame&                frame,
+        foundation::JobQueue&       job_queue,
+        foundation::AbortSwitch&    abort_switch) OVERRIDE;
+
+    // Return the SD-tree used to guide path sampling.
+    SDTree& get_sd_tree();
+
+  private:
+    const size_t                    m_training_pass_count;
+    const size_t                    m_spatial_threshold;
+    const float                     m_directional_threshold;
+    size_t                          m_pass_number;
+    SDTree                          m_sd_tree;
+    foundation::TrackedMemorySize   m_sd_tree_memory_size;
+};
+
+
+//
+// PTPassCallback class implementation.
+//
+
+inline SDTree& PTPassCallback::get_sd_tree()
+{
+    return m_sd_tree;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_PT_PTPASSCALLBACK_H
@@ -0,0 +1,270 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_SCATTERINGPOINT_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_SCATTERINGPOINT_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/tracer.h"
+#include "renderer/kernel/shading/shadingcontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/volume/phasefunction.h"
+#include "renderer/modeling/bsdf/bsdf.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cassert>
+
+namespace renderer
+{
+
+//
+// A point at which light is scattered toward the camera: either a point on a surface,
+// where scattering is described by a BSDF, or a point inside a participating medium,
+// where it is described by a phase function.
+//
+// The direct lighting and image-based lighting estimators only need to cull, trace
+// shadow rays from and evaluate scattering at such a point, so that the same light
+// sampling and MIS code serves both surface and medium vertices.
+//
+
+class ScatteringPoint
+{
+  public:
+    // Constructor for a point on a surface.
+    ScatteringPoint(
+        const ShadingPoint&             shading_point,
+        const foundation::Vector3d&     outgoing,               // world space outgoing direction, unit-length
+        const BSDF&                     bsdf,
+        const void*                     bsdf_data,
+        const int                       scattering_modes);      // permitted scattering modes during evaluation
+
+    // Constructor for a point inside a participating medium.
+    ScatteringPoint(
+        const ShadingRay&               ray,                    // ray along which the scattering event happened
+        const foundation::Vector3d&     point,
+        const PhaseFunction&            phase_function);
+
+    // Return true if this point lies on a surface.
+    bool is_on_surface() const;
+
+    // Surface-specific accessors.
+    const ShadingPoint& get_shading_point() const;
+    const BSDF& get_bsdf() const;
+    const void* get_bsdf_data() const;
+
+    const foundation::Vector3d& get_point() const;
+    const foundation::Vector3d& get_outgoing() const;
+    double get_time() const;
+
+    // Return false if light arriving from a given (not necessarily unit-length)
+    // direction cannot be scattered at this point, for instance because it comes
+    // from behind an opaque surface.
+    bool is_lit_from(const foundation::Vector3d& incoming) const;
+
+    // Compute the transmission in a given direction.
+    double trace(
+        const ShadingContext&           shading_context,
+        const foundation::Vector3d&     direction) const;
+
+    // Compute the transmission between this point and a given point.
+    double trace_between(
+        const ShadingContext&           shading_context,
+        const foundation::Vector3d&     target) const;
+
+    // Evaluate the scattering of light arriving from a given unit-length direction,
+    // including the cosine term on surfaces. Return the probability density with
+    // respect to solid angle of sampling this direction, or 0 if there is no scattering.
+    double evaluate(
+        const foundation::Vector3d&     incoming,
+        Spectrum&                       value) const;
+
+  private:
+    const ShadingPoint*                 m_shading_point;
+    const BSDF*                         m_bsdf;
+    const void*                         m_bsdf_data;
+    const PhaseFunction*                m_phase_function;
+    const int                           m_scattering_modes;
+    const foundation::Vector3d          m_point;
+    const foundation::Vector3d          m_outgoing;
+    const double                        m_time;
+    const ShadingRay::DepthType         m_ray_depth;
+};
+
+
+//
+// ScatteringPoint class implementation.
+//
+
+inline ScatteringPoint::ScatteringPoint(
+    const ShadingPoint&                 shading_point,
+    const foundation::Vector3d&         outgoing,
+    const BSDF&                         bsdf,
+    const void*                         bsdf_data,
+    const int                           scattering_modes)
+  : m_shading_point(&shading_point)
+  , m_bsdf(&bsdf)
+  , m_bsdf_data(bsdf_data)
+  , m_phase_function(0)
+  , m_scattering_modes(scattering_modes)
+  , m_point(shading_point.get_point())
+  , m_outgoing(outgoing)
+  , m_time(shading_point.get_time())
+  , m_ray_depth(shading_point.get_ray().m_depth)
+{
+    assert(foundation::is_normalized(outgoing));
+}
+
+inline ScatteringPoint::ScatteringPoint(
+    const ShadingRay&                   ray,
+    const foundation::Vector3d&         point,
+    const PhaseFunction&                phase_function)
+  : m_shading_point(0)
+  , m_bsdf(0)
+  , m_bsdf_data(0)
+  , m_phase_function(&phase_function)
+  , m_scattering_modes(BSDF::AllScatteringModes)
+  , m_point(point)
+  , m_outgoing(foundation::normalize(-ray.m_dir))
+  , m_time(ray.m_time)
+  , m_ray_depth(ray.m_depth)
+{
+}
+
+inline bool ScatteringPoint::is_on_surface() const
+{
+    return m_shading_point != 0;
+}
+
+inline const ShadingPoint& ScatteringPoint::get_shading_point() const
+{
+    assert(m_shading_point);
+    return *m_shading_point;
+}
+
+inline const BSDF& ScatteringPoint::get_bsdf() const
+{
+    assert(m_bsdf);
+    return *m_bsdf;
+}
+
+inline const void* ScatteringPoint::get_bsdf_data() const
+{
+    return m_bsdf_data;
+}
+
+inline const foundation::Vector3d& ScatteringPoint::get_point() const
+{
+    return m_point;
+}
+
+inline const foundation::Vector3d& ScatteringPoint::get_outgoing() const
+{
+    return m_outgoing;
+}
+
+inline double ScatteringPoint::get_time() const
+{
+    return m_time;
+}
+
+inline bool ScatteringPoint::is_lit_from(const foundation::Vector3d& incoming) const
+{
+    if (m_shading_point == 0)
+        return true;
+
+    double cos_in = foundation::dot(incoming, m_shading_point->get_shading_normal());
+    if (m_bsdf->get_type() == BSDF::Transmissive)
+        cos_in = -cos_in;
+
+    return cos_in > 0.0;
+}
+
+inline double ScatteringPoint::trace(
+    const ShadingContext&               shading_context,
+    const foundation::Vector3d&         direction) const
+{
+    return
+        m_shading_point
+            ? shading_context.get_tracer().trace(
+                  *m_shading_point,
+                  direction,
+                  ShadingRay::ShadowRay)
+            : shading_context.get_tracer().trace(
+                  m_point,
+                  direction,
+                  m_time,
+                  ShadingRay::ShadowRay,
+                  m_ray_depth);
+}
+
+inline double ScatteringPoint::trace_between(
+    const ShadingContext&               shading_context,
+    const foundation::Vector3d&         target) const
+{
+    return
+        m_shading_point
+            ? shading_context.get_tracer().trace_between(
+                  *m_shading_point,
+                  target,
+                  ShadingRay::ShadowRay)
+            : shading_context.get_tracer().trace_between(
+                  m_point,
+                  target,
+                  m_time,
+                  ShadingRay::ShadowRay,
+                  m_ray_depth);
+}
+
+inline double ScatteringPoint::evaluate(
+    const foundation::Vector3d&         incoming,
+    Spectrum&                           value) const
+{
+    if (m_shading_point == 0)
+        return m_phase_function->evaluate(m_outgoing, incoming, value);
+
+    return
+        m_bsdf->evaluate(
+            m_bsdf_data,
+            false,                          // not adjoint
+            true,                           // multiply by |cos(incoming, normal)|
+            m_shading_point->get_geometric_normal(),
+            m_shading_point->get_shading_basis(),
+            m_outgoing,
+            incoming,
+            m_scattering_modes,
+            value);
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SCATTERINGPOINT_H
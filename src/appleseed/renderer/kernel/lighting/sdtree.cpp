@@ -0,0 +1,443 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "sdtree.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/scalar.h"
+#include "foundation/platform/thread.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    // Map a unit-length direction to the unit square, preserving areas.
+    Vector2d direction_to_square(const Vector3d& d)
+    {
+        const double cos_theta = clamp(d.z, -1.0, 1.0);
+        double phi = atan2(d.y, d.x);
+        if (phi < 0.0)
+            phi += TwoPi;
+
+        return
+            Vector2d(
+                (cos_theta + 1.0) * 0.5,
+                min(phi * RcpTwoPi, 1.0 - 1.0e-9));
+    }
+
+    // Map a point of the unit square back to a unit-length direction.
+    Vector3d square_to_direction(const Vector2d& p)
+    {
+        const double cos_theta = 2.0 * p.x - 1.0;
+        const double sin_theta = sqrt(max(1.0 - cos_theta * cos_theta, 0.0));
+        const double phi = TwoPi * p.y;
+
+        return
+            Vector3d(
+                sin_theta * cos(phi),
+                sin_theta * sin(phi),
+                cos_theta);
+    }
+
+    // Return the quadrant of the unit square containing a point,
+    // and remap the point to the unit square of that quadrant.
+    size_t select_quadrant(Vector2d& p)
+    {
+        size_t quadrant = 0;
+
+        if (p.x >= 0.5)
+        {
+            quadrant += 1;
+            p.x -= 0.5;
+        }
+
+        if (p.y >= 0.5)
+        {
+            quadrant += 2;
+            p.y -= 0.5;
+        }
+
+        p *= 2.0;
+
+        return quadrant;
+    }
+
+    // Choose one of two events with probabilities proportional to their weights,
+    // and remap the sample to [0,1). Returns 0 or 1.
+    size_t choose(const double w0, const double w1, double& s)
+    {
+        const double p0 = w0 / (w0 + w1);
+
+        if (s < p0)
+        {
+            s = min(s / p0, 1.0 - 1.0e-9);
+            return 0;
+        }
+        else
+        {
+            s = min((s - p0) / (1.0 - p0), 1.0 - 1.0e-9);
+            return 1;
+        }
+    }
+
+    // A node of a directional tree under construction.
+    struct RefineItem
+    {
+        size_t  m_source_index;     // ~0 if the source tree is not subdivided this deep
+        size_t  m_node_index;
+        float   m_fraction;         // fraction of the total radiance covered by the node
+        size_t  m_depth;
+    };
+}
+
+
+//
+// DTree class implementation.
+//
+
+DTree::DTree()
+  : m_nodes(1)
+  , m_sample_count(0)
+{
+}
+
+size_t DTree::get_memory_size() const
+{
+    return sizeof(*this) + m_nodes.capacity() * sizeof(Node);
+}
+
+void DTree::record(const Vector3d& direction, const float radiance)
+{
+    Vector2d p = direction_to_square(direction);
+    size_t node_index = 0;
+
+    while (true)
+    {
+        Node& node = m_nodes[node_index];
+        const size_t quadrant = select_quadrant(p);
+
+        atomic_add(&node.m_sums[quadrant], radiance);
+
+        if (node.m_children[quadrant] == 0)
+            break;
+
+        node_index = node.m_children[quadrant];
+    }
+
+    boost_atomic::atomic_inc32(&m_sample_count);
+}
+
+Vector3d DTree::sample(const Vector2d& s) const
+{
+    Vector2d u = s;
+    Vector2d origin(0.0);
+    double size = 1.0;
+    size_t node_index = 0;
+
+    while (true)
+    {
+        const Node& node = m_nodes[node_index];
+
+        // Sample uniformly within nodes that received no radiance.
+        if (node.get_sum() <= 0.0f)
+            break;
+
+        // Choose a column of quadrants, then a quadrant within that column.
+        const size_t x = choose(node.m_sums[0] + node.m_sums[2], node.m_sums[1] + node.m_sums[3], u.x);
+        const size_t y = choose(node.m_sums[x], node.m_sums[x + 2], u.y);
+        const size_t quadrant = x + 2 * y;
+
+        size *= 0.5;
+        origin.x += x * size;
+        origin.y += y * size;
+
+        if (node.m_children[quadrant] == 0)
+            break;
+
+        node_index = node.m_children[quadrant];
+    }
+
+    return square_to_direction(origin + u * size);
+}
+
+double DTree::evaluate_pdf(const Vector3d& direction) const
+{
+    Vector2d p = direction_to_square(direction);
+    double pdf = 1.0;
+    size_t node_index = 0;
+
+    while (true)
+    {
+        const Node& node = m_nodes[node_index];
+
+        const float sum = node.get_sum();
+        if (sum <= 0.0f)
+            break;
+
+        const size_t quadrant = select_quadrant(p);
+        pdf *= 4.0 * node.m_sums[quadrant] / sum;
+
+        if (node.m_children[quadrant] == 0)
+            break;
+
+        node_index = node.m_children[quadrant];
+    }
+
+    // Account for the Jacobian of the cylindrical mapping.
+    return pdf * RcpFourPi;
+}
+
+void DTree::refine(const DTree& source, const float threshold)
+{
+    m_nodes.assign(1, Node());
+    m_sample_count = 0;
+
+    const float total = source.get_sum();
+    if (total <= 0.0f)
+        return;
+
+    vector<RefineItem> stack;
+
+    RefineItem root;
+    root.m_source_index = 0;
+    root.m_node_index = 0;
+    root.m_fraction = 1.0f;
+    root.m_depth = 1;
+    stack.push_back(root);
+
+    while (!stack.empty())
+    {
+        const RefineItem item = stack.back();
+        stack.pop_back();
+
+        const Node* source_node =
+            item.m_source_index != ~size_t(0) ? &source.m_nodes[item.m_source_index] : 0;
+        const float source_sum = source_node ? source_node->get_sum() : 0.0f;
+
+        for (size_t q = 0; q < 4; ++q)
+        {
+            // Radiance is assumed to be uniform below the leaves of the source tree.
+            const float fraction =
+                source_sum > 0.0f
+                    ? item.m_fraction * source_node->m_sums[q] / source_sum
+                    : item.m_fraction * 0.25f;
+
+            if (fraction <= threshold || item.m_depth >= MaxDepth)
+                continue;
+
+            const size_t child_index = m_nodes.size();
+            m_nodes.push_back(Node());
+            m_nodes[item.m_node_index].m_children[q] = static_cast<uint32>(child_index);
+
+            RefineItem child;
+            child.m_source_index =
+                source_node && source_node->m_children[q] != 0
+                    ? source_node->m_children[q]
+                    : ~size_t(0);
+            child.m_node_index = child_index;
+            child.m_fraction = fraction;
+            child.m_depth = item.m_depth + 1;
+            stack.push_back(child);
+        }
+    }
+}
+
+
+//
+// SDTree class implementation.
+//
+
+SDTree::SDTree(const AABB3d& bbox)
+  : m_bbox(bbox)
+  , m_nodes(1)
+  , m_leaves(1)
+  , m_recording(true)
+  , m_built(false)
+{
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const double extent = m_bbox.is_valid() ? m_bbox.extent(i) : 0.0;
+        m_rcp_extent[i] = extent > 0.0 ? 1.0 / extent : 0.0;
+    }
+}
+
+void SDTree::stop_recording()
+{
+    m_recording = false;
+
+    // Release the memory used by the recording trees.
+    for (size_t i = 0; i < m_leaves.size(); ++i)
+        m_leaves[i].m_recording = DTree();
+}
+
+void SDTree::record(
+    const Vector3d&     point,
+    const Vector3d&     direction,
+    const float         radiance)
+{
+    assert(m_recording);
+
+    m_leaves[find_leaf(point)].m_recording.record(direction, radiance);
+}
+
+const DTree* SDTree::find_sampling_dtree(const Vector3d& point) const
+{
+    if (!m_built)
+        return 0;
+
+    const DTree& dtree = m_leaves[find_leaf(point)].m_sampling;
+
+    return dtree.get_sum() > 0.0f ? &dtree : 0;
+}
+
+void SDTree::update(
+    const size_t        spatial_threshold,
+    const float         directional_threshold)
+{
+    vector<size_t> sample_counts(m_leaves.size());
+
+    for (size_t i = 0; i < m_leaves.size(); ++i)
+    {
+        Leaf& leaf = m_leaves[i];
+        sample_counts[i] = leaf.m_recording.get_sample_count();
+
+        // The radiance recorded during this pass becomes the sampling distribution.
+        leaf.m_sampling = leaf.m_recording;
+        leaf.m_recording.refine(leaf.m_sampling, directional_threshold);
+    }
+
+    // Split the leaves that received too many records, along the axis of their depth.
+    vector<pair<size_t, size_t> > stack;
+    stack.push_back(make_pair(0, 0));
+
+    while (!stack.empty())
+    {
+        const size_t node_index = stack.back().first;
+        const size_t depth = stack.back().second;
+        stack.pop_back();
+
+        if (!m_nodes[node_index].is_leaf())
+        {
+            stack.push_back(make_pair(m_nodes[node_index].m_children[0], depth + 1));
+            stack.push_back(make_pair(m_nodes[node_index].m_children[1], depth + 1));
+            continue;
+        }
+
+        const size_t leaf_index = m_nodes[node_index].m_leaf_index;
+
+        if (sample_counts[leaf_index] <= spatial_threshold || depth >= MaxDepth)
+            continue;
+
+        // Both halves start with the distributions of the parent. Records are assumed
+        // to be evenly distributed between the two halves.
+        const Leaf leaf = m_leaves[leaf_index];
+        const size_t new_leaf_index = m_leaves.size();
+        m_leaves.push_back(leaf);
+        sample_counts[leaf_index] /= 2;
+        sample_counts.push_back(sample_counts[leaf_index]);
+
+        const size_t child_index = m_nodes.size();
+        m_nodes.resize(child_index + 2);
+        m_nodes[child_index].m_leaf_index = static_cast<uint32>(leaf_index);
+        m_nodes[child_index + 1].m_leaf_index = static_cast<uint32>(new_leaf_index);
+        m_nodes[node_index].m_children[0] = static_cast<uint32>(child_index);
+        m_nodes[node_index].m_children[1] = static_cast<uint32>(child_index + 1);
+
+        stack.push_back(make_pair(child_index, depth + 1));
+        stack.push_back(make_pair(child_index + 1, depth + 1));
+    }
+
+    m_built = true;
+}
+
+size_t SDTree::get_sampling_node_count() const
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < m_leaves.size(); ++i)
+        count += m_leaves[i].m_sampling.get_node_count();
+
+    return count;
+}
+
+size_t SDTree::get_memory_size() const
+{
+    size_t size = sizeof(*this) + m_nodes.capacity() * sizeof(Node);
+
+    for (size_t i = 0; i < m_leaves.size(); ++i)
+    {
+        size += m_leaves[i].m_sampling.get_memory_size();
+        size += m_leaves[i].m_recording.get_memory_size();
+    }
+
+    return size;
+}
+
+size_t SDTree::find_leaf(const Vector3d& point) const
+{
+    // Compute the position of the point in the unit cube.
+    Vector3d p;
+    for (size_t i = 0; i < 3; ++i)
+        p[i] = clamp((point[i] - m_bbox.min[i]) * m_rcp_extent[i], 0.0, 1.0);
+
+    size_t node_index = 0;
+    size_t axis = 0;
+
+    while (!m_nodes[node_index].is_leaf())
+    {
+        const Node& node = m_nodes[node_index];
+
+        if (p[axis] < 0.5)
+        {
+            p[axis] *= 2.0;
+            node_index = node.m_children[0];
+        }
+        else
+        {
+            p[axis] = 2.0 * p[axis] - 1.0;
+            node_index = node.m_children[1];
+        }
+
+        axis = axis == 2 ? 0 : axis + 1;
+    }
+
+    return m_nodes[node_index].m_leaf_index;
+}
+
+}   // namespace renderer
@@ -0,0 +1,248 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_SDTREE_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_SDTREE_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+namespace renderer
+{
+
+//
+// A quadtree representing a distribution of incoming radiance over the sphere of directions.
+//
+// Directions are mapped to the unit square with an area-preserving cylindrical mapping.
+// Every node stores the radiance recorded in each of its four quadrants, such that the
+// tree can be sampled directly from its root.
+//
+// Recording is thread-safe; sampling and recording must not happen on the same tree
+// at the same time.
+//
+
+class DTree
+{
+  public:
+    // Constructor, creates a tree with a single node and no recorded radiance.
+    DTree();
+
+    // Record radiance arriving from a given direction. Thread-safe.
+    void record(const foundation::Vector3d& direction, const float radiance);
+
+    // Return the total recorded radiance.
+    float get_sum() const;
+
+    // Return the number of radiance records.
+    size_t get_sample_count() const;
+
+    // Return the number of nodes of the tree.
+    size_t get_node_count() const;
+
+    // Return the amount of memory used by the tree, in bytes.
+    size_t get_memory_size() const;
+
+    // Sample a direction proportionally to the recorded radiance.
+    foundation::Vector3d sample(const foundation::Vector2d& s) const;
+
+    // Evaluate the probability density (with respect to solid angle) of a given direction.
+    double evaluate_pdf(const foundation::Vector3d& direction) const;
+
+    // Clear this tree and subdivide it such that no leaf holds more than a given
+    // fraction of the radiance recorded in another tree.
+    void refine(const DTree& source, const float threshold);
+
+  private:
+    enum { MaxDepth = 20 };
+
+    struct Node
+    {
+        float               m_sums[4];          // radiance recorded in each quadrant
+        foundation::uint32  m_children[4];      // child node index of each quadrant, 0 for none
+
+        Node();
+
+        float get_sum() const;
+    };
+
+    std::vector<Node>       m_nodes;
+    foundation::uint32      m_sample_count;
+};
+
+
+//
+// A binary tree over the scene bounding box whose leaves hold directional distributions
+// of incoming radiance, learned over successive rendering passes.
+//
+// Each leaf holds two directional trees: one recording radiance during the current pass,
+// and one that was learned during the previous passes and is used to guide sampling.
+//
+// Reference:
+//
+//   Practical Path Guiding for Efficient Light-Transport Simulation
+//   Thomas Muller, Markus Gross, Jan Novak
+//   https://tom94.net/data/publications/mueller17practical/mueller17practical.pdf
+//
+
+class SDTree
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    explicit SDTree(const foundation::AABB3d& bbox);
+
+    // Return true if radiance should be recorded into the tree.
+    bool is_recording() const;
+
+    // Stop recording radiance. The current sampling distributions are kept.
+    void stop_recording();
+
+    // Record radiance arriving at a given point from a given direction. Thread-safe.
+    void record(
+        const foundation::Vector3d& point,
+        const foundation::Vector3d& direction,
+        const float                 radiance);
+
+    // Return the distribution to sample at a given point, or 0 if nothing was learned there yet.
+    const DTree* find_sampling_dtree(const foundation::Vector3d& point) const;
+
+    // Make the radiance recorded so far the new sampling distributions, then refine
+    // the spatial and directional subdivisions for the next recording pass.
+    void update(
+        const size_t                spatial_threshold,      // max number of records in a spatial leaf
+        const float                 directional_threshold); // max fraction of radiance in a directional leaf
+
+    // Return the number of spatial leaves.
+    size_t get_leaf_count() const;
+
+    // Return the total number of directional nodes used for sampling.
+    size_t get_sampling_node_count() const;
+
+    // Return the amount of memory used by the tree, in bytes.
+    size_t get_memory_size() const;
+
+  private:
+    enum { MaxDepth = 24 };
+
+    struct Node
+    {
+        foundation::uint32  m_children[2];      // child node indices, 0 for a leaf
+        foundation::uint32  m_leaf_index;       // index of the leaf in m_leaves
+
+        Node();
+
+        bool is_leaf() const;
+    };
+
+    struct Leaf
+    {
+        DTree               m_sampling;
+        DTree               m_recording;
+    };
+
+    const foundation::AABB3d    m_bbox;
+    foundation::Vector3d        m_rcp_extent;
+    std::vector<Node>           m_nodes;
+    std::vector<Leaf>           m_leaves;
+    bool                        m_recording;
+    bool                        m_built;
+
+    size_t find_leaf(const foundation::Vector3d& point) const;
+};
+
+
+//
+// DTree class implementation.
+//
+
+inline DTree::Node::Node()
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        m_sums[i] = 0.0f;
+        m_children[i] = 0;
+    }
+}
+
+inline float DTree::Node::get_sum() const
+{
+    return m_sums[0] + m_sums[1] + m_sums[2] + m_sums[3];
+}
+
+inline float DTree::get_sum() const
+{
+    return m_nodes[0].get_sum();
+}
+
+inline size_t DTree::get_sample_count() const
+{
+    return m_sample_count;
+}
+
+inline size_t DTree::get_node_count() const
+{
+    return m_nodes.size();
+}
+
+
+//
+// SDTree class implementation.
+//
+
+inline SDTree::Node::Node()
+  : m_leaf_index(0)
+{
+    m_children[0] = 0;
+    m_children[1] = 0;
+}
+
+inline bool SDTree::Node::is_leaf() const
+{
+    return m_children[0] == 0;
+}
+
+inline bool SDTree::is_recording() const
+{
+    return m_recording;
+}
+
+inline size_t SDTree::get_leaf_count() const
+{
+    return m_leaves.size();
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SDTREE_H
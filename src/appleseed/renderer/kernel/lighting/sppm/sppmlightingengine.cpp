@@ -54,6 +54,8 @@
 #include "foundation/math/mis.h"
 #include "foundation/math/population.h"
 #include "foundation/math/scalar.h"
+#include "foundation/platform/types.h"
+#include "foundation/platform/x86timer.h"
 #include "foundation/utility/memory.h"
 #include "foundation/utility/statistics.h"
 
@@ -131,6 +133,9 @@ namespace
           , m_path_count(0)
           , m_answer(m_params.m_max_photons_per_estimate)
         {
+            m_lookup_stats.m_timer_freq = m_lookup_stats.m_timer.frequency();
+            m_lookup_stats.m_count = 0;
+            m_lookup_stats.m_ticks = 0;
         }
 
         virtual void release() OVERRIDE
@@ -160,6 +165,7 @@ namespace
                 shading_context,
                 shading_point.get_scene(),
                 m_answer,
+                m_lookup_stats,
                 radiance,
                 aovs);
 
@@ -185,17 +191,30 @@ namespace
             Statistics stats;
             stats.insert("path count", m_path_count);
             stats.insert("path length", m_path_length);
+            stats.insert("photon lookups", m_lookup_stats.m_count);
+            stats.insert_time(
+                "photon lookup time",
+                static_cast<double>(m_lookup_stats.m_ticks) / m_lookup_stats.m_timer_freq);
 
             return StatisticsVector::make("sppm statistics", stats);
         }
 
       private:
+        struct LookupStatistics
+        {
+            X86Timer                    m_timer;
+            uint64                      m_timer_freq;
+            uint64                      m_count;        // number of photon lookups
+            uint64                      m_ticks;        // time spent in photon lookups, in timer ticks
+        };
+
         const SPPMParameters            m_params;
         const SPPMPassCallback&         m_pass_callback;
         const LightSampler&             m_light_sampler;
         uint64                          m_path_count;
         Population<uint64>              m_path_length;
         knn::Answer<float>              m_answer;
+        LookupStatistics                m_lookup_stats;
 
         struct PathVisitor
         {
@@ -204,9 +223,9 @@ namespace
             const LightSampler&         m_light_sampler;
             SamplingContext&            m_sampling_context;
             const ShadingContext&       m_shading_context;
-            TextureCache&               m_texture_cache;
             const EnvironmentEDF*       m_env_edf;
             knn::Answer<float>&         m_answer;
+            LookupStatistics&           m_lookup_stats;
             Spectrum&                   m_path_radiance;
             SpectrumStack&              m_path_aovs;
 
@@ -218,6 +237,7 @@ namespace
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
                 knn::Answer<float>&     answer,
+                LookupStatistics&       lookup_stats,
                 Spectrum&               path_radiance,
                 SpectrumStack&          path_aovs)
               : m_params(params)
@@ -225,9 +245,9 @@ namespace
               , m_light_sampler(light_sampler)
               , m_sampling_context(sampling_context)
               , m_shading_context(shading_context)
-              , m_texture_cache(shading_context.get_texture_cache())
               , m_env_edf(scene.get_environment()->get_environment_edf())
               , m_answer(answer)
+              , m_lookup_stats(lookup_stats)
               , m_path_radiance(path_radiance)
               , m_path_aovs(path_aovs)
             {
@@ -349,8 +369,10 @@ namespace
                 const Vector3f normal(vertex.get_geometric_normal());
 
                 // Find the nearby photons around the path vertex.
-                const knn::Query3f query(photon_map, m_answer);
-                query.run(point, radius * radius);
+                const uint64 lookup_start = m_lookup_stats.m_timer.read();
+                photon_map.find_nearest_photons(point, radius * radius, m_answer);
+                m_lookup_stats.m_ticks += m_lookup_stats.m_timer.read() - lookup_start;
+                ++m_lookup_stats.m_count;
                 const size_t photon_count = m_answer.size();
 
                 // Compute the square radius of the lookup disk.
@@ -370,6 +392,7 @@ namespace
                     return;
 #endif
 
+                const SPPMPhotonVector& photons = m_pass_callback.get_photons();
                 size_t included_photon_count = 0;
                 Spectrum indirect_radiance(0.0f);
 
@@ -378,22 +401,25 @@ namespace
                 {
                     // Retrieve the i'th photon.
                     const knn::Answer<float>::Entry& photon = m_answer.get(i);
-                    const SPPMPhotonData& data = m_pass_callback.get_photon_data(photon_map.remap(photon.m_index));
+                    const size_t photon_index = photon_map.remap(photon.m_index);
 
                     // Reject photons from the opposite hemisphere as they won't contribute.
-                    if (dot(normal, data.m_incoming) <= 0.0f)
+                    const Vector3f photon_incoming = photons.get_incoming(photon_index);
+                    if (dot(normal, photon_incoming) <= 0.0f)
                         continue;
 
+                    const Vector3f photon_geometric_normal = photons.get_geometric_normal(photon_index);
+
 #if 1
                     // Reject photons on a surface with too different an orientation.
                     const float NormalThreshold = 1.0e-3f;
-                    if (dot(normal, data.m_geometric_normal) < NormalThreshold)
+                    if (dot(normal, photon_geometric_normal) < NormalThreshold)
                         continue;
 #endif
 
 #if 0
                     // Reject photons on the wrong side of the surface.
-                    if (dot(vertex.m_outgoing, Vector3d(data.m_geometric_normal)) <= 0.0)
+                    if (dot(vertex.m_outgoing, Vector3d(photon_geometric_normal)) <= 0.0)
                         continue;
 #endif
 
@@ -416,7 +442,7 @@ namespace
                             vertex.get_geometric_normal(),
                             vertex.get_shading_basis(),
                             vertex.m_outgoing,                      // toward the camera
-                            normalize(Vector3d(data.m_incoming)),   // toward the light
+                            Vector3d(photon_incoming),              // toward the light
                             BSDF::Diffuse,
                             bsdf_value);
                     if (bsdf_prob == 0.0)
@@ -425,8 +451,11 @@ namespace
                     // The photons store flux but we are computing reflected radiance.
                     // The first step of the flux -> radiance conversion is done here.
                     // The conversion will be completed when doing density estimation.
-                    bsdf_value /= abs(dot(data.m_incoming, data.m_geometric_normal));
-                    bsdf_value *= data.m_flux;
+                    // The flux is only decoded for photons that passed all the tests above.
+                    Spectrum flux;
+                    photons.get_flux(photon_index, flux);
+                    bsdf_value /= abs(dot(photon_incoming, photon_geometric_normal));
+                    bsdf_value *= flux;
 
                     // Apply kernel weight.
 #if 0
@@ -464,13 +493,22 @@ namespace
             {
                 // Compute the emitted radiance.
                 Spectrum emitted_radiance;
-                vertex.compute_emitted_radiance(m_texture_cache, emitted_radiance);
+                vertex.compute_emitted_radiance(m_shading_context, emitted_radiance);
 
                 // Add the emitted light contribution.
                 vertex_radiance += emitted_radiance;
                 vertex_aovs.add(vertex.m_edf->get_render_layer_index(), emitted_radiance);
             }
 
+            void visit_volume_vertex(
+                const ShadingRay&       ray,
+                const Vector3d&         point,
+                const size_t            path_length,
+                const Spectrum&         throughput)
+            {
+                // There is no photon lookup in participating media, the path simply continues.
+            }
+
             void visit_environment(
                 const ShadingPoint&     shading_point,
                 const Vector3d&         outgoing,
@@ -489,7 +527,9 @@ namespace
                     return;
 
                 // Evaluate the environment EDF.
-                InputEvaluator input_evaluator(m_texture_cache);
+                InputEvaluator input_evaluator(
+                    m_shading_context.get_texture_cache(),
+                    m_shading_context.get_arena());
                 Spectrum env_radiance;
                 double env_prob;
                 m_env_edf->evaluate(
@@ -510,20 +550,23 @@ namespace
             Spectrum&               radiance)
         {
             const SPPMPhotonMap& photon_map = m_pass_callback.get_photon_map();
-            const knn::Query3f query(photon_map, m_answer);
 
-            query.run(
+            photon_map.find_nearest_photons(
                 Vector3f(shading_point.get_point()),
-                square(m_params.m_view_photons_radius));
+                square(m_params.m_view_photons_radius),
+                m_answer);
 
             radiance.set(0.0f);
 
+            const SPPMPhotonVector& photons = m_pass_callback.get_photons();
             const size_t photon_count = m_answer.size();
 
             for (size_t i = 0; i < photon_count; ++i)
             {
                 const knn::Answer<float>::Entry& photon = m_answer.get(i);
-                radiance += m_pass_callback.get_photon_data(photon_map.remap(photon.m_index)).m_flux;
+                Spectrum flux;
+                photons.get_flux(photon_map.remap(photon.m_index), flux);
+                radiance += flux;
             }
 
             if (photon_count > 1)
@@ -32,6 +32,8 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemorytracker.h"
+#include "renderer/global/globaltraceeventrecorder.h"
 #include "renderer/modeling/scene/scene.h"
 
 // appleseed.foundation headers.
@@ -75,6 +77,7 @@ SPPMPassCallback::SPPMPassCallback(
         params)
   , m_pass_number(0)
   , m_emitted_photon_count(0)
+  , m_photon_memory_size(global_memory_tracker(), "sppm photons")
 {
     // Compute the initial lookup radius.
     const float scene_diameter = static_cast<float>(2.0 * scene.compute_radius());
@@ -113,7 +116,14 @@ void SPPMPassCallback::pre_render(
         return;
 
     // Build a new photon map.
-    m_photon_map.reset(new SPPMPhotonMap(m_photons));
+    TraceScope trace(global_trace_event_recorder(), "build photon map", "setup");
+    m_photon_map.reset(
+        new SPPMPhotonMap(
+            m_photons,
+            m_params.m_photon_map_type,
+            m_lookup_radius));
+
+    m_photon_memory_size.set(m_photons.get_memory_size() + m_photon_map->get_memory_size());
 }
 
 void SPPMPassCallback::post_render(
@@ -129,9 +139,10 @@ void SPPMPassCallback::post_render(
     m_stopwatch.measure();
 
     RENDERER_LOG_INFO(
-        "sppm pass %s completed in %s.",
+        "sppm pass %s completed in %s (photon map built in %s).",
         pretty_uint(m_pass_number + 1).c_str(),
-        pretty_time(m_stopwatch.get_seconds()).c_str());
+        pretty_time(m_stopwatch.get_seconds()).c_str(),
+        pretty_time(m_photon_map.get() ? m_photon_map->get_build_time() : 0.0).c_str());
 
     ++m_pass_number;
 }
@@ -41,6 +41,7 @@
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/timer.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/memorytracker.h"
 #include "foundation/utility/stopwatch.h"
 
 // OSL headers.
@@ -58,7 +59,6 @@ namespace foundation    { class JobQueue; }
 namespace renderer      { class Frame; }
 namespace renderer      { class LightSampler; }
 namespace renderer      { class Scene; }
-namespace renderer      { class SPPMPhotonData; }
 namespace renderer      { class TextureStore; }
 namespace renderer      { class TraceContext; }
 
@@ -102,8 +102,8 @@ class SPPMPassCallback
     // Return the number of photons emitted for this pass.
     size_t get_emitted_photon_count() const;
 
-    // Return the i'th photon.
-    const SPPMPhotonData& get_photon_data(const size_t i) const;
+    // Return the photons of the current pass.
+    const SPPMPhotonVector& get_photons() const;
 
     // Return the current photon map.
     const SPPMPhotonMap& get_photon_map() const;
@@ -118,6 +118,7 @@ class SPPMPassCallback
     size_t                          m_emitted_photon_count;
     SPPMPhotonVector                m_photons;
     std::auto_ptr<SPPMPhotonMap>    m_photon_map;
+    foundation::TrackedMemorySize   m_photon_memory_size;
     float                           m_initial_lookup_radius;
     float                           m_lookup_radius;
     foundation::Stopwatch<foundation::DefaultWallclockTimer>
@@ -134,9 +135,9 @@ inline size_t SPPMPassCallback::get_emitted_photon_count() const
     return m_emitted_photon_count;
 }
 
-inline const SPPMPhotonData& SPPMPassCallback::get_photon_data(const size_t i) const
+inline const SPPMPhotonVector& SPPMPassCallback::get_photons() const
 {
-    return m_photons.m_data[i];
+    return m_photons;
 }
 
 inline const SPPMPhotonMap& SPPMPassCallback::get_photon_map() const
@@ -31,26 +31,94 @@
 #include "sppmphoton.h"
 
 // appleseed.foundation headers.
+#include "foundation/image/spectrum.h"
+#include "foundation/math/scalar.h"
 #include "foundation/utility/memory.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+
 using namespace foundation;
+using namespace std;
 
 namespace renderer
 {
 
+//
+// SPPMPackedFlux class implementation.
+//
+
+void SPPMPackedFlux::pack(const Spectrum& flux)
+{
+    const float max_sample = max_value(flux);
+
+    int e = 0;
+    if (max_sample > 0.0f)
+        frexp(max_sample, &e);
+
+    // Use -128 as the exponent of a black flux.
+    if (!(max_sample > 0.0f) || e < -127 || e > 127)
+    {
+        fill(m_mantissas, m_mantissas + Spectrum::Samples, uint8(0));
+        m_exponent = -128;
+        return;
+    }
+
+    // Samples are in [0, 256) once scaled.
+    const float scale = ldexp(1.0f, 8 - e);
+
+    for (size_t i = 0; i < Spectrum::Samples; ++i)
+    {
+        const float m = max(flux[i], 0.0f) * scale + 0.5f;
+        m_mantissas[i] = static_cast<uint8>(min(m, 255.0f));
+    }
+
+    m_exponent = static_cast<int8>(e);
+}
+
+
+//
+// Unit vector encoding implementation.
+//
+
+uint32 encode_unit_vector(const Vector3f& v)
+{
+    // Project the vector onto the octahedron, then onto the z = 0 plane.
+    const float rcp_norm1 = 1.0f / (abs(v.x) + abs(v.y) + abs(v.z));
+    float x = v.x * rcp_norm1;
+    float y = v.y * rcp_norm1;
+
+    // Fold the lower hemisphere over the diagonals.
+    if (v.z < 0.0f)
+    {
+        const float fx = (1.0f - abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float fy = (1.0f - abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+
+    // Quantize both coordinates to 16-bit signed integers.
+    const int16 qx = static_cast<int16>(round<int>(clamp(x, -1.0f, 1.0f) * 32767.0f));
+    const int16 qy = static_cast<int16>(round<int>(clamp(y, -1.0f, 1.0f) * 32767.0f));
+
+    return (static_cast<uint32>(static_cast<uint16>(qx)) << 16) | static_cast<uint16>(qy);
+}
+
+
 //
 // SPPMPhotonVector class implementation.
 //
 
 bool SPPMPhotonVector::empty() const
 {
-    assert(m_positions.empty() == m_data.empty());
+    assert(m_positions.empty() == m_fluxes.empty());
     return m_positions.empty();
 }
 
 size_t SPPMPhotonVector::size() const
 {
-    assert(m_positions.size() == m_data.size());
+    assert(m_positions.size() == m_fluxes.size());
     return m_positions.size();
 }
 
@@ -58,31 +126,44 @@ size_t SPPMPhotonVector::get_memory_size() const
 {
     return
         m_positions.capacity() * sizeof(Vector3f) +
-        m_data.capacity() * sizeof(SPPMPhotonData);
+        m_incoming.capacity() * sizeof(uint32) +
+        m_geometric_normals.capacity() * sizeof(uint32) +
+        m_fluxes.capacity() * sizeof(SPPMPackedFlux);
 }
 
 void SPPMPhotonVector::swap(SPPMPhotonVector& rhs)
 {
     m_positions.swap(rhs.m_positions);
-    m_data.swap(rhs.m_data);
+    m_incoming.swap(rhs.m_incoming);
+    m_geometric_normals.swap(rhs.m_geometric_normals);
+    m_fluxes.swap(rhs.m_fluxes);
 }
 
 void SPPMPhotonVector::clear_keep_memory()
 {
     foundation::clear_keep_memory(m_positions);
-    foundation::clear_keep_memory(m_data);
+    foundation::clear_keep_memory(m_incoming);
+    foundation::clear_keep_memory(m_geometric_normals);
+    foundation::clear_keep_memory(m_fluxes);
 }
 
 void SPPMPhotonVector::reserve(const size_t capacity)
 {
     m_positions.reserve(capacity);
-    m_data.reserve(capacity);
+    m_incoming.reserve(capacity);
+    m_geometric_normals.reserve(capacity);
+    m_fluxes.reserve(capacity);
 }
 
 void SPPMPhotonVector::push_back(const SPPMPhoton& photon)
 {
     m_positions.push_back(photon.m_position);
-    m_data.push_back(photon.m_data);
+    m_incoming.push_back(encode_unit_vector(photon.m_data.m_incoming));
+    m_geometric_normals.push_back(encode_unit_vector(photon.m_data.m_geometric_normal));
+
+    SPPMPackedFlux flux;
+    flux.pack(photon.m_data.m_flux);
+    m_fluxes.push_back(flux);
 }
 
 void SPPMPhotonVector::append(const SPPMPhotonVector& rhs)
@@ -90,7 +171,9 @@ void SPPMPhotonVector::append(const SPPMPhotonVector& rhs)
     boost::mutex::scoped_lock lock(m_mutex);
 
     m_positions.insert(m_positions.end(), rhs.m_positions.begin(), rhs.m_positions.end());
-    m_data.insert(m_data.end(), rhs.m_data.begin(), rhs.m_data.end());
+    m_incoming.insert(m_incoming.end(), rhs.m_incoming.begin(), rhs.m_incoming.end());
+    m_geometric_normals.insert(m_geometric_normals.end(), rhs.m_geometric_normals.begin(), rhs.m_geometric_normals.end());
+    m_fluxes.insert(m_fluxes.end(), rhs.m_fluxes.begin(), rhs.m_fluxes.end());
 }
 
 }   // namespace renderer
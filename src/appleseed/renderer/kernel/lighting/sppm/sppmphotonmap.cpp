@@ -47,23 +47,41 @@ using namespace foundation;
 namespace renderer
 {
 
-SPPMPhotonMap::SPPMPhotonMap(SPPMPhotonVector& photons)
+SPPMPhotonMap::SPPMPhotonMap(
+    SPPMPhotonVector&                   photons,
+    const SPPMParameters::PhotonMapType type,
+    const float                         lookup_radius)
+  : m_type(type)
+  , m_build_time(0.0)
 {
     const size_t photon_count = photons.size();
 
     if (photon_count > 0)
     {
         RENDERER_LOG_INFO(
-            "building sppm photon map from %s %s...",
+            "building sppm photon %s from %s %s...",
+            m_type == SPPMParameters::HashGrid ? "hash grid" : "kd-tree",
             pretty_uint(photon_count).c_str(),
             photon_count > 1 ? "photons" : "photon");
 
-        knn::Builder3f builder(*this);
-        builder.build_move_points<DefaultWallclockTimer>(photons.m_positions);
-
         Statistics statistics;
-        statistics.insert_time("build time", builder.get_build_time());
-        statistics.merge(knn::TreeStatistics<knn::Tree3f>(*this));
+
+        if (m_type == SPPMParameters::HashGrid)
+        {
+            // With cells twice as large as the lookup radius, lookups visit at most 8 cells.
+            knn::HashGridBuilder3f builder(m_grid);
+            builder.build_move_points<DefaultWallclockTimer>(photons.m_positions, 2.0f * lookup_radius);
+            m_build_time = builder.get_build_time();
+            statistics.insert_time("build time", m_build_time);
+        }
+        else
+        {
+            knn::Builder3f builder(m_tree);
+            builder.build_move_points<DefaultWallclockTimer>(photons.m_positions);
+            m_build_time = builder.get_build_time();
+            statistics.insert_time("build time", m_build_time);
+            statistics.merge(knn::TreeStatistics<knn::Tree3f>(m_tree));
+        }
 
         RENDERER_LOG_DEBUG("%s",
             StatisticsVector::make(
@@ -79,7 +97,10 @@ SPPMPhotonMap::SPPMPhotonMap(SPPMPhotonVector& photons)
 
 size_t SPPMPhotonMap::get_memory_size() const
 {
-    return knn::Tree3f::get_memory_size();
+    return
+        m_type == SPPMParameters::HashGrid
+            ? m_grid.get_memory_size()
+            : m_tree.get_memory_size();
 }
 
 }   // namespace renderer
@@ -30,8 +30,13 @@
 #ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTONMAP_H
 #define APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTONMAP_H
 
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/sppm/sppmparameters.h"
+
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/knn.h"
+#include "foundation/math/vector.h"
 
 // Standard headers.
 #include <cstddef>
@@ -42,17 +47,92 @@ namespace renderer  { class SPPMPhotonVector; }
 namespace renderer
 {
 
+//
+// The SPPM photon map, stored either in a kd-tree or, since lookups use a fixed radius
+// during a given pass, in a hash grid whose cells are sized after the lookup radius.
+//
+
 class SPPMPhotonMap
-  : public foundation::knn::Tree3f
+  : public foundation::NonCopyable
 {
   public:
     // Constructor, *moves* the photon positions into the map.
-    explicit SPPMPhotonMap(SPPMPhotonVector& photons);
+    SPPMPhotonMap(
+        SPPMPhotonVector&                   photons,
+        const SPPMParameters::PhotonMapType type,
+        const float                         lookup_radius);
+
+    // Return true if the map does not contain any photon.
+    bool empty() const;
+
+    // Transform an internal index to a photon index.
+    size_t remap(const size_t i) const;
+
+    // Return the position of the i'th photon, where i is an internal index.
+    const foundation::Vector3f& get_point(const size_t i) const;
+
+    // Find the photons closest to a given point, within a given distance.
+    // The indices stored in the answer are internal indices.
+    void find_nearest_photons(
+        const foundation::Vector3f&         point,
+        const float                         max_square_distance,
+        foundation::knn::Answer<float>&     answer) const;
+
+    // Return the time it took to build the map.
+    double get_build_time() const;
 
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
+
+  private:
+    const SPPMParameters::PhotonMapType     m_type;
+    foundation::knn::Tree3f                 m_tree;
+    foundation::knn::HashGrid3f             m_grid;
+    double                                  m_build_time;
 };
 
+
+//
+// SPPMPhotonMap class implementation.
+//
+
+inline bool SPPMPhotonMap::empty() const
+{
+    return m_type == SPPMParameters::HashGrid ? m_grid.empty() : m_tree.empty();
+}
+
+inline size_t SPPMPhotonMap::remap(const size_t i) const
+{
+    return m_type == SPPMParameters::HashGrid ? m_grid.remap(i) : m_tree.remap(i);
+}
+
+inline const foundation::Vector3f& SPPMPhotonMap::get_point(const size_t i) const
+{
+    return m_type == SPPMParameters::HashGrid ? m_grid.get_point(i) : m_tree.get_point(i);
+}
+
+inline void SPPMPhotonMap::find_nearest_photons(
+    const foundation::Vector3f&             point,
+    const float                             max_square_distance,
+    foundation::knn::Answer<float>&         answer) const
+{
+    if (m_type == SPPMParameters::HashGrid)
+    {
+        const foundation::knn::HashGridQuery3f query(m_grid, answer);
+        query.run(point, max_square_distance);
+    }
+    else
+    {
+        const foundation::knn::Query3f query(m_tree, answer);
+        query.run(point, max_square_distance);
+    }
+}
+
+inline double SPPMPhotonMap::get_build_time() const
+{
+    return m_build_time;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_SPPM_SPPMPHOTONMAP_H
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globaltraceeventrecorder.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/intersection/intersector.h"
 #include "renderer/kernel/lighting/sppm/sppmphoton.h"
@@ -151,6 +152,15 @@ namespace
             }
         }
 
+        void visit_volume_vertex(
+            const ShadingRay&       ray,
+            const Vector3d&         point,
+            const size_t            path_length,
+            const Spectrum&         throughput)
+        {
+            // Photons are not stored in participating media.
+        }
+
         void visit_environment(
             const ShadingPoint&     shading_point,
             const Vector3d&         outgoing,
@@ -221,6 +231,8 @@ namespace
 
         virtual void execute(const size_t thread_index) OVERRIDE
         {
+            TraceScope trace(global_trace_event_recorder(), "light photon tracing job", "jobs");
+
             const uint32 instance = hash_uint32(static_cast<uint32>(m_pass_hash + m_photon_begin));
             MersenneTwister rng(instance);
             SamplingContext sampling_context(
@@ -256,6 +268,9 @@ namespace
         void trace_light_photon(
             SamplingContext&        sampling_context)
         {
+            // Release the temporaries allocated while tracing the previous photon.
+            m_shading_context.get_arena().clear();
+
             LightSample light_sample;
             m_light_sampler.sample(sampling_context.next_vector2<4>(), light_sample);
 
@@ -286,7 +301,9 @@ namespace
             const EDF* edf = light_sample.m_triangle->m_edf;
 
             // Evaluate the EDF inputs.
-            InputEvaluator input_evaluator(m_texture_cache);
+            InputEvaluator input_evaluator(
+                m_shading_context.get_texture_cache(),
+                m_shading_context.get_arena());
             const void* edf_data =
                 input_evaluator.evaluate(edf->get_inputs(), light_sample.m_bary);
 
@@ -354,7 +371,9 @@ namespace
             const LightSample&      light_sample)
         {
             // Sample the light.
-            InputEvaluator input_evaluator(m_texture_cache);
+            InputEvaluator input_evaluator(
+                m_shading_context.get_texture_cache(),
+                m_shading_context.get_arena());
             SamplingContext child_sampling_context = sampling_context.split(2, 1);
             Vector3d emission_position, emission_direction;
             Spectrum light_value;
@@ -467,6 +486,8 @@ namespace
 
         virtual void execute(const size_t thread_index) OVERRIDE
         {
+            TraceScope trace(global_trace_event_recorder(), "environment photon tracing job", "jobs");
+
             const uint32 instance = hash_uint32(static_cast<uint32>(m_pass_hash + m_photon_begin));
             MersenneTwister rng(instance);
             SamplingContext sampling_context(
@@ -505,8 +526,13 @@ namespace
         void trace_env_photon(
             SamplingContext&        sampling_context)
         {
+            // Release the temporaries allocated while tracing the previous photon.
+            m_shading_context.get_arena().clear();
+
             // Sample the environment.
-            InputEvaluator input_evaluator(m_texture_cache);
+            InputEvaluator input_evaluator(
+                m_shading_context.get_texture_cache(),
+                m_shading_context.get_arena());
             Vector3d outgoing;
             Spectrum env_edf_value;
             double env_edf_prob;
@@ -43,6 +43,7 @@
 #include "renderer/modeling/scene/containers.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/volume/volume.h"
 
 // appleseed.foundation headers.
 #include "foundation/utility/foreach.h"
@@ -52,6 +53,7 @@
 // Standard headers.
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <set>
 
 using namespace foundation;
@@ -134,7 +136,8 @@ Tracer::Tracer(
     const float                 transparency_threshold,
     const size_t                max_iterations,
     const bool                  print_details)
-  : m_intersector(intersector)
+  : m_scene(scene)
+  , m_intersector(intersector)
   , m_texture_cache(texture_cache)
 #ifdef WITH_OSL
   , m_shadergroup_exec(shadergroup_exec)
@@ -224,6 +227,17 @@ const ShadingPoint& Tracer::do_trace(
         point = shading_point_ptr->get_point();
     }
 
+    // Account for the participating medium up to the occluder, if any.
+    if (transmission > 0.0)
+    {
+        transmission *=
+            evaluate_volume_transmission(
+                origin,
+                direction,
+                numeric_limits<double>::max(),
+                *shading_point_ptr);
+    }
+
     return *shading_point_ptr;
 }
 
@@ -303,9 +317,57 @@ const ShadingPoint& Tracer::do_trace_between(
         point = shading_point_ptr->get_point();
     }
 
+    // Account for the participating medium up to the occluder or the target point.
+    if (transmission > 0.0)
+    {
+        transmission *=
+            evaluate_volume_transmission(
+                origin,
+                target - origin,
+                1.0,
+                *shading_point_ptr);
+    }
+
     return *shading_point_ptr;
 }
 
+double Tracer::evaluate_volume_transmission(
+    const Vector3d&     origin,
+    const Vector3d&     direction,
+    const double        tmax) const
+{
+    double transmission = 1.0;
+
+    // The transmission through overlapping volumes is the product of their transmissions.
+    for (const_each<VolumeContainer> i = m_scene.volumes(); i; ++i)
+    {
+        transmission *= i->evaluate_transmittance(origin, direction, 0.0, tmax);
+
+        if (transmission == 0.0)
+            break;
+    }
+
+    return transmission;
+}
+
+double Tracer::evaluate_volume_transmission(
+    const Vector3d&     origin,
+    const Vector3d&     direction,
+    const double        tmax,
+    const ShadingPoint& shading_point) const
+{
+    if (m_scene.volumes().empty())
+        return 1.0;
+
+    // Stop at the shading point if the ray hit something.
+    const double t =
+        shading_point.hit()
+            ? dot(shading_point.get_point() - origin, direction) / square_norm(direction)
+            : tmax;
+
+    return evaluate_volume_transmission(origin, direction, t);
+}
+
 void Tracer::evaluate_alpha(
     const Material&     material,
     const ShadingPoint& shading_point,
@@ -141,6 +141,7 @@ class Tracer
         const ShadingRay::Type          ray_type);
 
   private:
+    const Scene&                        m_scene;
     const Intersector&                  m_intersector;
     TextureCache&                       m_texture_cache;
 #ifdef WITH_OSL
@@ -176,6 +177,19 @@ class Tracer
         const Material&                 material,
         const ShadingPoint&             shading_point,
         Alpha&                          alpha) const;
+
+    // Compute the transmission of the volumes of the scene along the segment [0, tmax] of a ray.
+    double evaluate_volume_transmission(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        const double                    tmax) const;
+
+    // Same as above, for the segment of a ray that ends at a given shading point.
+    double evaluate_volume_transmission(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        const double                    tmax,
+        const ShadingPoint&             shading_point) const;
 };
 
 
@@ -235,7 +249,10 @@ inline double Tracer::trace(
             ray_type,
             ray_depth);
 
-        return m_intersector.trace_probe(ray) ? 0.0 : 1.0;
+        return
+            m_intersector.trace_probe(ray)
+                ? 0.0
+                : evaluate_volume_transmission(ray.m_org, ray.m_dir, ray.m_tmax);
     }
     else
     {
@@ -267,7 +284,10 @@ inline double Tracer::trace(
             type,
             origin.get_ray().m_depth + 1);
 
-        return m_intersector.trace_probe(ray, &origin) ? 0.0 : 1.0;
+        return
+            m_intersector.trace_probe(ray, &origin)
+                ? 0.0
+                : evaluate_volume_transmission(ray.m_org, ray.m_dir, ray.m_tmax);
     }
     else
     {
@@ -337,7 +357,10 @@ inline double Tracer::trace_between(
             ray_type,
             ray_depth);
 
-        return m_intersector.trace_probe(ray) ? 0.0 : 1.0;
+        return
+            m_intersector.trace_probe(ray)
+                ? 0.0
+                : evaluate_volume_transmission(ray.m_org, ray.m_dir, ray.m_tmax);
     }
     else
     {
@@ -373,7 +396,10 @@ inline double Tracer::trace_between(
             type,
             origin.get_ray().m_depth + 1);
 
-        return m_intersector.trace_probe(ray, &origin) ? 0.0 : 1.0;
+        return
+            m_intersector.trace_probe(ray, &origin)
+                ? 0.0
+                : evaluate_volume_transmission(ray.m_org, ray.m_dir, ray.m_tmax);
     }
     else
     {
@@ -83,6 +83,28 @@ namespace
             shading_result.set_aovs_to_transparent_black_linear_rgba();
         }
 
+        virtual void defer_sample(
+            SamplingContext&    sampling_context,
+            const PixelContext& pixel_context,
+            const Vector2d&     image_point,
+            ShadingResult&      shading_result) OVERRIDE
+        {
+            render_sample(sampling_context, pixel_context, image_point, shading_result);
+        }
+
+        virtual void shade_deferred_samples() OVERRIDE
+        {
+        }
+
+        virtual void discard_deferred_samples() OVERRIDE
+        {
+        }
+
+        virtual uint64 get_ray_count() const OVERRIDE
+        {
+            return 0;
+        }
+
         virtual StatisticsVector get_statistics() const OVERRIDE
         {
             return StatisticsVector();
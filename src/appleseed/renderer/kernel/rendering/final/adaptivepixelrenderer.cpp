@@ -301,6 +301,11 @@ namespace
             }
         }
 
+        virtual uint64 get_ray_count() const OVERRIDE
+        {
+            return m_sample_renderer->get_ray_count();
+        }
+
         virtual StatisticsVector get_statistics() const OVERRIDE
         {
             return m_sample_renderer->get_statistics();
@@ -0,0 +1,734 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "adaptivetilerenderer.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/aov/tilestack.h"
+#include "renderer/kernel/rendering/final/blockerrorestimator.h"
+#include "renderer/kernel/rendering/ipasscallback.h"
+#include "renderer/kernel/rendering/isamplerenderer.h"
+#include "renderer/kernel/rendering/pixelcontext.h"
+#include "renderer/kernel/rendering/shadingresultframebuffer.h"
+#include "renderer/kernel/shading/shadingresult.h"
+#include "renderer/modeling/frame/frame.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/filter.h"
+#include "foundation/math/hash.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    //
+    // Adaptive sampling parameters.
+    //
+
+    struct Parameters
+    {
+        const size_t    m_min_samples;          // number of samples per pixel in the first pass
+        const size_t    m_max_samples;          // maximum number of samples per pixel
+        const size_t    m_average_samples;      // sample budget, as an average number of samples per pixel
+        const float     m_max_error;            // target error of a block
+        const double    m_time_limit;           // time limit in seconds, 0 for no limit
+        const size_t    m_max_passes;           // maximum number of passes
+
+        explicit Parameters(const ParamArray& params)
+          : m_min_samples(max<size_t>(params.get_optional<size_t>("min_samples", 16), 2))
+          , m_max_samples(max(params.get_optional<size_t>("max_samples", 256), m_min_samples))
+          , m_average_samples(params.get_optional<size_t>("samples", 64))
+          , m_max_error(pow(10.0f, -params.get_optional<float>("quality", 2.0f)))
+          , m_time_limit(params.get_optional<double>("time_limit", 0.0))
+          , m_max_passes(max<size_t>(params.get_optional<size_t>("max_passes", 32), 1))
+        {
+        }
+    };
+
+
+    //
+    // A rectangular block of pixels sampled at the same rate.
+    //
+
+    struct Block
+    {
+        AABB2i          m_bbox;                 // pixels covered by the block, in tile space
+        size_t          m_samples;              // number of samples per pixel taken so far
+        size_t          m_pass_samples;         // number of samples per pixel to take in the current pass
+        float           m_error;                // estimated error
+        bool            m_converged;            // true if the block has reached the target error
+
+        size_t get_pixel_count() const
+        {
+            return
+                static_cast<size_t>(m_bbox.extent(0) + 1) *
+                static_cast<size_t>(m_bbox.extent(1) + 1);
+        }
+    };
+
+
+    //
+    // Persistent rendering state of a tile.
+    //
+
+    struct TileState
+    {
+        auto_ptr<ShadingResultFrameBuffer>  m_framebuffer;
+        auto_ptr<BlockErrorEstimator>       m_estimator;
+        vector<Block>                       m_blocks;
+        uint64                              m_pass_sample_count;    // number of samples taken in the last pass
+    };
+
+
+    //
+    // The adaptive sampling controller holds the state of all tiles and
+    // redistributes the sample budget among blocks at the end of each pass.
+    //
+
+    class AdaptiveSamplingController
+      : public IPassCallback
+    {
+      public:
+        AdaptiveSamplingController(
+            const Frame&                frame,
+            const ParamArray&           params)
+          : m_params(params)
+          , m_tile_count_x(frame.image().properties().m_tile_count_x)
+          , m_margin_width(truncate<int>(ceil(frame.get_filter().get_xradius() - 0.5)))
+          , m_margin_height(truncate<int>(ceil(frame.get_filter().get_yradius() - 0.5)))
+          , m_tile_states(frame.image().properties().m_tile_count, 0)
+          , m_frame_done(true)
+        {
+        }
+
+        ~AdaptiveSamplingController()
+        {
+            clear_tile_states();
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        const Parameters& get_parameters() const
+        {
+            return m_params;
+        }
+
+        // Return the persistent state of a given tile. A tile is never rendered
+        // by more than one thread at a time, hence no synchronization is needed.
+        TileState& get_tile_state(
+            const Frame&                frame,
+            const size_t                tile_x,
+            const size_t                tile_y,
+            const AABB2u&               tile_bbox)
+        {
+            TileState*& state = m_tile_states[tile_y * m_tile_count_x + tile_x];
+
+            if (state == 0)
+                state = create_tile_state(frame, tile_x, tile_y, tile_bbox);
+
+            return *state;
+        }
+
+        virtual void pre_render(
+            const Frame&                frame,
+            JobQueue&                   job_queue,
+            AbortSwitch&                abort_switch) OVERRIDE
+        {
+            // Start from scratch if this is the first pass of a new frame.
+            if (m_frame_done)
+            {
+                clear_tile_states();
+
+                const AABB2u& crop_window = frame.get_crop_window();
+                m_pixel_count = (crop_window.extent(0) + 1) * (crop_window.extent(1) + 1);
+
+                m_pass = 0;
+                m_sample_count = 0;
+                m_frame_done = false;
+                m_stopwatch.start();
+            }
+
+            m_pass_start_time = m_stopwatch.measure().get_seconds();
+        }
+
+        virtual void post_render(
+            const Frame&                frame,
+            JobQueue&                   job_queue,
+            AbortSwitch&                abort_switch) OVERRIDE
+        {
+            // Rendering was interrupted: the next pass will start a new frame.
+            if (abort_switch.is_aborted())
+            {
+                m_frame_done = true;
+                return;
+            }
+
+            ++m_pass;
+
+            const double time = m_stopwatch.measure().get_seconds();
+            const double pass_time = time - m_pass_start_time;
+
+            // Collect the blocks that still need samples and compute the frame error.
+            vector<Block*> active_blocks;
+            uint64 pass_sample_count = 0;
+            double error_sum = 0.0;
+            double error_pixel_count = 0.0;
+            for (size_t i = 0; i < m_tile_states.size(); ++i)
+            {
+                TileState* state = m_tile_states[i];
+                if (state == 0)
+                    continue;
+
+                pass_sample_count += state->m_pass_sample_count;
+
+                for (size_t j = 0; j < state->m_blocks.size(); ++j)
+                {
+                    Block& block = state->m_blocks[j];
+                    const size_t block_pixel_count = block.get_pixel_count();
+
+                    error_sum += static_cast<double>(block.m_error) * block_pixel_count;
+                    error_pixel_count += block_pixel_count;
+
+                    if (!block.m_converged && block.m_samples < m_params.m_max_samples)
+                        active_blocks.push_back(&block);
+                }
+            }
+
+            m_sample_count += pass_sample_count;
+            m_frame_error = error_pixel_count > 0.0 ? error_sum / error_pixel_count : 0.0;
+
+            RENDERER_LOG_DEBUG(
+                "adaptive sampling: pass %s, %s active block%s, estimated error %s.",
+                pretty_uint(m_pass).c_str(),
+                pretty_uint(active_blocks.size()).c_str(),
+                active_blocks.size() > 1 ? "s" : "",
+                pretty_scalar(m_frame_error, 5).c_str());
+
+            // Determine whether rendering should continue.
+            const char* stop_reason = 0;
+            uint64 pass_budget = 0;
+            if (active_blocks.empty())
+                stop_reason = "all blocks reached the target error";
+            else if (m_pass >= m_params.m_max_passes)
+                stop_reason = "maximum number of passes reached";
+            else
+            {
+                pass_budget = compute_pass_budget(time, pass_time, pass_sample_count);
+
+                if (pass_budget == 0)
+                {
+                    stop_reason =
+                        m_params.m_time_limit > 0.0 && time >= m_params.m_time_limit
+                            ? "time limit reached"
+                            : "sample budget exhausted";
+                }
+                else if (allocate_samples(active_blocks, pass_budget) == 0)
+                    stop_reason = "sample budget exhausted";
+            }
+
+            if (stop_reason)
+            {
+                RENDERER_LOG_INFO(
+                    "adaptive sampling: %s after %s pass%s, %s samples/pixel on average, estimated error %s, %s.",
+                    stop_reason,
+                    pretty_uint(m_pass).c_str(),
+                    m_pass > 1 ? "es" : "",
+                    pretty_ratio(m_sample_count, static_cast<uint64>(m_pixel_count)).c_str(),
+                    pretty_scalar(m_frame_error, 5).c_str(),
+                    pretty_time(time).c_str());
+
+                // Stop the generic frame renderer after this pass.
+                m_frame_done = true;
+                abort_switch.abort();
+            }
+        }
+
+      private:
+        const Parameters            m_params;
+        const size_t                m_tile_count_x;
+        const int                   m_margin_width;
+        const int                   m_margin_height;
+        vector<TileState*>          m_tile_states;
+
+        bool                        m_frame_done;
+        size_t                      m_pixel_count;
+        size_t                      m_pass;
+        uint64                      m_sample_count;
+        double                      m_frame_error;
+        Stopwatch<DefaultWallclockTimer> m_stopwatch;
+        double                      m_pass_start_time;
+
+        TileState* create_tile_state(
+            const Frame&                frame,
+            const size_t                tile_x,
+            const size_t                tile_y,
+            const AABB2u&               tile_bbox) const
+        {
+            const Tile& tile = frame.image().tile(tile_x, tile_y);
+
+            // The tile is extended by the radius of the reconstruction filter.
+            AABB2i padded_bbox(tile_bbox);
+            padded_bbox.min.x -= m_margin_width;
+            padded_bbox.min.y -= m_margin_height;
+            padded_bbox.max.x += m_margin_width;
+            padded_bbox.max.y += m_margin_height;
+
+            TileState* state = new TileState();
+
+            state->m_framebuffer.reset(
+                new ShadingResultFrameBuffer(
+                    tile.get_width(),
+                    tile.get_height(),
+                    frame.aov_images().size(),
+                    tile_bbox,
+                    frame.get_filter()));
+            state->m_framebuffer->clear();
+
+            state->m_estimator.reset(new BlockErrorEstimator(padded_bbox));
+
+            // The whole (padded) tile is initially a single block.
+            Block block;
+            block.m_bbox = padded_bbox;
+            block.m_samples = 0;
+            block.m_pass_samples = m_params.m_min_samples;
+            block.m_error = 0.0f;
+            block.m_converged = false;
+            state->m_blocks.push_back(block);
+
+            state->m_pass_sample_count = 0;
+
+            return state;
+        }
+
+        void clear_tile_states()
+        {
+            for (size_t i = 0; i < m_tile_states.size(); ++i)
+            {
+                delete m_tile_states[i];
+                m_tile_states[i] = 0;
+            }
+        }
+
+        uint64 compute_pass_budget(
+            const double                time,
+            const double                pass_time,
+            const uint64                pass_sample_count) const
+        {
+            // Never spend more than the remaining sample budget.
+            const uint64 budget = static_cast<uint64>(m_params.m_average_samples) * m_pixel_count;
+            uint64 pass_budget = budget > m_sample_count ? budget - m_sample_count : 0;
+
+            // Spread the remaining budget over several passes such that the error
+            // estimates can be refined between them.
+            pass_budget = min(pass_budget, static_cast<uint64>(m_params.m_min_samples) * m_pixel_count);
+
+            // Make sure the next pass completes before the time limit, assuming
+            // the same throughput as in the pass that just ended.
+            if (m_params.m_time_limit > 0.0 && pass_time > 0.0)
+            {
+                const double remaining_time = max(m_params.m_time_limit - time, 0.0);
+                const double samples_per_second = pass_sample_count / pass_time;
+                pass_budget = min(pass_budget, static_cast<uint64>(remaining_time * samples_per_second));
+            }
+
+            return pass_budget;
+        }
+
+        // Distribute the samples of the next pass among active blocks, in proportion
+        // to their error. Return the number of samples effectively allocated.
+        uint64 allocate_samples(
+            const vector<Block*>&       active_blocks,
+            const uint64                pass_budget) const
+        {
+            double weight = 0.0;
+            for (size_t i = 0; i < active_blocks.size(); ++i)
+                weight += static_cast<double>(active_blocks[i]->m_error) * active_blocks[i]->get_pixel_count();
+
+            if (weight == 0.0)
+                return 0;
+
+            uint64 allocated = 0;
+
+            for (size_t i = 0; i < active_blocks.size(); ++i)
+            {
+                Block& block = *active_blocks[i];
+
+                const double samples = pass_budget * block.m_error / weight;
+
+                block.m_pass_samples =
+                    min(
+                        static_cast<size_t>(samples + 0.5),
+                        m_params.m_max_samples - block.m_samples);
+
+                allocated += static_cast<uint64>(block.m_pass_samples) * block.get_pixel_count();
+            }
+
+            return allocated;
+        }
+    };
+
+
+    //
+    // Adaptive tile renderer.
+    //
+
+    class AdaptiveTileRenderer
+      : public ITileRenderer
+    {
+      public:
+        AdaptiveTileRenderer(
+            AdaptiveSamplingController& controller,
+            ISampleRendererFactory*     factory,
+            const bool                  primary)
+          : m_controller(controller)
+          , m_params(controller.get_parameters())
+          , m_sample_renderer(factory->create(primary))
+          , m_invalid_sample_count(0)
+        {
+        }
+
+        ~AdaptiveTileRenderer()
+        {
+            if (m_invalid_sample_count > 0)
+            {
+                RENDERER_LOG_WARNING(
+                    "found %s pixel sample%s with NaN or negative values.",
+                    pretty_uint(m_invalid_sample_count).c_str(),
+                    m_invalid_sample_count > 1 ? "s" : "");
+            }
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual void render_tile(
+            const Frame&    frame,
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const size_t    pass_hash,
+            AbortSwitch&    abort_switch) OVERRIDE
+        {
+            // Retrieve frame properties.
+            const CanvasProperties& frame_properties = frame.image().properties();
+            assert(tile_x < frame_properties.m_tile_count_x);
+            assert(tile_y < frame_properties.m_tile_count_y);
+
+            // Retrieve tile properties.
+            Tile& tile = frame.image().tile(tile_x, tile_y);
+            TileStack aov_tiles = frame.aov_images().tiles(tile_x, tile_y);
+            const size_t tile_origin_x = frame_properties.m_tile_width * tile_x;
+            const size_t tile_origin_y = frame_properties.m_tile_height * tile_y;
+
+            // Compute the image space bounding box of the pixels to render.
+            AABB2u tile_bbox;
+            tile_bbox.min.x = tile_origin_x;
+            tile_bbox.min.y = tile_origin_y;
+            tile_bbox.max.x = tile_origin_x + tile.get_width() - 1;
+            tile_bbox.max.y = tile_origin_y + tile.get_height() - 1;
+            tile_bbox = AABB2u::intersect(tile_bbox, frame.get_crop_window());
+            if (!tile_bbox.is_valid())
+                return;
+
+            // Transform the bounding box to local (tile) space.
+            tile_bbox.min.x -= tile_origin_x;
+            tile_bbox.min.y -= tile_origin_y;
+            tile_bbox.max.x -= tile_origin_x;
+            tile_bbox.max.y -= tile_origin_y;
+
+            TileState& state = m_controller.get_tile_state(frame, tile_x, tile_y, tile_bbox);
+
+            // Seed the RNG with the tile index.
+            m_rng = SamplingContext::RNGType(
+                hash_uint32(
+                    static_cast<uint32>(pass_hash + tile_y * frame_properties.m_tile_count_x + tile_x)));
+
+            // Render the samples allocated to the blocks of this tile.
+            state.m_pass_sample_count = 0;
+            for (size_t i = 0; i < state.m_blocks.size(); ++i)
+            {
+                const Block& block = state.m_blocks[i];
+
+                if (block.m_pass_samples == 0)
+                    continue;
+
+                for (int ty = block.m_bbox.min.y; ty <= block.m_bbox.max.y; ++ty)
+                {
+                    // Cancel any work done on this tile if rendering is aborted.
+                    if (abort_switch.is_aborted())
+                        return;
+
+                    for (int tx = block.m_bbox.min.x; tx <= block.m_bbox.max.x; ++tx)
+                    {
+                        render_pixel(
+                            frame,
+                            static_cast<int>(tile_origin_x) + tx,
+                            static_cast<int>(tile_origin_y) + ty,
+                            tx, ty,
+                            pass_hash,
+                            block,
+                            state);
+                    }
+                }
+
+                state.m_pass_sample_count +=
+                    static_cast<uint64>(block.m_pass_samples) * block.get_pixel_count();
+            }
+
+            // Develop the framebuffer to the tile.
+            if (frame.is_premultiplied_alpha())
+                state.m_framebuffer->develop_to_tile_premult_alpha(tile, aov_tiles);
+            else state.m_framebuffer->develop_to_tile_straight_alpha(tile, aov_tiles);
+
+            update_blocks(state);
+        }
+
+        virtual StatisticsVector get_statistics() const OVERRIDE
+        {
+            return m_sample_renderer->get_statistics();
+        }
+
+      private:
+        // Blocks are only subdivided once their error is within this factor of the target error.
+        static const size_t SplitErrorFactor = 16;
+
+        // Blocks are never subdivided below this size, in pixels.
+        static const int MinBlockSize = 4;
+
+        AdaptiveSamplingController&         m_controller;
+        const Parameters&                   m_params;
+        auto_release_ptr<ISampleRenderer>   m_sample_renderer;
+        SamplingContext::RNGType            m_rng;
+        uint64                              m_invalid_sample_count;
+
+        void render_pixel(
+            const Frame&                frame,
+            const int                   ix,
+            const int                   iy,
+            const int                   tx,
+            const int                   ty,
+            const size_t                pass_hash,
+            const Block&                block,
+            TileState&                  state)
+        {
+            const size_t aov_count = frame.aov_images().size();
+            const PixelContext pixel_context(ix, iy);
+
+            // Create a sampling context.
+            const size_t frame_width = frame.image().properties().m_canvas_width;
+            const size_t instance =
+                mix_uint32(
+                    static_cast<uint32>(pass_hash),
+                    static_cast<uint32>(iy * frame_width + ix));
+            SamplingContext sampling_context(
+                m_rng,
+                2,                      // number of dimensions
+                0,                      // number of samples -- unknown
+                instance);              // initial instance number
+
+            for (size_t i = 0; i < block.m_pass_samples; ++i)
+            {
+                // Generate a uniform sample in [0,1)^2.
+                const Vector2d s = sampling_context.next_vector2<2>();
+
+                // Compute the sample position in NDC.
+                const Vector2d sample_position = frame.get_sample_position(ix + s.x, iy + s.y);
+
+                // Render the sample.
+                SamplingContext child_sampling_context(sampling_context);
+                ShadingResult shading_result(aov_count);
+                m_sample_renderer->render_sample(
+                    child_sampling_context,
+                    pixel_context,
+                    sample_position,
+                    shading_result);
+
+                // Ignore invalid samples.
+                if (!shading_result.is_valid_linear_rgb())
+                {
+                    signal_invalid_sample();
+                    continue;
+                }
+
+                // Merge the sample into the framebuffer.
+                state.m_framebuffer->add(tx + s.x, ty + s.y, shading_result);
+
+                // Every other sample also goes to the half buffer.
+                state.m_estimator->add(
+                    tx, ty,
+                    Color3f(
+                        shading_result.m_main.m_color[0],
+                        shading_result.m_main.m_color[1],
+                        shading_result.m_main.m_color[2]),
+                    (block.m_samples + i) % 2 == 0);
+            }
+        }
+
+        void update_blocks(TileState& state) const
+        {
+            const BlockErrorEstimator& estimator = *state.m_estimator;
+            const float split_error = SplitErrorFactor * m_params.m_max_error;
+
+            vector<Block> blocks;
+            blocks.reserve(2 * state.m_blocks.size());
+
+            for (size_t i = 0; i < state.m_blocks.size(); ++i)
+            {
+                Block block = state.m_blocks[i];
+
+                // Only blocks that received new samples need to be reconsidered.
+                if (block.m_pass_samples == 0)
+                {
+                    blocks.push_back(block);
+                    continue;
+                }
+
+                block.m_samples += block.m_pass_samples;
+                block.m_pass_samples = 0;
+                block.m_error = estimator.get_block_error(block.m_bbox);
+                block.m_converged = block.m_error <= m_params.m_max_error;
+
+                // Subdivide blocks whose error estimate is reliable enough.
+                const int block_size = max(block.m_bbox.extent(0), block.m_bbox.extent(1)) + 1;
+                if (!block.m_converged && block.m_error <= split_error && block_size >= 2 * MinBlockSize)
+                {
+                    Block children[2];
+                    children[0] = children[1] = block;
+                    estimator.split_block(block.m_bbox, children[0].m_bbox, children[1].m_bbox);
+
+                    for (size_t j = 0; j < 2; ++j)
+                    {
+                        children[j].m_error = estimator.get_block_error(children[j].m_bbox);
+                        children[j].m_converged = children[j].m_error <= m_params.m_max_error;
+                        blocks.push_back(children[j]);
+                    }
+                }
+                else blocks.push_back(block);
+            }
+
+            state.m_blocks.swap(blocks);
+        }
+
+        void signal_invalid_sample()
+        {
+            // todo: mark pixel as faulty in the diagnostic map.
+            if (m_invalid_sample_count++ == 0)
+                RENDERER_LOG_WARNING("found at least one pixel sample with NaN or negative values.");
+        }
+    };
+}
+
+
+//
+// AdaptiveTileRendererFactory class implementation.
+//
+
+struct AdaptiveTileRendererFactory::Impl
+{
+    ISampleRendererFactory*                         m_factory;
+    auto_release_ptr<AdaptiveSamplingController>    m_controller;
+
+    Impl(
+        const Frame&                frame,
+        ISampleRendererFactory*     factory,
+        const ParamArray&           params)
+      : m_factory(factory)
+      , m_controller(new AdaptiveSamplingController(frame, params))
+    {
+    }
+};
+
+AdaptiveTileRendererFactory::AdaptiveTileRendererFactory(
+    const Frame&                    frame,
+    ISampleRendererFactory*         factory,
+    const ParamArray&               params)
+  : impl(new Impl(frame, factory, params))
+{
+}
+
+AdaptiveTileRendererFactory::~AdaptiveTileRendererFactory()
+{
+    delete impl;
+}
+
+void AdaptiveTileRendererFactory::release()
+{
+    delete this;
+}
+
+ITileRenderer* AdaptiveTileRendererFactory::create(const bool primary)
+{
+    return new AdaptiveTileRenderer(*impl->m_controller, impl->m_factory, primary);
+}
+
+IPassCallback* AdaptiveTileRendererFactory::get_pass_callback() const
+{
+    return impl->m_controller.get();
+}
+
+size_t AdaptiveTileRendererFactory::get_max_pass_count() const
+{
+    return impl->m_controller->get_parameters().m_max_passes;
+}
+
+}   // namespace renderer
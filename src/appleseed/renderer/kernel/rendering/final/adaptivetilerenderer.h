@@ -0,0 +1,96 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_ADAPTIVETILERENDERER_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_ADAPTIVETILERENDERER_H
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/itilerenderer.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace renderer  { class Frame; }
+namespace renderer  { class IPassCallback; }
+namespace renderer  { class ISampleRendererFactory; }
+
+namespace renderer
+{
+
+//
+// Adaptive tile renderer.
+//
+// The frame is rendered in a series of passes over all tiles. The first pass takes
+// the same number of samples in every pixel. At the end of each pass, the error of
+// blocks of pixels is estimated from two half-buffers, blocks are hierarchically
+// subdivided, and the remaining sample budget is redistributed to the noisiest
+// blocks. Rendering stops once all blocks have reached the target error, or when
+// the sample budget or the time limit is exhausted.
+//
+// This tile renderer must be driven by the generic frame renderer, using the pass
+// callback returned by get_pass_callback() and get_max_pass_count() passes.
+//
+
+class AdaptiveTileRendererFactory
+  : public ITileRendererFactory
+{
+  public:
+    // Constructor.
+    AdaptiveTileRendererFactory(
+        const Frame&                frame,
+        ISampleRendererFactory*     factory,
+        const ParamArray&           params);
+
+    // Destructor.
+    ~AdaptiveTileRendererFactory();
+
+    // Delete this instance.
+    virtual void release() OVERRIDE;
+
+    // Return a new adaptive tile renderer instance.
+    virtual ITileRenderer* create(const bool primary) OVERRIDE;
+
+    // Return the pass callback that redistributes samples between passes.
+    IPassCallback* get_pass_callback() const;
+
+    // Return the maximum number of passes.
+    size_t get_max_pass_count() const;
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_ADAPTIVETILERENDERER_H
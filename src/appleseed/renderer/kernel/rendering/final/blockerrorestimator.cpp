@@ -0,0 +1,163 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "blockerrorestimator.h"
+
+// Standard headers.
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// BlockErrorEstimator class implementation.
+//
+
+BlockErrorEstimator::BlockErrorEstimator(const AABB2i& bbox)
+  : m_bbox(bbox)
+  , m_width(static_cast<size_t>(bbox.extent(0) + 1))
+  , m_pixels(m_width * static_cast<size_t>(bbox.extent(1) + 1))
+{
+    assert(bbox.is_valid());
+
+    clear();
+}
+
+void BlockErrorEstimator::clear()
+{
+    for (size_t i = 0; i < m_pixels.size(); ++i)
+    {
+        Pixel& p = m_pixels[i];
+        p.m_full_sum.set(0.0f);
+        p.m_half_sum.set(0.0f);
+        p.m_full_count = 0.0f;
+        p.m_half_count = 0.0f;
+    }
+}
+
+float BlockErrorEstimator::get_pixel_error(const int x, const int y) const
+{
+    const Pixel& p = pixel(x, y);
+
+    // The error cannot be estimated until both halves contain at least one sample.
+    if (p.m_half_count == 0.0f || p.m_half_count == p.m_full_count)
+        return 0.0f;
+
+    const Color3f full = p.m_full_sum / p.m_full_count;
+    const Color3f half = p.m_half_sum / p.m_half_count;
+
+    const float diff =
+        abs(full[0] - half[0]) +
+        abs(full[1] - half[1]) +
+        abs(full[2] - half[2]);
+
+    // Normalize by the square root of the intensity to account for the lower
+    // sensitivity of the eye in bright areas.
+    const float intensity = full[0] + full[1] + full[2];
+    return intensity > 0.0f ? diff / sqrt(intensity) : diff;
+}
+
+float BlockErrorEstimator::get_block_error(const AABB2i& block) const
+{
+    assert(block.is_valid());
+
+    float error = 0.0f;
+
+    for (int y = block.min.y; y <= block.max.y; ++y)
+    {
+        for (int x = block.min.x; x <= block.max.x; ++x)
+            error += get_pixel_error(x, y);
+    }
+
+    const size_t pixel_count =
+        static_cast<size_t>(block.extent(0) + 1) *
+        static_cast<size_t>(block.extent(1) + 1);
+
+    return error / pixel_count;
+}
+
+void BlockErrorEstimator::split_block(
+    const AABB2i&   block,
+    AABB2i&         first,
+    AABB2i&         second) const
+{
+    assert(block.is_valid());
+
+    // Split along the largest dimension.
+    const size_t dim = block.extent(0) >= block.extent(1) ? 0 : 1;
+    const size_t other = 1 - dim;
+    const int size = block.extent(dim) + 1;
+    assert(size >= 2);
+
+    // Compute the error of each row or column of pixels across the split dimension.
+    vector<float> slice_errors(size, 0.0f);
+    float total_error = 0.0f;
+    for (int i = 0; i < size; ++i)
+    {
+        for (int j = block.min[other]; j <= block.max[other]; ++j)
+        {
+            const float e =
+                dim == 0
+                    ? get_pixel_error(block.min.x + i, j)
+                    : get_pixel_error(j, block.min.y + i);
+            slice_errors[i] += e;
+        }
+
+        total_error += slice_errors[i];
+    }
+
+    // Find the split position that balances the error between the two sub-blocks.
+    // Fall back to the middle of the block if there is no error at all.
+    int split = size / 2;
+    if (total_error > 0.0f)
+    {
+        const float half_error = 0.5f * total_error;
+        float accumulated_error = 0.0f;
+        split = size - 1;
+        for (int i = 0; i < size - 1; ++i)
+        {
+            accumulated_error += slice_errors[i];
+            if (accumulated_error >= half_error)
+            {
+                split = i + 1;
+                break;
+            }
+        }
+    }
+    assert(split >= 1 && split < size);
+
+    first = second = block;
+    first.max[dim] = block.min[dim] + split - 1;
+    second.min[dim] = block.min[dim] + split;
+}
+
+}   // namespace renderer
@@ -0,0 +1,154 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_BLOCKERRORESTIMATOR_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_BLOCKERRORESTIMATOR_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/image/color.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace renderer
+{
+
+//
+// Estimates the error of rectangular blocks of pixels by comparing the image made
+// of all the samples with the image made of only half of them, as described in
+//
+//   A Hierarchical Automatic Stopping Condition for Monte Carlo Global Illumination
+//   Holger Dammertz, Johannes Hanika, Alexander Keller, Hendrik P. A. Lensch
+//   http://jo.dreggn.org/home/2009_stopping.pdf
+//
+// Pixel coordinates are expressed in the same space as the bounding box passed to
+// the constructor; they may be negative.
+//
+
+class BlockErrorEstimator
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor. 'bbox' is the inclusive rectangle of pixels covered by the estimator.
+    explicit BlockErrorEstimator(const foundation::AABB2i& bbox);
+
+    // Return the rectangle of pixels covered by the estimator.
+    const foundation::AABB2i& get_bbox() const;
+
+    // Remove all samples.
+    void clear();
+
+    // Add a sample to a given pixel. 'half' should be true for every other sample:
+    // those samples are also accumulated into the half buffer.
+    void add(
+        const int                   x,
+        const int                   y,
+        const foundation::Color3f&  color,
+        const bool                  half);
+
+    // Return the error of a given pixel, or 0 if the pixel has less than two samples.
+    float get_pixel_error(const int x, const int y) const;
+
+    // Return the average pixel error over a block of pixels.
+    float get_block_error(const foundation::AABB2i& block) const;
+
+    // Split a block along its largest dimension such that both sub-blocks have
+    // roughly the same total error. The block must be at least two pixels wide
+    // along its largest dimension.
+    void split_block(
+        const foundation::AABB2i&   block,
+        foundation::AABB2i&         first,
+        foundation::AABB2i&         second) const;
+
+  private:
+    struct Pixel
+    {
+        foundation::Color3f         m_full_sum;
+        foundation::Color3f         m_half_sum;
+        float                       m_full_count;
+        float                       m_half_count;
+    };
+
+    const foundation::AABB2i        m_bbox;
+    const size_t                    m_width;
+    std::vector<Pixel>              m_pixels;
+
+    const Pixel& pixel(const int x, const int y) const;
+    Pixel& pixel(const int x, const int y);
+};
+
+
+//
+// BlockErrorEstimator class implementation.
+//
+
+inline const foundation::AABB2i& BlockErrorEstimator::get_bbox() const
+{
+    return m_bbox;
+}
+
+inline void BlockErrorEstimator::add(
+    const int                       x,
+    const int                       y,
+    const foundation::Color3f&      color,
+    const bool                      half)
+{
+    Pixel& p = pixel(x, y);
+
+    p.m_full_sum += color;
+    p.m_full_count += 1.0f;
+
+    if (half)
+    {
+        p.m_half_sum += color;
+        p.m_half_count += 1.0f;
+    }
+}
+
+inline const BlockErrorEstimator::Pixel& BlockErrorEstimator::pixel(const int x, const int y) const
+{
+    assert(m_bbox.contains(foundation::Vector2i(x, y)));
+
+    return m_pixels[(y - m_bbox.min.y) * m_width + (x - m_bbox.min.x)];
+}
+
+inline BlockErrorEstimator::Pixel& BlockErrorEstimator::pixel(const int x, const int y)
+{
+    assert(m_bbox.contains(foundation::Vector2i(x, y)));
+
+    return m_pixels[(y - m_bbox.min.y) * m_width + (x - m_bbox.min.x)];
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_BLOCKERRORESTIMATOR_H
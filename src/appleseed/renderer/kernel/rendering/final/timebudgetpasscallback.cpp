@@ -0,0 +1,141 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "timebudgetpasscallback.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/modeling/frame/frame.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// TimeBudgetPassCallback class implementation.
+//
+
+namespace
+{
+    // Upper bound on the number of passes; the number of samples per pixel doubles
+    // with each pass so this limit is never reached in practice.
+    const size_t MaxPassCount = 1000;
+}
+
+TimeBudgetPassCallback::TimeBudgetPassCallback(const ParamArray& params)
+  : m_scheduler(
+        params.get_required<double>("time_limit", 60.0),
+        params.get_optional<size_t>("time_limit_initial_samples", 1))
+  , m_frame_done(true)
+  , m_pass_start_time(0.0)
+{
+}
+
+void TimeBudgetPassCallback::release()
+{
+    delete this;
+}
+
+size_t TimeBudgetPassCallback::get_max_pass_count() const
+{
+    return MaxPassCount;
+}
+
+void TimeBudgetPassCallback::pre_render(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    AbortSwitch&            abort_switch)
+{
+    // Start from scratch if this is the first pass of a new frame.
+    if (m_frame_done)
+    {
+        m_scheduler.reset();
+        m_frame_done = false;
+        m_stopwatch.start();
+    }
+
+    m_pass_start_time = m_stopwatch.measure().get_seconds();
+
+    RENDERER_LOG_DEBUG(
+        "rendering pass with %s sample%s/pixel.",
+        pretty_uint(m_scheduler.get_pass_samples()).c_str(),
+        m_scheduler.get_pass_samples() > 1 ? "s" : "");
+}
+
+void TimeBudgetPassCallback::post_render(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    AbortSwitch&            abort_switch)
+{
+    // Rendering was interrupted: the next pass will start a new frame.
+    if (abort_switch.is_aborted())
+    {
+        m_frame_done = true;
+        return;
+    }
+
+    const double elapsed = m_stopwatch.measure().get_seconds();
+
+    if (m_scheduler.end_pass(elapsed, elapsed - m_pass_start_time) > 0 &&
+        m_scheduler.get_pass_count() < MaxPassCount)
+        return;
+
+    const AABB2u& crop_window = frame.get_crop_window();
+    const size_t pixel_count = (crop_window.extent(0) + 1) * (crop_window.extent(1) + 1);
+    const double render_time = m_scheduler.get_render_time();
+
+    RENDERER_LOG_INFO(
+        "time budget: rendered %s pass%s with %s sample%s/pixel in %s (%s samples/second).",
+        pretty_uint(m_scheduler.get_pass_count()).c_str(),
+        m_scheduler.get_pass_count() > 1 ? "es" : "",
+        pretty_uint(m_scheduler.get_total_samples()).c_str(),
+        m_scheduler.get_total_samples() > 1 ? "s" : "",
+        pretty_time(elapsed).c_str(),
+        pretty_uint(
+            render_time > 0.0
+                ? static_cast<uint64>(m_scheduler.get_total_samples() * pixel_count / render_time)
+                : 0).c_str());
+
+    // Stop the generic frame renderer after this pass.
+    m_frame_done = true;
+    abort_switch.abort();
+}
+
+}   // namespace renderer
@@ -0,0 +1,108 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_TIMEBUDGETPASSCALLBACK_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_TIMEBUDGETPASSCALLBACK_H
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/final/timebudgetscheduler.h"
+#include "renderer/kernel/rendering/ipasscallback.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/utility/stopwatch.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace foundation    { class AbortSwitch; }
+namespace foundation    { class JobQueue; }
+namespace renderer      { class Frame; }
+
+namespace renderer
+{
+
+//
+// Drives the generic frame renderer and the uniform pixel renderer such that the
+// frame is rendered in a given amount of time. Every pass refines all tiles; the
+// number of samples per pixel of each pass is chosen such that the last pass ends
+// right before the time limit.
+//
+
+class TimeBudgetPassCallback
+  : public IPassCallback
+{
+  public:
+    // Constructor.
+    explicit TimeBudgetPassCallback(const ParamArray& params);
+
+    // Delete this instance.
+    virtual void release() OVERRIDE;
+
+    // This method is called at the beginning of a pass.
+    virtual void pre_render(
+        const Frame&                frame,
+        foundation::JobQueue&       job_queue,
+        foundation::AbortSwitch&    abort_switch) OVERRIDE;
+
+    // This method is called at the end of a pass.
+    virtual void post_render(
+        const Frame&                frame,
+        foundation::JobQueue&       job_queue,
+        foundation::AbortSwitch&    abort_switch) OVERRIDE;
+
+    // Return the number of samples per pixel to render in the current pass.
+    size_t get_pass_sample_count() const;
+
+    // Return the maximum number of passes.
+    size_t get_max_pass_count() const;
+
+  private:
+    TimeBudgetScheduler             m_scheduler;
+    bool                            m_frame_done;
+    double                          m_pass_start_time;
+    foundation::Stopwatch<foundation::DefaultWallclockTimer>
+                                    m_stopwatch;
+};
+
+
+//
+// TimeBudgetPassCallback class implementation.
+//
+
+inline size_t TimeBudgetPassCallback::get_pass_sample_count() const
+{
+    return m_scheduler.get_pass_samples();
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_TIMEBUDGETPASSCALLBACK_H
@@ -0,0 +1,166 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_TIMEBUDGETSCHEDULER_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_TIMEBUDGETSCHEDULER_H
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// Schedules rendering passes such that the whole frame is uniformly refined until
+// a time limit is reached. Every pass renders all pixels with the same number of
+// samples; the number of samples per pixel of the next pass is derived from the
+// rendering throughput measured during the previous passes.
+//
+
+class TimeBudgetScheduler
+{
+  public:
+    // Constructor.
+    TimeBudgetScheduler(
+        const double    time_limit,             // in seconds
+        const size_t    initial_samples = 1);   // number of samples per pixel of the first pass
+
+    // Prepare for rendering a new frame.
+    void reset();
+
+    // Return the number of samples per pixel of the current pass.
+    size_t get_pass_samples() const;
+
+    // Return the number of samples per pixel rendered so far.
+    size_t get_total_samples() const;
+
+    // Return the number of passes rendered so far.
+    size_t get_pass_count() const;
+
+    // Return the time spent rendering passes so far, in seconds.
+    double get_render_time() const;
+
+    // Signal the end of the current pass. 'elapsed' is the time elapsed since the
+    // beginning of the frame and 'pass_time' is the duration of the pass, both in
+    // seconds. Return the number of samples per pixel of the next pass, or 0 if
+    // there isn't enough time left for another pass.
+    size_t end_pass(const double elapsed, const double pass_time);
+
+  private:
+    const double    m_time_limit;
+    const size_t    m_initial_samples;
+    size_t          m_pass_samples;
+    size_t          m_total_samples;
+    size_t          m_pass_count;
+    double          m_render_time;
+};
+
+
+//
+// TimeBudgetScheduler class implementation.
+//
+
+inline TimeBudgetScheduler::TimeBudgetScheduler(
+    const double        time_limit,
+    const size_t        initial_samples)
+  : m_time_limit(time_limit)
+  , m_initial_samples(std::max<size_t>(initial_samples, 1))
+{
+    reset();
+}
+
+inline void TimeBudgetScheduler::reset()
+{
+    m_pass_samples = m_initial_samples;
+    m_total_samples = 0;
+    m_pass_count = 0;
+    m_render_time = 0.0;
+}
+
+inline size_t TimeBudgetScheduler::get_pass_samples() const
+{
+    return m_pass_samples;
+}
+
+inline size_t TimeBudgetScheduler::get_total_samples() const
+{
+    return m_total_samples;
+}
+
+inline size_t TimeBudgetScheduler::get_pass_count() const
+{
+    return m_pass_count;
+}
+
+inline double TimeBudgetScheduler::get_render_time() const
+{
+    return m_render_time;
+}
+
+inline size_t TimeBudgetScheduler::end_pass(const double elapsed, const double pass_time)
+{
+    assert(m_pass_samples > 0);
+
+    m_total_samples += m_pass_samples;
+    m_render_time += pass_time;
+    ++m_pass_count;
+
+    // Keep a small safety margin to absorb variations in rendering throughput.
+    const double SafetyFactor = 0.95;
+    const double remaining_time = (m_time_limit - elapsed) * SafetyFactor;
+
+    // Estimate how many samples per pixel can still be rendered, assuming that the
+    // throughput of the next pass will match the average throughput so far.
+    size_t affordable_samples;
+    if (remaining_time <= 0.0)
+        affordable_samples = 0;
+    else if (m_render_time <= 0.0)
+        affordable_samples = 2 * m_total_samples;
+    else
+    {
+        const double time_per_sample = m_render_time / m_total_samples;
+        const double samples = std::min(remaining_time / time_per_sample, 1.0e9);
+        affordable_samples = static_cast<size_t>(samples);
+    }
+
+    // Double the number of samples per pixel at each pass, which keeps the number
+    // of passes low while refining the throughput estimate, and give all the
+    // remaining time to the last pass.
+    m_pass_samples =
+        affordable_samples <= 2 * m_total_samples
+            ? affordable_samples
+            : m_total_samples;
+
+    return m_pass_samples;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_FINAL_TIMEBUDGETSCHEDULER_H
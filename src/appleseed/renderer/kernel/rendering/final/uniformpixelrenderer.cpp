@@ -36,6 +36,7 @@
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/spectrumstack.h"
 #include "renderer/kernel/rendering/final/pixelsampler.h"
+#include "renderer/kernel/rendering/final/timebudgetpasscallback.h"
 #include "renderer/kernel/rendering/isamplerenderer.h"
 #include "renderer/kernel/rendering/pixelcontext.h"
 #include "renderer/kernel/rendering/pixelrendererbase.h"
@@ -58,6 +59,7 @@
 // Standard headers.
 #include <cmath>
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class Tile; }
@@ -80,15 +82,19 @@ namespace
     {
       public:
         UniformPixelRenderer(
-            ISampleRendererFactory*     factory,
-            const ParamArray&           params,
-            const bool                  primary)
+            ISampleRendererFactory*         factory,
+            const TimeBudgetPassCallback*   time_budget,
+            const ParamArray&               params,
+            const bool                      primary)
           : m_params(params)
           , m_sample_renderer(factory->create(primary))
+          , m_time_budget(time_budget)
+          , m_decorrelate(m_params.m_decorrelate || time_budget != 0)
           , m_sample_count(m_params.m_samples)
           , m_sqrt_sample_count(round<int>(sqrt(static_cast<double>(m_params.m_samples))))
+          , m_deferred_sample_count(0)
         {
-            if (!m_params.m_decorrelate)
+            if (!m_decorrelate)
             {
                 m_pixel_sampler.initialize(m_sqrt_sample_count);
 
@@ -105,6 +111,12 @@ namespace
             }
         }
 
+        ~UniformPixelRenderer()
+        {
+            for (size_t i = 0; i < m_deferred_results.size(); ++i)
+                delete m_deferred_results[i];
+        }
+
         virtual void release() OVERRIDE
         {
             delete this;
@@ -126,8 +138,12 @@ namespace
             const int iy = pixel_context.m_iy;
             const size_t aov_count = frame.aov_images().size();
 
-            if (m_params.m_decorrelate)
+            if (m_decorrelate)
             {
+                // With a time budget, the number of samples varies from pass to pass.
+                const size_t sample_count =
+                    m_time_budget ? m_time_budget->get_pass_sample_count() : m_sample_count;
+
                 // Create a sampling context.
                 const size_t frame_width = frame.image().properties().m_canvas_width;
                 const size_t instance = hash_uint32(static_cast<uint32>(pass_hash + iy * frame_width + ix));
@@ -137,30 +153,26 @@ namespace
                     0,                  // number of samples -- unknown
                     instance);          // initial instance number
 
-                for (size_t i = 0; i < m_sample_count; ++i)
+                for (size_t i = 0; i < sample_count; ++i)
                 {
                     // Generate a uniform sample in [0,1)^2.
                     const Vector2d s =
-                        m_sample_count > 1 || m_params.m_force_aa
+                        sample_count > 1 || m_time_budget || m_params.m_force_aa
                             ? sampling_context.next_vector2<2>()
                             : Vector2d(0.5);
 
                     // Compute the sample position in NDC.
                     const Vector2d sample_position = frame.get_sample_position(ix + s.x, iy + s.y);
 
-                    // Render the sample.
+                    // Render the sample and merge it into the framebuffer.
                     SamplingContext child_sampling_context(sampling_context);
-                    ShadingResult shading_result(aov_count);
-                    m_sample_renderer->render_sample(
+                    render_sample(
                         child_sampling_context,
                         pixel_context,
                         sample_position,
-                        shading_result);
-
-                    // Merge the sample into the framebuffer.
-                    if (shading_result.is_valid_linear_rgb())
-                        framebuffer.add(tx + s.x, ty + s.y, shading_result);
-                    else signal_invalid_sample();
+                        Vector2d(tx + s.x, ty + s.y),
+                        aov_count,
+                        framebuffer);
                 }
             }
             else
@@ -189,23 +201,56 @@ namespace
                             instance,       // number of samples
                             instance);      // initial instance number -- end of sequence
 
-                        // Render the sample.
-                        ShadingResult shading_result(aov_count);
-                        m_sample_renderer->render_sample(
+                        // Render the sample and merge it into the framebuffer.
+                        render_sample(
                             sampling_context,
                             pixel_context,
                             sample_position,
-                            shading_result);
-
-                        // Merge the sample into the framebuffer.
-                        if (shading_result.is_valid_linear_rgb())
-                            framebuffer.add(s.x - ix + tx, s.y - iy + ty, shading_result);
-                        else signal_invalid_sample();
+                            Vector2d(s.x - ix + tx, s.y - iy + ty),
+                            aov_count,
+                            framebuffer);
                     }
                 }
             }
         }
 
+        virtual void shade_deferred_samples(ShadingResultFrameBuffer& framebuffer) OVERRIDE
+        {
+            if (m_deferred_sample_count == 0)
+                return;
+
+            m_sample_renderer->shade_deferred_samples();
+
+            for (size_t i = 0; i < m_deferred_sample_count; ++i)
+            {
+                const ShadingResult& shading_result = *m_deferred_results[i];
+
+                if (shading_result.is_valid_linear_rgb())
+                {
+                    const Vector2d& position = m_deferred_positions[i];
+                    framebuffer.add(position.x, position.y, shading_result);
+                }
+                else signal_invalid_sample();
+            }
+
+            m_deferred_sample_count = 0;
+        }
+
+        virtual void discard_deferred_samples() OVERRIDE
+        {
+            if (m_deferred_sample_count == 0)
+                return;
+
+            m_sample_renderer->discard_deferred_samples();
+
+            m_deferred_sample_count = 0;
+        }
+
+        virtual uint64 get_ray_count() const OVERRIDE
+        {
+            return m_sample_renderer->get_ray_count();
+        }
+
         virtual StatisticsVector get_statistics() const OVERRIDE
         {
             return m_sample_renderer->get_statistics();
@@ -226,11 +271,66 @@ namespace
             }
         };
 
+        // Maximum number of samples whose shading can be deferred before they get shaded.
+        enum { MaxDeferredSampleCount = 4096 };
+
         const Parameters                    m_params;
         auto_release_ptr<ISampleRenderer>   m_sample_renderer;
+        const TimeBudgetPassCallback*       m_time_budget;
+        const bool                          m_decorrelate;
         const size_t                        m_sample_count;
         const int                           m_sqrt_sample_count;
         PixelSampler                        m_pixel_sampler;
+
+        // Shading results are recycled from one batch of deferred samples to the next.
+        vector<ShadingResult*>              m_deferred_results;
+        vector<Vector2d>                    m_deferred_positions;
+        size_t                              m_deferred_sample_count;
+
+        void render_sample(
+            SamplingContext&            sampling_context,
+            const PixelContext&         pixel_context,
+            const Vector2d&             sample_position,
+            const Vector2d&             framebuffer_position,
+            const size_t                aov_count,
+            ShadingResultFrameBuffer&   framebuffer)
+        {
+            if (is_deferred_shading_enabled())
+            {
+                if (m_deferred_sample_count == m_deferred_results.size())
+                {
+                    m_deferred_results.push_back(new ShadingResult(aov_count));
+                    m_deferred_positions.push_back(Vector2d());
+                }
+
+                ShadingResult& shading_result = *m_deferred_results[m_deferred_sample_count];
+                m_deferred_positions[m_deferred_sample_count] = framebuffer_position;
+                ++m_deferred_sample_count;
+
+                m_sample_renderer->defer_sample(
+                    sampling_context,
+                    pixel_context,
+                    sample_position,
+                    shading_result);
+
+                // Bound the memory used by deferred samples.
+                if (m_deferred_sample_count == MaxDeferredSampleCount)
+                    shade_deferred_samples(framebuffer);
+            }
+            else
+            {
+                ShadingResult shading_result(aov_count);
+                m_sample_renderer->render_sample(
+                    sampling_context,
+                    pixel_context,
+                    sample_position,
+                    shading_result);
+
+                if (shading_result.is_valid_linear_rgb())
+                    framebuffer.add(framebuffer_position.x, framebuffer_position.y, shading_result);
+                else signal_invalid_sample();
+            }
+        }
     };
 }
 
@@ -240,9 +340,11 @@ namespace
 //
 
 UniformPixelRendererFactory::UniformPixelRendererFactory(
-    ISampleRendererFactory*     factory,
-    const ParamArray&           params)
+    ISampleRendererFactory*         factory,
+    const ParamArray&               params,
+    const TimeBudgetPassCallback*   time_budget)
   : m_factory(factory)
+  , m_time_budget(time_budget)
   , m_params(params)
 {
 }
@@ -254,7 +356,7 @@ void UniformPixelRendererFactory::release()
 
 IPixelRenderer* UniformPixelRendererFactory::create(const bool primary)
 {
-    return new UniformPixelRenderer(m_factory, m_params, primary);
+    return new UniformPixelRenderer(m_factory, m_time_budget, m_params, primary);
 }
 
 }   // namespace renderer
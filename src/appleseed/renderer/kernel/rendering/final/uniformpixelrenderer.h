@@ -39,6 +39,7 @@
 
 // Forward declarations.
 namespace renderer  { class ISampleRendererFactory; }
+namespace renderer  { class TimeBudgetPassCallback; }
 
 namespace renderer
 {
@@ -51,10 +52,12 @@ class UniformPixelRendererFactory
   : public IPixelRendererFactory
 {
   public:
-    // Constructor.
+    // Constructor. If a time budget is provided, the number of samples
+    // per pixel of each pass is dictated by the time budget.
     UniformPixelRendererFactory(
-        ISampleRendererFactory*     factory,
-        const ParamArray&           params);
+        ISampleRendererFactory*         factory,
+        const ParamArray&               params,
+        const TimeBudgetPassCallback*   time_budget = 0);
 
     // Delete this instance.
     virtual void release() OVERRIDE;
@@ -64,6 +67,7 @@ class UniformPixelRendererFactory
 
   private:
     ISampleRendererFactory*         m_factory;
+    const TimeBudgetPassCallback*   m_time_budget;
     ParamArray                      m_params;
 };
 
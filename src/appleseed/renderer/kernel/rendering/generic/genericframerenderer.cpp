@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globaltraceeventrecorder.h"
 #include "renderer/kernel/rendering/generic/tilejob.h"
 #include "renderer/kernel/rendering/generic/tilejobfactory.h"
 #include "renderer/kernel/rendering/framerendererbase.h"
@@ -193,6 +194,16 @@ namespace
             return m_is_rendering;
         }
 
+        virtual StatisticsVector get_statistics() const OVERRIDE
+        {
+            StatisticsVector stats;
+
+            for (size_t i = 0; i < m_tile_renderers.size(); ++i)
+                stats.merge(m_tile_renderers[i]->get_statistics());
+
+            return stats;
+        }
+
       private:
         struct Parameters
         {
@@ -274,6 +285,8 @@ namespace
                     if (m_pass_count > 1)
                         RENDERER_LOG_INFO("--- beginning pass %s ---", pretty_uint(pass + 1).c_str());
 
+                    TraceScope pass_trace(global_trace_event_recorder(), "pass", "rendering");
+
                     // Invoke the pre-pass callback if there is one.
                     if (m_pass_callback)
                     {
@@ -347,12 +360,7 @@ namespace
         {
             assert(!m_tile_renderers.empty());
 
-            StatisticsVector stats;
-
-            for (size_t i = 0; i < m_tile_renderers.size(); ++i)
-                stats.merge(m_tile_renderers[i]->get_statistics());
-
-            RENDERER_LOG_DEBUG("%s", stats.to_string().c_str());
+            RENDERER_LOG_DEBUG("%s", get_statistics().to_string().c_str());
         }
     };
 }
@@ -38,6 +38,7 @@
 #include "renderer/kernel/intersection/tracecontext.h"
 #include "renderer/kernel/lighting/ilightingengine.h"
 #include "renderer/kernel/lighting/tracer.h"
+#include "renderer/kernel/rendering/pixelcontext.h"
 #ifdef WITH_OSL
 #include "renderer/kernel/shading/oslshadergroupexec.h"
 #endif
@@ -50,24 +51,30 @@
 #include "renderer/kernel/texturing/texturecache.h"
 #include "renderer/modeling/camera/camera.h"
 #include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/material/material.h"
 #include "renderer/modeling/scene/scene.h"
+#ifdef WITH_OSL
+#include "renderer/modeling/shadergroup/shadergroup.h"
+#endif
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
 #include "foundation/image/colorspace.h"
 #include "foundation/image/spectrum.h"
+#include "foundation/math/population.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/arena.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/string.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cstddef>
+#include <deque>
 #include <limits>
 #include <string>
-
-// Forward declarations.
-namespace renderer  { class PixelContext; }
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -132,6 +139,12 @@ namespace
                 m_params.m_transparency_threshold,
                 m_params.m_max_iterations)
           , m_shading_engine(shading_engine)
+          , m_sample_count(0)
+          , m_shading_count(0)
+          , m_deferred_shading_count(0)
+          , m_deferred_wave_count(0)
+          , m_unsorted_material_switch_count(0)
+          , m_sorted_material_switch_count(0)
         {
         }
 
@@ -158,6 +171,8 @@ namespace
 
 #endif
 
+            ++m_sample_count;
+
             // Construct a primary ray.
             ShadingRay primary_ray;
             m_scene.get_camera()->generate_ray(
@@ -165,84 +180,17 @@ namespace
                 image_point,
                 primary_ray);
 
-            ShadingPoint shading_points[2];
-            size_t shading_point_index = 0;
-            const ShadingPoint* shading_point_ptr = 0;
-            size_t iterations = 0;
-
-            while (true)
-            {
-                // Put a hard limit on the number of iterations.
-                if (++iterations >= m_params.m_max_iterations)
-                {
-                    RENDERER_LOG_WARNING(
-                        "reached hard iteration limit (%s), breaking primary ray trace loop.",
-                        pretty_int(m_params.m_max_iterations).c_str());
-                    break;
-                }
-
-                // Trace the ray.
-                shading_points[shading_point_index].clear();
-                m_intersector.trace(
-                    primary_ray,
-                    shading_points[shading_point_index],
-                    shading_point_ptr);
-
-                // Update the pointers to the shading points.
-                shading_point_ptr = &shading_points[shading_point_index];
-                shading_point_index = 1 - shading_point_index;
-
-                if (iterations == 1)
-                {
-                    // Shade the intersection point.
-                    m_shading_engine.shade(
-                        sampling_context,
-                        pixel_context,
-                        m_shading_context,
-                        *shading_point_ptr,
-                        shading_result);
-
-                    // Transform the result to the linear RGB color space.
-                    shading_result.transform_to_linear_rgb(m_lighting_conditions);
-
-                    // Apply alpha premultiplication.
-                    if (shading_point_ptr->hit())
-                        shading_result.apply_alpha_premult_linear_rgb();
-                }
-                else
-                {
-                    // Shade the intersection point.
-                    ShadingResult local_result(shading_result.m_aovs.size());
-                    m_shading_engine.shade(
-                        sampling_context,
-                        pixel_context,
-                        m_shading_context,
-                        *shading_point_ptr,
-                        local_result);
-
-                    // Transform the result to the linear RGB color space.
-                    local_result.transform_to_linear_rgb(m_lighting_conditions);
-
-                    // Apply alpha premultiplication.
-                    if (shading_point_ptr->hit())
-                        local_result.apply_alpha_premult_linear_rgb();
-
-                    // Compositing.
-                    shading_result.composite_over_linear_rgb(local_result);
-                }
-
-                // Stop once we hit the environment.
-                if (!shading_point_ptr->hit())
-                    break;
-
-                // Stop once we hit full opacity.
-                if (max_value(shading_result.m_main.m_alpha) > m_opacity_threshold)
-                    break;
+            // Trace the primary ray.
+            ShadingPoint shading_point;
+            m_intersector.trace(primary_ray, shading_point);
 
-                // Move the ray origin to the intersection point.
-                primary_ray.m_org = shading_point_ptr->get_point();
-                primary_ray.m_tmax = numeric_limits<double>::max();
-            }
+            // Shade the sample.
+            shade_sample(
+                sampling_context,
+                pixel_context,
+                primary_ray,
+                shading_point,
+                shading_result);
 
 #ifdef DEBUG_DISPLAY_TEXTURE_CACHE_PERFORMANCES
 
@@ -268,9 +216,139 @@ namespace
 #endif
         }
 
+        virtual void defer_sample(
+            SamplingContext&        sampling_context,
+            const PixelContext&     pixel_context,
+            const Vector2d&         image_point,
+            ShadingResult&          shading_result) OVERRIDE
+        {
+            ++m_sample_count;
+
+            // Construct a primary ray.
+            ShadingRay primary_ray;
+            m_scene.get_camera()->generate_ray(
+                sampling_context,
+                image_point,
+                primary_ray);
+
+            // Trace the primary ray. The shading point is traced in place since copying
+            // it would discard the intersection data computed on demand.
+            m_deferred_samples.push_back(
+                DeferredSample(
+                    sampling_context,
+                    pixel_context,
+                    primary_ray,
+                    shading_result));
+            DeferredSample& sample = m_deferred_samples.back();
+            m_intersector.trace(primary_ray, sample.m_shading_point);
+            sample.update_sort_key();
+        }
+
+        virtual void shade_deferred_samples() OVERRIDE
+        {
+            // Shade the deferred samples in waves. Each wave shades one point of the camera
+            // path of every remaining sample, then traces the continuation rays of the samples
+            // that went through a transparent surface, whose hits form the next wave.
+            m_deferred_sample_order.resize(m_deferred_samples.size());
+            for (size_t i = 0, e = m_deferred_sample_order.size(); i < e; ++i)
+                m_deferred_sample_order[i] = i;
+
+            while (!m_deferred_sample_order.empty())
+            {
+                const size_t wave_size = m_deferred_sample_order.size();
+
+                ++m_deferred_wave_count;
+                m_deferred_shading_count += wave_size;
+
+                // Sort the samples of the wave by material, preserving their order within a material.
+                m_unsorted_material_switch_count += count_material_switches();
+                stable_sort(
+                    m_deferred_sample_order.begin(),
+                    m_deferred_sample_order.end(),
+                    DeferredSampleOrder(m_deferred_samples));
+                m_sorted_material_switch_count += count_material_switches();
+
+                // Shade the samples of the wave and keep the ones that continue.
+                size_t continued_sample_count = 0;
+                for (size_t i = 0; i < wave_size; ++i)
+                {
+#ifdef WITH_OSL
+                    // Execute the surface shaders of the next samples as a batch.
+                    if (i % OSLShaderGroupExec::MaxBatchSize == 0)
+                    {
+                        execute_osl_shading_batch(
+                            i,
+                            min<size_t>(i + OSLShaderGroupExec::MaxBatchSize, wave_size));
+                    }
+#endif
+
+                    const size_t sample_index = m_deferred_sample_order[i];
+                    DeferredSample& sample = m_deferred_samples[sample_index];
+
+                    if (shade_point(
+                            sample.m_sampling_context,
+                            sample.m_pixel_context,
+                            sample.m_shading_point,
+                            sample.m_iterations,
+                            *sample.m_shading_result))
+                        m_deferred_sample_order[continued_sample_count++] = sample_index;
+                }
+
+                m_deferred_sample_order.resize(continued_sample_count);
+
+                // Trace the continuation rays of the next wave.
+                for (size_t i = 0; i < continued_sample_count; ++i)
+                {
+                    DeferredSample& sample = m_deferred_samples[m_deferred_sample_order[i]];
+                    const ShadingPoint parent_shading_point(sample.m_shading_point);
+
+                    // Move the ray origin to the intersection point.
+                    sample.m_primary_ray.m_org = parent_shading_point.get_point();
+                    sample.m_primary_ray.m_tmax = numeric_limits<double>::max();
+
+                    // Trace the ray.
+                    sample.m_shading_point.clear();
+                    m_intersector.trace(
+                        sample.m_primary_ray,
+                        sample.m_shading_point,
+                        &parent_shading_point);
+
+                    ++sample.m_iterations;
+                    sample.update_sort_key();
+                }
+            }
+
+            m_deferred_samples.clear();
+        }
+
+        virtual void discard_deferred_samples() OVERRIDE
+        {
+            m_deferred_samples.clear();
+        }
+
+        virtual uint64 get_ray_count() const OVERRIDE
+        {
+            return m_intersector.get_ray_count();
+        }
+
         virtual StatisticsVector get_statistics() const OVERRIDE
         {
+            Statistics shading_stats;
+            shading_stats.insert("samples", m_sample_count);
+            shading_stats.insert("shading points", m_shading_count);
+            shading_stats.insert("heap allocations per shading point", m_heap_allocations_per_point);
+
+            if (m_deferred_wave_count > 0)
+            {
+                // Comparing material switches before and after binning measures the coherence gain.
+                shading_stats.insert("deferred shading points", m_deferred_shading_count);
+                shading_stats.insert("deferred shading waves", m_deferred_wave_count);
+                shading_stats.insert("material switches before binning", m_unsorted_material_switch_count);
+                shading_stats.insert("material switches after binning", m_sorted_material_switch_count);
+            }
+
             StatisticsVector stats;
+            stats.insert("shading statistics", shading_stats);
             stats.merge(m_texture_cache.get_statistics());
             stats.merge(m_intersector.get_statistics());
             stats.merge(m_lighting_engine->get_statistics());
@@ -292,6 +370,57 @@ namespace
             }
         };
 
+        struct DeferredSample
+        {
+            SamplingContext         m_sampling_context;
+            PixelContext            m_pixel_context;
+            ShadingRay              m_primary_ray;
+            ShadingPoint            m_shading_point;
+            ShadingResult*          m_shading_result;
+            size_t                  m_iterations;   // index of the current point along the camera path, starting at 1
+            UniqueID                m_sort_key;
+
+            DeferredSample(
+                const SamplingContext&  sampling_context,
+                const PixelContext&     pixel_context,
+                const ShadingRay&       primary_ray,
+                ShadingResult&          shading_result)
+              : m_sampling_context(sampling_context)
+              , m_pixel_context(pixel_context)
+              , m_primary_ray(primary_ray)
+              , m_shading_result(&shading_result)
+              , m_iterations(1)
+              , m_sort_key(0)
+            {
+            }
+
+            // Samples are shaded by groups of identical materials. Sorting by unique ID
+            // rather than by address keeps the shading order deterministic.
+            void update_sort_key()
+            {
+                const Material* material = m_shading_point.get_material();
+                m_sort_key = material ? material->get_uid() : ~UniqueID(0);
+            }
+        };
+
+        // Deferred samples are stored in a deque so that they never move once traced.
+        typedef deque<DeferredSample> DeferredSampleDeque;
+
+        struct DeferredSampleOrder
+        {
+            const DeferredSampleDeque& m_samples;
+
+            explicit DeferredSampleOrder(const DeferredSampleDeque& samples)
+              : m_samples(samples)
+            {
+            }
+
+            bool operator()(const size_t lhs, const size_t rhs) const
+            {
+                return m_samples[lhs].m_sort_key < m_samples[rhs].m_sort_key;
+            }
+        };
+
         const Parameters            m_params;
         const Scene&                m_scene;
         const LightingConditions&   m_lighting_conditions;
@@ -306,6 +435,185 @@ namespace
         ILightingEngine*            m_lighting_engine;
         const ShadingContext        m_shading_context;
         ShadingEngine&              m_shading_engine;
+
+        uint64                      m_sample_count;
+        uint64                      m_shading_count;
+        Population<uint64>          m_heap_allocations_per_point;
+
+        DeferredSampleDeque         m_deferred_samples;
+        vector<size_t>              m_deferred_sample_order;
+        uint64                      m_deferred_shading_count;
+        uint64                      m_deferred_wave_count;
+        uint64                      m_unsorted_material_switch_count;
+        uint64                      m_sorted_material_switch_count;
+
+        // Count the material changes between consecutive samples of the current wave.
+        size_t count_material_switches() const
+        {
+            size_t count = 0;
+
+            for (size_t i = 1, e = m_deferred_sample_order.size(); i < e; ++i)
+            {
+                if (m_deferred_samples[m_deferred_sample_order[i - 1]].m_sort_key !=
+                    m_deferred_samples[m_deferred_sample_order[i]].m_sort_key)
+                    ++count;
+            }
+
+            return count;
+        }
+
+#ifdef WITH_OSL
+        // Execute the OSL surface shaders of a range of sorted deferred samples as a batch.
+        void execute_osl_shading_batch(const size_t begin, const size_t end)
+        {
+            const ShaderGroup* shader_groups[OSLShaderGroupExec::MaxBatchSize];
+            const ShadingPoint* shading_points[OSLShaderGroupExec::MaxBatchSize];
+            size_t count = 0;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const ShadingPoint& shading_point =
+                    m_deferred_samples[m_deferred_sample_order[i]].m_shading_point;
+
+                if (!shading_point.hit())
+                    continue;
+
+                const Material* material = shading_point.get_material();
+                const ShaderGroup* shader_group = material ? material->get_osl_surface() : 0;
+
+                // The shading of transparent surfaces starts with a transparency
+                // execution, which would discard the results of the batch.
+                if (shader_group == 0 || shader_group->has_transparency())
+                    continue;
+
+                shader_groups[count] = shader_group;
+                shading_points[count] = &shading_point;
+                ++count;
+            }
+
+            m_shadergroup_exec.execute_shading_batch(shader_groups, shading_points, count);
+        }
+#endif
+
+        // Shade a sample whose primary ray has been traced, continuing through transparent surfaces.
+        void shade_sample(
+            SamplingContext&        sampling_context,
+            const PixelContext&     pixel_context,
+            ShadingRay&             primary_ray,
+            const ShadingPoint&     primary_shading_point,
+            ShadingResult&          shading_result)
+        {
+            ShadingPoint shading_points[2];
+            size_t shading_point_index = 0;
+            const ShadingPoint* shading_point_ptr = &primary_shading_point;
+            size_t iterations = 1;
+
+            while (
+                shade_point(
+                    sampling_context,
+                    pixel_context,
+                    *shading_point_ptr,
+                    iterations,
+                    shading_result))
+            {
+                ++iterations;
+
+                // Move the ray origin to the intersection point.
+                primary_ray.m_org = shading_point_ptr->get_point();
+                primary_ray.m_tmax = numeric_limits<double>::max();
+
+                // Trace the ray.
+                shading_points[shading_point_index].clear();
+                m_intersector.trace(
+                    primary_ray,
+                    shading_points[shading_point_index],
+                    shading_point_ptr);
+
+                // Update the pointers to the shading points.
+                shading_point_ptr = &shading_points[shading_point_index];
+                shading_point_index = 1 - shading_point_index;
+            }
+        }
+
+        // Shade the iterations'th point of the camera path of a sample and composite it into
+        // the shading result of the sample. Return true if the path continues beyond this point.
+        bool shade_point(
+            SamplingContext&        sampling_context,
+            const PixelContext&     pixel_context,
+            const ShadingPoint&     shading_point,
+            const size_t            iterations,
+            ShadingResult&          shading_result)
+        {
+            // Release the temporaries allocated while shading the previous point.
+            Arena& arena = m_shading_context.get_arena();
+            arena.clear();
+
+            const uint64 initial_heap_allocation_count = arena.get_heap_allocation_count();
+
+            if (iterations == 1)
+            {
+                // Shade the intersection point.
+                ++m_shading_count;
+                m_shading_engine.shade(
+                    sampling_context,
+                    pixel_context,
+                    m_shading_context,
+                    shading_point,
+                    shading_result);
+
+                // Transform the result to the linear RGB color space.
+                shading_result.transform_to_linear_rgb(m_lighting_conditions);
+
+                // Apply alpha premultiplication.
+                if (shading_point.hit())
+                    shading_result.apply_alpha_premult_linear_rgb();
+            }
+            else
+            {
+                // Shade the intersection point.
+                ShadingResult local_result(shading_result.m_aovs.size());
+                ++m_shading_count;
+                m_shading_engine.shade(
+                    sampling_context,
+                    pixel_context,
+                    m_shading_context,
+                    shading_point,
+                    local_result);
+
+                // Transform the result to the linear RGB color space.
+                local_result.transform_to_linear_rgb(m_lighting_conditions);
+
+                // Apply alpha premultiplication.
+                if (shading_point.hit())
+                    local_result.apply_alpha_premult_linear_rgb();
+
+                // Compositing.
+                shading_result.composite_over_linear_rgb(local_result);
+            }
+
+            // Count the temporaries that didn't fit in the arena.
+            m_heap_allocations_per_point.insert(
+                arena.get_heap_allocation_count() - initial_heap_allocation_count);
+
+            // Stop once we hit the environment.
+            if (!shading_point.hit())
+                return false;
+
+            // Stop once we hit full opacity.
+            if (max_value(shading_result.m_main.m_alpha) > m_opacity_threshold)
+                return false;
+
+            // Put a hard limit on the number of iterations.
+            if (iterations + 1 >= m_params.m_max_iterations)
+            {
+                RENDERER_LOG_WARNING(
+                    "reached hard iteration limit (%s), breaking primary ray trace loop.",
+                    pretty_int(m_params.m_max_iterations).c_str());
+                return false;
+            }
+
+            return true;
+        }
     };
 }
 
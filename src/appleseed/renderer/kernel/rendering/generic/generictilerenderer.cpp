@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
 #include "renderer/global/globaltypes.h"
+#include "renderer/kernel/aov/aovsettings.h"
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/tilestack.h"
 #include "renderer/kernel/rendering/ipixelrenderer.h"
@@ -43,7 +44,9 @@
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
 #include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/math/aabb.h"
 #include "foundation/math/filter.h"
@@ -53,6 +56,7 @@
 #include "foundation/math/vector.h"
 #include "foundation/platform/breakpoint.h"
 #include "foundation/platform/types.h"
+#include "foundation/platform/x86timer.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/iostreamop.h"
 #include "foundation/utility/job.h"
@@ -78,6 +82,22 @@ namespace
     //
     // Generic tile renderer.
     //
+    // When the enable_cost_heatmap parameter is set, the tile renderer measures the
+    // time spent and the number of rays traced while rendering each pixel, accumulates
+    // them over all passes, and stores them in the "render_time" (in microseconds) and
+    // "ray_count" AOVs. The values are stored unmodified so that they can be remapped
+    // to a heatmap in compositing.
+    //
+    // The cost heatmap cannot be combined with deferred shading: shading happens once
+    // all the pixels of a tile have been traced, and would not be accounted for.
+    //
+
+    bool is_cost_heatmap_enabled(const ParamArray& params)
+    {
+        return
+            params.get_optional<bool>("enable_cost_heatmap", false) &&
+            !params.get_optional<bool>("deferred_shading", false);
+    }
 
 #ifndef NDEBUG
 
@@ -95,13 +115,26 @@ namespace
             const Frame&                        frame,
             IPixelRendererFactory*              pixel_renderer_factory,
             IShadingResultFrameBufferFactory*   framebuffer_factory, 
+            Image*                              cost_image,
             const ParamArray&                   params,
             const bool                          primary)
-          : m_pixel_renderer(pixel_renderer_factory->create(primary))
+          : m_params(params)
+          , m_pixel_renderer(pixel_renderer_factory->create(primary))
           , m_framebuffer_factory(framebuffer_factory)
+          , m_cost_image(cost_image)
+          , m_render_time_aov_index(frame.aov_images().get("render_time"))
+          , m_ray_count_aov_index(frame.aov_images().get("ray_count"))
         {
             compute_tile_margins(frame, primary);
             compute_pixel_ordering(frame);
+
+            if (m_cost_image)
+            {
+                m_timer.reset(new X86Timer());
+                m_rcp_timer_frequency_us = 1.0e6 / m_timer->frequency();
+            }
+
+            m_pixel_renderer->set_deferred_shading(m_params.m_deferred_shading);
         }
 
         virtual void release() OVERRIDE
@@ -146,6 +179,10 @@ namespace
             // Inform the pixel renderer that we are about to render a tile.
             m_pixel_renderer->on_tile_begin(frame, tile, aov_tiles);
 
+            // Retrieve the tile into which per-pixel rendering costs are accumulated.
+            // Tiles are rendered by a single thread at a time, so no locking is needed.
+            Tile* cost_tile = m_cost_image ? &m_cost_image->tile(tile_x, tile_y) : 0;
+
             // Create the framebuffer into which we will accumulate the samples.
             ShadingResultFrameBuffer* framebuffer =
                 m_framebuffer_factory->create(
@@ -166,7 +203,11 @@ namespace
             {
                 // Cancel any work done on this tile if rendering is aborted.
                 if (abort_switch.is_aborted())
+                {
+                    // Don't let pending samples leak into the next tile, and don't waste time shading them.
+                    m_pixel_renderer->discard_deferred_samples();
                     return;
+                }
 
                 // Retrieve the coordinates of the pixel in the padded tile.
                 const int tx = m_pixel_ordering[i].x;
@@ -192,6 +233,13 @@ namespace
 
 #endif
 
+                // Record the state of the cost counters before rendering this pixel.
+                const bool measure_cost =
+                    cost_tile &&
+                    tile_bbox.contains(Vector2u(static_cast<size_t>(tx), static_cast<size_t>(ty)));
+                const uint64 start_time = measure_cost ? m_timer->read() : 0;
+                const uint64 start_ray_count = measure_cost ? m_pixel_renderer->get_ray_count() : 0;
+
                 // Render this pixel.
                 m_pixel_renderer->render_pixel(
                     frame,
@@ -203,13 +251,33 @@ namespace
                     tx, ty,
                     m_rng,
                     *framebuffer);
+
+                // Store the cost of this pixel.
+                if (measure_cost)
+                {
+                    const uint64 elapsed = m_timer->read() - start_time;
+                    const uint64 ray_count = m_pixel_renderer->get_ray_count() - start_ray_count;
+
+                    Color<float, 2> values;
+                    cost_tile->get_pixel(tx, ty, values);
+                    values[0] += static_cast<float>(elapsed * m_rcp_timer_frequency_us);
+                    values[1] += static_cast<float>(ray_count);
+                    cost_tile->set_pixel(tx, ty, values);
+                }
             }
 
+            // Shade the samples whose shading was deferred, grouped by material.
+            m_pixel_renderer->shade_deferred_samples(*framebuffer);
+
             // Develop the framebuffer to the tile.
             if (frame.is_premultiplied_alpha())
                 framebuffer->develop_to_tile_premult_alpha(tile, aov_tiles);
             else framebuffer->develop_to_tile_straight_alpha(tile, aov_tiles);
 
+            // Copy per-pixel rendering costs to their AOVs, overwriting what the framebuffer developed.
+            if (cost_tile)
+                develop_cost_tile(*cost_tile, tile_bbox, aov_tiles);
+
             // Release the framebuffer.
             m_framebuffer_factory->destroy(framebuffer);
 
@@ -223,13 +291,50 @@ namespace
         }
 
       protected:
+        struct Parameters
+        {
+            const bool  m_deferred_shading;
+
+            explicit Parameters(const ParamArray& params)
+              : m_deferred_shading(params.get_optional<bool>("deferred_shading", false))
+            {
+            }
+        };
+
+        const Parameters                    m_params;
         auto_release_ptr<IPixelRenderer>    m_pixel_renderer;
         IShadingResultFrameBufferFactory*   m_framebuffer_factory;
+        Image*                              m_cost_image;
+        const size_t                        m_render_time_aov_index;
+        const size_t                        m_ray_count_aov_index;
+        auto_ptr<X86Timer>                  m_timer;
+        double                              m_rcp_timer_frequency_us;
         int                                 m_margin_width;
         int                                 m_margin_height;
         vector<Vector<int16, 2> >           m_pixel_ordering;
         SamplingContext::RNGType            m_rng;
 
+        void develop_cost_tile(
+            const Tile&             cost_tile,
+            const AABB2u&           tile_bbox,
+            TileStack&              aov_tiles) const
+        {
+            for (size_t y = tile_bbox.min.y; y <= tile_bbox.max.y; ++y)
+            {
+                for (size_t x = tile_bbox.min.x; x <= tile_bbox.max.x; ++x)
+                {
+                    Color<float, 2> values;
+                    cost_tile.get_pixel(x, y, values);
+
+                    if (m_render_time_aov_index != ~size_t(0))
+                        aov_tiles.set_pixel(x, y, m_render_time_aov_index, Color4f(values[0], values[0], values[0], 1.0f));
+
+                    if (m_ray_count_aov_index != ~size_t(0))
+                        aov_tiles.set_pixel(x, y, m_ray_count_aov_index, Color4f(values[1], values[1], values[1], 1.0f));
+                }
+            }
+        }
+
         void compute_tile_margins(const Frame& frame, const bool primary)
         {
             m_margin_width = truncate<int>(ceil(frame.get_filter().get_xradius() - 0.5));
@@ -301,6 +406,53 @@ GenericTileRendererFactory::GenericTileRendererFactory(
   , m_framebuffer_factory(framebuffer_factory)
   , m_params(params)
 {
+    // Costs are only measured if the AOVs that receive them were created.
+    const ImageStack& images = frame.aov_images();
+    if (is_cost_heatmap_enabled(params) &&
+        (images.get("render_time") != ~size_t(0) || images.get("ray_count") != ~size_t(0)))
+    {
+        const CanvasProperties& props = frame.image().properties();
+
+        m_cost_image.reset(
+            new Image(
+                props.m_canvas_width,
+                props.m_canvas_height,
+                props.m_tile_width,
+                props.m_tile_height,
+                2,
+                PixelFormatFloat));
+
+        m_cost_image->clear(Color<float, 2>(0.0f));
+    }
+}
+
+void GenericTileRendererFactory::create_cost_heatmap_aovs(
+    const Frame&                        frame,
+    const ParamArray&                   params)
+{
+    if (!params.get_optional<bool>("enable_cost_heatmap", false))
+        return;
+
+    if (!is_cost_heatmap_enabled(params))
+    {
+        RENDERER_LOG_ERROR("the cost heatmap cannot be used with deferred shading, disabling it.");
+        return;
+    }
+
+    ImageStack& images = frame.aov_images();
+
+    if (images.get("render_time") == ~size_t(0) && images.size() < MaxAOVCount)
+        images.append("render_time", ImageStack::IdentificationType, PixelFormatFloat);
+
+    if (images.get("ray_count") == ~size_t(0) && images.size() < MaxAOVCount)
+        images.append("ray_count", ImageStack::IdentificationType, PixelFormatFloat);
+
+    if (images.get("render_time") == ~size_t(0) || images.get("ray_count") == ~size_t(0))
+    {
+        RENDERER_LOG_WARNING(
+            "could not create some of the cost heatmap AOVs, maximum number of AOVs (" FMT_SIZE_T ") reached.",
+            MaxAOVCount);
+    }
 }
 
 void GenericTileRendererFactory::release()
@@ -315,6 +467,7 @@ ITileRenderer* GenericTileRendererFactory::create(const bool primary)
             m_frame,
             m_pixel_renderer_factory,
             m_framebuffer_factory,
+            m_cost_image.get(),
             m_params,
             primary);
 }
@@ -37,10 +37,14 @@
 // appleseed.foundation headers.
 #include "foundation/platform/compiler.h"
 
+// Standard headers.
+#include <memory>
+
 // Forward declarations.
-namespace renderer  { class Frame; }
-namespace renderer  { class IPixelRendererFactory; }
-namespace renderer  { class IShadingResultFrameBufferFactory; }
+namespace foundation    { class Image; }
+namespace renderer      { class Frame; }
+namespace renderer      { class IPixelRendererFactory; }
+namespace renderer      { class IShadingResultFrameBufferFactory; }
 
 namespace renderer
 {
@@ -66,11 +70,19 @@ class GenericTileRendererFactory
     // Return a new generic tile renderer instance.
     virtual ITileRenderer* create(const bool primary) OVERRIDE;
 
+    // Create the AOVs of the cost heatmap, if it is enabled by a given set of
+    // tile renderer parameters. Must be called while setting up the AOVs of
+    // the frame, before the factory is constructed.
+    static void create_cost_heatmap_aovs(
+        const Frame&                        frame,
+        const ParamArray&                   params);
+
   private:
     const Frame&                            m_frame;
     IPixelRendererFactory*                  m_pixel_renderer_factory;
     IShadingResultFrameBufferFactory*       m_framebuffer_factory;
     ParamArray                              m_params;
+    std::auto_ptr<foundation::Image>        m_cost_image;       // per-pixel rendering costs accumulated over all passes
 };
 
 }       // namespace renderer
@@ -31,6 +31,7 @@
 #include "tilejob.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globaltraceeventrecorder.h"
 #include "renderer/kernel/rendering/itilecallback.h"
 #include "renderer/kernel/rendering/itilerenderer.h"
 #include "renderer/modeling/frame/frame.h"
@@ -81,6 +82,8 @@ void TileJob::execute(const size_t thread_index)
 {
     assert(thread_index < m_tile_renderers.size());
 
+    TraceScope trace(global_trace_event_recorder(), "tile job", "jobs");
+
     // Retrieve the tile callback.
     ITileCallback* tile_callback =
         m_tile_callbacks.size() == m_tile_renderers.size()
@@ -33,6 +33,9 @@
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
 
+// Forward declarations.
+namespace foundation    { class StatisticsVector; }
+
 namespace renderer
 {
 
@@ -52,6 +55,9 @@ class IFrameRenderer
     virtual void stop_rendering() = 0;
     virtual void terminate_rendering() = 0;
     virtual bool is_rendering() const = 0;
+
+    // Retrieve performance statistics, merged across all rendering threads.
+    virtual foundation::StatisticsVector get_statistics() const = 0;
 };
 
 
@@ -36,6 +36,7 @@
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
 #include "foundation/math/aabb.h"
+#include "foundation/platform/types.h"
 
 // Standard headers.
 #include <cstddef>
@@ -84,6 +85,21 @@ class IPixelRenderer
         SamplingContext::RNGType&   rng,
         ShadingResultFrameBuffer&   framebuffer) = 0;
 
+    // Enable or disable deferred shading. When enabled, render_pixel() may only trace
+    // the primary rays of the pixel and postpone their shading until
+    // shade_deferred_samples() is called. Pixel renderers that cannot defer shading
+    // keep shading samples immediately.
+    virtual void set_deferred_shading(const bool enabled) = 0;
+
+    // Shade the samples whose shading was deferred and store them into the framebuffer.
+    virtual void shade_deferred_samples(ShadingResultFrameBuffer& framebuffer) = 0;
+
+    // Drop the samples whose shading was deferred, for instance when rendering is aborted.
+    virtual void discard_deferred_samples() = 0;
+
+    // Return the total number of rays traced so far by this pixel renderer.
+    virtual foundation::uint64 get_ray_count() const = 0;
+
     // Retrieve performance statistics.
     virtual foundation::StatisticsVector get_statistics() const = 0;
 };
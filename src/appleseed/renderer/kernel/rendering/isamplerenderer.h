@@ -36,6 +36,7 @@
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 
 // Forward declarations.
 namespace foundation    { class StatisticsVector; }
@@ -61,6 +62,26 @@ class ISampleRenderer
         const foundation::Vector2d&     image_point,
         ShadingResult&                  shading_result) = 0;
 
+    // Like render_sample() but only trace the primary ray of the sample and postpone
+    // its shading until shade_deferred_samples() is called. The shading result must
+    // remain valid until then. Sample renderers that cannot defer shading may render
+    // the sample immediately.
+    virtual void defer_sample(
+        SamplingContext&                sampling_context,
+        const PixelContext&             pixel_context,
+        const foundation::Vector2d&     image_point,
+        ShadingResult&                  shading_result) = 0;
+
+    // Shade all the samples deferred since the last call to this method.
+    virtual void shade_deferred_samples() = 0;
+
+    // Drop all the samples deferred since the last call to shade_deferred_samples(),
+    // without shading them. Their shading results are left untouched.
+    virtual void discard_deferred_samples() = 0;
+
+    // Return the total number of rays traced so far by this sample renderer.
+    virtual foundation::uint64 get_ray_count() const = 0;
+
     // Retrieve performance statistics.
     virtual foundation::StatisticsVector get_statistics() const = 0;
 };
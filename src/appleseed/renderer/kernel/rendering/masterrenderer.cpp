@@ -30,9 +30,13 @@
 #include "masterrenderer.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalmemorytracker.h"
+#include "renderer/global/globaltraceeventrecorder.h"
+#include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/lighting/drt/drtlightingengine.h"
 #include "renderer/kernel/lighting/lighttracing/lighttracingsamplegenerator.h"
 #include "renderer/kernel/lighting/pt/ptlightingengine.h"
+#include "renderer/kernel/lighting/pt/ptpasscallback.h"
 #include "renderer/kernel/lighting/sppm/sppmlightingengine.h"
 #include "renderer/kernel/lighting/sppm/sppmparameters.h"
 #include "renderer/kernel/lighting/sppm/sppmpasscallback.h"
@@ -43,6 +47,8 @@
 #include "renderer/kernel/rendering/debug/debugsamplerenderer.h"
 #include "renderer/kernel/rendering/debug/debugtilerenderer.h"
 #include "renderer/kernel/rendering/final/adaptivepixelrenderer.h"
+#include "renderer/kernel/rendering/final/adaptivetilerenderer.h"
+#include "renderer/kernel/rendering/final/timebudgetpasscallback.h"
 #include "renderer/kernel/rendering/final/uniformpixelrenderer.h"
 #include "renderer/kernel/rendering/generic/genericframerenderer.h"
 #include "renderer/kernel/rendering/generic/genericsamplegenerator.h"
@@ -63,10 +69,16 @@
 #include "renderer/kernel/rendering/serialtilecallback.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingengine.h"
+#include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/kernel/texturing/texturestore.h"
 #include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/object/iregion.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/regionkit.h"
 #include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/containers.h"
 #include "renderer/modeling/scene/scene.h"
 #ifdef WITH_OSL
 #include "renderer/kernel/rendering/oiioerrorhandler.h"
@@ -75,10 +87,16 @@
 #endif
 
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/thread.h"
+#include "foundation/utility/foreach.h"
 #include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/lazy.h"
+#include "foundation/utility/memorytracker.h"
 #include "foundation/utility/searchpaths.h"
+#include "foundation/utility/statistics.h"
 
 // boost headers.
 #include "boost/filesystem/path.hpp"
@@ -151,6 +169,11 @@ const ParamArray& MasterRenderer::get_parameters() const
     return m_params;
 }
 
+const StatisticsVector& MasterRenderer::get_statistics() const
+{
+    return m_statistics;
+}
+
 bool MasterRenderer::render()
 {
     try
@@ -242,6 +265,8 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 
 #ifdef WITH_OSL
 
+    TraceScope osl_setup_trace(global_trace_event_recorder(), "osl setup", "setup");
+
     // Create the error handler.
     OIIOErrorHandler error_handler;
 
@@ -352,14 +377,28 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 
     register_closures(*shading_system);
 
+    osl_setup_trace.end();
+
 #endif  // WITH_OSL
 
     // We start by binding entities inputs. This must be done before creating/updating the trace context.
+    TraceScope binding_trace(global_trace_event_recorder(), "bind scene entities inputs", "setup");
     if (!bind_scene_entities_inputs())
         return IRendererController::AbortRendering;
+    binding_trace.end();
 
     m_project.create_aov_images();
+
+    if (m_params.get_optional<string>("tile_renderer", "") == "generic")
+    {
+        GenericTileRendererFactory::create_cost_heatmap_aovs(
+            *m_project.get_frame(),
+            m_params.child("generic_tile_renderer"));
+    }
+
+    TraceScope trace_context_trace(global_trace_event_recorder(), "update trace context", "setup");
     m_project.update_trace_context();
+    trace_context_trace.end();
 
     const Scene& scene = *m_project.get_scene();
 
@@ -369,10 +408,14 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     const TraceContext& trace_context = m_project.get_trace_context();
 
     // Create the texture store.
+    TraceScope texture_store_trace(global_trace_event_recorder(), "create texture store", "setup");
     TextureStore texture_store(scene, m_params.child("texture_store"));
+    texture_store_trace.end();
 
     // Create the light sampler.
+    TraceScope light_sampler_trace(global_trace_event_recorder(), "create light sampler", "setup");
     LightSampler light_sampler(scene, m_params.child("light_sampler"));
+    light_sampler_trace.end();
 
     // Create the shading engine.
     ShadingEngine shading_engine(m_params.child("shading_engine"));
@@ -390,15 +433,28 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
         {
             lighting_engine_factory.reset(
                 new DRTLightingEngineFactory(
+                    scene,
                     light_sampler,
                     m_params.child("drt")));    // todo: change to "drt_lighting_engine" -- or?
         }
         else if (value == "pt")
         {
+            const ParamArray& params = m_params.child("pt");    // todo: change to "pt_lighting_engine" -- or?
+
+            // Path guiding learns from the first passes of a multi-pass render.
+            SDTree* sd_tree = 0;
+            if (params.get_optional<bool>("enable_path_guiding", false))
+            {
+                PTPassCallback* pt_pass_callback = new PTPassCallback(scene, params);
+                pass_callback.reset(pt_pass_callback);
+                sd_tree = &pt_pass_callback->get_sd_tree();
+            }
+
             lighting_engine_factory.reset(
                 new PTLightingEngineFactory(
                     light_sampler,
-                    m_params.child("pt")));     // todo: change to "pt_lighting_engine" -- or?
+                    params,
+                    sd_tree));
         }
         else if (value == "sppm")
         {
@@ -517,18 +573,35 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     //
 
     auto_ptr<IPixelRendererFactory> pixel_renderer_factory;
+    TimeBudgetPassCallback* time_budget_pass_callback = 0;
     {
         const string value = m_params.get_optional<string>("pixel_renderer", "");
 
         if (value == "uniform")
         {
+            const ParamArray& frame_renderer_params = m_params.child("generic_frame_renderer");
+
             ParamArray params = m_params.child("uniform_pixel_renderer");
-            copy_param(params, m_params.child("generic_frame_renderer"), "passes");
+            copy_param(params, frame_renderer_params, "passes");
+
+            // With a time limit, the number of samples per pixel is chosen at render time.
+            if (frame_renderer_params.strings().exist("time_limit"))
+            {
+                if (pass_callback.get())
+                {
+                    RENDERER_LOG_ERROR("a time limit cannot be used with the SPPM lighting engine or with path guiding.");
+                    return IRendererController::AbortRendering;
+                }
+
+                time_budget_pass_callback = new TimeBudgetPassCallback(frame_renderer_params);
+                pass_callback.reset(time_budget_pass_callback);
+            }
 
             pixel_renderer_factory.reset(
                 new UniformPixelRendererFactory(
                     sample_renderer_factory.get(),
-                    params));
+                    params,
+                    time_budget_pass_callback));
         }
         else if (value == "adaptive")
         {
@@ -554,8 +627,11 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 
     auto_ptr<IShadingResultFrameBufferFactory> shading_result_framebuffer_factory;
     {
+        // Passes of a time-budgeted render accumulate into the same framebuffers.
         const string value =
-            m_params.get_optional<string>("shading_result_framebuffer", "ephemeral");
+            time_budget_pass_callback
+                ? "permanent"
+                : m_params.get_optional<string>("shading_result_framebuffer", "ephemeral");
 
         if (value == "ephemeral")
         {
@@ -582,6 +658,7 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     //
 
     auto_ptr<ITileRendererFactory> tile_renderer_factory;
+    AdaptiveTileRendererFactory* adaptive_tile_renderer_factory = 0;
     {
         const string value = m_params.get_optional<string>("tile_renderer", "");
 
@@ -594,6 +671,22 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
                     shading_result_framebuffer_factory.get(),
                     m_params.child("generic_tile_renderer")));
         }
+        else if (value == "adaptive")
+        {
+            // The adaptive tile renderer relies on its own pass callback.
+            if (pass_callback.get())
+            {
+                RENDERER_LOG_ERROR("the adaptive tile renderer cannot be used with the SPPM lighting engine, with path guiding or with a time limit.");
+                return IRendererController::AbortRendering;
+            }
+
+            adaptive_tile_renderer_factory =
+                new AdaptiveTileRendererFactory(
+                    frame,
+                    sample_renderer_factory.get(),
+                    m_params.child("adaptive_tile_renderer"));
+            tile_renderer_factory.reset(adaptive_tile_renderer_factory);
+        }
         else if (value == "blank")
         {
             tile_renderer_factory.reset(new BlankTileRendererFactory());
@@ -625,12 +718,22 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
             ParamArray params = m_params.child("generic_frame_renderer");
             copy_param(params, m_params, "rendering_threads");
 
+            // The adaptive tile renderer decides by itself when to stop rendering.
+            IPassCallback* frame_pass_callback = pass_callback.get();
+            if (adaptive_tile_renderer_factory)
+            {
+                params.insert("passes", adaptive_tile_renderer_factory->get_max_pass_count());
+                frame_pass_callback = adaptive_tile_renderer_factory->get_pass_callback();
+            }
+            else if (time_budget_pass_callback)
+                params.insert("passes", time_budget_pass_callback->get_max_pass_count());
+
             frame_renderer.reset(
                 GenericFrameRendererFactory::create(
                     frame,
                     tile_renderer_factory.get(),
                     m_tile_callback_factory,
-                    pass_callback.get(),
+                    frame_pass_callback,
                     params));
         }
         else if (value == "progressive")
@@ -665,11 +768,56 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
             );
 
     // Print texture store performance statistics.
-    RENDERER_LOG_DEBUG("%s", texture_store.get_statistics().to_string().c_str());
+    const StatisticsVector texture_store_stats = texture_store.get_statistics();
+    RENDERER_LOG_DEBUG("%s", texture_store_stats.to_string().c_str());
+    m_statistics.merge(texture_store_stats);
 
     return status;
 }
 
+namespace
+{
+    size_t get_image_memory_size(const Image& image)
+    {
+        const CanvasProperties& props = image.properties();
+        return props.m_pixel_count * props.m_pixel_size;
+    }
+
+    size_t get_frame_memory_size(const Frame& frame)
+    {
+        size_t size = get_image_memory_size(frame.image());
+
+        const ImageStack& aov_images = frame.aov_images();
+        for (size_t i = 0; i < aov_images.size(); ++i)
+            size += get_image_memory_size(aov_images.get_image(i));
+
+        return size;
+    }
+
+    size_t get_mesh_memory_size(AssemblyContainer& assemblies)
+    {
+        size_t size = 0;
+
+        for (each<AssemblyContainer> i = assemblies; i; ++i)
+        {
+            for (each<ObjectContainer> j = i->objects(); j; ++j)
+            {
+                Access<RegionKit> region_kit(&j->get_region_kit());
+
+                for (const_each<RegionKit> k = *region_kit; k; ++k)
+                {
+                    Access<StaticTriangleTess> tess(&(*k)->get_static_triangle_tess());
+                    size += tess->get_memory_size();
+                }
+            }
+
+            size += get_mesh_memory_size(i->assemblies());
+        }
+
+        return size;
+    }
+}
+
 IRendererController::Status MasterRenderer::render_frame_sequence(
     IFrameRenderer*         frame_renderer
 #ifdef WITH_OSL
@@ -687,6 +835,7 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
         m_renderer_controller->on_frame_begin();
 
         // Prepare the scene for rendering. Don't proceed if that failed.
+        TraceScope scene_preparation_trace(global_trace_event_recorder(), "prepare scene", "setup");
 #ifdef WITH_OSL
         if (!m_project.get_scene()->on_frame_begin(m_project, &shading_system, m_abort_switch))
 #else
@@ -696,6 +845,7 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
             m_renderer_controller->on_frame_end();
             return IRendererController::AbortRendering;
         }
+        scene_preparation_trace.end();
 
         // Don't proceed with rendering if scene preparation was aborted.
         if (is_aborted(m_abort_switch))
@@ -704,6 +854,18 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
             return m_renderer_controller->on_progress();
         }
 
+        // Account for the memory used by the frame and by the mesh data while rendering this frame.
+        TrackedMemorySize frame_memory_size(global_memory_tracker(), "frame");
+        TrackedMemorySize mesh_memory_size(global_memory_tracker(), "mesh data");
+        if (global_memory_tracker().is_enabled())
+        {
+            global_memory_tracker().begin_frame();
+            frame_memory_size.set(get_frame_memory_size(*m_project.get_frame()));
+            mesh_memory_size.set(get_mesh_memory_size(m_project.get_scene()->assemblies()));
+        }
+
+        TraceScope frame_trace(global_trace_event_recorder(), "render frame", "rendering");
+
         frame_renderer->start_rendering();
 
         const IRendererController::Status status = wait_for_event(frame_renderer);
@@ -725,6 +887,15 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
 
         assert(!frame_renderer->is_rendering());
 
+        frame_trace.end();
+
+        // Collect the performance statistics of this frame.
+        m_statistics = frame_renderer->get_statistics();
+
+        // Print a summary of the memory used while rendering this frame.
+        if (global_memory_tracker().is_enabled())
+            RENDERER_LOG_INFO("%s", global_memory_tracker().get_statistics().to_string().c_str());
+
         m_project.get_scene()->on_frame_end(m_project);
         m_renderer_controller->on_frame_end();
 
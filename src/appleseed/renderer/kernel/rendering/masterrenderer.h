@@ -34,6 +34,9 @@
 #include "renderer/global/global.h"
 #include "renderer/kernel/rendering/irenderercontroller.h"
 
+// appleseed.foundation headers.
+#include "foundation/utility/statistics.h"
+
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
@@ -92,6 +95,9 @@ class DLLSYMBOL MasterRenderer
     // Render the project. Return true on success, false otherwise.
     bool render();
 
+    // Return the performance statistics of the last rendered frame.
+    const foundation::StatisticsVector& get_statistics() const;
+
   private:
     Project&                        m_project;
     ParamArray                      m_params;
@@ -103,6 +109,8 @@ class DLLSYMBOL MasterRenderer
     SerialRendererController*       m_serial_renderer_controller;
     ITileCallbackFactory*           m_serial_tile_callback_factory;
 
+    foundation::StatisticsVector    m_statistics;
+
 #ifdef WITH_OSL
     boost::shared_ptr<OIIO::TextureSystem>  m_texture_system;
     std::size_t                             m_texture_cache_size;
@@ -50,6 +50,7 @@ namespace renderer
 
 PixelRendererBase::PixelRendererBase()
   : m_invalid_sample_count(0)
+  , m_deferred_shading(false)
 {
 }
 
@@ -78,6 +79,19 @@ void PixelRendererBase::on_tile_end(
 {
 }
 
+void PixelRendererBase::set_deferred_shading(const bool enabled)
+{
+    m_deferred_shading = enabled;
+}
+
+void PixelRendererBase::shade_deferred_samples(ShadingResultFrameBuffer& framebuffer)
+{
+}
+
+void PixelRendererBase::discard_deferred_samples()
+{
+}
+
 void PixelRendererBase::signal_invalid_sample()
 {
     // todo: mark pixel as faulty in the diagnostic map.
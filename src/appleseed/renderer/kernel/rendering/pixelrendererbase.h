@@ -40,6 +40,7 @@
 // Forward declarations.
 namespace foundation    { class Tile; }
 namespace renderer      { class Frame; }
+namespace renderer      { class ShadingResultFrameBuffer; }
 namespace renderer      { class TileStack; }
 
 namespace renderer
@@ -71,13 +72,35 @@ class PixelRendererBase
         foundation::Tile&           tile,
         TileStack&                  aov_tiles) OVERRIDE;
 
+    // Enable or disable deferred shading.
+    virtual void set_deferred_shading(const bool enabled) OVERRIDE;
+
+    // Shade the samples whose shading was deferred. Does nothing by default.
+    virtual void shade_deferred_samples(ShadingResultFrameBuffer& framebuffer) OVERRIDE;
+
+    // Drop the samples whose shading was deferred. Does nothing by default.
+    virtual void discard_deferred_samples() OVERRIDE;
+
   protected:
     void signal_invalid_sample();
 
+    bool is_deferred_shading_enabled() const;
+
   private:
     foundation::uint64 m_invalid_sample_count;
+    bool               m_deferred_shading;
 };
 
+
+//
+// PixelRendererBase class implementation.
+//
+
+inline bool PixelRendererBase::is_deferred_shading_enabled() const
+{
+    return m_deferred_shading;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_PIXELRENDERERBASE_H
@@ -259,6 +259,16 @@ namespace
             return m_job_queue.has_scheduled_or_running_jobs();
         }
 
+        virtual StatisticsVector get_statistics() const
+        {
+            StatisticsVector stats;
+
+            for (size_t i = 0; i < m_sample_generators.size(); ++i)
+                stats.merge(m_sample_generators[i]->get_statistics());
+
+            return stats;
+        }
+
       private:
         struct Parameters
         {
@@ -439,12 +449,7 @@ namespace
         {
             assert(!m_sample_generators.empty());
 
-            StatisticsVector stats;
-
-            for (size_t i = 0; i < m_sample_generators.size(); ++i)
-                stats.merge(m_sample_generators[i]->get_statistics());
-
-            RENDERER_LOG_DEBUG("%s", stats.to_string().c_str());
+            RENDERER_LOG_DEBUG("%s", get_statistics().to_string().c_str());
         }
     };
 }
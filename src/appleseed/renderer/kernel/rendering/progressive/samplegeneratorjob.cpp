@@ -31,6 +31,7 @@
 #include "samplegeneratorjob.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globaltraceeventrecorder.h"
 #include "renderer/kernel/rendering/progressive/samplecounter.h"
 #include "renderer/kernel/rendering/isamplegenerator.h"
 #include "renderer/kernel/rendering/itilecallback.h"
@@ -103,6 +104,8 @@ void SampleGeneratorJob::execute(const size_t thread_index)
     if (sample_count == 0)
         return;
 
+    TraceScope trace(global_trace_event_recorder(), "sample generator job", "jobs");
+
     // Invoke the pre-pass callback if there is one.
     if (m_tile_callback)
     {
@@ -0,0 +1,385 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "sharedmemorytilecallback.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/rendering/sharedmemorytileprotocol.h"
+#include "renderer/kernel/rendering/tilecallbackbase.h"
+#include "renderer/modeling/frame/frame.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/string.h"
+
+// Boost headers.
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Standard headers.
+#include <cstring>
+#include <exception>
+#include <new>
+#include <set>
+#include <string>
+
+using namespace boost::interprocess;
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// SharedMemoryTileCallback.
+//
+
+namespace
+{
+    //
+    // A single instance of this callback is shared by all rendering threads. m_mutex
+    // only protects the segment and the bookkeeping of sequence numbers: tiles are
+    // converted into their slots concurrently, and slots are then published in
+    // sequence order as soon as all the slots that precede them are filled.
+    //
+
+    class SharedMemoryTileCallback
+      : public TileCallbackBase
+    {
+      public:
+        SharedMemoryTileCallback(
+            const char*             segment_name,
+            const size_t            slot_count)
+          : m_segment_name(segment_name)
+          , m_requested_slot_count(slot_count)
+          , m_header(0)
+          , m_next_sequence(0)
+          , m_published_count(0)
+        {
+        }
+
+        ~SharedMemoryTileCallback()
+        {
+            close_segment();
+        }
+
+        virtual void release() OVERRIDE
+        {
+            // Do nothing, this callback is owned by the factory.
+        }
+
+        virtual void post_render_tile(
+            const Frame*            frame,
+            const size_t            tile_x,
+            const size_t            tile_y) OVERRIDE
+        {
+            if (open_segment(*frame))
+                publish_tile(*frame, tile_x, tile_y);
+        }
+
+        virtual void post_render(const Frame* frame) OVERRIDE
+        {
+            if (!open_segment(*frame))
+                return;
+
+            const CanvasProperties& frame_props = frame->image().properties();
+
+            for (size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty)
+            {
+                for (size_t tx = 0; tx < frame_props.m_tile_count_x; ++tx)
+                    publish_tile(*frame, tx, ty);
+            }
+        }
+
+      private:
+        const string                m_segment_name;
+        const size_t                m_requested_slot_count;
+        boost::mutex                m_mutex;
+        boost::condition_variable   m_slot_released;
+        shared_memory_object        m_shm;
+        mapped_region               m_region;
+        SharedMemoryTileHeader*     m_header;
+        uint64                      m_next_sequence;        // sequence number of the next slot to fill
+        uint64                      m_published_count;      // number of slots published so far
+        set<uint64>                 m_filled_sequences;     // slots filled but not yet published
+
+        static bool matches(
+            const SharedMemoryTileHeader&   header,
+            const CanvasProperties&         props,
+            const size_t                    plane_count)
+        {
+            return
+                header.m_canvas_width == props.m_canvas_width &&
+                header.m_canvas_height == props.m_canvas_height &&
+                header.m_tile_width == props.m_tile_width &&
+                header.m_tile_height == props.m_tile_height &&
+                header.m_channel_count == props.m_channel_count &&
+                header.m_plane_count == plane_count;
+        }
+
+        // Make sure the shared memory segment exists and matches the properties of the frame.
+        bool open_segment(const Frame& frame)
+        {
+            const CanvasProperties& props = frame.image().properties();
+            const size_t plane_count = 1 + frame.aov_images().size();
+
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (m_header)
+            {
+                if (matches(*m_header, props, plane_count))
+                    return true;
+
+                // The frame changed: readers will have to attach to a new segment.
+                wait_until_all_published(lock);
+                close_segment();
+            }
+
+            const size_t slot_count =
+                m_requested_slot_count > 0
+                    ? m_requested_slot_count
+                    : props.m_tile_count * plane_count;
+            const size_t slot_size =
+                props.m_tile_width * props.m_tile_height * props.m_channel_count * sizeof(float);
+
+            try
+            {
+                shared_memory_object::remove(m_segment_name.c_str());
+
+                shared_memory_object shm(create_only, m_segment_name.c_str(), read_write);
+                shm.truncate(get_shared_memory_tile_segment_size(slot_count, slot_size));
+
+                mapped_region region(shm, read_write);
+
+                m_shm.swap(shm);
+                m_region.swap(region);
+            }
+            catch (const exception& e)
+            {
+                RENDERER_LOG_ERROR(
+                    "failed to create shared memory segment \"%s\": %s.",
+                    m_segment_name.c_str(),
+                    e.what());
+                return false;
+            }
+
+            m_header = new (m_region.get_address()) SharedMemoryTileHeader();
+            m_header->m_magic = SharedMemoryTileMagic;
+            m_header->m_version = SharedMemoryTileVersion;
+            m_header->m_canvas_width = static_cast<uint32>(props.m_canvas_width);
+            m_header->m_canvas_height = static_cast<uint32>(props.m_canvas_height);
+            m_header->m_tile_width = static_cast<uint32>(props.m_tile_width);
+            m_header->m_tile_height = static_cast<uint32>(props.m_tile_height);
+            m_header->m_channel_count = static_cast<uint32>(props.m_channel_count);
+            m_header->m_plane_count = static_cast<uint32>(plane_count);
+            m_header->m_slot_count = static_cast<uint32>(slot_count);
+            m_header->m_slot_size = static_cast<uint32>(slot_size);
+            m_header->m_acquired_count = 0;
+            m_header->m_published_count = 0;
+            m_header->m_closed = false;
+
+            m_next_sequence = 0;
+            m_published_count = 0;
+            m_filled_sequences.clear();
+
+            RENDERER_LOG_INFO(
+                "publishing tiles to shared memory segment \"%s\" (" FMT_SIZE_T " slots, %s).",
+                m_segment_name.c_str(),
+                slot_count,
+                pretty_size(m_region.get_size()).c_str());
+
+            return true;
+        }
+
+        void close_segment()
+        {
+            if (m_header == 0)
+                return;
+
+            {
+                scoped_lock<interprocess_mutex> lock(m_header->m_mutex);
+                m_header->m_closed = true;
+            }
+
+            m_header->m_tile_published.notify_all();
+            m_header = 0;
+
+            // Wake up the writers waiting for a slot of this segment.
+            m_slot_released.notify_all();
+
+            // Readers keep their own mapping of the segment, only the name goes away.
+            mapped_region().swap(m_region);
+            shared_memory_object().swap(m_shm);
+            shared_memory_object::remove(m_segment_name.c_str());
+        }
+
+        void publish_tile(
+            const Frame&            frame,
+            const size_t            tile_x,
+            const size_t            tile_y)
+        {
+            publish_plane_tile(frame.image(), 0, tile_x, tile_y);
+
+            for (size_t i = 0, e = frame.aov_images().size(); i < e; ++i)
+                publish_plane_tile(frame.aov_images().get_image(i), i + 1, tile_x, tile_y);
+        }
+
+        void publish_plane_tile(
+            const Image&            image,
+            const size_t            plane_index,
+            const size_t            tile_x,
+            const size_t            tile_y)
+        {
+            const CanvasProperties& props = image.properties();
+            const Tile& tile = image.tile(tile_x, tile_y);
+
+            uint64 sequence;
+            SharedMemoryTileSlot* slot =
+                acquire_slot(
+                    tile.get_pixel_count() * tile.get_channel_count() * sizeof(float),
+                    sequence);
+            if (slot == 0)
+                return;
+
+            slot->m_sequence = sequence;
+            slot->m_plane = static_cast<uint32>(plane_index);
+            slot->m_x = static_cast<uint32>(tile_x * props.m_tile_width);
+            slot->m_y = static_cast<uint32>(tile_y * props.m_tile_height);
+            slot->m_width = static_cast<uint32>(tile.get_width());
+            slot->m_height = static_cast<uint32>(tile.get_height());
+
+            // Convert the pixels straight into the slot, without any intermediate copy.
+            uint8* pixels = reinterpret_cast<uint8*>(get_shared_memory_tile_pixels(slot));
+            if (tile.get_pixel_format() == PixelFormatFloat)
+                memcpy(pixels, tile.get_storage(), tile.get_size());
+            else
+            {
+                const Tile converted_tile(tile, PixelFormatFloat, pixels);
+            }
+
+            publish_slot(sequence);
+        }
+
+        // Reserve the next slot of the ring buffer, waiting until the tile it holds has been
+        // published. Return 0 if the segment was closed or cannot hold the tile anymore.
+        SharedMemoryTileSlot* acquire_slot(
+            const size_t            tile_size,
+            uint64&                 sequence)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            while (m_header && m_next_sequence - m_published_count >= m_header->m_slot_count)
+                m_slot_released.wait(lock);
+
+            // The segment may have been closed or reopened for another frame while we were waiting.
+            if (m_header == 0 || tile_size > m_header->m_slot_size)
+                return 0;
+
+            sequence = m_next_sequence++;
+
+            // Let readers know that the slot is about to be overwritten.
+            {
+                scoped_lock<interprocess_mutex> header_lock(m_header->m_mutex);
+                m_header->m_acquired_count = m_next_sequence;
+            }
+
+            return
+                get_shared_memory_tile_slot(
+                    m_header,
+                    static_cast<size_t>(sequence % m_header->m_slot_count));
+        }
+
+        // Mark a slot as filled and publish all the filled slots that are now contiguous.
+        void publish_slot(const uint64 sequence)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            m_filled_sequences.insert(sequence);
+
+            const uint64 previous_published_count = m_published_count;
+
+            while (!m_filled_sequences.empty() && *m_filled_sequences.begin() == m_published_count)
+            {
+                m_filled_sequences.erase(m_filled_sequences.begin());
+                ++m_published_count;
+            }
+
+            if (m_published_count == previous_published_count)
+                return;
+
+            {
+                scoped_lock<interprocess_mutex> header_lock(m_header->m_mutex);
+                m_header->m_published_count = m_published_count;
+            }
+
+            m_header->m_tile_published.notify_all();
+            m_slot_released.notify_all();
+        }
+
+        void wait_until_all_published(boost::mutex::scoped_lock& lock)
+        {
+            while (m_published_count < m_next_sequence)
+                m_slot_released.wait(lock);
+        }
+    };
+}
+
+
+//
+// SharedMemoryTileCallbackFactory class implementation.
+//
+
+SharedMemoryTileCallbackFactory::SharedMemoryTileCallbackFactory(
+    const char*     segment_name,
+    const size_t    slot_count)
+  : m_callback(new SharedMemoryTileCallback(segment_name, slot_count))
+{
+}
+
+void SharedMemoryTileCallbackFactory::release()
+{
+    delete this;
+}
+
+ITileCallback* SharedMemoryTileCallbackFactory::create()
+{
+    return m_callback.get();
+}
+
+}   // namespace renderer
@@ -0,0 +1,74 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_SHAREDMEMORYTILECALLBACK_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_SHAREDMEMORYTILECALLBACK_H
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/itilecallback.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+
+namespace renderer
+{
+
+//
+// A tile callback that publishes rendered tiles into a named shared memory segment
+// from which external viewers can read them without interfering with rendering.
+// See renderer/kernel/rendering/sharedmemorytileprotocol.h for the layout of the segment.
+//
+
+class DLLSYMBOL SharedMemoryTileCallbackFactory
+  : public ITileCallbackFactory
+{
+  public:
+    // If slot_count is zero, the ring buffer is made large enough to hold all the
+    // tiles of all the images (beauty and AOVs) of the frame.
+    explicit SharedMemoryTileCallbackFactory(
+        const char*     segment_name,
+        const size_t    slot_count = 0);
+
+    virtual void release() OVERRIDE;
+
+    virtual ITileCallback* create() OVERRIDE;
+
+  private:
+    std::auto_ptr<ITileCallback> m_callback;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_SHAREDMEMORYTILECALLBACK_H
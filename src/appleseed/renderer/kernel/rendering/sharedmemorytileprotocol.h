@@ -0,0 +1,148 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_SHAREDMEMORYTILEPROTOCOL_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_SHAREDMEMORYTILEPROTOCOL_H
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+
+// Boost headers.
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+
+// Standard headers.
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// Layout of the shared memory segment used to publish rendered tiles to external viewers.
+//
+// The segment starts with a SharedMemoryTileHeader, followed by m_slot_count slots.
+// Each slot is a SharedMemoryTileSlot immediately followed by m_slot_size bytes of
+// pixels, stored as 32-bit floats, m_channel_count channels per pixel, row-major.
+//
+// The slots form a ring buffer. There may be several writers (the rendering threads of
+// the renderer) filling different slots at the same time. The tile with publication
+// sequence number n is stored in slot n % m_slot_count. A writer reserves sequence
+// number n by setting m_acquired_count to n + 1 under m_mutex, fills the slot without
+// holding any lock, then tiles are published in sequence order: m_published_count is
+// incremented under m_mutex and m_tile_published is broadcast. A slot is only reserved
+// again once the tile it holds has been published.
+//
+// A reader remembers how many tiles it has consumed, waits on m_tile_published, then
+// copies the new slots. A copy of the tile with sequence number n is only valid if
+// m_acquired_count <= n + m_slot_count once the copy is done, otherwise a writer may
+// have started reusing the slot and the tile must be dropped.
+//
+// When the renderer detaches, or when the frame properties change, m_closed is set
+// and m_tile_published is broadcast; readers must then detach from the segment and
+// attach again if they want to follow the next frame.
+//
+
+const foundation::uint32 SharedMemoryTileMagic = 0x41534D54;   // 'ASMT'
+const foundation::uint32 SharedMemoryTileVersion = 2;
+
+struct SharedMemoryTileHeader
+{
+    foundation::uint32                          m_magic;
+    foundation::uint32                          m_version;
+
+    // Frame properties.
+    foundation::uint32                          m_canvas_width;
+    foundation::uint32                          m_canvas_height;
+    foundation::uint32                          m_tile_width;
+    foundation::uint32                          m_tile_height;
+    foundation::uint32                          m_channel_count;
+    foundation::uint32                          m_plane_count;     // beauty + AOVs
+
+    // Ring buffer properties.
+    foundation::uint32                          m_slot_count;
+    foundation::uint32                          m_slot_size;       // size in bytes of the pixels of one slot
+
+    // The fields below are protected by m_mutex.
+    foundation::uint64                          m_acquired_count;  // total number of slots reserved by writers so far
+    foundation::uint64                          m_published_count; // total number of tiles published so far
+    bool                                        m_closed;          // true once the renderer has detached
+
+    boost::interprocess::interprocess_mutex     m_mutex;
+    boost::interprocess::interprocess_condition m_tile_published;
+};
+
+struct SharedMemoryTileSlot
+{
+    foundation::uint64                          m_sequence;        // publication sequence number of this tile
+    foundation::uint32                          m_plane;           // 0 for the beauty image, i + 1 for AOV #i
+    foundation::uint32                          m_x;               // position of the tile in the canvas, in pixels
+    foundation::uint32                          m_y;
+    foundation::uint32                          m_width;           // dimensions of the tile, in pixels
+    foundation::uint32                          m_height;
+    foundation::uint32                          m_padding;
+};
+
+// Return the size in bytes of one slot, including its header.
+inline size_t get_shared_memory_tile_slot_stride(const size_t slot_size)
+{
+    return sizeof(SharedMemoryTileSlot) + ((slot_size + 15) & ~size_t(15));
+}
+
+// Return the size in bytes of a whole shared memory segment.
+inline size_t get_shared_memory_tile_segment_size(
+    const size_t    slot_count,
+    const size_t    slot_size)
+{
+    return
+        ((sizeof(SharedMemoryTileHeader) + 15) & ~size_t(15))
+        + slot_count * get_shared_memory_tile_slot_stride(slot_size);
+}
+
+// Return a pointer to a given slot of a shared memory segment.
+inline SharedMemoryTileSlot* get_shared_memory_tile_slot(
+    void*           segment,
+    const size_t    slot_index)
+{
+    const SharedMemoryTileHeader* header = static_cast<const SharedMemoryTileHeader*>(segment);
+
+    return
+        reinterpret_cast<SharedMemoryTileSlot*>(
+            static_cast<foundation::uint8*>(segment)
+                + ((sizeof(SharedMemoryTileHeader) + 15) & ~size_t(15))
+                + slot_index * get_shared_memory_tile_slot_stride(header->m_slot_size));
+}
+
+// Return a pointer to the pixels of a given slot.
+inline float* get_shared_memory_tile_pixels(SharedMemoryTileSlot* slot)
+{
+    return reinterpret_cast<float*>(slot + 1);
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_SHAREDMEMORYTILEPROTOCOL_H
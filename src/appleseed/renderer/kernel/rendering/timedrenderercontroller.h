@@ -45,6 +45,10 @@ namespace renderer
 //
 // A renderer controller with a time limit.
 //
+// Rendering is simply stopped when the time limit is reached. To render a frame that
+// is uniformly refined when the time limit is reached, set the time_limit parameter
+// of the generic frame renderer instead.
+//
 
 class DLLSYMBOL TimedRendererController
   : public DefaultRendererController
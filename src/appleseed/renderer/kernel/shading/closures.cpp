@@ -46,6 +46,9 @@
 #include <boost/mpl/contains.hpp>
 #include <boost/static_assert.hpp>
 
+// Standard headers.
+#include <algorithm>
+
 using namespace foundation;
 using namespace renderer;
 
@@ -132,13 +135,39 @@ CompositeClosure::CompositeClosure(
 
     process_closure_tree(ci, Color3f(1.0f));
 
-    if (get_num_closures())
-        m_cdf.prepare();
+    const size_t closure_count = get_num_closures();
+
+    if (closure_count)
+    {
+        // Normalize the weights so that they add up to 1.0.
+        double weight_sum = 0.0;
+        for (size_t i = 0; i < closure_count; ++i)
+            weight_sum += m_weights[i];
+
+        const double rcp_weight_sum = 1.0 / weight_sum;
+        for (size_t i = 0; i < closure_count; ++i)
+            m_weights[i] *= rcp_weight_sum;
+
+        // Compute the cumulative distribution function.
+        double cumulated_weight = 0.0;
+        for (size_t i = 0; i < closure_count - 1; ++i)
+        {
+            cumulated_weight += m_weights[i];
+            m_cdf[i] = cumulated_weight;
+        }
+        m_cdf[closure_count - 1] = 1.0;
+    }
 }
 
 size_t CompositeClosure::choose_closure(const double w) const
 {
-    return m_cdf.sample(w).first;
+    assert(get_num_closures() > 0);
+    assert(w >= 0.0 && w < 1.0);
+
+    const double* i = std::upper_bound(m_cdf, m_cdf + get_num_closures(), w);
+    assert(i < m_cdf + get_num_closures());
+
+    return static_cast<size_t>(i - m_cdf);
 }
 
 void CompositeClosure::process_closure_tree(
@@ -416,7 +445,7 @@ void CompositeClosure::do_add_closure(
     if (w <= 0.0)
         return;
 
-    m_cdf.insert(get_num_closures(), w);
+    m_weights[m_num_closures] = w;
     linear_rgb_reflectance_to_spectrum(weight, m_spectrum_multipliers[m_num_closures]);
     m_normals[m_num_closures] = normalize(normal);
     m_has_tangent[m_num_closures] = has_tangent;
@@ -40,7 +40,6 @@
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/image/color.h"
-#include "foundation/math/cdf.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/compiler.h"
 
@@ -135,6 +134,9 @@ class APPLESEED_ALIGN(16) CompositeClosure
     enum { MaxClosureEntries = 8 };
     enum { MaxPoolSize = MaxClosureEntries * (sizeof(boost::mpl::deref<BiggestInputValueType::base>::type) + 16) };
 
+    // Composite closures are constructed in place in the input evaluator's memory block
+    // and are never destructed, hence all members must be plain, fixed-size arrays.
+
     // m_pool has to be first, because it has to be aligned.
     char                            m_pool[MaxPoolSize];
     void*                           m_input_values[MaxClosureEntries];
@@ -144,7 +146,8 @@ class APPLESEED_ALIGN(16) CompositeClosure
     foundation::Vector3d            m_tangents[MaxClosureEntries];
     int                             m_num_closures;
     int                             m_num_bytes;
-    foundation::CDF<size_t, double> m_cdf;
+    double                          m_weights[MaxClosureEntries];
+    double                          m_cdf[MaxClosureEntries];
     Spectrum                        m_spectrum_multipliers[MaxClosureEntries];
 
     void process_closure_tree(
@@ -198,7 +201,7 @@ inline ClosureID CompositeClosure::get_closure_type(const size_t index) const
 inline double CompositeClosure::get_closure_cdf_weight(const size_t index) const
 {
     assert(index < get_num_closures());
-    return m_cdf[index].second;
+    return m_weights[index];
 }
 
 inline const Spectrum& CompositeClosure::get_closure_spectrum_multiplier(const size_t index) const
@@ -37,6 +37,7 @@
 #include "renderer/modeling/object/regionkit.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/instancearray.h"
 #include "renderer/modeling/scene/containers.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/scene.h"
@@ -186,53 +187,69 @@ void AOVoxelTree::build(
         // Retrieve the assembly.
         const Assembly& assembly = assembly_instance.get_assembly();
 
-        // Loop over the object instances of the assembly.
-        for (const_each<ObjectInstanceContainer> j = assembly.object_instances(); j; ++j)
-        {
-            // Retrieve the object instance.
-            const ObjectInstance& object_instance = *j;
-
-            // Compute the object space to world space transformation.
-            const Transformd transform =
-                  assembly_instance.transform_sequence().evaluate(time)
-                * object_instance.get_transform();
+        // Evaluate the transform of the assembly instance.
+        const Transformd assembly_instance_transform =
+            assembly_instance.transform_sequence().evaluate(time);
 
-            // Retrieve the object.
-            Object& object = object_instance.get_object();
+        // Place the assembly once per element of the instance array, if any.
+        const InstanceArray& instance_array = assembly_instance.instance_array();
+        const size_t instance_count = instance_array.empty() ? 1 : instance_array.size();
 
-            // Retrieve the region kit of the object.
-            Access<RegionKit> region_kit(&object.get_region_kit());
+        for (size_t k = 0; k < instance_count; ++k)
+        {
+            const Transformd instance_transform =
+                instance_array.empty()
+                    ? assembly_instance_transform
+                    : instance_array.get_transform(k) * assembly_instance_transform;
 
-            // Loop over the regions of the object.
-            const size_t region_count = region_kit->size();
-            for (size_t region_index = 0; region_index < region_count; ++region_index)
+            // Loop over the object instances of the assembly.
+            for (const_each<ObjectInstanceContainer> j = assembly.object_instances(); j; ++j)
             {
-                // Retrieve the region.
-                const IRegion* region = (*region_kit)[region_index];
+                // Retrieve the object instance.
+                const ObjectInstance& object_instance = *j;
+
+                // Compute the object space to world space transformation.
+                const Transformd transform =
+                      instance_transform
+                    * object_instance.get_transform();
+
+                // Retrieve the object.
+                Object& object = object_instance.get_object();
 
-                // Retrieve the tessellation of the region.
-                Access<StaticTriangleTess> tess(&region->get_static_triangle_tess());
+                // Retrieve the region kit of the object.
+                Access<RegionKit> region_kit(&object.get_region_kit());
 
-                // Push all triangles of the region into the tree.
-                const size_t triangle_count = tess->m_primitives.size();
-                for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
+                // Loop over the regions of the object.
+                const size_t region_count = region_kit->size();
+                for (size_t region_index = 0; region_index < region_count; ++region_index)
                 {
-                    // Fetch the triangle.
-                    const Triangle& triangle = tess->m_primitives[triangle_index];
-
-                    // Retrieve object instance space vertices of the triangle.
-                    const GVector3& v0_os = tess->m_vertices[triangle.m_v0];
-                    const GVector3& v1_os = tess->m_vertices[triangle.m_v1];
-                    const GVector3& v2_os = tess->m_vertices[triangle.m_v2];
-
-                    // Transform triangle vertices to world space.
-                    const GVector3 v0(transform.point_to_parent(v0_os));
-                    const GVector3 v1(transform.point_to_parent(v1_os));
-                    const GVector3 v2(transform.point_to_parent(v2_os));
-
-                    // Push the triangle into the tree.
-                    TriangleIntersector intersector(v0, v1, v2);
-                    builder.push(intersector);
+                    // Retrieve the region.
+                    const IRegion* region = (*region_kit)[region_index];
+
+                    // Retrieve the tessellation of the region.
+                    Access<StaticTriangleTess> tess(&region->get_static_triangle_tess());
+
+                    // Push all triangles of the region into the tree.
+                    const size_t triangle_count = tess->m_primitives.size();
+                    for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
+                    {
+                        // Fetch the triangle.
+                        const Triangle& triangle = tess->m_primitives[triangle_index];
+
+                        // Retrieve object instance space vertices of the triangle.
+                        const GVector3& v0_os = tess->m_vertices[triangle.m_v0];
+                        const GVector3& v1_os = tess->m_vertices[triangle.m_v1];
+                        const GVector3& v2_os = tess->m_vertices[triangle.m_v2];
+
+                        // Transform triangle vertices to world space.
+                        const GVector3 v0(transform.point_to_parent(v0_os));
+                        const GVector3 v1(transform.point_to_parent(v1_os));
+                        const GVector3 v2(transform.point_to_parent(v2_os));
+
+                        // Push the triangle into the tree.
+                        TriangleIntersector intersector(v0, v1, v2);
+                        builder.push(intersector);
+                    }
                 }
             }
         }
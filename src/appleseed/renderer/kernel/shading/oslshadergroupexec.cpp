@@ -34,6 +34,12 @@
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/modeling/shadergroup/shadergroup.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
 namespace renderer
 {
 
@@ -45,11 +51,16 @@ OSLShaderGroupExec::OSLShaderGroupExec(OSL::ShadingSystem& shading_system)
   : m_osl_shading_system(shading_system)
   , m_osl_thread_info(shading_system.create_thread_info())
   , m_osl_shading_context(shading_system.get_context(m_osl_thread_info))
+  , m_last_shader_group(0)
+  , m_last_shading_point(0)
 {
 }
 
 OSLShaderGroupExec::~OSLShaderGroupExec()
 {
+    for (size_t i = 0; i < m_batch_contexts.size(); ++i)
+        m_osl_shading_system.release_context(m_batch_contexts[i]);
+
     if (m_osl_shading_context)
         m_osl_shading_system.release_context(m_osl_shading_context);
 
@@ -57,6 +68,46 @@ OSLShaderGroupExec::~OSLShaderGroupExec()
         m_osl_shading_system.destroy_thread_info(m_osl_thread_info);
 }
 
+// Shader groups are ordered by unique ID rather than by address to keep the order deterministic.
+struct OSLShaderGroupExec::BatchEntryOrder
+{
+    bool operator()(const BatchEntry& lhs, const BatchEntry& rhs) const
+    {
+        return lhs.m_shader_group->get_uid() < rhs.m_shader_group->get_uid();
+    }
+};
+
+void OSLShaderGroupExec::execute_shading_batch(
+    const ShaderGroup* const    shader_groups[],
+    const ShadingPoint* const   shading_points[],
+    const size_t                count) const
+{
+    assert(m_osl_thread_info);
+    assert(count <= MaxBatchSize);
+
+    // Gather the shading points by shader group.
+    m_batch.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_batch[i].m_shader_group = shader_groups[i];
+        m_batch[i].m_shading_point = shading_points[i];
+    }
+    stable_sort(m_batch.begin(), m_batch.end(), BatchEntryOrder());
+
+    // Each shading point of the batch gets its own OSL shading context.
+    while (m_batch_contexts.size() < count)
+        m_batch_contexts.push_back(m_osl_shading_system.get_context(m_osl_thread_info));
+
+    // Execute each shader group on all its shading points in a row.
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_osl_shading_system.execute(
+            *m_batch_contexts[i],
+            *m_batch[i].m_shader_group->shadergroup_ref(),
+            m_batch[i].m_shading_point->get_osl_shader_globals());
+    }
+}
+
 void OSLShaderGroupExec::execute_shading(
     const ShaderGroup&          shader_group,
     const ShadingPoint&         shading_point) const
@@ -64,10 +115,8 @@ void OSLShaderGroupExec::execute_shading(
     assert(m_osl_shading_context);
     assert(m_osl_thread_info);
 
-    m_osl_shading_system.execute(
-        *m_osl_shading_context,
-        *shader_group.shadergroup_ref(),
-        shading_point.get_osl_shader_globals());
+    if (!has_valid_results(shader_group, shading_point))
+        do_execute(shader_group, shading_point);
 }
 
 void OSLShaderGroupExec::execute_transparency(
@@ -80,10 +129,7 @@ void OSLShaderGroupExec::execute_transparency(
     ShadingRay::TypeType saved_type = shading_point.m_ray.m_type;
     shading_point.m_ray.m_type = ShadingRay::ShadowRay;
 
-    m_osl_shading_system.execute(
-        *m_osl_shading_context,
-        *shader_group.shadergroup_ref(),
-        shading_point.get_osl_shader_globals());
+    do_execute(shader_group, shading_point);
 
     process_transparency_tree(shading_point.get_osl_shader_globals().Ci, alpha);
 
@@ -94,4 +140,48 @@ void OSLShaderGroupExec::execute_transparency(
     shading_point.m_ray.m_type = saved_type;
 }
 
+bool OSLShaderGroupExec::has_valid_results(
+    const ShaderGroup&  shader_group,
+    const ShadingPoint& shading_point) const
+{
+    // Retracing or copying a shading point resets its shader globals, and thus its closure tree.
+    if (!(shading_point.m_members & ShadingPoint::HasOSLShaderGlobals) ||
+        shading_point.m_shader_globals.Ci == 0 ||
+        shading_point.m_shader_globals.raytype != static_cast<int>(shading_point.get_ray().m_type))
+        return false;
+
+    // Reuse the results of the last execution.
+    if (&shader_group == m_last_shader_group && &shading_point == m_last_shading_point)
+        return true;
+
+    // Reuse the results of the last batch.
+    for (size_t i = 0, e = m_batch.size(); i < e; ++i)
+    {
+        if (m_batch[i].m_shader_group == &shader_group && m_batch[i].m_shading_point == &shading_point)
+            return true;
+    }
+
+    return false;
+}
+
+void OSLShaderGroupExec::do_execute(
+    const ShaderGroup&  shader_group,
+    const ShadingPoint& shading_point) const
+{
+    // The closure tree of the shading point is about to be replaced.
+    for (size_t i = 0, e = m_batch.size(); i < e; ++i)
+    {
+        if (m_batch[i].m_shading_point == &shading_point)
+            m_batch[i].m_shading_point = 0;
+    }
+
+    m_osl_shading_system.execute(
+        *m_osl_shading_context,
+        *shader_group.shadergroup_ref(),
+        shading_point.get_osl_shader_globals());
+
+    m_last_shader_group = &shader_group;
+    m_last_shading_point = &shading_point;
+}
+
 }   // namespace renderer
@@ -38,6 +38,10 @@
 // OSL headers.
 #include "OSL/oslexec.h"
 
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
 // Forward declarations.
 namespace renderer  { class ShaderGroup; }
 namespace renderer  { class ShadingPoint; }
@@ -48,17 +52,38 @@ namespace renderer
 //
 // OSLShaderGroupExec class.
 //
+// The closure tree produced by an execution remains valid until the next execution.
+// When a shader group is executed again on the same shading point with the same ray
+// type and nothing else was executed in between (for instance when the path tracer
+// starts from a camera hit that was just shaded by the surface shader), the previous
+// results are reused instead of running the shaders again.
+//
+// Shading points can also be executed in batches: the points of a batch are gathered
+// by shader group, so that each group runs on all its points in a row, and each point
+// gets its own OSL shading context. The closure trees of all the points of a batch
+// thus remain valid until the next batch and are reused by execute_shading(). The OSL
+// version used by appleseed only has a scalar execution entry point, so a batch is a
+// coherent sequence of scalar executions rather than a SIMD execution.
+//
 
 class OSLShaderGroupExec
   : public foundation::NonCopyable
 {
   public:
+    // Maximum number of shading points in a batch.
+    enum { MaxBatchSize = 64 };
+
     // Constructor.
     explicit OSLShaderGroupExec(OSL::ShadingSystem& shading_system);
 
     // Destructor.
     ~OSLShaderGroupExec();
 
+    void execute_shading_batch(
+        const ShaderGroup* const    shader_groups[],
+        const ShadingPoint* const   shading_points[],
+        const size_t                count) const;
+
     void execute_shading(
         const ShaderGroup&      shader_group, 
         const ShadingPoint&     shading_point) const;
@@ -73,6 +98,30 @@ class OSLShaderGroupExec
     OSL::ShadingSystem&         m_osl_shading_system;
     OSL::PerThreadInfo*         m_osl_thread_info;
     OSL::ShadingContext*        m_osl_shading_context;
+
+    struct BatchEntry
+    {
+        const ShaderGroup*      m_shader_group;
+        const ShadingPoint*     m_shading_point;
+    };
+
+    struct BatchEntryOrder;
+
+    // Last execution.
+    mutable const ShaderGroup*  m_last_shader_group;
+    mutable const ShadingPoint* m_last_shading_point;
+
+    // Last batch.
+    mutable std::vector<OSL::ShadingContext*>   m_batch_contexts;
+    mutable std::vector<BatchEntry>             m_batch;
+
+    bool has_valid_results(
+        const ShaderGroup&      shader_group,
+        const ShadingPoint&     shading_point) const;
+
+    void do_execute(
+        const ShaderGroup&      shader_group,
+        const ShadingPoint&     shading_point) const;
 };
 
 }       // namespace renderer
@@ -37,6 +37,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/utility/arena.h"
 
 // Standard headers.
 #include <cstddef>
@@ -85,6 +86,11 @@ class ShadingContext
     // Return the maximum number of iterations in ray/path tracing loops.
     size_t get_max_iterations() const;
 
+    // Return the arena from which shading code can allocate temporaries such as
+    // the storage of input evaluators. The arena is cleared at the beginning of
+    // every shading point or light path.
+    foundation::Arena& get_arena() const;
+
 #ifdef WITH_OSL
     void execute_osl_shading(
         const ShaderGroup&  shader_group, 
@@ -104,6 +110,7 @@ class ShadingContext
     ILightingEngine*            m_lighting_engine;
     const float                 m_transparency_threshold;
     const size_t                m_max_iterations;
+    mutable foundation::Arena   m_arena;
 
 #ifdef WITH_OSL
     OSLShaderGroupExec&         m_shadergroup_exec;
@@ -140,6 +147,11 @@ inline size_t ShadingContext::get_max_iterations() const
     return m_max_iterations;
 }
 
+inline foundation::Arena& ShadingContext::get_arena() const
+{
+    return m_arena;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_SHADING_SHADINGCONTEXT_H
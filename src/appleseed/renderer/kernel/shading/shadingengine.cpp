@@ -185,7 +185,9 @@ void ShadingEngine::shade_environment(
     if (environment_shader)
     {
         // There is an environment shader: execute it.
-        InputEvaluator input_evaluator(shading_context.get_texture_cache());
+        InputEvaluator input_evaluator(
+            shading_context.get_texture_cache(),
+            shading_context.get_arena());
         const ShadingRay& ray = shading_point.get_ray();
         const Vector3d direction = normalize(ray.m_dir);
         environment_shader->evaluate(
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/intersection/intersector.h"
+#include "renderer/modeling/object/curveobject.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/object.h"
 
@@ -40,6 +41,10 @@
 #include "foundation/utility/attributeset.h"
 #include "foundation/utility/otherwise.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+
 using namespace foundation;
 using namespace std;
 
@@ -65,6 +70,13 @@ void ShadingPoint::fetch_source_geometry() const
     // Retrieve the object.
     m_object = &m_object_instance->get_object();
 
+    // Curves have their own source geometry.
+    if (m_primitive_type == PrimitiveCurve)
+    {
+        fetch_curve_geometry();
+        return;
+    }
+
     // Retrieve the region kit of the object.
     assert(m_region_kit_cache);
     const RegionKit& region_kit =
@@ -154,6 +166,54 @@ void ShadingPoint::fetch_source_geometry() const
     assert(is_normalized(m_n2));
 }
 
+void ShadingPoint::fetch_curve_geometry() const
+{
+    const CurveObject& curve_object = static_cast<const CurveObject&>(*m_object);
+
+    // Curves use the first material slot.
+    m_triangle_pa = 0;
+
+    // Retrieve the position across the ribbon and the segment parameter at the intersection point.
+    const double v = m_bary[0];
+    const double u = m_bary[1];
+
+    // Evaluate the hit segment at the intersection point.
+    const GCurve3 segment = curve_object.get_segment(m_triangle_index);
+    const Vector3d center(segment.evaluate_point(static_cast<GScalar>(u)));
+    const Vector3d tangent(segment.evaluate_tangent(static_cast<GScalar>(u)));
+    const double width = segment.evaluate_width(static_cast<GScalar>(u));
+
+    // Compute the object instance space ray direction.
+    const Vector3d dir =
+        m_object_instance->get_transform().vector_to_local(
+            m_assembly_instance_transform.vector_to_local(m_ray.m_dir));
+
+    // Compute the unit vector across the ribbon and the normal to the ribbon.
+    Vector3d side = cross(dir, tangent);
+    const double side_norm = norm(side);
+    side = side_norm > 0.0 ? side / side_norm : Basis3d(normalize(dir)).get_tangent_u();
+    const Vector3d normal = faceforward(normalize(cross(side, tangent)), dir);
+
+    // Build a triangle tangent to the ribbon, such that the barycentric coordinates of
+    // the intersection point are the position across the ribbon and the segment parameter.
+    const Vector3d point = center + ((v - 0.5) * width) * side;
+    const Vector3d v0 = point - (v * width) * side - u * tangent;
+    m_v0 = GVector3(v0);
+    m_v1 = GVector3(v0 + width * side);
+    m_v2 = GVector3(v0 + tangent);
+
+    // Texture coordinates run along the curve in U and across the ribbon in V.
+    const GVector2 param_range = curve_object.get_segment_param_range(m_triangle_index);
+    m_v0_uv = GVector2(param_range[0], GScalar(0.0));
+    m_v1_uv = GVector2(param_range[0], GScalar(1.0));
+    m_v2_uv = GVector2(param_range[1], GScalar(0.0));
+
+    // Bend the shading normal across the ribbon so that the curve is shaded like a tube.
+    const double x = 2.0 * v - 1.0;
+    const GVector3 shading_normal(normalize(x * side + sqrt(max(1.0 - x * x, 0.0)) * normal));
+    m_n0 = m_n1 = m_n2 = shading_normal;
+}
+
 void ShadingPoint::refine_and_offset() const
 {
     assert(hit());
@@ -244,6 +304,65 @@ Vector3d ShadingPoint::get_biased_point(const Vector3d& direction) const
     return m_biased_point;
 }
 
+void ShadingPoint::compute_screen_space_partial_derivatives() const
+{
+    if (!m_ray.m_has_differentials)
+    {
+        m_dpdx = m_dpdy = Vector3d(0.0);
+        m_duvdx = m_duvdy = Vector2d(0.0);
+        return;
+    }
+
+    // Intersect the auxiliary rays with the tangent plane at the intersection point.
+    const Vector3d& p = get_point();
+    const Vector3d& n = get_geometric_normal();
+    const double dx_den = dot(n, m_ray.m_rx_dir);
+    const double dy_den = dot(n, m_ray.m_ry_dir);
+
+    if (dx_den == 0.0 || dy_den == 0.0)
+    {
+        m_dpdx = m_dpdy = Vector3d(0.0);
+        m_duvdx = m_duvdy = Vector2d(0.0);
+        return;
+    }
+
+    const double d = dot(n, p);
+    const double tx = (d - dot(n, m_ray.m_rx_org)) / dx_den;
+    const double ty = (d - dot(n, m_ray.m_ry_org)) / dy_den;
+    m_dpdx = m_ray.m_rx_org + tx * m_ray.m_rx_dir - p;
+    m_dpdy = m_ray.m_ry_org + ty * m_ray.m_ry_dir - p;
+
+    // Express the offsets in the barycentric frame of the triangle by solving
+    // the normal equations of dp = db0 * e1 + db1 * e2 in the least squares sense.
+    const Vector3d e1 = get_vertex(1) - get_vertex(0);
+    const Vector3d e2 = get_vertex(2) - get_vertex(0);
+    const double a11 = dot(e1, e1);
+    const double a12 = dot(e1, e2);
+    const double a22 = dot(e2, e2);
+    const double det = a11 * a22 - a12 * a12;
+
+    if (det == 0.0)
+    {
+        m_duvdx = m_duvdy = Vector2d(0.0);
+        return;
+    }
+
+    const double rcp_det = 1.0 / det;
+    const double bx1 = dot(e1, m_dpdx), bx2 = dot(e2, m_dpdx);
+    const double by1 = dot(e1, m_dpdy), by2 = dot(e2, m_dpdy);
+    const double db0dx = (a22 * bx1 - a12 * bx2) * rcp_det;
+    const double db1dx = (a11 * bx2 - a12 * bx1) * rcp_det;
+    const double db0dy = (a22 * by1 - a12 * by2) * rcp_det;
+    const double db1dy = (a11 * by2 - a12 * by1) * rcp_det;
+
+    // Map barycentric offsets to texture space offsets.
+    const Vector2d v0_uv(m_v0_uv);
+    const Vector2d duv1 = Vector2d(m_v1_uv) - v0_uv;
+    const Vector2d duv2 = Vector2d(m_v2_uv) - v0_uv;
+    m_duvdx = db0dx * duv1 + db1dx * duv2;
+    m_duvdy = db0dy * duv1 + db1dy * duv2;
+}
+
 #ifdef WITH_OSL
 
 OSL::ShaderGlobals& ShadingPoint::get_osl_shader_globals() const
@@ -255,8 +374,8 @@ OSL::ShaderGlobals& ShadingPoint::get_osl_shader_globals() const
         const ShadingRay& ray(get_ray());
 
         m_shader_globals.P = Vector3f(get_point());
-        m_shader_globals.dPdx = OSL::Vec3(0, 0, 0);
-        m_shader_globals.dPdy = OSL::Vec3(0, 0, 0);
+        m_shader_globals.dPdx = Vector3f(get_dpdx());
+        m_shader_globals.dPdy = Vector3f(get_dpdy());
         m_shader_globals.dPdz = OSL::Vec3(0, 0, 0);
 
         m_shader_globals.I = -Vector3f(ray.m_dir);
@@ -267,12 +386,12 @@ OSL::ShaderGlobals& ShadingPoint::get_osl_shader_globals() const
         m_shader_globals.Ng = Vector3f(get_geometric_normal());
 
         m_shader_globals.u = get_uv(0).x;
-        m_shader_globals.dudx = 0;
-        m_shader_globals.dudy = 0;
+        m_shader_globals.dudx = static_cast<float>(get_duvdx(0).x);
+        m_shader_globals.dudy = static_cast<float>(get_duvdy(0).x);
 
         m_shader_globals.v = get_uv(0).y;
-        m_shader_globals.dvdx = 0;
-        m_shader_globals.dvdy = 0;
+        m_shader_globals.dvdx = static_cast<float>(get_duvdx(0).y);
+        m_shader_globals.dvdy = static_cast<float>(get_duvdy(0).y);
 
         m_shader_globals.dPdu = Vector3f(get_dpdu(0));
         m_shader_globals.dPdv = Vector3f(get_dpdv(0));
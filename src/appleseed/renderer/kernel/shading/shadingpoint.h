@@ -42,6 +42,7 @@
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
 #include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/instancearray.h"
 #include "renderer/modeling/scene/objectinstance.h"
 
 // appleseed.foundation headers.
@@ -78,6 +79,13 @@ namespace renderer
 class ShadingPoint
 {
   public:
+    // Types of primitives.
+    enum PrimitiveType
+    {
+        PrimitiveTriangle,
+        PrimitiveCurve
+    };
+
     // Constructor, calls clear().
     ShadingPoint();
 
@@ -105,7 +113,12 @@ class ShadingPoint
     // Return the distance from the ray origin to the intersection point.
     double get_distance() const;
 
+    // Return the type of the primitive that was hit.
+    PrimitiveType get_primitive_type() const;
+
     // Return the barycentric coordinates of the intersection point.
+    // For curves, these are the position across the ribbon and the
+    // parameter of the curve segment at the intersection point.
     const foundation::Vector2d& get_bary() const;
 
     // Return the texture coordinates from a given UV set at the intersection point.
@@ -124,6 +137,16 @@ class ShadingPoint
     const foundation::Vector3d& get_dpdu(const size_t uvset) const;
     const foundation::Vector3d& get_dpdv(const size_t uvset) const;
 
+    // Return the world space partial derivatives of the intersection point wrt. screen space
+    // x and y, estimated from the ray differentials. They are null if the ray has no differentials.
+    const foundation::Vector3d& get_dpdx() const;
+    const foundation::Vector3d& get_dpdy() const;
+
+    // Return the partial derivatives of the texture coordinates from a given UV set wrt.
+    // screen space x and y. They are null if the ray has no differentials.
+    const foundation::Vector2d& get_duvdx(const size_t uvset) const;
+    const foundation::Vector2d& get_duvdy(const size_t uvset) const;
+
     // Return the world space geometric normal at the intersection point. The geometric normal
     // always faces the incoming ray, i.e. dot(ray_dir, geometric_normal) is always positive or null.
     const foundation::Vector3d& get_geometric_normal() const;
@@ -154,6 +177,14 @@ class ShadingPoint
     // Return the assembly instance that was hit.
     const AssemblyInstance& get_assembly_instance() const;
 
+    // Return the index, within the instance array of the assembly instance, of the
+    // element that was hit, or InstanceArray::InvalidIndex if there is no instance array.
+    size_t get_instance_array_index() const;
+
+    // Return the user ID of the element of the instance array that was hit (its index
+    // if the array has no user IDs), or 0 if there is no instance array.
+    foundation::uint32 get_instance_id() const;
+
     // Return the assembly that was hit.
     const Assembly& get_assembly() const;
 
@@ -170,6 +201,7 @@ class ShadingPoint
     size_t get_region_index() const;
 
     // Return the index, within the region, of the hit triangle.
+    // For curves, return the index of the hit segment within the curve object.
     size_t get_triangle_index() const;
 
     // Return the index, within the region, of the primitive attribute of the hit triangle.
@@ -182,6 +214,7 @@ class ShadingPoint
   private:
     friend class AssemblyLeafProbeVisitor;
     friend class AssemblyLeafVisitor;
+    friend class CurveLeafVisitor;
     friend class Intersector;
 #ifdef WITH_OSL
     friend class OSLShaderGroupExec;
@@ -190,22 +223,22 @@ class ShadingPoint
     friend class TriangleLeafVisitor;
     friend class ShadingPointBuilder;
 
+    // Hit record: written by the intersector and copied by the copy constructor.
     RegionKitAccessCache*               m_region_kit_cache;
     StaticTriangleTessAccessCache*      m_tess_cache;
     TextureCache*                       m_texture_cache;
-
     const Scene*                        m_scene;
-    mutable ShadingRay                  m_ray;                          // world space ray (m_tmax = distance to intersection)
-
-    // Intersection results.
-    bool                                m_hit;                          // true if there was a hit, false otherwise
-    foundation::Vector2d                m_bary;                         // barycentric coordinates of intersection point
     const AssemblyInstance*             m_assembly_instance;            // hit assembly instance
-    foundation::Transformd              m_assembly_instance_transform;  // transform of the hit assembly instance at ray time
-    size_t                              m_object_instance_index;        // index of the object instance that was hit
-    size_t                              m_region_index;                 // index of the region containing the hit triangle
-    size_t                              m_triangle_index;               // index of the hit triangle
+    foundation::uint32                  m_instance_array_index;         // index of the hit element of the instance array
+    foundation::Vector2d                m_bary;                         // barycentric coordinates of intersection point
+    foundation::uint32                  m_object_instance_index;        // index of the object instance that was hit
+    foundation::uint32                  m_region_index;                 // index of the region containing the hit triangle
+    foundation::uint32                  m_triangle_index;               // index of the hit triangle
+    PrimitiveType                       m_primitive_type;               // type of the hit primitive
+    bool                                m_hit;                          // true if there was a hit, false otherwise
+    mutable ShadingRay                  m_ray;                          // world space ray (m_tmax = distance to intersection)
     TriangleSupportPlaneType            m_triangle_support_plane;       // support plane of the hit triangle
+    foundation::Transformd              m_assembly_instance_transform;  // transform of the hit assembly instance at ray time
 
     // Additional intersection results, computed on demand.
     enum Members
@@ -222,38 +255,47 @@ class ShadingPoint
         HasShadingBasis                 = 1 << 9,
         HasWorldSpaceVertices           = 1 << 10,
         HasWorldSpaceVertexNormals      = 1 << 11,
-        HasMaterial                     = 1 << 12
+        HasMaterial                     = 1 << 12,
+        HasScreenSpaceDerivatives       = 1 << 13
 
 #ifdef WITH_OSL
-        , HasOSLShaderGlobals           = 1 << 13
+        , HasOSLShaderGlobals           = 1 << 14
 #endif
     };
+
+    // Members needed by nearly every shading operation come first so that they share cache lines.
     mutable foundation::uint32          m_members;                      // which members have already been computed
+    mutable foundation::uint32          m_triangle_pa;                  // hit triangle attribute index
     mutable const Assembly*             m_assembly;                     // hit assembly
     mutable const ObjectInstance*       m_object_instance;              // hit object instance
     mutable Object*                     m_object;                       // hit object
-    mutable foundation::uint32          m_triangle_pa;                  // hit triangle attribute index
+    mutable const Material*             m_material;                     // material at intersection point
+    mutable ObjectInstance::Side        m_side;                         // side of the surface that was hit
     mutable GVector2                    m_v0_uv, m_v1_uv, m_v2_uv;      // texture coordinates from UV set #0 at triangle vertices
     mutable GVector3                    m_v0, m_v1, m_v2;               // object instance space triangle vertices
     mutable GVector3                    m_n0, m_n1, m_n2;               // object instance space triangle vertex normals
     mutable foundation::Vector2d        m_uv;                           // texture coordinates from UV set #0
     mutable foundation::Vector3d        m_point;                        // world space intersection point
-    mutable foundation::Vector3d        m_biased_point;                 // world space intersection point with per-object-instance bias applied
-    mutable foundation::Vector3d        m_dpdu;                         // world space partial derivative of the intersection point wrt. U
-    mutable foundation::Vector3d        m_dpdv;                         // world space partial derivative of the intersection point wrt. V
     mutable foundation::Vector3d        m_geometric_normal;             // world space geometric normal, unit-length
-    mutable foundation::Vector3d        m_shading_normal;               // world space (possibly modified) shading normal, unit-length
     mutable foundation::Vector3d        m_original_shading_normal;      // original world space shading normal, unit-length
-    mutable ObjectInstance::Side        m_side;                         // side of the surface that was hit
+    mutable foundation::Vector3d        m_shading_normal;               // world space (possibly modified) shading normal, unit-length
     mutable foundation::Basis3d         m_shading_basis;                // world space orthonormal basis around shading normal
-    mutable foundation::Vector3d        m_v0_w, m_v1_w, m_v2_w;         // world space triangle vertices
-    mutable foundation::Vector3d        m_n0_w, m_n1_w, m_n2_w;         // world space triangle vertex normals
-    mutable const Material*             m_material;                     // material at intersection point
+    mutable foundation::Vector3d        m_dpdu;                         // world space partial derivative of the intersection point wrt. U
+    mutable foundation::Vector3d        m_dpdv;                         // world space partial derivative of the intersection point wrt. V
 
     // Data required to avoid self-intersections.
     mutable foundation::Vector3d        m_asm_geo_normal;               // assembly instance space geometric normal to hit triangle
     mutable foundation::Vector3d        m_front_point;                  // hit point refined to front, in assembly instance space
     mutable foundation::Vector3d        m_back_point;                   // hit point refined to back, in assembly instance space
+    mutable foundation::Vector3d        m_biased_point;                 // world space intersection point with per-object-instance bias applied
+
+    // Members that are seldom needed come last.
+    mutable foundation::Vector3d        m_v0_w, m_v1_w, m_v2_w;         // world space triangle vertices
+    mutable foundation::Vector3d        m_n0_w, m_n1_w, m_n2_w;         // world space triangle vertex normals
+    mutable foundation::Vector3d        m_dpdx;                         // world space partial derivative of the intersection point wrt. screen space X
+    mutable foundation::Vector3d        m_dpdy;                         // world space partial derivative of the intersection point wrt. screen space Y
+    mutable foundation::Vector2d        m_duvdx;                        // partial derivative of the texture coordinates from UV set #0 wrt. screen space X
+    mutable foundation::Vector2d        m_duvdy;                        // partial derivative of the texture coordinates from UV set #0 wrt. screen space Y
 
 #ifdef WITH_OSL
     mutable OSL::ShaderGlobals          m_shader_globals;
@@ -265,11 +307,17 @@ class ShadingPoint
     // Fetch the source geometry.
     void fetch_source_geometry() const;
 
+    // Fetch the source geometry of a curve, as a triangle tangent to the ribbon at the intersection point.
+    void fetch_curve_geometry() const;
+
     // Refine and offset the intersection point.
     void refine_and_offset() const;
 
     // Compute the partial derivatives dp/du and dp/dv.
     void compute_partial_derivatives() const;
+
+    // Compute the partial derivatives dp/dx, dp/dy, duv/dx and duv/dy from the ray differentials.
+    void compute_screen_space_partial_derivatives() const;
 };
 
 
@@ -287,15 +335,17 @@ inline ShadingPoint::ShadingPoint(const ShadingPoint& rhs)
   , m_tess_cache(rhs.m_tess_cache)
   , m_texture_cache(rhs.m_texture_cache)
   , m_scene(rhs.m_scene)
-  , m_ray(rhs.m_ray)
-  , m_hit(rhs.m_hit)
-  , m_bary(rhs.m_bary)
   , m_assembly_instance(rhs.m_assembly_instance)
-  , m_assembly_instance_transform(rhs.m_assembly_instance_transform)
+  , m_instance_array_index(rhs.m_instance_array_index)
+  , m_bary(rhs.m_bary)
   , m_object_instance_index(rhs.m_object_instance_index)
   , m_region_index(rhs.m_region_index)
   , m_triangle_index(rhs.m_triangle_index)
+  , m_primitive_type(rhs.m_primitive_type)
+  , m_hit(rhs.m_hit)
+  , m_ray(rhs.m_ray)
   , m_triangle_support_plane(rhs.m_triangle_support_plane)
+  , m_assembly_instance_transform(rhs.m_assembly_instance_transform)
   , m_members(0)
 {
 }
@@ -342,6 +392,12 @@ inline double ShadingPoint::get_distance() const
     return m_ray.m_tmax;
 }
 
+inline ShadingPoint::PrimitiveType ShadingPoint::get_primitive_type() const
+{
+    assert(hit());
+    return m_primitive_type;
+}
+
 inline const foundation::Vector2d& ShadingPoint::get_bary() const
 {
     assert(hit());
@@ -423,6 +479,60 @@ inline const foundation::Vector3d& ShadingPoint::get_dpdv(const size_t uvset) co
     return m_dpdv;
 }
 
+inline const foundation::Vector3d& ShadingPoint::get_dpdx() const
+{
+    assert(hit());
+
+    if (!(m_members & HasScreenSpaceDerivatives))
+    {
+        compute_screen_space_partial_derivatives();
+        m_members |= HasScreenSpaceDerivatives;
+    }
+
+    return m_dpdx;
+}
+
+inline const foundation::Vector3d& ShadingPoint::get_dpdy() const
+{
+    assert(hit());
+
+    if (!(m_members & HasScreenSpaceDerivatives))
+    {
+        compute_screen_space_partial_derivatives();
+        m_members |= HasScreenSpaceDerivatives;
+    }
+
+    return m_dpdy;
+}
+
+inline const foundation::Vector2d& ShadingPoint::get_duvdx(const size_t uvset) const
+{
+    assert(hit());
+    assert(uvset == 0);     // todo: support multiple UV sets
+
+    if (!(m_members & HasScreenSpaceDerivatives))
+    {
+        compute_screen_space_partial_derivatives();
+        m_members |= HasScreenSpaceDerivatives;
+    }
+
+    return m_duvdx;
+}
+
+inline const foundation::Vector2d& ShadingPoint::get_duvdy(const size_t uvset) const
+{
+    assert(hit());
+    assert(uvset == 0);     // todo: support multiple UV sets
+
+    if (!(m_members & HasScreenSpaceDerivatives))
+    {
+        compute_screen_space_partial_derivatives();
+        m_members |= HasScreenSpaceDerivatives;
+    }
+
+    return m_duvdy;
+}
+
 inline const foundation::Vector3d& ShadingPoint::get_geometric_normal() const
 {
     assert(hit());
@@ -518,32 +628,19 @@ inline const foundation::Vector3d& ShadingPoint::get_original_shading_normal() c
 
     if (!(m_members & HasOriginalShadingNormal))
     {
-        const double w = 1.0 - m_bary[0] - m_bary[1];
-
-        if (m_members & HasWorldSpaceVertexNormals)
-        {
-            // We already have the world space vertex normals of the hit triangle.
-            // Use them to compute the shading normal directly in world space.
-            m_original_shading_normal =
-                  m_n0_w * w
-                + m_n1_w * m_bary[0]
-                + m_n2_w * m_bary[1];
-        }
-        else
-        {
-            cache_source_geometry();
+        cache_source_geometry();
 
-            // Compute the object instance space shading normal.
-            m_original_shading_normal =
-                  foundation::Vector3d(m_n0) * w
-                + foundation::Vector3d(m_n1) * m_bary[0]
-                + foundation::Vector3d(m_n2) * m_bary[1];
+        // Compute the object instance space shading normal.
+        const double w = 1.0 - m_bary[0] - m_bary[1];
+        m_original_shading_normal =
+              foundation::Vector3d(m_n0) * w
+            + foundation::Vector3d(m_n1) * m_bary[0]
+            + foundation::Vector3d(m_n2) * m_bary[1];
 
-            // Transform the shading normal to world space.
-            m_original_shading_normal =
-                m_assembly_instance_transform.normal_to_parent(
-                    m_object_instance->get_transform().normal_to_parent(m_original_shading_normal));
-        }
+        // Transform the shading normal to world space.
+        m_original_shading_normal =
+            m_assembly_instance_transform.normal_to_parent(
+                m_object_instance->get_transform().normal_to_parent(m_original_shading_normal));
 
         // Normalize the shading normal.
         m_original_shading_normal = foundation::normalize(m_original_shading_normal);
@@ -618,11 +715,11 @@ inline const foundation::Vector3d& ShadingPoint::get_vertex_normal(const size_t
     {
         cache_source_geometry();
 
-        // Retrieve instance space to assembly instance space transform.
+        // Retrieve object instance space to assembly instance space transform.
         const foundation::Transformd& obj_instance_transform =
             m_object_instance->get_transform();
 
-        // Transform vertex normals to world space.
+        // Transform triangle vertex normals to world space.
         const foundation::Vector3d n0(m_n0);
         const foundation::Vector3d n1(m_n1);
         const foundation::Vector3d n2(m_n2);
@@ -633,7 +730,7 @@ inline const foundation::Vector3d& ShadingPoint::get_vertex_normal(const size_t
         m_n1_w = m_assembly_instance_transform.normal_to_parent(m_n1_w);
         m_n2_w = m_assembly_instance_transform.normal_to_parent(m_n2_w);
 
-        // World space vertex normals are now available.
+        // World space triangle vertex normals are now available.
         m_members |= HasWorldSpaceVertexNormals;
     }
 
@@ -677,6 +774,21 @@ inline const AssemblyInstance& ShadingPoint::get_assembly_instance() const
     return *m_assembly_instance;
 }
 
+inline size_t ShadingPoint::get_instance_array_index() const
+{
+    assert(hit());
+    return m_instance_array_index;
+}
+
+inline foundation::uint32 ShadingPoint::get_instance_id() const
+{
+    assert(hit());
+    return
+        m_instance_array_index == InstanceArray::InvalidIndex
+            ? 0
+            : m_assembly_instance->instance_array().get_id(m_instance_array_index);
+}
+
 inline const Assembly& ShadingPoint::get_assembly() const
 {
     assert(hit());
@@ -701,19 +813,19 @@ inline const Object& ShadingPoint::get_object() const
 inline size_t ShadingPoint::get_object_instance_index() const
 {
     assert(hit());
-    return m_object_instance_index;
+    return static_cast<size_t>(m_object_instance_index);
 }
 
 inline size_t ShadingPoint::get_region_index() const
 {
     assert(hit());
-    return m_region_index;
+    return static_cast<size_t>(m_region_index);
 }
 
 inline size_t ShadingPoint::get_triangle_index() const
 {
     assert(hit());
-    return m_triangle_index;
+    return static_cast<size_t>(m_triangle_index);
 }
 
 inline size_t ShadingPoint::get_primitive_attribute_index() const
@@ -42,6 +42,7 @@ ShadingPointBuilder::ShadingPointBuilder(ShadingPoint& shading_point)
   : m_shading_point(shading_point)
 {
     m_shading_point.m_hit = true;
+    m_shading_point.m_primitive_type = ShadingPoint::PrimitiveTriangle;
 }
 
 void ShadingPointBuilder::set_scene(const Scene* scene)
@@ -36,14 +36,20 @@
 #include "foundation/math/vector.h"
 #include "foundation/platform/types.h"
 
+// Standard headers.
+#include <cstddef>
+
 namespace renderer
 {
 
 //
 // A ray as it is used throughout the renderer.
 //
+// When m_has_differentials is true, the ray carries the origins and directions
+// of two auxiliary rays offset by one pixel in x and y on the image plane.
+// They are used to estimate the screen space footprint of shading points.
+//
 // todo: add importance/contribution?
-// todo: replace ray by ray differential.
 //
 
 class ShadingRay
@@ -70,11 +76,21 @@ class ShadingRay
         SpecularRay                 = 1 << 6,
     };
 
+    // Number of ray types.
+    static const size_t NumTypes = 7;
+
     // Public members.
     double                          m_time;
     TypeType                        m_type;
     DepthType                       m_depth;
 
+    // Ray differentials (only valid if m_has_differentials is true).
+    bool                            m_has_differentials;
+    VectorType                      m_rx_org;
+    VectorType                      m_rx_dir;
+    VectorType                      m_ry_org;
+    VectorType                      m_ry_dir;
+
     // Constructors.
     ShadingRay();                               // leave all fields uninitialized
     ShadingRay(
@@ -96,6 +112,9 @@ class ShadingRay
         const double                time,
         const TypeType              type,
         const DepthType             depth = 0);
+
+    // Copy the ray differentials of another ray.
+    void copy_differentials(const ShadingRay& rhs);
 };
 
 // Transform a ShadingRay.
@@ -126,6 +145,7 @@ inline ShadingRay::ShadingRay(
   , m_time(time)
   , m_type(type)
   , m_depth(depth)
+  , m_has_differentials(false)
 {
 }
 
@@ -139,6 +159,7 @@ inline ShadingRay::ShadingRay(
   , m_time(time)
   , m_type(type)
   , m_depth(depth)
+  , m_has_differentials(false)
 {
 }
 
@@ -154,7 +175,17 @@ inline ShadingRay::ShadingRay(
   , m_time(time)
   , m_type(type)
   , m_depth(depth)
+  , m_has_differentials(false)
+{
+}
+
+inline void ShadingRay::copy_differentials(const ShadingRay& rhs)
 {
+    m_has_differentials = rhs.m_has_differentials;
+    m_rx_org = rhs.m_rx_org;
+    m_rx_dir = rhs.m_rx_dir;
+    m_ry_org = rhs.m_ry_org;
+    m_ry_dir = rhs.m_ry_dir;
 }
 
 template <typename U>
@@ -162,12 +193,22 @@ inline ShadingRay transform_to_local(
     const foundation::Transform<U>& transform,
     const ShadingRay&               ray)
 {
-    return
-        ShadingRay(
-            transform.transform_to_local(ray),
-            ray.m_time,
-            ray.m_type,
-            ray.m_depth);
+    ShadingRay result(
+        transform.transform_to_local(ray),
+        ray.m_time,
+        ray.m_type,
+        ray.m_depth);
+
+    if (ray.m_has_differentials)
+    {
+        result.m_has_differentials = true;
+        result.m_rx_org = transform.point_to_local(ray.m_rx_org);
+        result.m_rx_dir = transform.vector_to_local(ray.m_rx_dir);
+        result.m_ry_org = transform.point_to_local(ray.m_ry_org);
+        result.m_ry_dir = transform.vector_to_local(ray.m_ry_dir);
+    }
+
+    return result;
 }
 
 template <typename U>
@@ -175,12 +216,22 @@ inline ShadingRay transform_to_parent(
     const foundation::Transform<U>& transform,
     const ShadingRay&               ray)
 {
-    return
-        ShadingRay(
-            transform.transform_to_parent(ray),
-            ray.m_time,
-            ray.m_type,
-            ray.m_depth);
+    ShadingRay result(
+        transform.transform_to_parent(ray),
+        ray.m_time,
+        ray.m_type,
+        ray.m_depth);
+
+    if (ray.m_has_differentials)
+    {
+        result.m_has_differentials = true;
+        result.m_rx_org = transform.point_to_parent(ray.m_rx_org);
+        result.m_rx_dir = transform.vector_to_parent(ray.m_rx_dir);
+        result.m_ry_org = transform.point_to_parent(ray.m_ry_org);
+        result.m_ry_dir = transform.vector_to_parent(ray.m_ry_dir);
+    }
+
+    return result;
 }
 
 }       // namespace renderer
@@ -113,6 +113,9 @@ class StaticTessellation
     // Compute the local space bounding box of the tessellation over the shutter interval.
     GAABB3 compute_local_bbox() const;
 
+    // Return the approximate size in bytes of the vertices, normals, UVs, vertex poses and primitives.
+    size_t get_memory_size() const;
+
   private:
     foundation::AttributeSet::ChannelID m_uv_0_cid;         // UV coordinates set #0
     foundation::AttributeSet::ChannelID m_ms_count_cid;     // motion segment count
@@ -279,6 +282,17 @@ GAABB3 StaticTessellation<Primitive>::compute_local_bbox() const
     return bbox;
 }
 
+template <typename Primitive>
+size_t StaticTessellation<Primitive>::get_memory_size() const
+{
+    return
+          m_vertices.capacity() * sizeof(GVector3)
+        + m_vertex_normals.capacity() * sizeof(GVector3)
+        + m_primitives.capacity() * sizeof(PrimitiveType)
+        + get_uv_vertex_count() * sizeof(GVector2)
+        + m_vertices.size() * get_motion_segment_count() * sizeof(GVector3);
+}
+
 template <typename Primitive>
 void StaticTessellation<Primitive>::create_uv_0_attribute()
 {
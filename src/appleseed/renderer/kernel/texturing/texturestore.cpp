@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalmemorytracker.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/modeling/texture/texture.h"
@@ -197,8 +198,10 @@ void TextureStore::TileSwapper::load(const TileKey& key, TileRecord& record)
     }
 
     // Track the amount of memory used by the tile cache.
-    m_memory_size += record.m_tile->get_memory_size();
+    const size_t tile_memory_size = record.m_tile->get_memory_size();
+    m_memory_size += tile_memory_size;
     m_peak_memory_size = max(m_peak_memory_size, m_memory_size);
+    global_memory_tracker().record_allocation("texture store", tile_memory_size);
 
     if (m_params.m_track_store_size)
     {
@@ -231,6 +234,7 @@ bool TextureStore::TileSwapper::unload(const TileKey& key, TileRecord& record)
     const size_t tile_memory_size = record.m_tile->get_memory_size();
     assert(m_memory_size >= tile_memory_size);
     m_memory_size -= tile_memory_size;
+    global_memory_tracker().record_deallocation("texture store", tile_memory_size);
 
     // Fetch the texture container.
     const TextureContainer& textures =
@@ -0,0 +1,242 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Interface header.
+#include "fluidvolume.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// FluidVolume class implementation.
+//
+
+namespace
+{
+    // Maximum optical depth covered by a single ray marching step.
+    const double MaxStepOpticalDepth = 0.1;
+
+    // Optical depth beyond which the medium is considered opaque.
+    const double MaxOpticalDepth = 20.0;
+
+    struct RayMarchingVisitor
+    {
+        const FluidVolume&  m_volume;
+        const Vector3d&     m_origin;
+        const Vector3d&     m_direction;
+        const double        m_voxel_size;
+        const double        m_extinction_scale;
+        double              m_optical_depth;
+
+        RayMarchingVisitor(
+            const FluidVolume&  volume,
+            const Vector3d&     origin,
+            const Vector3d&     direction,
+            const double        voxel_size,
+            const double        extinction_scale)
+          : m_volume(volume)
+          , m_origin(origin)
+          , m_direction(direction)
+          , m_voxel_size(voxel_size)
+          , m_extinction_scale(extinction_scale)
+          , m_optical_depth(0.0)
+        {
+        }
+
+        bool visit(const double t0, const double t1, const double cell_majorant)
+        {
+            if (cell_majorant == 0.0)
+                return true;
+
+            const double majorant = cell_majorant * m_extinction_scale;
+
+            // Take fewer steps in cells where the medium is thin, but never
+            // more than one step per voxel.
+            const double length = t1 - t0;
+            const double max_step_count = ceil(length / m_voxel_size);
+            const double step_count =
+                min(max(ceil(majorant * length / MaxStepOpticalDepth), 1.0), max_step_count);
+            const double step = length / step_count;
+
+            // Integrate the extinction coefficient using the midpoint rule.
+            double t = t0 + 0.5 * step;
+            for (double i = 0.0; i < step_count; i += 1.0, t += step)
+                m_optical_depth += m_volume.get_extinction(m_origin + t * m_direction) * m_extinction_scale * step;
+
+            return m_optical_depth < MaxOpticalDepth;
+        }
+    };
+}
+
+FluidVolume::FluidVolume(
+    const VoxelGrid&    grid,
+    const size_t        density_channel_index,
+    const AABB3d&       bbox,
+    const double        density_scale,
+    const float         albedo)
+  : m_bbox(bbox)
+  , m_rcp_extent(Vector3d(1.0) / bbox.extent())
+  , m_albedo(albedo)
+  , m_extinction(grid.get_xres(), grid.get_yres(), grid.get_zres(), 1)
+{
+    assert(density_channel_index < grid.get_channel_count());
+
+    // Convert densities to extinction coefficients.
+    for (size_t z = 0; z < grid.get_zres(); ++z)
+    {
+        for (size_t y = 0; y < grid.get_yres(); ++y)
+        {
+            for (size_t x = 0; x < grid.get_xres(); ++x)
+            {
+                const float density = grid.voxel(x, y, z)[density_channel_index];
+                m_extinction.voxel(x, y, z)[0] =
+                    static_cast<float>(max(density * density_scale, 0.0));
+            }
+        }
+    }
+
+    const Vector3d extent = bbox.extent();
+    m_voxel_size =
+        min(
+            min(extent.x / grid.get_xres(), extent.y / grid.get_yres()),
+            extent.z / grid.get_zres());
+
+    build_majorant_grid();
+}
+
+double FluidVolume::evaluate_transmittance(
+    const Vector3d&     origin,
+    const Vector3d&     direction,
+    const double        tmin,
+    const double        tmax,
+    const double        extinction_scale) const
+{
+    // Work with a unit-length direction so that distances are volume space distances.
+    const double length = norm(direction);
+    const Vector3d unit_direction = direction / length;
+
+    RayMarchingVisitor visitor(*this, origin, unit_direction, m_voxel_size, extinction_scale);
+    traverse(origin, unit_direction, tmin * length, tmax * length, visitor);
+
+    return visitor.m_optical_depth < MaxOpticalDepth ? exp(-visitor.m_optical_depth) : 0.0;
+}
+
+void FluidVolume::build_majorant_grid()
+{
+    const size_t res[3] =
+    {
+        m_extinction.get_xres(),
+        m_extinction.get_yres(),
+        m_extinction.get_zres()
+    };
+
+    for (size_t i = 0; i < 3; ++i)
+        m_cell_count[i] = (res[i] + CellSize - 1) / CellSize;
+
+    m_majorants.resize(m_cell_count[0] * m_cell_count[1] * m_cell_count[2]);
+    m_occupied_cell_count = 0;
+
+    // Lookups interpolate between neighboring voxels: a cell spanning the unit interval
+    // [c / m, (c + 1) / m] along an axis depends on voxels floor(c * (n - 1) / m) to
+    // ceil((c + 1) * (n - 1) / m).
+    size_t cell_begin[3], cell_end[3];
+
+    size_t cell_index = 0;
+
+    for (size_t cz = 0; cz < m_cell_count[2]; ++cz)
+    {
+        for (size_t cy = 0; cy < m_cell_count[1]; ++cy)
+        {
+            for (size_t cx = 0; cx < m_cell_count[0]; ++cx, ++cell_index)
+            {
+                const size_t c[3] = { cx, cy, cz };
+
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    const double scale = static_cast<double>(res[i] - 1) / m_cell_count[i];
+                    cell_begin[i] = truncate<size_t>(floor(c[i] * scale));
+                    cell_end[i] = min(truncate<size_t>(ceil((c[i] + 1) * scale)), res[i] - 1);
+                }
+
+                float majorant = 0.0f;
+
+                for (size_t z = cell_begin[2]; z <= cell_end[2]; ++z)
+                {
+                    for (size_t y = cell_begin[1]; y <= cell_end[1]; ++y)
+                    {
+                        for (size_t x = cell_begin[0]; x <= cell_end[0]; ++x)
+                            majorant = max(majorant, m_extinction.voxel(x, y, z)[0]);
+                    }
+                }
+
+                m_majorants[cell_index] = static_cast<double>(majorant);
+
+                if (majorant > 0.0f)
+                    ++m_occupied_cell_count;
+            }
+        }
+    }
+}
+
+bool FluidVolume::clip(
+    const Vector3d&     origin,
+    const Vector3d&     direction,
+    double&             tmin,
+    double&             tmax) const
+{
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (direction[i] == 0.0)
+        {
+            if (origin[i] < m_bbox.min[i] || origin[i] > m_bbox.max[i])
+                return false;
+        }
+        else
+        {
+            const double rcp_dir = 1.0 / direction[i];
+            double t0 = (m_bbox.min[i] - origin[i]) * rcp_dir;
+            double t1 = (m_bbox.max[i] - origin[i]) * rcp_dir;
+
+            if (t0 > t1)
+                swap(t0, t1);
+
+            tmin = max(tmin, t0);
+            tmax = min(tmax, t1);
+        }
+    }
+
+    return tmin < tmax;
+}
+
+}   // namespace renderer
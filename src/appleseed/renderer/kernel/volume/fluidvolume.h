@@ -0,0 +1,338 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#ifndef APPLESEED_RENDERER_KERNEL_VOLUME_FLUIDVOLUME_H
+#define APPLESEED_RENDERER_KERNEL_VOLUME_FLUIDVOLUME_H
+
+// appleseed.renderer headers.
+#include "renderer/kernel/volume/volume.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/math/voxelgrid.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace renderer
+{
+
+//
+// A heterogeneous participating medium defined by the density channel of a voxel grid.
+//
+// The medium is defined in its own space (the volume space), in which the grid occupies
+// a given bounding box. Rays are expressed in volume space; the extinction scale passed
+// to the tracing methods converts distances along a ray from volume space to the space
+// in which extinction coefficients are expressed (typically world space).
+//
+// The medium is gray: extinction is proportional to density and scattering is isotropic.
+// A coarse grid of extinction upper bounds (the majorant grid) is built at construction
+// time. Empty cells of this grid are skipped entirely, and both ray marching and delta
+// tracking adapt their step sizes to the local majorant, so the cost of tracing a ray
+// through the medium is proportional to the occupied volume it crosses.
+//
+// Reference:
+//
+//   Unbiased Global Illumination with Participating Media, Matthias Raab, Daniel Seibert, Alexander Keller
+//   http://www.uni-ulm.de/fileadmin/website_uni_ulm/iui.inst.100/institut/Papers/ugiwpm.pdf
+//
+
+class FluidVolume
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    FluidVolume(
+        const VoxelGrid&                grid,
+        const size_t                    density_channel_index,
+        const foundation::AABB3d&       bbox,                   // volume space bounding box of the grid
+        const double                    density_scale,          // extinction coefficient for a density of 1
+        const float                     albedo);                // single-scattering albedo
+
+    // Return the volume space bounding box of the medium.
+    const foundation::AABB3d& get_bbox() const;
+
+    // Return the single-scattering albedo of the medium.
+    float get_albedo() const;
+
+    // Return the number of cells of the majorant grid that contain some medium.
+    size_t get_occupied_cell_count() const;
+
+    // Return the extinction coefficient at a given volume space point.
+    double get_extinction(const foundation::Vector3d& point) const;
+
+    // Compute the transmittance along the segment [tmin, tmax] of a ray, by ray marching.
+    double evaluate_transmittance(
+        const foundation::Vector3d&     origin,                 // volume space ray origin
+        const foundation::Vector3d&     direction,              // volume space ray direction
+        const double                    tmin,
+        const double                    tmax,
+        const double                    extinction_scale) const;
+
+    // Sample a collision along the segment [tmin, tmax] of a ray, by delta tracking.
+    // Returns true and the ray parameter of the collision if a real collision occurred.
+    template <typename RNG>
+    bool sample_distance(
+        const foundation::Vector3d&     origin,                 // volume space ray origin
+        const foundation::Vector3d&     direction,              // volume space ray direction
+        const double                    tmin,
+        const double                    tmax,
+        const double                    extinction_scale,
+        RNG&                            rng,
+        double&                         distance) const;
+
+  private:
+    enum { CellSize = 8 };              // size of a cell of the majorant grid, in voxels
+
+    typedef foundation::VoxelGrid3<float, double> ExtinctionGrid;
+
+    const foundation::AABB3d            m_bbox;
+    const foundation::Vector3d          m_rcp_extent;
+    const float                         m_albedo;
+    ExtinctionGrid                      m_extinction;
+    double                              m_voxel_size;
+
+    size_t                              m_cell_count[3];
+    std::vector<double>                 m_majorants;
+    size_t                              m_occupied_cell_count;
+
+    void build_majorant_grid();
+
+    // Clip a ray with a unit-length direction to the bounding box of the medium.
+    bool clip(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        double&                         tmin,
+        double&                         tmax) const;
+
+    // Visit the cells of the majorant grid pierced by a ray with a unit-length direction.
+    // The visitor is called with the extent of the ray inside each cell, and the majorant
+    // of that cell. Traversal stops as soon as the visitor returns false.
+    template <typename Visitor>
+    void traverse(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        double                          tmin,
+        double                          tmax,
+        Visitor&                        visitor) const;
+
+    template <typename RNG>
+    struct DeltaTrackingVisitor
+    {
+        const FluidVolume&              m_volume;
+        const foundation::Vector3d&     m_origin;
+        const foundation::Vector3d&     m_direction;
+        const double                    m_extinction_scale;
+        RNG&                            m_rng;
+        double                          m_distance;
+        bool                            m_collided;
+
+        DeltaTrackingVisitor(
+            const FluidVolume&          volume,
+            const foundation::Vector3d& origin,
+            const foundation::Vector3d& direction,
+            const double                extinction_scale,
+            RNG&                        rng)
+          : m_volume(volume)
+          , m_origin(origin)
+          , m_direction(direction)
+          , m_extinction_scale(extinction_scale)
+          , m_rng(rng)
+          , m_collided(false)
+        {
+        }
+
+        bool visit(const double t0, const double t1, const double cell_majorant)
+        {
+            if (cell_majorant == 0.0)
+                return true;
+
+            const double majorant = cell_majorant * m_extinction_scale;
+            const double rcp_majorant = 1.0 / majorant;
+            double t = t0;
+
+            while (true)
+            {
+                // Sample a tentative collision using the majorant of this cell.
+                t -= std::log(1.0 - foundation::rand_double2(m_rng)) * rcp_majorant;
+
+                // The process is memoryless: resume in the next cell.
+                if (t >= t1)
+                    return true;
+
+                // Accept the collision with probability extinction / majorant.
+                const double extinction =
+                    m_volume.get_extinction(m_origin + t * m_direction) * m_extinction_scale;
+                if (foundation::rand_double2(m_rng) * majorant < extinction)
+                {
+                    m_distance = t;
+                    m_collided = true;
+                    return false;
+                }
+            }
+        }
+    };
+};
+
+
+//
+// FluidVolume class implementation.
+//
+
+inline const foundation::AABB3d& FluidVolume::get_bbox() const
+{
+    return m_bbox;
+}
+
+inline float FluidVolume::get_albedo() const
+{
+    return m_albedo;
+}
+
+inline size_t FluidVolume::get_occupied_cell_count() const
+{
+    return m_occupied_cell_count;
+}
+
+inline double FluidVolume::get_extinction(const foundation::Vector3d& point) const
+{
+    float extinction;
+    m_extinction.linear_lookup((point - m_bbox.min) * m_rcp_extent, &extinction);
+    return static_cast<double>(extinction);
+}
+
+template <typename RNG>
+bool FluidVolume::sample_distance(
+    const foundation::Vector3d&         origin,
+    const foundation::Vector3d&         direction,
+    const double                        tmin,
+    const double                        tmax,
+    const double                        extinction_scale,
+    RNG&                                rng,
+    double&                             distance) const
+{
+    // Work with a unit-length direction so that distances are volume space distances.
+    const double length = foundation::norm(direction);
+    const foundation::Vector3d unit_direction = direction / length;
+
+    DeltaTrackingVisitor<RNG> visitor(*this, origin, unit_direction, extinction_scale, rng);
+    traverse(origin, unit_direction, tmin * length, tmax * length, visitor);
+
+    if (!visitor.m_collided)
+        return false;
+
+    distance = visitor.m_distance / length;
+    return true;
+}
+
+template <typename Visitor>
+void FluidVolume::traverse(
+    const foundation::Vector3d&         origin,
+    const foundation::Vector3d&         direction,
+    double                              tmin,
+    double                              tmax,
+    Visitor&                            visitor) const
+{
+    if (!clip(origin, direction, tmin, tmax))
+        return;
+
+    // Compute the entry point and the direction in the unit cube.
+    const foundation::Vector3d entry = (origin + tmin * direction - m_bbox.min) * m_rcp_extent;
+    const foundation::Vector3d unit_dir = direction * m_rcp_extent;
+
+    int cell[3], step[3], end[3];
+    double t_next[3], t_delta[3];
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const int cell_count = static_cast<int>(m_cell_count[i]);
+        const double scaled_entry = foundation::saturate(entry[i]) * cell_count;
+        cell[i] = std::min(foundation::truncate<int>(scaled_entry), cell_count - 1);
+
+        if (unit_dir[i] > 0.0)
+        {
+            step[i] = 1;
+            end[i] = cell_count;
+            t_delta[i] = 1.0 / (cell_count * unit_dir[i]);
+            t_next[i] = tmin + (cell[i] + 1 - scaled_entry) * t_delta[i];
+        }
+        else if (unit_dir[i] < 0.0)
+        {
+            step[i] = -1;
+            end[i] = -1;
+            t_delta[i] = -1.0 / (cell_count * unit_dir[i]);
+            t_next[i] = tmin + (scaled_entry - cell[i]) * t_delta[i];
+        }
+        else
+        {
+            step[i] = 0;
+            end[i] = -1;
+            t_delta[i] = std::numeric_limits<double>::max();
+            t_next[i] = std::numeric_limits<double>::max();
+        }
+    }
+
+    double t = tmin;
+
+    while (t < tmax)
+    {
+        // Find the axis along which the ray leaves the current cell.
+        const size_t axis =
+            t_next[0] < t_next[1]
+                ? (t_next[0] < t_next[2] ? 0 : 2)
+                : (t_next[1] < t_next[2] ? 1 : 2);
+
+        const double t_exit = std::min(t_next[axis], tmax);
+
+        const size_t cell_index =
+            (cell[2] * m_cell_count[1] + cell[1]) * m_cell_count[0] + cell[0];
+
+        if (!visitor.visit(t, t_exit, m_majorants[cell_index]))
+            return;
+
+        // Move to the next cell.
+        cell[axis] += step[axis];
+        if (cell[axis] == end[axis])
+            return;
+
+        t_next[axis] += t_delta[axis];
+        t = t_exit;
+    }
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_VOLUME_FLUIDVOLUME_H
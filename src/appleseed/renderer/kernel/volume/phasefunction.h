@@ -0,0 +1,88 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_VOLUME_PHASEFUNCTION_H
+#define APPLESEED_RENDERER_KERNEL_VOLUME_PHASEFUNCTION_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+
+namespace renderer
+{
+
+//
+// Phase function interface.
+//
+// A phase function describes the angular distribution of light scattered at a point
+// inside a participating medium. It plays the role of the BSDF for medium vertices.
+//
+
+class PhaseFunction
+  : public foundation::NonCopyable
+{
+  public:
+    // Destructor.
+    virtual ~PhaseFunction() {}
+
+    // Evaluate the phase function for a given pair of directions. Both directions
+    // point away from the scattering point and are unit-length. Return the probability
+    // density with respect to solid angle of sampling the incoming direction.
+    virtual double evaluate(
+        const foundation::Vector3d&     outgoing,
+        const foundation::Vector3d&     incoming,
+        Spectrum&                       value) const = 0;
+};
+
+
+//
+// Isotropic phase function.
+//
+
+class IsotropicPhaseFunction
+  : public PhaseFunction
+{
+  public:
+    virtual double evaluate(
+        const foundation::Vector3d&     outgoing,
+        const foundation::Vector3d&     incoming,
+        Spectrum&                       value) const OVERRIDE
+    {
+        value.set(static_cast<float>(foundation::RcpFourPi));
+        return foundation::RcpFourPi;
+    }
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_VOLUME_PHASEFUNCTION_H
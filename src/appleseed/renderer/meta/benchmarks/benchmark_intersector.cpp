@@ -0,0 +1,148 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/utility/testutils.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+BENCHMARK_SUITE(Renderer_Kernel_Intersection_Intersector)
+{
+    template <size_t Resolution>
+    struct Fixture
+    {
+        static const size_t RayCount = 1000;
+
+        auto_release_ptr<Project>   m_project;
+        TraceContext                m_trace_context;
+        TextureStore                m_texture_store;
+        TextureCache                m_texture_cache;
+        Intersector                 m_intersector;
+        ShadingRay                  m_rays[RayCount];
+        size_t                      m_hits;
+
+        Fixture()
+          : m_project(create_project())
+          , m_trace_context(*m_project->get_scene())
+          , m_texture_store(*m_project->get_scene())
+          , m_texture_cache(m_texture_store)
+          , m_intersector(m_trace_context, m_texture_cache)
+          , m_hits(0)
+        {
+            // Shoot rays from the camera position toward random points of the back wall.
+            const Vector3d origin(0.278, 0.273, -0.800);
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                const Vector3d target(
+                    rand_double1(rng, 0.0, 0.556),
+                    rand_double1(rng, 0.0, 0.549),
+                    0.559);
+
+                m_rays[i] =
+                    ShadingRay(
+                        origin,
+                        normalize(target - origin),
+                        0.0,
+                        ShadingRay::CameraRay);
+            }
+        }
+
+        static auto_release_ptr<Project> create_project()
+        {
+            auto_release_ptr<Project> project(
+                Resolution > 0
+                    ? create_scaled_cornell_box_project(Resolution)
+                    : CornellBoxProjectFactory::create());
+
+            InputBinder input_binder;
+            input_binder.bind(*project->get_scene());
+
+            return project;
+        }
+
+        void trace_rays()
+        {
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                ShadingPoint shading_point;
+                if (m_intersector.trace(m_rays[i], shading_point))
+                    ++m_hits;
+            }
+        }
+
+        void trace_probe_rays()
+        {
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                if (m_intersector.trace_probe(m_rays[i]))
+                    ++m_hits;
+            }
+        }
+    };
+
+    BENCHMARK_CASE_F(Trace_CornellBox_1000Rays, Fixture<0>)
+    {
+        trace_rays();
+    }
+
+    BENCHMARK_CASE_F(TraceProbe_CornellBox_1000Rays, Fixture<0>)
+    {
+        trace_probe_rays();
+    }
+
+    BENCHMARK_CASE_F(Trace_CornellBoxWith180KTriangles_1000Rays, Fixture<300>)
+    {
+        trace_rays();
+    }
+
+    BENCHMARK_CASE_F(TraceProbe_CornellBoxWith180KTriangles_1000Rays, Fixture<300>)
+    {
+        trace_probe_rays();
+    }
+}
@@ -0,0 +1,111 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/defaultrenderercontroller.h"
+#include "renderer/kernel/rendering/masterrenderer.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/project/configuration.h"
+#include "renderer/modeling/project/configurationcontainer.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/testutils.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+BENCHMARK_SUITE(Renderer_Kernel_Rendering_MasterRenderer)
+{
+    // Render a single 64x64 pass with one sample per pixel and a single rendering thread,
+    // so that results can be compared across machines and commits. The fixture renders
+    // a first pass to build the acceleration structures, which then remain cached in
+    // the trace context of the project, so that the benchmark cases only time passes.
+    template <size_t Resolution>
+    struct Fixture
+    {
+        auto_release_ptr<Project>   m_project;
+        ParamArray                  m_params;
+        DefaultRendererController   m_renderer_controller;
+
+        Fixture()
+          : m_project(
+                Resolution > 0
+                    ? create_scaled_cornell_box_project(Resolution)
+                    : CornellBoxProjectFactory::create())
+          , m_params(m_project->configurations().get_by_name("final")->get_inherited_parameters())
+        {
+            m_project->set_frame(
+                FrameFactory::create(
+                    "beauty",
+                    ParamArray()
+                        .insert("camera", "camera")
+                        .insert("resolution", "64 64")
+                        .insert("color_space", "srgb")));
+
+            m_params.insert("rendering_threads", "1");
+            m_params.insert_path("uniform_pixel_renderer.samples", "1");
+
+            render("drt");
+        }
+
+        void render(const char* lighting_engine)
+        {
+            m_params.insert("lighting_engine", lighting_engine);
+
+            MasterRenderer renderer(
+                m_project.ref(),
+                m_params,
+                &m_renderer_controller);
+
+            renderer.render();
+        }
+    };
+
+    BENCHMARK_CASE_F(RenderPass_CornellBox_DistributionRayTracing, Fixture<0>)
+    {
+        render("drt");
+    }
+
+    BENCHMARK_CASE_F(RenderPass_CornellBox_PathTracing, Fixture<0>)
+    {
+        render("pt");
+    }
+
+    BENCHMARK_CASE_F(RenderPass_CornellBoxWith180KTriangles_PathTracing, Fixture<300>)
+    {
+        render("pt");
+    }
+}
@@ -0,0 +1,75 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/utility/testutils.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+BENCHMARK_SUITE(Renderer_Kernel_Intersection_TraceContext)
+{
+    template <size_t Resolution>
+    struct Fixture
+    {
+        auto_release_ptr<Project>   m_project;
+
+        Fixture()
+          : m_project(
+                Resolution > 0
+                    ? create_scaled_cornell_box_project(Resolution)
+                    : CornellBoxProjectFactory::create())
+        {
+        }
+    };
+
+    BENCHMARK_CASE_F(Build_CornellBox, Fixture<0>)
+    {
+        TraceContext trace_context(*m_project->get_scene());
+    }
+
+    BENCHMARK_CASE_F(Build_CornellBoxWith20KTriangles, Fixture<100>)
+    {
+        TraceContext trace_context(*m_project->get_scene());
+    }
+
+    BENCHMARK_CASE_F(Build_CornellBoxWith180KTriangles, Fixture<300>)
+    {
+        TraceContext trace_context(*m_project->get_scene());
+    }
+}
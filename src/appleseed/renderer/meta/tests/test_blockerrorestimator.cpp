@@ -0,0 +1,143 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/final/blockerrorestimator.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Final_BlockErrorEstimator)
+{
+    const AABB2i BBox(Vector2i(-2, -2), Vector2i(5, 5));
+
+    TEST_CASE(GetPixelError_GivenNoSample_ReturnsZero)
+    {
+        BlockErrorEstimator estimator(BBox);
+
+        EXPECT_EQ(0.0f, estimator.get_pixel_error(0, 0));
+    }
+
+    TEST_CASE(GetPixelError_GivenSamplesOnlyInFullBuffer_ReturnsZero)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(0, 0, Color3f(1.0f), false);
+        estimator.add(0, 0, Color3f(3.0f), false);
+
+        EXPECT_EQ(0.0f, estimator.get_pixel_error(0, 0));
+    }
+
+    TEST_CASE(GetPixelError_GivenIdenticalSamples_ReturnsZero)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(-2, -2, Color3f(0.5f), true);
+        estimator.add(-2, -2, Color3f(0.5f), false);
+
+        EXPECT_EQ(0.0f, estimator.get_pixel_error(-2, -2));
+    }
+
+    TEST_CASE(GetPixelError_GivenDifferentSamples_ReturnsNormalizedDifference)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(5, 5, Color3f(1.0f), true);
+        estimator.add(5, 5, Color3f(3.0f), false);
+
+        // Full: 2, half: 1, per-channel difference: 1, intensity: 6.
+        EXPECT_FEQ(3.0f / std::sqrt(6.0f), estimator.get_pixel_error(5, 5));
+    }
+
+    TEST_CASE(GetPixelError_AfterClear_ReturnsZero)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(0, 0, Color3f(1.0f), true);
+        estimator.add(0, 0, Color3f(3.0f), false);
+        estimator.clear();
+
+        EXPECT_EQ(0.0f, estimator.get_pixel_error(0, 0));
+    }
+
+    TEST_CASE(GetBlockError_ReturnsAveragePixelError)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(0, 0, Color3f(1.0f), true);
+        estimator.add(0, 0, Color3f(3.0f), false);
+
+        const float expected = 3.0f / std::sqrt(6.0f) / 4.0f;
+
+        EXPECT_FEQ(expected, estimator.get_block_error(AABB2i(Vector2i(0, 0), Vector2i(1, 1))));
+    }
+
+    TEST_CASE(SplitBlock_GivenNoError_SplitsLargestDimensionInTheMiddle)
+    {
+        BlockErrorEstimator estimator(BBox);
+
+        AABB2i first, second;
+        estimator.split_block(AABB2i(Vector2i(-2, 0), Vector2i(5, 1)), first, second);
+
+        EXPECT_EQ(AABB2i(Vector2i(-2, 0), Vector2i(1, 1)), first);
+        EXPECT_EQ(AABB2i(Vector2i(2, 0), Vector2i(5, 1)), second);
+    }
+
+    TEST_CASE(SplitBlock_GivenErrorConcentratedAtTheTop_BalancesError)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(0, -2, Color3f(1.0f), true);
+        estimator.add(0, -2, Color3f(3.0f), false);
+        estimator.add(0, -1, Color3f(1.0f), true);
+        estimator.add(0, -1, Color3f(3.0f), false);
+
+        AABB2i first, second;
+        estimator.split_block(AABB2i(Vector2i(0, -2), Vector2i(1, 5)), first, second);
+
+        EXPECT_EQ(AABB2i(Vector2i(0, -2), Vector2i(1, -2)), first);
+        EXPECT_EQ(AABB2i(Vector2i(0, -1), Vector2i(1, 5)), second);
+    }
+
+    TEST_CASE(SplitBlock_GivenErrorConcentratedInLastColumn_KeepsBothBlocksNonEmpty)
+    {
+        BlockErrorEstimator estimator(BBox);
+        estimator.add(5, 0, Color3f(1.0f), true);
+        estimator.add(5, 0, Color3f(3.0f), false);
+
+        AABB2i first, second;
+        estimator.split_block(AABB2i(Vector2i(0, 0), Vector2i(5, 0)), first, second);
+
+        EXPECT_EQ(AABB2i(Vector2i(0, 0), Vector2i(4, 0)), first);
+        EXPECT_EQ(AABB2i(Vector2i(5, 0), Vector2i(5, 0)), second);
+    }
+}
@@ -0,0 +1,151 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// appleseed.renderer headers.
+#include "renderer/kernel/volume/fluidvolume.h"
+#include "renderer/kernel/volume/volume.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Volume_FluidVolume)
+{
+    struct Fixture
+    {
+        VoxelGrid   m_grid;
+        AABB3d      m_bbox;
+
+        Fixture()
+          : m_grid(32, 32, 32, 1)
+          , m_bbox(Vector3d(0.0), Vector3d(1.0))
+        {
+        }
+
+        // Fill the slab x < 0.5 with the given density.
+        void fill_half(const float density)
+        {
+            for (size_t z = 0; z < m_grid.get_zres(); ++z)
+            {
+                for (size_t y = 0; y < m_grid.get_yres(); ++y)
+                {
+                    for (size_t x = 0; x < m_grid.get_xres() / 2; ++x)
+                        m_grid.voxel(x, y, z)[0] = density;
+                }
+            }
+        }
+    };
+
+    TEST_CASE_F(EvaluateTransmittance_GivenEmptyGrid_ReturnsOne, Fixture)
+    {
+        const FluidVolume volume(m_grid, 0, m_bbox, 1.0, 1.0f);
+
+        const double transmittance =
+            volume.evaluate_transmittance(Vector3d(-1.0, 0.5, 0.5), Vector3d(1.0, 0.0, 0.0), 0.0, 10.0, 1.0);
+
+        EXPECT_EQ(0, volume.get_occupied_cell_count());
+        EXPECT_EQ(1.0, transmittance);
+    }
+
+    TEST_CASE_F(EvaluateTransmittance_GivenRayMissingVolume_ReturnsOne, Fixture)
+    {
+        fill_half(1.0f);
+        const FluidVolume volume(m_grid, 0, m_bbox, 1.0, 1.0f);
+
+        const double transmittance =
+            volume.evaluate_transmittance(Vector3d(-1.0, 2.0, 0.5), Vector3d(1.0, 0.0, 0.0), 0.0, 10.0, 1.0);
+
+        EXPECT_EQ(1.0, transmittance);
+    }
+
+    TEST_CASE_F(EvaluateTransmittance_GivenHomogeneousSlab_MatchesBeerLambert, Fixture)
+    {
+        fill_half(1.0f);
+        const FluidVolume volume(m_grid, 0, m_bbox, 2.0, 1.0f);
+
+        // The ray crosses the occupied slab along z, well inside of it.
+        const double transmittance =
+            volume.evaluate_transmittance(Vector3d(0.25, 0.5, -1.0), Vector3d(0.0, 0.0, 1.0), 0.0, 10.0, 1.0);
+
+        EXPECT_FEQ_EPS(std::exp(-2.0), transmittance, 1.0e-3);
+    }
+
+    TEST_CASE_F(EvaluateTransmittance_GivenExtinctionScale_ScalesOpticalDepth, Fixture)
+    {
+        fill_half(1.0f);
+        const FluidVolume volume(m_grid, 0, m_bbox, 2.0, 1.0f);
+
+        const double transmittance =
+            volume.evaluate_transmittance(Vector3d(0.25, 0.5, -1.0), Vector3d(0.0, 0.0, 1.0), 0.0, 10.0, 0.5);
+
+        EXPECT_FEQ_EPS(std::exp(-1.0), transmittance, 1.0e-3);
+    }
+
+    TEST_CASE_F(SampleDistance_GivenEmptyGrid_ReturnsFalse, Fixture)
+    {
+        const FluidVolume volume(m_grid, 0, m_bbox, 1.0, 1.0f);
+
+        MersenneTwister rng;
+        double distance;
+
+        EXPECT_FALSE(
+            volume.sample_distance(Vector3d(-1.0, 0.5, 0.5), Vector3d(1.0, 0.0, 0.0), 0.0, 10.0, 1.0, rng, distance));
+    }
+
+    TEST_CASE_F(SampleDistance_GivenHomogeneousSlab_CollisionRateMatchesTransmittance, Fixture)
+    {
+        fill_half(1.0f);
+        const FluidVolume volume(m_grid, 0, m_bbox, 2.0, 1.0f);
+
+        MersenneTwister rng;
+        const size_t SampleCount = 10000;
+        size_t collision_count = 0;
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            double distance;
+            if (volume.sample_distance(Vector3d(0.25, 0.5, -1.0), Vector3d(0.0, 0.0, 1.0), 0.0, 10.0, 1.0, rng, distance))
+            {
+                EXPECT_TRUE(distance >= 1.0 && distance <= 2.0);
+                ++collision_count;
+            }
+        }
+
+        const double collision_rate = static_cast<double>(collision_count) / SampleCount;
+
+        EXPECT_FEQ_EPS(1.0 - std::exp(-2.0), collision_rate, 0.02);
+    }
+}
@@ -0,0 +1,132 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/modeling/scene/instancearray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Modeling_Scene_InstanceArray)
+{
+    const Transformd make_transform(const Vector3d& translation, const double angle, const double scale)
+    {
+        return
+            Transformd::from_local_to_parent(
+                  Matrix4d::translation(translation)
+                * Matrix4d::rotation_y(angle)
+                * Matrix4d::scaling(Vector3d(scale)));
+    }
+
+    TEST_CASE(Constructor_ReturnsEmptyArray)
+    {
+        InstanceArray instance_array;
+
+        EXPECT_TRUE(instance_array.empty());
+        EXPECT_EQ(0, instance_array.size());
+        EXPECT_FALSE(instance_array.has_ids());
+    }
+
+    TEST_CASE(PushBack_ReturnsIndexOfInstance)
+    {
+        InstanceArray instance_array;
+
+        EXPECT_EQ(0, instance_array.push_back(Transformd::identity()));
+        EXPECT_EQ(1, instance_array.push_back(Transformd::identity()));
+        EXPECT_EQ(2, instance_array.size());
+    }
+
+    TEST_CASE(GetId_GivenNoIds_ReturnsIndex)
+    {
+        InstanceArray instance_array;
+        instance_array.push_back(Transformd::identity());
+        instance_array.push_back(Transformd::identity());
+
+        EXPECT_EQ(1, instance_array.get_id(1));
+    }
+
+    TEST_CASE(GetId_GivenIdsAddedAfterInstancesWithoutIds_ReturnsIndexForEarlierInstances)
+    {
+        InstanceArray instance_array;
+        instance_array.push_back(Transformd::identity());
+        instance_array.push_back(Transformd::identity(), 42);
+        instance_array.push_back(Transformd::identity());
+
+        EXPECT_TRUE(instance_array.has_ids());
+        EXPECT_EQ(0, instance_array.get_id(0));
+        EXPECT_EQ(42, instance_array.get_id(1));
+        EXPECT_EQ(2, instance_array.get_id(2));
+    }
+
+    TEST_CASE(GetTransform_ReturnsTransformPassedToPushBack)
+    {
+        const Transformd transform = make_transform(Vector3d(1.0, 2.0, 3.0), 0.5, 2.0);
+
+        InstanceArray instance_array;
+        instance_array.push_back(transform);
+
+        const Transformd result = instance_array.get_transform(0);
+
+        EXPECT_FEQ_EPS(transform.get_local_to_parent(), result.get_local_to_parent(), 1.0e-5);
+        EXPECT_FEQ_EPS(transform.get_parent_to_local(), result.get_parent_to_local(), 1.0e-5);
+    }
+
+    TEST_CASE(GetTransform_ReturnsTransformWhoseMatricesAreInverseOfEachOther)
+    {
+        InstanceArray instance_array;
+        instance_array.push_back(make_transform(Vector3d(-4.0, 0.5, 7.0), 1.2, 0.3));
+
+        const Transformd result = instance_array.get_transform(0);
+
+        EXPECT_FEQ_EPS(
+            Matrix4d::make_identity(),
+            result.get_local_to_parent() * result.get_parent_to_local(),
+            1.0e-9);
+    }
+
+    TEST_CASE(Clear_RemovesInstancesAndIds)
+    {
+        InstanceArray instance_array;
+        instance_array.push_back(Transformd::identity(), 7);
+
+        instance_array.clear();
+
+        EXPECT_TRUE(instance_array.empty());
+        EXPECT_FALSE(instance_array.has_ids());
+    }
+}
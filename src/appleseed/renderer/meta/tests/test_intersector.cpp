@@ -35,6 +35,7 @@
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/kernel/texturing/texturecache.h"
 #include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/object/curveobject.h"
 #include "renderer/modeling/object/object.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
@@ -50,6 +51,7 @@
 #include "foundation/math/vector.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/iostreamop.h"
 #include "foundation/utility/test.h"
 
 using namespace foundation;
@@ -92,8 +94,51 @@ TEST_SUITE(Renderer_Kernel_Intersection_Intersector)
         }
     };
 
+    struct CurveScene
+    {
+        auto_release_ptr<Scene> m_scene;
+
+        CurveScene()
+          : m_scene(SceneFactory::create())
+        {
+            auto_release_ptr<Assembly> assembly(
+                AssemblyFactory::create("assembly", ParamArray()));
+
+            ParamArray params;
+            params.insert("basis", "linear");
+
+            auto_release_ptr<CurveObject> curve_object(
+                CurveObjectFactory::create("curve", params));
+            curve_object->push_vertex(GVector3(-1.0f, 0.0f, 0.0f), 0.2f);
+            curve_object->push_vertex(GVector3(1.0f, 0.0f, 0.0f), 0.2f);
+            curve_object->push_curve(0, 2);
+            curve_object->push_material_slot("default");
+
+            assembly->objects().insert(
+                auto_release_ptr<Object>(curve_object.release()));
+
+            assembly->object_instances().insert(
+                ObjectInstanceFactory::create(
+                    "curve_instance",
+                    ParamArray(),
+                    "curve",
+                    Transformd::identity(),
+                    StringDictionary()));
+
+            m_scene->assembly_instances().insert(
+                auto_release_ptr<AssemblyInstance>(
+                    AssemblyInstanceFactory::create(
+                        "assembly_instance",
+                        ParamArray(),
+                        "assembly")));
+
+            m_scene->assemblies().insert(assembly);
+        }
+    };
+
+    template <typename Base>
     struct Fixture
-      : public BindInputs<TestScene>
+      : public BindInputs<Base>
     {
         TraceContext    m_trace_context;
         TextureStore    m_texture_store;
@@ -101,15 +146,15 @@ TEST_SUITE(Renderer_Kernel_Intersection_Intersector)
         Intersector     m_intersector;
 
         Fixture()
-          : m_trace_context(m_scene.ref())
-          , m_texture_store(m_scene.ref())
+          : m_trace_context(Base::m_scene.ref())
+          , m_texture_store(Base::m_scene.ref())
           , m_texture_cache(m_texture_store)
           , m_intersector(m_trace_context, m_texture_cache)
         {
         }
     };
 
-    TEST_CASE_F(Trace_GivenAssemblyContainingEmptyBoundingBoxAndRayWithTMaxInsideAssembly_ReturnsFalse, Fixture)
+    TEST_CASE_F(Trace_GivenAssemblyContainingEmptyBoundingBoxAndRayWithTMaxInsideAssembly_ReturnsFalse, Fixture<TestScene>)
     {
         const ShadingRay ray(
             Vector3d(0.0, 0.0, 2.0),
@@ -125,7 +170,7 @@ TEST_SUITE(Renderer_Kernel_Intersection_Intersector)
         EXPECT_FALSE(hit);
     }
 
-    TEST_CASE_F(TraceProbe_GivenAssemblyContainingEmptyBoundingBoxAndRayWithTMaxInsideAssembly_ReturnsFalse, Fixture)
+    TEST_CASE_F(TraceProbe_GivenAssemblyContainingEmptyBoundingBoxAndRayWithTMaxInsideAssembly_ReturnsFalse, Fixture<TestScene>)
     {
         const ShadingRay ray(
             Vector3d(0.0, 0.0, 2.0),
@@ -139,4 +184,110 @@ TEST_SUITE(Renderer_Kernel_Intersection_Intersector)
 
         EXPECT_FALSE(hit);
     }
+
+    TEST_CASE_F(Trace_GivenRayPiercingCurve_ReturnsHitOnRibbon, Fixture<CurveScene>)
+    {
+        const ShadingRay ray(
+            Vector3d(0.5, 0.05, 2.0),
+            Vector3d(0.0, 0.0, -1.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::CameraRay);
+
+        ShadingPoint shading_point;
+        const bool hit = m_intersector.trace(ray, shading_point);
+
+        ASSERT_TRUE(hit);
+        EXPECT_EQ(ShadingPoint::PrimitiveCurve, shading_point.get_primitive_type());
+        EXPECT_FEQ(2.0, shading_point.get_distance());
+        EXPECT_FEQ(Vector2d(0.75, 0.25), shading_point.get_uv(0));
+        EXPECT_FEQ(Vector3d(0.0, 0.0, 1.0), shading_point.get_geometric_normal());
+    }
+
+    TEST_CASE_F(Trace_GivenRayPassingBesideCurve_ReturnsFalse, Fixture<CurveScene>)
+    {
+        const ShadingRay ray(
+            Vector3d(0.5, 0.2, 2.0),
+            Vector3d(0.0, 0.0, -1.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::CameraRay);
+
+        ShadingPoint shading_point;
+        const bool hit = m_intersector.trace(ray, shading_point);
+
+        EXPECT_FALSE(hit);
+    }
+
+    TEST_CASE_F(TraceProbe_GivenRayPiercingCurve_ReturnsTrue, Fixture<CurveScene>)
+    {
+        const ShadingRay ray(
+            Vector3d(-0.5, 0.0, 2.0),
+            Vector3d(0.0, 0.0, -1.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::CameraRay);
+
+        const bool hit = m_intersector.trace_probe(ray);
+
+        EXPECT_TRUE(hit);
+    }
+
+    TEST_CASE_F(Trace_GivenSecondaryRayLeavingCurveTowardItsAxis_DoesNotHitSameCurve, Fixture<CurveScene>)
+    {
+        const ShadingRay camera_ray(
+            Vector3d(0.5, 0.05, 2.0),
+            Vector3d(0.0, 0.0, -1.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::CameraRay);
+
+        ShadingPoint parent_shading_point;
+        ASSERT_TRUE(m_intersector.trace(camera_ray, parent_shading_point));
+
+        // The ribbon faces the secondary ray and crosses its path right below its origin.
+        const ShadingRay secondary_ray(
+            parent_shading_point.get_point(),
+            Vector3d(0.0, -1.0, 0.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::ShadowRay);
+
+        ShadingPoint shading_point;
+        const bool hit = m_intersector.trace(secondary_ray, shading_point, &parent_shading_point);
+
+        EXPECT_FALSE(hit);
+    }
+
+    TEST_CASE_F(TraceProbe_GivenSecondaryRayLeavingCurveTowardItsAxis_ReturnsFalse, Fixture<CurveScene>)
+    {
+        const ShadingRay camera_ray(
+            Vector3d(0.5, 0.05, 2.0),
+            Vector3d(0.0, 0.0, -1.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::CameraRay);
+
+        ShadingPoint parent_shading_point;
+        ASSERT_TRUE(m_intersector.trace(camera_ray, parent_shading_point));
+
+        // The ribbon faces the secondary ray and crosses its path right below its origin.
+        const ShadingRay secondary_ray(
+            parent_shading_point.get_point(),
+            Vector3d(0.0, -1.0, 0.0),
+            0.0,
+            10.0,
+            0.0,
+            ShadingRay::ShadowRay);
+
+        const bool hit = m_intersector.trace_probe(secondary_ray, &parent_shading_point);
+
+        EXPECT_FALSE(hit);
+    }
 }
@@ -0,0 +1,121 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/drt/irradiancecache.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_DRT_IrradianceCache)
+{
+    TEST_CASE(Lookup_GivenEmptyCache_ReturnsFalse)
+    {
+        IrradianceCache cache(0.2, 0.01, 1.0);
+
+        Spectrum irradiance;
+        const bool found = cache.lookup(Vector3d(0.0), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        EXPECT_FALSE(found);
+    }
+
+    TEST_CASE(Lookup_AtRecordPosition_ReturnsRecordIrradiance)
+    {
+        IrradianceCache cache(0.2, 0.01, 1.0);
+        cache.insert(Vector3d(0.5, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(2.0f));
+
+        Spectrum irradiance;
+        const bool found = cache.lookup(Vector3d(0.5, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        ASSERT_TRUE(found);
+        EXPECT_TRUE(irradiance == Spectrum(2.0f));
+    }
+
+    TEST_CASE(Lookup_OutsideRecordRadius_ReturnsFalse)
+    {
+        IrradianceCache cache(0.2, 0.01, 1.0);
+        cache.insert(Vector3d(0.5, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), 0.5, Spectrum(2.0f));
+
+        // The record is valid up to 0.2 * 0.5 = 0.1 units away.
+        Spectrum irradiance;
+        const bool found = cache.lookup(Vector3d(0.65, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        EXPECT_FALSE(found);
+    }
+
+    TEST_CASE(Lookup_WithOppositeNormal_ReturnsFalse)
+    {
+        IrradianceCache cache(0.2, 0.01, 1.0);
+        cache.insert(Vector3d(0.5, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(2.0f));
+
+        Spectrum irradiance;
+        const bool found = cache.lookup(Vector3d(0.5, 0.0, 0.5), Vector3d(0.0, -1.0, 0.0), irradiance);
+
+        EXPECT_FALSE(found);
+    }
+
+    TEST_CASE(Lookup_AcrossCellBoundary_FindsRecord)
+    {
+        // Cells are 2 * 0.2 * 1.0 = 0.4 units wide: the record straddles the boundary at x = 0.4.
+        IrradianceCache cache(0.2, 0.01, 1.0);
+        cache.insert(Vector3d(0.39, 0.0, 0.1), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(2.0f));
+
+        Spectrum irradiance;
+        const bool found = cache.lookup(Vector3d(0.41, 0.0, 0.1), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        ASSERT_TRUE(found);
+        EXPECT_TRUE(irradiance == Spectrum(2.0f));
+    }
+
+    TEST_CASE(Lookup_BetweenTwoRecords_InterpolatesIrradiance)
+    {
+        IrradianceCache cache(0.2, 0.01, 1.0);
+        cache.insert(Vector3d(0.49, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(1.0f));
+        cache.insert(Vector3d(0.51, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(3.0f));
+
+        Spectrum irradiance;
+        const bool found = cache.lookup(Vector3d(0.5, 0.0, 0.5), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        ASSERT_TRUE(found);
+        EXPECT_FEQ(2.0f, irradiance[0]);
+    }
+
+    TEST_CASE(GetRecordCount_AfterInsertions_ReturnsNumberOfInsertedRecords)
+    {
+        IrradianceCache cache(0.2, 0.01, 1.0);
+        cache.insert(Vector3d(0.0), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(1.0f));
+        cache.insert(Vector3d(0.2), Vector3d(0.0, 1.0, 0.0), 1.0, Spectrum(1.0f));
+
+        EXPECT_EQ(2, cache.get_record_count());
+    }
+}
@@ -28,12 +28,16 @@
 //
 
 // appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/camera/camera.h"
 #include "renderer/modeling/camera/pinholecamera.h"
+#include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/project/project.h"
 #include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/rng.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/iostreamop.h"
@@ -66,4 +70,40 @@ TEST_SUITE(Renderer_Modeling_Camera_PinholeCamera)
 
         camera->on_frame_end(project.ref());
     }
+
+    TEST_CASE(GenerateRay_GivenFrame_ComputesRayDifferentialsOffsetByOnePixel)
+    {
+        auto_release_ptr<Project> project(ProjectFactory::create("test"));
+        project->set_frame(
+            FrameFactory::create(
+                "frame",
+                ParamArray().insert("resolution", "640 480")));
+
+        PinholeCameraFactory factory;
+        auto_release_ptr<Camera> camera(
+            factory.create(
+                "camera",
+                ParamArray().insert("film_width", "0.025")
+                            .insert("film_height", "0.025")
+                            .insert("focal_length", "0.035")));
+
+        camera->on_frame_begin(project.ref());
+
+        MersenneTwister rng;
+        SamplingContext sampling_context(rng);
+
+        ShadingRay ray;
+        camera->generate_ray(sampling_context, Vector2d(0.25, 0.75), ray);
+
+        ASSERT_TRUE(ray.m_has_differentials);
+
+        Vector2d projected_x, projected_y;
+        ASSERT_TRUE(camera->project_point(0.0, ray.m_rx_org + 10.0 * ray.m_rx_dir, projected_x));
+        ASSERT_TRUE(camera->project_point(0.0, ray.m_ry_org + 10.0 * ray.m_ry_dir, projected_y));
+
+        EXPECT_FEQ(Vector2d(0.25 + 1.0 / 640, 0.75), projected_x);
+        EXPECT_FEQ(Vector2d(0.25, 0.75 + 1.0 / 480), projected_y);
+
+        camera->on_frame_end(project.ref());
+    }
 }
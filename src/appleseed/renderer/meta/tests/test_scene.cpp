@@ -33,6 +33,7 @@
 #include "renderer/modeling/object/triangle.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/instancearray.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/utility/paramarray.h"
@@ -44,6 +45,7 @@
 #include "foundation/math/transform.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/iostreamop.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
@@ -110,4 +112,55 @@ TEST_SUITE(Renderer_Modeling_Scene_Scene)
 
         EXPECT_FEQ(10.0 * sqrt(3.0) + sqrt(3.0), radius);
     }
+
+    TEST_CASE(ComputeBBox_GivenAssemblyInstanceWithInstanceArray_BoundsAllInstances)
+    {
+        // Create a scene.
+        auto_release_ptr<Scene> scene(SceneFactory::create());
+
+        // Create an assembly.
+        auto_release_ptr<Assembly> assembly(
+            AssemblyFactory::create("assembly", ParamArray()));
+
+        // Create an object.
+        assembly->objects().insert(
+            auto_release_ptr<Object>(
+                new BoundingBoxObject(
+                    "object",
+                    GAABB3(GVector3(-1.0), GVector3(1.0)))));
+
+        // Create an instance of the object.
+        assembly->object_instances().insert(
+            ObjectInstanceFactory::create(
+                "object_inst",
+                ParamArray(),
+                "object",
+                Transformd::identity(),
+                StringDictionary()));
+
+        // Create an instance of the assembly placed twice by its instance array.
+        auto_release_ptr<AssemblyInstance> assembly_instance(
+            AssemblyInstanceFactory::create(
+                "assembly_inst",
+                ParamArray(),
+                "assembly"));
+        assembly_instance->transform_sequence().set_transform(
+            0.0,
+            Transformd::from_local_to_parent(
+                Matrix4d::translation(Vector3d(0.0, 5.0, 0.0))));
+        assembly_instance->instance_array().push_back(
+            Transformd::from_local_to_parent(
+                Matrix4d::translation(Vector3d(-10.0, 0.0, 0.0))));
+        assembly_instance->instance_array().push_back(
+            Transformd::from_local_to_parent(
+                Matrix4d::translation(Vector3d(10.0, 0.0, 0.0))));
+
+        // Insert the assembly and the assembly instance into the scene.
+        scene->assemblies().insert(assembly);
+        scene->assembly_instances().insert(assembly_instance);
+
+        const GAABB3 bbox = scene->compute_bbox();
+
+        EXPECT_FEQ(GAABB3(GVector3(-11.0, 4.0, -1.0), GVector3(11.0, 6.0, 1.0)), bbox);
+    }
 }
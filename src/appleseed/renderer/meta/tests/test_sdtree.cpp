@@ -0,0 +1,187 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/sdtree.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_SDTree)
+{
+    // Record radiance coming mostly from directions close to +Z.
+    void record_peaked_radiance(DTree& dtree, const size_t count)
+    {
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector2d s;
+            s[0] = rand_double2(rng);
+            s[1] = rand_double2(rng);
+
+            const Vector3d direction = sample_sphere_uniform(s);
+            dtree.record(direction, direction.z > 0.9 ? 10.0f : 0.1f);
+        }
+    }
+
+    // Estimate the integral of the PDF of a directional tree over the sphere.
+    double integrate_pdf(const DTree& dtree)
+    {
+        MersenneTwister rng;
+        const size_t SampleCount = 100000;
+        double sum = 0.0;
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            Vector2d s;
+            s[0] = rand_double2(rng);
+            s[1] = rand_double2(rng);
+
+            sum += dtree.evaluate_pdf(sample_sphere_uniform(s));
+        }
+
+        return sum * 4.0 * Pi / SampleCount;
+    }
+
+    TEST_CASE(DTree_Constructor_HasNoRadiance)
+    {
+        DTree dtree;
+
+        EXPECT_EQ(0.0f, dtree.get_sum());
+        EXPECT_EQ(0, dtree.get_sample_count());
+        EXPECT_EQ(1, dtree.get_node_count());
+    }
+
+    TEST_CASE(DTree_Record_AccumulatesRadianceAndSampleCount)
+    {
+        DTree dtree;
+
+        dtree.record(Vector3d(0.0, 0.0, 1.0), 2.0f);
+        dtree.record(Vector3d(1.0, 0.0, 0.0), 3.0f);
+
+        EXPECT_FEQ(5.0f, dtree.get_sum());
+        EXPECT_EQ(2, dtree.get_sample_count());
+    }
+
+    TEST_CASE(DTree_Refine_GivenPeakedRadiance_SubdividesAndClearsRadiance)
+    {
+        DTree source;
+        record_peaked_radiance(source, 10000);
+
+        DTree dtree;
+        dtree.refine(source, 0.01f);
+
+        EXPECT_GT(1, dtree.get_node_count());
+        EXPECT_EQ(0.0f, dtree.get_sum());
+        EXPECT_EQ(0, dtree.get_sample_count());
+    }
+
+    TEST_CASE(DTree_EvaluatePDF_GivenRefinedTree_IntegratesToOne)
+    {
+        DTree source;
+        record_peaked_radiance(source, 10000);
+
+        DTree dtree;
+        dtree.refine(source, 0.01f);
+        record_peaked_radiance(dtree, 100000);
+
+        EXPECT_FEQ_EPS(1.0, integrate_pdf(dtree), 0.02);
+    }
+
+    TEST_CASE(DTree_Sample_GivenPeakedRadiance_FavorsBrightDirections)
+    {
+        DTree source;
+        record_peaked_radiance(source, 10000);
+
+        DTree dtree;
+        dtree.refine(source, 0.01f);
+        record_peaked_radiance(dtree, 100000);
+
+        MersenneTwister rng;
+        const size_t SampleCount = 10000;
+        size_t bright_count = 0;
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            Vector2d s;
+            s[0] = rand_double2(rng);
+            s[1] = rand_double2(rng);
+
+            const Vector3d direction = dtree.sample(s);
+
+            if (direction.z > 0.9)
+                ++bright_count;
+        }
+
+        // Bright directions cover 5% of the sphere but carry 84% of the radiance.
+        EXPECT_GT(SampleCount / 2, bright_count);
+    }
+
+    TEST_CASE(SDTree_FindSamplingDTree_BeforeUpdate_ReturnsNull)
+    {
+        SDTree sd_tree(AABB3d(Vector3d(-1.0), Vector3d(1.0)));
+
+        sd_tree.record(Vector3d(0.0), Vector3d(0.0, 0.0, 1.0), 1.0f);
+
+        EXPECT_EQ(0, sd_tree.find_sampling_dtree(Vector3d(0.0)));
+    }
+
+    TEST_CASE(SDTree_Update_GivenManyRecords_SplitsSpatialLeaves)
+    {
+        SDTree sd_tree(AABB3d(Vector3d(-1.0), Vector3d(1.0)));
+
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const Vector3d point(
+                rand_double1(rng, -1.0, 1.0),
+                rand_double1(rng, -1.0, 1.0),
+                rand_double1(rng, -1.0, 1.0));
+
+            sd_tree.record(point, Vector3d(0.0, 0.0, 1.0), 1.0f);
+        }
+
+        sd_tree.update(100, 0.01f);
+
+        EXPECT_GT(1, sd_tree.get_leaf_count());
+        EXPECT_NEQ(0, sd_tree.find_sampling_dtree(Vector3d(0.5, -0.5, 0.5)));
+    }
+}
@@ -0,0 +1,137 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/sppm/sppmphoton.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Lighting_SPPM_SPPMPhoton)
+{
+    bool check_unit_vector_roundtrip(const Vector3f& v)
+    {
+        const Vector3f result = decode_unit_vector(encode_unit_vector(v));
+        return norm(result - v) < 1.0e-3f;
+    }
+
+    TEST_CASE(EncodeUnitVector_GivenMajorAxes_RoundTrips)
+    {
+        EXPECT_TRUE(check_unit_vector_roundtrip(Vector3f(+1.0f, 0.0f, 0.0f)));
+        EXPECT_TRUE(check_unit_vector_roundtrip(Vector3f(-1.0f, 0.0f, 0.0f)));
+        EXPECT_TRUE(check_unit_vector_roundtrip(Vector3f(0.0f, +1.0f, 0.0f)));
+        EXPECT_TRUE(check_unit_vector_roundtrip(Vector3f(0.0f, -1.0f, 0.0f)));
+        EXPECT_TRUE(check_unit_vector_roundtrip(Vector3f(0.0f, 0.0f, +1.0f)));
+        EXPECT_TRUE(check_unit_vector_roundtrip(Vector3f(0.0f, 0.0f, -1.0f)));
+    }
+
+    TEST_CASE(EncodeUnitVector_GivenRandomDirections_RoundTrips)
+    {
+        MersenneTwister rng;
+        size_t failure_count = 0;
+
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            Vector2f s;
+            s[0] = rand_float2(rng);
+            s[1] = rand_float2(rng);
+
+            if (!check_unit_vector_roundtrip(sample_sphere_uniform(s)))
+                ++failure_count;
+        }
+
+        EXPECT_EQ(0, failure_count);
+    }
+
+    TEST_CASE(PackedFlux_GivenBlackFlux_UnpacksToBlack)
+    {
+        SPPMPackedFlux packed;
+        packed.pack(Spectrum(0.0f));
+
+        Spectrum flux(1.0f);
+        packed.unpack(flux);
+
+        EXPECT_TRUE(is_zero(flux));
+    }
+
+    TEST_CASE(PackedFlux_GivenVaryingFlux_UnpacksWithinQuantizationError)
+    {
+        Spectrum flux;
+        for (size_t i = 0; i < Spectrum::Samples; ++i)
+            flux[i] = 1.0e-4f * (i + 1) * (i + 1);
+
+        SPPMPackedFlux packed;
+        packed.pack(flux);
+
+        Spectrum result;
+        packed.unpack(result);
+
+        // Each sample is quantized to 1/256 of the next power of two above the largest sample.
+        const float max_error = max_value(flux) / 128.0f;
+
+        for (size_t i = 0; i < Spectrum::Samples; ++i)
+            EXPECT_FEQ_EPS(flux[i], result[i], max_error);
+    }
+
+    TEST_CASE(PushBack_StoresPhotonsMoreCompactlyThanUncompressedPhotons)
+    {
+        SPPMPhoton photon;
+        photon.m_position = Vector3f(1.0f, 2.0f, 3.0f);
+        photon.m_data.m_incoming = Vector3f(0.0f, 1.0f, 0.0f);
+        photon.m_data.m_geometric_normal = Vector3f(0.0f, 0.0f, 1.0f);
+        photon.m_data.m_flux.set(0.5f);
+
+        SPPMPhotonVector photons;
+        photons.reserve(100);
+
+        for (size_t i = 0; i < 100; ++i)
+            photons.push_back(photon);
+
+        EXPECT_EQ(100, photons.size());
+        EXPECT_LT(100 * sizeof(SPPMPhoton), photons.get_memory_size());
+
+        Spectrum flux;
+        photons.get_flux(42, flux);
+
+        EXPECT_TRUE(flux == Spectrum(0.5f));
+        EXPECT_FEQ(photon.m_data.m_incoming, photons.get_incoming(42));
+    }
+}
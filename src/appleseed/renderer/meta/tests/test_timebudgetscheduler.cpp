@@ -0,0 +1,90 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/final/timebudgetscheduler.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Final_TimeBudgetScheduler)
+{
+    TEST_CASE(GetPassSamples_GivenDefaultState_ReturnsInitialSamples)
+    {
+        TimeBudgetScheduler scheduler(10.0, 4);
+
+        EXPECT_EQ(4, scheduler.get_pass_samples());
+        EXPECT_EQ(0, scheduler.get_total_samples());
+        EXPECT_EQ(0, scheduler.get_pass_count());
+    }
+
+    TEST_CASE(EndPass_GivenPlentyOfTimeLeft_DoublesTotalSamples)
+    {
+        TimeBudgetScheduler scheduler(1000.0);
+
+        EXPECT_EQ(1, scheduler.end_pass(0.1, 0.1));
+        EXPECT_EQ(2, scheduler.end_pass(0.2, 0.1));
+        EXPECT_EQ(4, scheduler.end_pass(0.4, 0.2));
+
+        EXPECT_EQ(4, scheduler.get_total_samples());
+        EXPECT_EQ(3, scheduler.get_pass_count());
+    }
+
+    TEST_CASE(EndPass_GivenLittleTimeLeft_GivesAllRemainingTimeToNextPass)
+    {
+        TimeBudgetScheduler scheduler(10.0, 4);
+
+        // 0.5 second per sample per pixel.
+        EXPECT_EQ(4, scheduler.end_pass(2.0, 2.0));
+
+        // 6 seconds left, minus the safety margin.
+        EXPECT_EQ(11, scheduler.end_pass(4.0, 2.0));
+    }
+
+    TEST_CASE(EndPass_GivenTimeLimitExceeded_ReturnsZero)
+    {
+        TimeBudgetScheduler scheduler(1.0);
+
+        EXPECT_EQ(0, scheduler.end_pass(1.5, 1.5));
+    }
+
+    TEST_CASE(Reset_RestoresInitialState)
+    {
+        TimeBudgetScheduler scheduler(1.0, 2);
+        scheduler.end_pass(1.5, 1.5);
+
+        scheduler.reset();
+
+        EXPECT_EQ(2, scheduler.get_pass_samples());
+        EXPECT_EQ(0, scheduler.get_total_samples());
+        EXPECT_EQ(0.0, scheduler.get_render_time());
+    }
+}
@@ -0,0 +1,197 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/triangletree.h"
+#include "renderer/kernel/intersection/trianglevertexinfo.h"
+#include "renderer/utility/bbox.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Intersection_TriangleTree)
+{
+    bool contains(const GAABB3& outer, const GAABB3& inner)
+    {
+        return outer.contains(inner.min) && outer.contains(inner.max);
+    }
+
+    TEST_CASE(ComputeTriangleMotionBBoxes_GivenPoseBetweenTwoBBoxes_InterpolatedBBoxContainsTriangleAtPose)
+    {
+        // A single triangle with 3 motion segments moving up then down.
+        const GScalar Heights[4] = { 0.0f, 3.0f, -3.0f, 0.0f };
+
+        vector<GVector3> triangle_vertices;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            triangle_vertices.push_back(GVector3(0.0f, Heights[i], 0.0f));
+            triangle_vertices.push_back(GVector3(1.0f, Heights[i], 0.0f));
+            triangle_vertices.push_back(GVector3(0.0f, Heights[i] + 1.0f, 0.0f));
+        }
+
+        vector<TriangleVertexInfo> triangle_vertex_infos;
+        triangle_vertex_infos.push_back(TriangleVertexInfo(0, 3));
+
+        vector<size_t> triangle_indices;
+        triangle_indices.push_back(0);
+
+        // Over [0, 0.5], the bounding boxes are placed at 0, 0.25 and 0.5 while the
+        // triangle reaches its second pose at 1/3.
+        const double TimeBegin = 0.0;
+        const double TimeEnd = 0.5;
+
+        const vector<GAABB3> bboxes =
+            compute_triangle_motion_bboxes(
+                triangle_indices,
+                0,
+                1,
+                triangle_vertex_infos,
+                triangle_vertices,
+                TimeBegin,
+                TimeEnd);
+
+        ASSERT_EQ(3, bboxes.size());
+
+        const size_t Pose = 1;
+        const double pose_time = static_cast<double>(Pose) / 3;
+
+        GAABB3 pose_bbox;
+        pose_bbox.invalidate();
+        pose_bbox.insert(triangle_vertices[Pose * 3 + 0]);
+        pose_bbox.insert(triangle_vertices[Pose * 3 + 1]);
+        pose_bbox.insert(triangle_vertices[Pose * 3 + 2]);
+
+        const GAABB3 interpolated_bbox =
+            interpolate<GAABB3>(
+                bboxes.begin(),
+                bboxes.end(),
+                (pose_time - TimeBegin) / (TimeEnd - TimeBegin));
+
+        EXPECT_TRUE(contains(interpolated_bbox, pose_bbox));
+    }
+
+    TEST_CASE(ComputeTriangleMotionBBoxes_GivenAnyPoseTime_InterpolatedBBoxContainsTriangleAtPose)
+    {
+        // A single triangle with 7 motion segments zigzagging along X.
+        const size_t MotionSegmentCount = 7;
+
+        vector<GVector3> triangle_vertices;
+        for (size_t i = 0; i <= MotionSegmentCount; ++i)
+        {
+            const GScalar x = i % 2 == 0 ? 0.0f : 5.0f;
+            triangle_vertices.push_back(GVector3(x + 0.0f, 0.0f, 0.0f));
+            triangle_vertices.push_back(GVector3(x + 1.0f, 0.0f, 0.0f));
+            triangle_vertices.push_back(GVector3(x + 0.0f, 1.0f, 0.0f));
+        }
+
+        vector<TriangleVertexInfo> triangle_vertex_infos;
+        triangle_vertex_infos.push_back(TriangleVertexInfo(0, MotionSegmentCount));
+
+        vector<size_t> triangle_indices;
+        triangle_indices.push_back(0);
+
+        // Time intervals of the nodes of temporal splits of depth 0 to 3.
+        for (size_t depth = 0; depth <= 3; ++depth)
+        {
+            const size_t interval_count = size_t(1) << depth;
+
+            for (size_t j = 0; j < interval_count; ++j)
+            {
+                const double time_begin = static_cast<double>(j) / interval_count;
+                const double time_end = static_cast<double>(j + 1) / interval_count;
+
+                const vector<GAABB3> bboxes =
+                    compute_triangle_motion_bboxes(
+                        triangle_indices,
+                        0,
+                        1,
+                        triangle_vertex_infos,
+                        triangle_vertices,
+                        time_begin,
+                        time_end);
+
+                for (size_t m = 0; m < MotionSegmentCount; ++m)
+                {
+                    const double pose_time = static_cast<double>(m) / MotionSegmentCount;
+
+                    if (pose_time < time_begin || pose_time >= time_end)
+                        continue;
+
+                    GAABB3 pose_bbox;
+                    pose_bbox.invalidate();
+                    pose_bbox.insert(triangle_vertices[m * 3 + 0]);
+                    pose_bbox.insert(triangle_vertices[m * 3 + 1]);
+                    pose_bbox.insert(triangle_vertices[m * 3 + 2]);
+
+                    const GAABB3 interpolated_bbox =
+                        interpolate<GAABB3>(
+                            bboxes.begin(),
+                            bboxes.end(),
+                            (pose_time - time_begin) / (time_end - time_begin));
+
+                    EXPECT_TRUE(contains(interpolated_bbox, pose_bbox));
+                }
+            }
+        }
+    }
+
+    TEST_CASE(MergeMotionBBoxes_GivenNonNestedKeyCounts_InterpolatedBBoxContainsKeysOfBothPaths)
+    {
+        // Left path: 2 motion segments with a key at 0.5 sticking out.
+        vector<GAABB3> left_bboxes;
+        left_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(1.0f)));
+        left_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(4.0f)));
+        left_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(1.0f)));
+
+        // Right path: 3 motion segments, none of its keys at 0.5.
+        vector<GAABB3> right_bboxes;
+        right_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(1.0f)));
+        right_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(1.0f)));
+        right_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(1.0f)));
+        right_bboxes.push_back(GAABB3(GVector3(0.0f), GVector3(1.0f)));
+
+        const vector<GAABB3> bboxes = merge_motion_bboxes(left_bboxes, right_bboxes);
+
+        ASSERT_EQ(4, bboxes.size());
+
+        const GAABB3 interpolated_bbox = interpolate<GAABB3>(bboxes.begin(), bboxes.end(), 0.5);
+
+        EXPECT_TRUE(contains(interpolated_bbox, left_bboxes[1]));
+    }
+}
@@ -0,0 +1,168 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/volume/fluidvolume.h"
+#include "renderer/kernel/volume/volume.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/volume/volume.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+#include <memory>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Modeling_Volume_Volume)
+{
+    // A volume filled with a homogeneous medium of unit extinction in the unit cube.
+    class TestVolume
+      : public Volume
+    {
+      public:
+        mutable size_t m_build_count;
+
+        TestVolume()
+          : Volume("volume", ParamArray())
+          , m_build_count(0)
+        {
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual const char* get_model() const OVERRIDE
+        {
+            return "test_volume";
+        }
+
+      protected:
+        virtual auto_ptr<FluidVolume> create_medium(const Project& project) const OVERRIDE
+        {
+            ++m_build_count;
+
+            VoxelGrid grid(4, 4, 4, 1);
+
+            for (size_t z = 0; z < grid.get_zres(); ++z)
+            {
+                for (size_t y = 0; y < grid.get_yres(); ++y)
+                {
+                    for (size_t x = 0; x < grid.get_xres(); ++x)
+                        grid.voxel(x, y, z)[0] = 1.0f;
+                }
+            }
+
+            return
+                auto_ptr<FluidVolume>(
+                    new FluidVolume(grid, 0, AABB3d(Vector3d(0.0), Vector3d(1.0)), 1.0, 1.0f));
+        }
+    };
+
+    struct Fixture
+    {
+        auto_release_ptr<Project>   m_project;
+        TestVolume                  m_volume;
+
+        Fixture()
+          : m_project(ProjectFactory::create("project"))
+        {
+        }
+    };
+
+    TEST_CASE_F(OnFrameBegin_CalledForTwoFrames_BuildsMediumOnce, Fixture)
+    {
+        m_volume.on_frame_begin(m_project.ref());
+        m_volume.on_frame_end(m_project.ref());
+        m_volume.on_frame_begin(m_project.ref());
+        m_volume.on_frame_end(m_project.ref());
+
+        EXPECT_EQ(1, m_volume.m_build_count);
+    }
+
+    TEST_CASE_F(OnFrameBegin_AfterTransformChange_DoesNotRebuildMedium, Fixture)
+    {
+        m_volume.on_frame_begin(m_project.ref());
+        m_volume.on_frame_end(m_project.ref());
+        m_volume.set_transform(Transformd::from_local_to_parent(Matrix4d::translation(Vector3d(1.0))));
+        m_volume.on_frame_begin(m_project.ref());
+        m_volume.on_frame_end(m_project.ref());
+
+        EXPECT_EQ(1, m_volume.m_build_count);
+    }
+
+    TEST_CASE_F(OnFrameBegin_AfterVersionBump_RebuildsMedium, Fixture)
+    {
+        m_volume.on_frame_begin(m_project.ref());
+        m_volume.on_frame_end(m_project.ref());
+        m_volume.bump_version_id();
+        m_volume.on_frame_begin(m_project.ref());
+        m_volume.on_frame_end(m_project.ref());
+
+        EXPECT_EQ(2, m_volume.m_build_count);
+    }
+
+    TEST_CASE_F(EvaluateTransmittance_GivenTranslatedVolume_TracesInWorldSpace, Fixture)
+    {
+        m_volume.set_transform(Transformd::from_local_to_parent(Matrix4d::translation(Vector3d(10.0, 0.0, 0.0))));
+        m_volume.on_frame_begin(m_project.ref());
+
+        const double transmittance_inside =
+            m_volume.evaluate_transmittance(Vector3d(9.0, 0.5, 0.5), Vector3d(1.0, 0.0, 0.0), 0.0, 10.0);
+        const double transmittance_outside =
+            m_volume.evaluate_transmittance(Vector3d(-1.0, 0.5, 0.5), Vector3d(1.0, 0.0, 0.0), 0.0, 2.0);
+
+        EXPECT_FEQ_EPS(std::exp(-1.0), transmittance_inside, 1.0e-6);
+        EXPECT_EQ(1.0, transmittance_outside);
+    }
+
+    TEST_CASE_F(EvaluateTransmittance_GivenScaledVolume_MeasuresOpticalDepthInWorldSpace, Fixture)
+    {
+        m_volume.set_transform(Transformd::from_local_to_parent(Matrix4d::scaling(Vector3d(2.0))));
+        m_volume.on_frame_begin(m_project.ref());
+
+        const double transmittance =
+            m_volume.evaluate_transmittance(Vector3d(-1.0, 1.0, 1.0), Vector3d(1.0, 0.0, 0.0), 0.0, 10.0);
+
+        EXPECT_FEQ_EPS(std::exp(-2.0), transmittance, 1.0e-6);
+    }
+}
@@ -33,9 +33,13 @@
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
 #include "renderer/kernel/shading/shadingray.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/project/project.h"
 #include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
 #include "foundation/math/scalar.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/containers/specializedarrays.h"
@@ -69,6 +73,7 @@ Camera::Camera(
     const char*         name,
     const ParamArray&   params)
   : Entity(g_class_uid, params)
+  , m_pixel_size_ndc(0.0)
 {
     set_name(name);
 }
@@ -85,6 +90,16 @@ bool Camera::on_frame_begin(
     m_shutter_open_time = m_params.get_optional<double>("shutter_open_time", 0.0);
     m_shutter_close_time = m_params.get_optional<double>("shutter_close_time", 1.0);
 
+    // Compute the dimensions of a pixel in normalized device coordinates.
+    const Frame* frame = project.get_frame();
+    if (frame)
+    {
+        const CanvasProperties& props = frame->image().properties();
+        m_pixel_size_ndc[0] = props.m_rcp_canvas_width;
+        m_pixel_size_ndc[1] = props.m_rcp_canvas_height;
+    }
+    else m_pixel_size_ndc = Vector2d(0.0);
+
     return true;
 }
 
@@ -292,6 +307,7 @@ void Camera::initialize_ray(
     }
 
     ray.m_type = ShadingRay::CameraRay;
+    ray.m_has_differentials = false;
 }
 
 bool Camera::has_param(const char* name) const
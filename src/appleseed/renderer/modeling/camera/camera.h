@@ -128,6 +128,7 @@ class DLLSYMBOL Camera
     TransformSequence   m_transform_sequence;
     double              m_shutter_open_time;
     double              m_shutter_close_time;
+    foundation::Vector2d m_pixel_size_ndc;      // dimensions of a pixel in NDC, zero if unknown
 
     // Utility function to retrieve the film dimensions (in meters) from the camera parameters.
     foundation::Vector2d extract_film_dimensions() const;
@@ -124,6 +124,17 @@ namespace
 
             // Compute the direction of the ray.
             ray.m_dir = transform.vector_to_parent(ndc_to_camera(point));
+
+            // Compute the ray differentials.
+            ray.m_has_differentials = true;
+            ray.m_rx_org = ray.m_org;
+            ray.m_ry_org = ray.m_org;
+            ray.m_rx_dir =
+                transform.vector_to_parent(
+                    ndc_to_camera(Vector2d(point.x + m_pixel_size_ndc.x, point.y)));
+            ray.m_ry_dir =
+                transform.vector_to_parent(
+                    ndc_to_camera(Vector2d(point.x, point.y + m_pixel_size_ndc.y)));
         }
 
         virtual bool project_point(
@@ -228,6 +228,19 @@ namespace
             ray.m_dir.x = (point.x - 0.5) * m_kx - lens_point.x;
             ray.m_dir.y = (0.5 - point.y) * m_ky - lens_point.y;
             ray.m_dir.z = -m_focal_distance;
+
+            // Compute the ray differentials. The auxiliary rays go through
+            // the same point of the lens as the main ray.
+            ray.m_has_differentials = true;
+            ray.m_rx_org = ray.m_org;
+            ray.m_ry_org = ray.m_org;
+            ray.m_rx_dir = ray.m_dir;
+            ray.m_rx_dir.x += m_pixel_size_ndc.x * m_kx;
+            ray.m_ry_dir = ray.m_dir;
+            ray.m_ry_dir.y -= m_pixel_size_ndc.y * m_ky;
+            ray.m_rx_dir = transform.vector_to_parent(ray.m_rx_dir);
+            ray.m_ry_dir = transform.vector_to_parent(ray.m_ry_dir);
+
             ray.m_dir = transform.vector_to_parent(ray.m_dir);
         }
 
@@ -354,6 +367,7 @@ namespace
             ray.m_tmax = numeric_limits<double>::max();
             ray.m_time = time;
             ray.m_type = ShadingRay::ProbeRay;
+            ray.m_has_differentials = false;
 
             // Trace the ray.
             ShadingPoint shading_point;
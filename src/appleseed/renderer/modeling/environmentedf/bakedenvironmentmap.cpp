@@ -0,0 +1,253 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "bakedenvironmentmap.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/environmentedf/environmentedf.h"
+#include "renderer/modeling/environmentedf/sphericalcoordinates.h"
+#include "renderer/modeling/input/inputevaluator.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/colorspace.h"
+#include "foundation/math/scalar.h"
+#include "foundation/utility/job/abortswitch.h"
+
+// Standard headers.
+#include <cassert>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    class RadianceSampler
+    {
+      public:
+        RadianceSampler(
+            const EnvironmentEDF&   edf,
+            InputEvaluator&         input_evaluator,
+            vector<Spectrum>&       radiance,
+            const size_t            width,
+            const size_t            height)
+          : m_edf(edf)
+          , m_input_evaluator(input_evaluator)
+          , m_radiance(radiance)
+          , m_width(width)
+          , m_rcp_width(1.0 / width)
+          , m_rcp_height(1.0 / height)
+        {
+        }
+
+        void sample(const size_t x, const size_t y, size_t& payload, double& importance)
+        {
+            payload = x;
+
+            // Compute the direction corresponding to the center of this texel.
+            double theta, phi;
+            unit_square_to_angles(
+                (x + 0.5) * m_rcp_width,
+                (y + 0.5) * m_rcp_height,
+                theta,
+                phi);
+            const Vector3d outgoing = Vector3d::unit_vector(theta, phi);
+
+            // Evaluate and store the radiance emitted in this direction.
+            Spectrum& value = m_radiance[y * m_width + x];
+            m_edf.evaluate(m_input_evaluator, outgoing, value);
+
+            // Texels near the poles subtend smaller solid angles.
+            importance =
+                  max(static_cast<double>(sum_value(value * XYZCMFCIE19312Deg[1])), 0.0)
+                * sin(theta);
+        }
+
+      private:
+        const EnvironmentEDF&   m_edf;
+        InputEvaluator&         m_input_evaluator;
+        vector<Spectrum>&       m_radiance;
+        const size_t            m_width;
+        const double            m_rcp_width;
+        const double            m_rcp_height;
+    };
+}
+
+
+//
+// BakedEnvironmentMap class implementation.
+//
+
+BakedEnvironmentMap::BakedEnvironmentMap(
+    const size_t                width,
+    const size_t                height)
+  : m_width(width)
+  , m_height(height)
+  , m_rcp_width(1.0 / width)
+  , m_rcp_height(1.0 / height)
+  , m_probability_scale((width * height) / (2.0 * Pi * Pi))
+{
+    assert(width > 0);
+    assert(height > 0);
+}
+
+bool BakedEnvironmentMap::bake(
+    const EnvironmentEDF&       edf,
+    const Scene&                scene,
+    AbortSwitch*                abort_switch)
+{
+    RENDERER_LOG_INFO(
+        "baking " FMT_SIZE_T "x" FMT_SIZE_T " radiance table for environment edf \"%s\"...",
+        m_width,
+        m_height,
+        edf.get_name());
+
+    m_radiance.resize(m_width * m_height);
+
+    TextureStore texture_store(scene);
+    TextureCache texture_cache(texture_store);
+    InputEvaluator input_evaluator(texture_cache);
+    RadianceSampler sampler(edf, input_evaluator, m_radiance, m_width, m_height);
+
+    m_importance_sampler.reset(new ImageImportanceSamplerType(m_width, m_height));
+    m_importance_sampler->rebuild(sampler, abort_switch);
+
+    if (is_aborted(abort_switch))
+    {
+        m_importance_sampler.reset();
+        m_radiance.clear();
+        return false;
+    }
+
+    RENDERER_LOG_INFO(
+        "baked radiance table for environment edf \"%s\".",
+        edf.get_name());
+
+    return true;
+}
+
+void BakedEnvironmentMap::sample(
+    const Vector2d&             s,
+    Vector3d&                   outgoing,
+    Spectrum&                   value,
+    double&                     probability) const
+{
+    assert(m_importance_sampler.get());
+
+    // Sample the importance map.
+    size_t x, y;
+    double prob_xy;
+    m_importance_sampler->sample(s, x, y, prob_xy);
+
+    // Compute the world space emission direction.
+    double theta, phi;
+    unit_square_to_angles(
+        (x + 0.5) * m_rcp_width,
+        (y + 0.5) * m_rcp_height,
+        theta,
+        phi);
+    outgoing = Vector3d::unit_vector(theta, phi);
+
+    // The interpolated radiance at the center of a texel is the value of that texel.
+    value = m_radiance[y * m_width + x];
+
+    // Compute the probability density of this direction.
+    probability = prob_xy * m_probability_scale / sin(theta);
+}
+
+void BakedEnvironmentMap::evaluate(
+    const Vector3d&             outgoing,
+    Spectrum&                   value) const
+{
+    assert(is_normalized(outgoing));
+    assert(!m_radiance.empty());
+
+    double theta, phi;
+    unit_vector_to_angles(outgoing, theta, phi);
+
+    double u, v;
+    angles_to_unit_square(theta, phi, u, v);
+
+    // Compute the coordinates of the four texels surrounding the lookup point.
+    // The table wraps around horizontally and is clamped vertically.
+    const double fx = u * m_width - 0.5;
+    const double fy = clamp(v * m_height - 0.5, 0.0, static_cast<double>(m_height - 1));
+    const double floor_fx = floor(fx);
+    const size_t x0 = static_cast<size_t>(floor_fx + m_width) % m_width;
+    const size_t x1 = x0 + 1 < m_width ? x0 + 1 : 0;
+    const size_t y0 = truncate<size_t>(fy);
+    const size_t y1 = min(y0 + 1, m_height - 1);
+    const float wx = static_cast<float>(fx - floor_fx);
+    const float wy = static_cast<float>(fy - y0);
+
+    // Bilinearly interpolate the radiance.
+    Spectrum top = m_radiance[y0 * m_width + x0];
+    top *= 1.0f - wx;
+    top += m_radiance[y0 * m_width + x1] * wx;
+
+    Spectrum bottom = m_radiance[y1 * m_width + x0];
+    bottom *= 1.0f - wx;
+    bottom += m_radiance[y1 * m_width + x1] * wx;
+
+    value = top;
+    value *= 1.0f - wy;
+    value += bottom * wy;
+}
+
+double BakedEnvironmentMap::evaluate_pdf(const Vector3d& outgoing) const
+{
+    assert(is_normalized(outgoing));
+    assert(m_importance_sampler.get());
+
+    double theta, phi;
+    unit_vector_to_angles(outgoing, theta, phi);
+
+    double u, v;
+    angles_to_unit_square(theta, phi, u, v);
+
+    const size_t x = min(truncate<size_t>(u * m_width), m_width - 1);
+    const size_t y = min(truncate<size_t>(v * m_height), m_height - 1);
+
+    const double sin_theta = sin(theta);
+
+    if (sin_theta == 0.0)
+        return 0.0;
+
+    const double prob_xy = m_importance_sampler->get_pdf(x, y);
+
+    return prob_xy * m_probability_scale / sin_theta;
+}
+
+}   // namespace renderer
@@ -0,0 +1,107 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_BAKEDENVIRONMENTMAP_H
+#define APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_BAKEDENVIRONMENTMAP_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/imageimportancesampler.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class AbortSwitch; }
+namespace renderer      { class EnvironmentEDF; }
+namespace renderer      { class Scene; }
+
+namespace renderer
+{
+
+//
+// A latitude-longitude table of the radiance emitted by an environment EDF,
+// together with an importance sampler following its luminance distribution.
+//
+// It allows to replace the costly evaluation of analytic environment models
+// by a table lookup, and their sampling by importance sampling.
+//
+
+class BakedEnvironmentMap
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    BakedEnvironmentMap(
+        const size_t                width,
+        const size_t                height);
+
+    // Tabulate the radiance of a given environment EDF.
+    // Returns true on success, false if baking was aborted.
+    bool bake(
+        const EnvironmentEDF&       edf,
+        const Scene&                scene,
+        foundation::AbortSwitch*    abort_switch = 0);
+
+    // Sample the table.
+    void sample(
+        const foundation::Vector2d& s,
+        foundation::Vector3d&       outgoing,
+        Spectrum&                   value,
+        double&                     probability) const;
+
+    // Look up the table for a given direction.
+    void evaluate(
+        const foundation::Vector3d& outgoing,
+        Spectrum&                   value) const;
+
+    // Return the probability density of a given direction.
+    double evaluate_pdf(const foundation::Vector3d& outgoing) const;
+
+  private:
+    typedef ImageImportanceSampler<size_t, double> ImageImportanceSamplerType;
+
+    const size_t                    m_width;
+    const size_t                    m_height;
+    const double                    m_rcp_width;
+    const double                    m_rcp_height;
+    const double                    m_probability_scale;
+
+    std::vector<Spectrum>           m_radiance;
+    std::auto_ptr<ImageImportanceSamplerType> m_importance_sampler;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_BAKEDENVIRONMENTMAP_H
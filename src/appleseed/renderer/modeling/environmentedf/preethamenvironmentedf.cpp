@@ -31,12 +31,16 @@
 #include "preethamenvironmentedf.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
 #include "renderer/global/globaltypes.h"
+#include "renderer/modeling/environmentedf/bakedenvironmentmap.h"
 #include "renderer/modeling/environmentedf/environmentedf.h"
 #include "renderer/modeling/environmentedf/sphericalcoordinates.h"
 #include "renderer/modeling/input/inputarray.h"
 #include "renderer/modeling/input/inputevaluator.h"
 #include "renderer/modeling/input/source.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
@@ -49,8 +53,11 @@
 #include "foundation/utility/containers/dictionary.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
@@ -146,6 +153,25 @@ namespace
                 m_uniform_Y_zenith = compute_zenith_Y(m_uniform_values.m_turbidity, m_sun_theta);
             }
 
+            // Optionally bake the sky into a radiance table.
+            m_baked_map.reset();
+            if (m_params.get_optional<bool>("bake", false))
+            {
+                if (m_uniform_turbidity)
+                {
+                    const size_t width = max(m_params.get_optional<size_t>("bake_resolution", 512), size_t(2));
+                    auto_ptr<BakedEnvironmentMap> baked_map(new BakedEnvironmentMap(width, width / 2));
+                    if (baked_map->bake(*this, *project.get_scene(), abort_switch))
+                        m_baked_map = baked_map;
+                }
+                else
+                {
+                    RENDERER_LOG_WARNING(
+                        "while preparing environment edf \"%s\": turbidity is not uniform, the sky will not be baked.",
+                        get_name());
+                }
+            }
+
             return true;
         }
 
@@ -156,6 +182,12 @@ namespace
             Spectrum&           value,
             double&             probability) const OVERRIDE
         {
+            if (m_baked_map.get())
+            {
+                m_baked_map->sample(s, outgoing, value, probability);
+                return;
+            }
+
             outgoing = sample_hemisphere_cosine(s);
 
             const Vector3d shifted_outgoing = shift(outgoing);
@@ -173,6 +205,12 @@ namespace
         {
             assert(is_normalized(outgoing));
 
+            if (m_baked_map.get())
+            {
+                m_baked_map->evaluate(outgoing, value);
+                return;
+            }
+
             const Vector3d shifted_outgoing = shift(outgoing);
             if (shifted_outgoing.y > 0.0)
                 compute_sky_radiance(input_evaluator, shifted_outgoing, value);
@@ -187,6 +225,13 @@ namespace
         {
             assert(is_normalized(outgoing));
 
+            if (m_baked_map.get())
+            {
+                m_baked_map->evaluate(outgoing, value);
+                probability = m_baked_map->evaluate_pdf(outgoing);
+                return;
+            }
+
             const Vector3d shifted_outgoing = shift(outgoing);
             if (shifted_outgoing.y > 0.0)
                 compute_sky_radiance(input_evaluator, shifted_outgoing, value);
@@ -201,6 +246,9 @@ namespace
         {
             assert(is_normalized(outgoing));
 
+            if (m_baked_map.get())
+                return m_baked_map->evaluate_pdf(outgoing);
+
             return outgoing.y > 0.0 ? outgoing.y * RcpPi : 0.0;
         }
 
@@ -234,6 +282,8 @@ namespace
         double                      m_uniform_y_zenith;
         double                      m_uniform_Y_zenith;
 
+        auto_ptr<BakedEnvironmentMap> m_baked_map;
+
         // Compute the coefficients of the luminance distribution function.
         static void compute_Y_coefficients(
             const double        turbidity,
@@ -520,6 +570,22 @@ DictionaryArray PreethamEnvironmentEDFFactory::get_input_metadata() const
             .insert("use", "optional")
             .insert("default", "0.0"));
 
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "bake")
+            .insert("label", "Bake Sky")
+            .insert("type", "boolean")
+            .insert("use", "optional")
+            .insert("default", "false"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "bake_resolution")
+            .insert("label", "Baked Sky Horizontal Resolution")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", "512"));
+
     return metadata;
 }
 
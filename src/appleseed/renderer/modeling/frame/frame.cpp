@@ -52,10 +52,13 @@
 #ifdef APPLESEED_USE_SSE
 #include "foundation/platform/sse.h"
 #endif
+#include "foundation/platform/system.h"
 #include "foundation/platform/timer.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/containers/specializedarrays.h"
 #include "foundation/utility/iostreamop.h"
+#include "foundation/utility/job.h"
 #include "foundation/utility/otherwise.h"
 #include "foundation/utility/stopwatch.h"
 #include "foundation/utility/string.h"
@@ -64,6 +67,7 @@
 #include "boost/filesystem/path.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <string>
@@ -289,7 +293,7 @@ namespace
     >
     void transform_float_tile(Tile& tile, const float rcp_target_gamma)
     {
-        assert(ColorSpace == ColorSpaceLinearRGB || ColorSpace == ColorSpaceSRGB);
+        assert(tile.get_pixel_format() == PixelFormatFloat);
         assert(tile.get_channel_count() == 4);
 
         float* pixel_ptr = reinterpret_cast<float*>(tile.pixel(0));
@@ -302,8 +306,18 @@ namespace
             __m128 original_color = color;
 
             // Apply color space conversion.
-            if (ColorSpace == ColorSpaceSRGB)
+            switch (ColorSpace)
+            {
+              case ColorSpaceSRGB:
                 color = fast_linear_rgb_to_srgb(color);
+                break;
+
+              case ColorSpaceCIEXYZ:
+                color = linear_rgb_to_ciexyz(color);
+                break;
+
+              default:;
+            }
 
             // Apply clamping.
             // todo: mark clamped pixels in the diagnostic map.
@@ -328,7 +342,7 @@ namespace
     >
     void transform_float_tile(Tile& tile, const float rcp_target_gamma)
     {
-        assert(ColorSpace == ColorSpaceLinearRGB || ColorSpace == ColorSpaceSRGB);
+        assert(tile.get_pixel_format() == PixelFormatFloat);
         assert(tile.get_channel_count() == 4);
 
         Color4f* pixel_ptr = reinterpret_cast<Color4f*>(tile.pixel(0));
@@ -340,8 +354,18 @@ namespace
             Color4f color(*pixel_ptr);
 
             // Apply color space conversion.
-            if (ColorSpace == ColorSpaceSRGB)
+            switch (ColorSpace)
+            {
+              case ColorSpaceSRGB:
                 color.rgb() = fast_linear_rgb_to_srgb(color.rgb());
+                break;
+
+              case ColorSpaceCIEXYZ:
+                color.rgb() = linear_rgb_to_ciexyz(color.rgb());
+                break;
+
+              default:;
+            }
 
             // Apply clamping.
             // todo: mark clamped pixels in the diagnostic map.
@@ -362,52 +386,131 @@ namespace
     }
 
 #endif
+
+    template <
+        int  ColorSpace,
+        bool Clamp,
+        bool GammaCorrect
+    >
+    void transform_uint8_tile(Tile& tile, const float rcp_target_gamma)
+    {
+        assert(ColorSpace == ColorSpaceLinearRGB || ColorSpace == ColorSpaceSRGB);
+        assert(tile.get_pixel_format() == PixelFormatUInt8);
+        assert(tile.get_channel_count() == 4);
+
+        // With 8-bit channels and a transformation that operates on each channel
+        // independently, all possible outcomes fit in a 256-entry lookup table.
+        uint8 table[256];
+        for (size_t i = 0; i < 256; ++i)
+        {
+            float c = static_cast<float>(i) * (1.0f / 255);
+
+            if (ColorSpace == ColorSpaceSRGB)
+                c = fast_linear_rgb_to_srgb(c);
+
+            if (Clamp)
+                c = saturate(c);
+
+            if (GammaCorrect)
+                c = fast_pow(c, rcp_target_gamma);
+
+            // Same conversion as foundation::Pixel::convert_to_format().
+            table[i] = truncate<uint8>(clamp(c * 256.0f, 0.0f, 255.0f));
+        }
+
+        uint8* pixel_ptr = tile.pixel(0);
+        uint8* pixel_end = pixel_ptr + tile.get_pixel_count() * 4;
+
+        // Leave the alpha channel unmodified.
+        for (; pixel_ptr < pixel_end; pixel_ptr += 4)
+        {
+            pixel_ptr[0] = table[pixel_ptr[0]];
+            pixel_ptr[1] = table[pixel_ptr[1]];
+            pixel_ptr[2] = table[pixel_ptr[2]];
+        }
+    }
+
+    class TransformTileRowJob
+      : public IJob
+    {
+      public:
+        TransformTileRowJob(
+            const Frame&    frame,
+            Image&          image,
+            const size_t    tile_y)
+          : m_frame(frame)
+          , m_image(image)
+          , m_tile_y(tile_y)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) OVERRIDE
+        {
+            const size_t tile_count_x = m_image.properties().m_tile_count_x;
+
+            for (size_t tx = 0; tx < tile_count_x; ++tx)
+                m_frame.transform_to_output_color_space(m_image.tile(tx, m_tile_y));
+        }
+
+      private:
+        const Frame&        m_frame;
+        Image&              m_image;
+        const size_t        m_tile_y;
+    };
 }
 
 void Frame::transform_to_output_color_space(Tile& tile) const
 {
-    #define TRANSFORM_GENERIC_TILE(ColorSpace)                                                      \
-        if (impl->m_clamp)                                                                          \
-        {                                                                                           \
-            if (impl->m_target_gamma != 1.0f)                                                       \
-                transform_generic_tile<ColorSpace, true, true>(tile, impl->m_rcp_target_gamma);     \
-            else transform_generic_tile<ColorSpace, true, false>(tile, impl->m_rcp_target_gamma);   \
-        }                                                                                           \
-        else                                                                                        \
-        {                                                                                           \
-            if (impl->m_target_gamma != 1.0f)                                                       \
-                transform_generic_tile<ColorSpace, false, true>(tile, impl->m_rcp_target_gamma);    \
-            else transform_generic_tile<ColorSpace, false, false>(tile, impl->m_rcp_target_gamma);  \
+    #define TRANSFORM_TILE(Function, ColorSpace)                                                \
+        if (impl->m_clamp)                                                                      \
+        {                                                                                       \
+            if (impl->m_target_gamma != 1.0f)                                                   \
+                Function<ColorSpace, true, true>(tile, impl->m_rcp_target_gamma);               \
+            else Function<ColorSpace, true, false>(tile, impl->m_rcp_target_gamma);             \
+        }                                                                                       \
+        else                                                                                    \
+        {                                                                                       \
+            if (impl->m_target_gamma != 1.0f)                                                   \
+                Function<ColorSpace, false, true>(tile, impl->m_rcp_target_gamma);              \
+            else Function<ColorSpace, false, false>(tile, impl->m_rcp_target_gamma);            \
         }
 
-    #define TRANSFORM_FLOAT_TILE(ColorSpace)                                                        \
-        if (impl->m_clamp)                                                                          \
-        {                                                                                           \
-            if (impl->m_target_gamma != 1.0f)                                                       \
-                transform_float_tile<ColorSpace, true, true>(tile, impl->m_rcp_target_gamma);       \
-            else transform_float_tile<ColorSpace, true, false>(tile, impl->m_rcp_target_gamma);     \
-        }                                                                                           \
-        else                                                                                        \
-        {                                                                                           \
-            if (impl->m_target_gamma != 1.0f)                                                       \
-                transform_float_tile<ColorSpace, false, true>(tile, impl->m_rcp_target_gamma);      \
-            else transform_float_tile<ColorSpace, false, false>(tile, impl->m_rcp_target_gamma);    \
-        }
+    if (is_output_color_space_transform_identity())
+        return;
+
+    // Dispatch on the format of the tile rather than on the format of the frame
+    // since callers may hand us tiles that were converted to another format.
+    const PixelFormat pixel_format = tile.get_pixel_format();
 
-    if (impl->m_pixel_format == PixelFormatFloat)
+    if (pixel_format == PixelFormatFloat)
     {
         switch (m_color_space)
         {
           case ColorSpaceLinearRGB:
-            TRANSFORM_FLOAT_TILE(ColorSpaceLinearRGB);
+            TRANSFORM_TILE(transform_float_tile, ColorSpaceLinearRGB);
             break;
 
           case ColorSpaceSRGB:
-            TRANSFORM_FLOAT_TILE(ColorSpaceSRGB);
+            TRANSFORM_TILE(transform_float_tile, ColorSpaceSRGB);
             break;
 
           case ColorSpaceCIEXYZ:
-            TRANSFORM_GENERIC_TILE(ColorSpaceCIEXYZ);
+            TRANSFORM_TILE(transform_float_tile, ColorSpaceCIEXYZ);
+            break;
+
+          assert_otherwise;
+        }
+    }
+    else if (pixel_format == PixelFormatUInt8 && m_color_space != ColorSpaceCIEXYZ)
+    {
+        switch (m_color_space)
+        {
+          case ColorSpaceLinearRGB:
+            TRANSFORM_TILE(transform_uint8_tile, ColorSpaceLinearRGB);
+            break;
+
+          case ColorSpaceSRGB:
+            TRANSFORM_TILE(transform_uint8_tile, ColorSpaceSRGB);
             break;
 
           assert_otherwise;
@@ -418,34 +521,60 @@ void Frame::transform_to_output_color_space(Tile& tile) const
         switch (m_color_space)
         {
           case ColorSpaceLinearRGB:
-            TRANSFORM_GENERIC_TILE(ColorSpaceLinearRGB);
+            TRANSFORM_TILE(transform_generic_tile, ColorSpaceLinearRGB);
             break;
 
           case ColorSpaceSRGB:
-            TRANSFORM_GENERIC_TILE(ColorSpaceSRGB);
+            TRANSFORM_TILE(transform_generic_tile, ColorSpaceSRGB);
             break;
 
           case ColorSpaceCIEXYZ:
-            TRANSFORM_GENERIC_TILE(ColorSpaceCIEXYZ);
+            TRANSFORM_TILE(transform_generic_tile, ColorSpaceCIEXYZ);
             break;
 
           assert_otherwise;
         }
     }
 
-    #undef TRANSFORM_FLOAT_TILE
-    #undef TRANSFORM_GENERIC_TILE
+    #undef TRANSFORM_TILE
 }
 
 void Frame::transform_to_output_color_space(Image& image) const
 {
+    if (is_output_color_space_transform_identity())
+        return;
+
     const CanvasProperties& image_props = image.properties();
+    const size_t thread_count =
+        min(System::get_logical_cpu_core_count(), image_props.m_tile_count_y);
 
-    for (size_t ty = 0; ty < image_props.m_tile_count_y; ++ty)
+    if (thread_count <= 1)
     {
-        for (size_t tx = 0; tx < image_props.m_tile_count_x; ++tx)
-            transform_to_output_color_space(image.tile(tx, ty));
+        for (size_t ty = 0; ty < image_props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < image_props.m_tile_count_x; ++tx)
+                transform_to_output_color_space(image.tile(tx, ty));
+        }
+
+        return;
     }
+
+    // Transform rows of tiles in parallel.
+    JobQueue job_queue;
+    for (size_t ty = 0; ty < image_props.m_tile_count_y; ++ty)
+        job_queue.schedule(new TransformTileRowJob(*this, image, ty));
+
+    JobManager job_manager(global_logger(), job_queue, thread_count);
+    job_manager.start();
+    job_queue.wait_until_completion();
+}
+
+bool Frame::is_output_color_space_transform_identity() const
+{
+    return
+        m_color_space == ColorSpaceLinearRGB &&
+        !impl->m_clamp &&
+        impl->m_target_gamma == 1.0f;
 }
 
 void Frame::clear_main_image()
@@ -457,12 +586,16 @@ bool Frame::write_main_image(const char* file_path) const
 {
     assert(file_path);
 
-    Image transformed_image(*impl->m_image);
-    transform_to_output_color_space(transformed_image);
-
     const ImageAttributes image_attributes =
         ImageAttributes::create_default_attributes();
 
+    // Avoid copying the main image when there is nothing to transform.
+    if (is_output_color_space_transform_identity())
+        return write_image(file_path, *impl->m_image, image_attributes);
+
+    Image transformed_image(*impl->m_image);
+    transform_to_output_color_space(transformed_image);
+
     return write_image(file_path, transformed_image, image_attributes);
 }
 
@@ -518,14 +651,17 @@ bool Frame::archive(
     if (output_path)
         *output_path = duplicate_string(file_path.c_str());
 
+    const ImageAttributes image_attributes =
+        ImageAttributes::create_default_attributes();
+
+    // Avoid copying the main image when there is nothing to transform.
+    if (is_output_color_space_transform_identity())
+        return write_image(file_path.c_str(), *impl->m_image, image_attributes);
+
     Image transformed_image(*impl->m_image);
     transform_to_output_color_space(transformed_image);
 
-    return
-        write_image(
-            file_path.c_str(),
-            transformed_image,
-            ImageAttributes::create_default_attributes());
+    return write_image(file_path.c_str(), transformed_image, image_attributes);
 }
 
 void Frame::extract_parameters()
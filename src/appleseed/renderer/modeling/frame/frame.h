@@ -105,9 +105,13 @@ class DLLSYMBOL Frame
     const foundation::AABB2u& get_crop_window() const;
 
     // Convert a tile or an image from linear RGB to the output color space.
+    // Images are converted in place, using one thread per logical core.
     void transform_to_output_color_space(foundation::Tile& tile) const;
     void transform_to_output_color_space(foundation::Image& image) const;
 
+    // Return true if the conversion to the output color space leaves pixels unchanged.
+    bool is_output_color_space_transform_identity() const;
+
     // Return the normalized device coordinates of a given sample.
     foundation::Vector2d get_sample_position(
         const double    sample_x,               // x coordinate of the sample in the image, in [0,width)
@@ -34,8 +34,12 @@
 #include "renderer/modeling/input/inputarray.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/arena.h"
+#include "foundation/utility/memory.h"
 
 // Standard headers.
 #include <cstddef>
@@ -51,11 +55,22 @@ namespace renderer
 //
 
 class InputEvaluator
+  : public foundation::NonCopyable
 {
   public:
-    // Constructor.
+    // Constructor. The storage for the input values is allocated from the heap.
     explicit InputEvaluator(TextureCache& texture_cache);
 
+    // Constructor. The storage for the input values is allocated from an arena
+    // and returned to it upon destruction, so input evaluators sharing an arena
+    // must be destroyed in the reverse order of their construction.
+    InputEvaluator(
+        TextureCache&               texture_cache,
+        foundation::Arena&          arena);
+
+    // Destructor.
+    ~InputEvaluator();
+
     // Evaluate a set of inputs, and return the values as an opaque block of memory.
     const void* evaluate(
         const InputArray&           inputs,
@@ -74,8 +89,10 @@ class InputEvaluator
     enum { DataSize = 8 * 1024 }; // bytes
 
   private:
-    SSE_ALIGN foundation::uint8     m_data[DataSize];
     TextureCache&                   m_texture_cache;
+    foundation::Arena*              m_arena;
+    foundation::Arena::Marker       m_arena_marker;
+    foundation::uint8*              m_data;
 };
 
 
@@ -85,7 +102,26 @@ class InputEvaluator
 
 inline InputEvaluator::InputEvaluator(TextureCache& texture_cache)
   : m_texture_cache(texture_cache)
+  , m_arena(0)
+  , m_data(static_cast<foundation::uint8*>(foundation::aligned_malloc(DataSize, 16)))
+{
+}
+
+inline InputEvaluator::InputEvaluator(
+    TextureCache&                   texture_cache,
+    foundation::Arena&              arena)
+  : m_texture_cache(texture_cache)
+  , m_arena(&arena)
+  , m_arena_marker(arena.get_marker())
+  , m_data(static_cast<foundation::uint8*>(arena.allocate(DataSize)))
+{
+}
+
+inline InputEvaluator::~InputEvaluator()
 {
+    if (m_arena)
+        m_arena->release(m_arena_marker);
+    else foundation::aligned_free(m_data);
 }
 
 inline const void* InputEvaluator::evaluate(
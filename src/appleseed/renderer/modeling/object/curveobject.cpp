@@ -0,0 +1,278 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "curveobject.h"
+
+// appleseed.renderer headers.
+#include "renderer/utility/messagecontext.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+#include "foundation/utility/makevector.h"
+
+// Standard headers.
+#include <cassert>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// CurveObject class implementation.
+//
+
+namespace
+{
+    struct Curve
+    {
+        uint32  m_first_vertex;
+        uint32  m_vertex_count;
+        uint32  m_first_segment;
+    };
+}
+
+struct CurveObject::Impl
+{
+    Basis                       m_basis;
+    vector<GVector3>            m_vertices;
+    vector<GScalar>             m_vertex_widths;
+    vector<Curve>               m_curves;
+    vector<uint32>              m_segment_curves;       // index of the curve of each segment
+    RegionKit                   m_region_kit;
+    mutable Lazy<RegionKit>     m_lazy_region_kit;
+    vector<string>              m_material_slots;
+
+    Impl()
+      : m_lazy_region_kit(&m_region_kit)
+    {
+    }
+
+    size_t get_degree() const
+    {
+        return m_basis == BasisLinear ? 1 : 3;
+    }
+};
+
+CurveObject::CurveObject(
+    const char*         name,
+    const ParamArray&   params)
+  : Object(name, params)
+  , impl(new Impl())
+{
+    const EntityDefMessageContext message_context("object", this);
+    const string basis =
+        params.get_optional<string>(
+            "basis",
+            "bspline",
+            make_vector("linear", "bspline"),
+            message_context);
+    impl->m_basis = basis == "linear" ? BasisLinear : BasisBSpline;
+}
+
+CurveObject::~CurveObject()
+{
+    delete impl;
+}
+
+void CurveObject::release()
+{
+    delete this;
+}
+
+const char* CurveObject::get_model() const
+{
+    return CurveObjectFactory::get_model();
+}
+
+GAABB3 CurveObject::compute_local_bbox() const
+{
+    GAABB3 bbox;
+    bbox.invalidate();
+
+    const size_t segment_count = get_segment_count();
+
+    for (size_t i = 0; i < segment_count; ++i)
+        bbox.insert(get_segment(i).compute_bbox());
+
+    return bbox;
+}
+
+Lazy<RegionKit>& CurveObject::get_region_kit()
+{
+    return impl->m_lazy_region_kit;
+}
+
+CurveObject::Basis CurveObject::get_basis() const
+{
+    return impl->m_basis;
+}
+
+void CurveObject::reserve_vertices(const size_t count)
+{
+    impl->m_vertices.reserve(count);
+    impl->m_vertex_widths.reserve(count);
+}
+
+size_t CurveObject::push_vertex(const GVector3& vertex, const GScalar width)
+{
+    assert(width >= GScalar(0.0));
+
+    const size_t index = impl->m_vertices.size();
+    impl->m_vertices.push_back(vertex);
+    impl->m_vertex_widths.push_back(width);
+    return index;
+}
+
+size_t CurveObject::get_vertex_count() const
+{
+    return impl->m_vertices.size();
+}
+
+const GVector3& CurveObject::get_vertex(const size_t index) const
+{
+    assert(index < impl->m_vertices.size());
+    return impl->m_vertices[index];
+}
+
+GScalar CurveObject::get_vertex_width(const size_t index) const
+{
+    assert(index < impl->m_vertex_widths.size());
+    return impl->m_vertex_widths[index];
+}
+
+void CurveObject::reserve_curves(const size_t count)
+{
+    impl->m_curves.reserve(count);
+}
+
+size_t CurveObject::push_curve(const size_t first_vertex, const size_t vertex_count)
+{
+    assert(first_vertex + vertex_count <= impl->m_vertices.size());
+
+    const size_t index = impl->m_curves.size();
+
+    Curve curve;
+    curve.m_first_vertex = static_cast<uint32>(first_vertex);
+    curve.m_vertex_count = static_cast<uint32>(vertex_count);
+    curve.m_first_segment = static_cast<uint32>(impl->m_segment_curves.size());
+    impl->m_curves.push_back(curve);
+
+    // Curves with too few vertices have no segments.
+    const size_t degree = impl->get_degree();
+    if (vertex_count > degree)
+        impl->m_segment_curves.insert(impl->m_segment_curves.end(), vertex_count - degree, static_cast<uint32>(index));
+
+    return index;
+}
+
+size_t CurveObject::get_curve_count() const
+{
+    return impl->m_curves.size();
+}
+
+size_t CurveObject::get_segment_count() const
+{
+    return impl->m_segment_curves.size();
+}
+
+GCurve3 CurveObject::get_segment(const size_t index) const
+{
+    assert(index < impl->m_segment_curves.size());
+
+    const Curve& curve = impl->m_curves[impl->m_segment_curves[index]];
+    const size_t first_vertex = curve.m_first_vertex + index - curve.m_first_segment;
+    const GVector3* vertices = &impl->m_vertices[first_vertex];
+    const GScalar* widths = &impl->m_vertex_widths[first_vertex];
+
+    return
+        impl->m_basis == BasisLinear
+            ? GCurve3::from_linear(vertices[0], vertices[1], widths[0], widths[1])
+            : GCurve3::from_bspline(vertices, widths);
+}
+
+GVector2 CurveObject::get_segment_param_range(const size_t index) const
+{
+    assert(index < impl->m_segment_curves.size());
+
+    const Curve& curve = impl->m_curves[impl->m_segment_curves[index]];
+    const GScalar rcp_segment_count =
+        GScalar(1.0) / static_cast<GScalar>(curve.m_vertex_count - impl->get_degree());
+    const GScalar begin = static_cast<GScalar>(index - curve.m_first_segment) * rcp_segment_count;
+
+    return GVector2(begin, begin + rcp_segment_count);
+}
+
+void CurveObject::reserve_material_slots(const size_t count)
+{
+    impl->m_material_slots.reserve(count);
+}
+
+size_t CurveObject::push_material_slot(const char* name)
+{
+    const size_t index = impl->m_material_slots.size();
+    impl->m_material_slots.push_back(name);
+    return index;
+}
+
+size_t CurveObject::get_material_slot_count() const
+{
+    return impl->m_material_slots.size();
+}
+
+const char* CurveObject::get_material_slot(const size_t index) const
+{
+    return impl->m_material_slots[index].c_str();
+}
+
+
+//
+// CurveObjectFactory class implementation.
+//
+
+const char* CurveObjectFactory::get_model()
+{
+    return "curve_object";
+}
+
+auto_release_ptr<CurveObject> CurveObjectFactory::create(
+    const char*         name,
+    const ParamArray&   params)
+{
+    return
+        auto_release_ptr<CurveObject>(
+            new CurveObject(name, params));
+}
+
+}   // namespace renderer
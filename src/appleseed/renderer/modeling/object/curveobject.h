@@ -0,0 +1,161 @@
+
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_OBJECT_CURVEOBJECT_H
+#define APPLESEED_RENDERER_MODELING_OBJECT_CURVEOBJECT_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/regionkit.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/beziercurve.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/lazy.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace renderer  { class ParamArray; }
+
+namespace renderer
+{
+
+//
+// Curve segment in Bezier form.
+//
+
+typedef foundation::BezierCurve3<GScalar> GCurve3;
+
+
+//
+// Curve object (source geometry), used to represent hair and fur.
+//
+// Curves are rendered as flat ribbons that always face the incoming ray,
+// with a width interpolated from the widths of their control vertices.
+// Each curve references a range of consecutive vertices. With the B-spline
+// basis, a curve with N vertices has N - 3 segments and does not pass through
+// its first and last vertices; duplicate them to pin the curve to its ends.
+//
+// Curve objects have no triangles: their region kit is empty.
+//
+
+class DLLSYMBOL CurveObject
+  : public Object
+{
+  public:
+    // Curve basis.
+    enum Basis
+    {
+        BasisLinear,                                        // polylines
+        BasisBSpline                                        // uniform cubic B-splines
+    };
+
+    // Delete this instance.
+    virtual void release() OVERRIDE;
+
+    // Return a string identifying the model of this object.
+    virtual const char* get_model() const OVERRIDE;
+
+    // Compute the local space bounding box of the object over the shutter interval.
+    virtual GAABB3 compute_local_bbox() const OVERRIDE;
+
+    // Return the region kit of the object.
+    virtual foundation::Lazy<RegionKit>& get_region_kit() OVERRIDE;
+
+    // Return the basis of the curves.
+    Basis get_basis() const;
+
+    // Insert and access vertices.
+    void reserve_vertices(const size_t count);
+    size_t push_vertex(const GVector3& vertex, const GScalar width);
+    size_t get_vertex_count() const;
+    const GVector3& get_vertex(const size_t index) const;
+    GScalar get_vertex_width(const size_t index) const;
+
+    // Insert and access curves.
+    void reserve_curves(const size_t count);
+    size_t push_curve(const size_t first_vertex, const size_t vertex_count);
+    size_t get_curve_count() const;
+
+    // Access curve segments.
+    size_t get_segment_count() const;
+    GCurve3 get_segment(const size_t index) const;
+
+    // Return the range of the parameter of its curve spanned by a given segment.
+    // The curve parameter goes from 0 at the first vertex to 1 at the last one.
+    GVector2 get_segment_param_range(const size_t index) const;
+
+    // Insert and access material slots.
+    void reserve_material_slots(const size_t count);
+    size_t push_material_slot(const char* name);
+    virtual size_t get_material_slot_count() const OVERRIDE;
+    virtual const char* get_material_slot(const size_t index) const OVERRIDE;
+
+  private:
+    friend class CurveObjectFactory;
+
+    struct Impl;
+    Impl* impl;
+
+    // Constructor.
+    CurveObject(
+        const char*         name,
+        const ParamArray&   params);
+
+    // Destructor.
+    ~CurveObject();
+};
+
+
+//
+// Curve object factory.
+//
+
+class DLLSYMBOL CurveObjectFactory
+{
+  public:
+    // Return a string identifying this object model.
+    static const char* get_model();
+
+    // Create a new curve object.
+    static foundation::auto_release_ptr<CurveObject> create(
+        const char*         name,
+        const ParamArray&   params);
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_OBJECT_CURVEOBJECT_H
@@ -82,6 +82,9 @@
 #include "renderer/modeling/texture/itexturefactory.h"
 #include "renderer/modeling/texture/texture.h"
 #include "renderer/modeling/texture/texturefactoryregistrar.h"
+#include "renderer/modeling/volume/ivolumefactory.h"
+#include "renderer/modeling/volume/volume.h"
+#include "renderer/modeling/volume/volumefactoryregistrar.h"
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
@@ -392,7 +395,8 @@ namespace
         ElementTextureInstance,
         ElementTransform,
         ElementTranslation,
-        ElementValues
+        ElementValues,
+        ElementVolume
     };
 
     typedef IElementHandler<ProjectElementID> ElementHandlerType;
@@ -1482,6 +1486,39 @@ namespace
     };
 
 
+    //
+    // <volume> element handler.
+    //
+
+    class VolumeElementHandler
+      : public EntityElementHandler<
+                   Volume,
+                   VolumeFactoryRegistrar,
+                   TransformSequenceElementHandler<ParametrizedElementHandler> >
+    {
+      public:
+        explicit VolumeElementHandler(ParseContext& context)
+          : Base("volume", context)
+        {
+        }
+
+        virtual void end_element() OVERRIDE
+        {
+            Base::end_element();
+
+            if (m_entity.get())
+                m_entity->set_transform(get_earliest_transform());
+        }
+
+      private:
+        typedef EntityElementHandler<
+            Volume,
+            VolumeFactoryRegistrar,
+            TransformSequenceElementHandler<ParametrizedElementHandler>
+        > Base;
+    };
+
+
     //
     // <object> element handler.
     //
@@ -2261,6 +2298,12 @@ namespace
                     static_cast<TextureInstanceElementHandler*>(handler)->get_texture_instance());
                 break;
 
+              case ElementVolume:
+                insert(
+                    m_scene->volumes(),
+                    static_cast<VolumeElementHandler*>(handler)->get_entity());
+                break;
+
               default:
                 ParametrizedElementHandler::end_child_element(element, handler);
                 break;
@@ -2816,6 +2859,7 @@ namespace
             register_factory_helper<TransformElementHandler>("transform", ElementTransform);
             register_factory_helper<TranslationElementHandler>("translation", ElementTranslation);
             register_factory_helper<ValuesElementHandler>("values", ElementValues);
+            register_factory_helper<VolumeElementHandler>("volume", ElementVolume);
 
             auto_ptr<IElementHandlerFactory<ProjectElementID> > factory(
                 new ProjectElementHandlerFactory(m_context, project));
@@ -60,6 +60,7 @@
 #endif
 #include "renderer/modeling/surfaceshader/surfaceshader.h"
 #include "renderer/modeling/texture/texture.h"
+#include "renderer/modeling/volume/volume.h"
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
@@ -815,6 +816,7 @@ namespace
                 !scene.environment_edfs().empty() ||
                 !scene.environment_shaders().empty() ||
                 scene.get_environment() != 0 ||
+                !scene.volumes().empty() ||
                 !scene.assemblies().empty() ||
                 !scene.assembly_instances().empty());
 
@@ -832,6 +834,7 @@ namespace
             if (scene.get_environment())
                 write(*scene.get_environment());
 
+            write_collection(scene.volumes());
             write_collection(scene.assemblies());
             write_collection(scene.assembly_instances());
         }
@@ -944,6 +947,23 @@ namespace
             write_params(texture_instance.get_parameters());
             write_transform(texture_instance.get_transform());
         }
+
+        // Write a <volume> element.
+        void write(Volume& volume)
+        {
+            XMLElement element("volume", m_file, m_indenter);
+            element.add_attribute("name", volume.get_name());
+            element.add_attribute("model", volume.get_model());
+            element.write(true);
+
+            ParamArray& params = volume.get_parameters();
+
+            if (params.strings().exist("filename"))
+                handle_link_to_asset(params, "filename");
+
+            write_params(params);
+            write_transform(volume.get_transform());
+        }
     };
 }
 
@@ -35,6 +35,7 @@
 #include "renderer/modeling/scene/basegroup.h"
 
 // Standard headers.
+#include <cstddef>
 #include <string>
 
 using namespace foundation;
@@ -119,10 +120,23 @@ GAABB3 AssemblyInstance::compute_parent_bbox() const
 
     const Assembly* assembly = find_assembly();
 
-    return
-        assembly
-            ? m_transform_sequence.to_parent(assembly->compute_local_bbox())
-            : GAABB3::invalid();
+    if (assembly == 0)
+        return GAABB3::invalid();
+
+    const GAABB3 assembly_bbox = assembly->compute_local_bbox();
+
+    if (m_instance_array.empty())
+        return m_transform_sequence.to_parent(assembly_bbox);
+
+    // Bound all the elements of the instance array.
+    GAABB3 instances_bbox;
+    instances_bbox.invalidate();
+
+    const size_t instance_count = m_instance_array.size();
+    for (size_t i = 0; i < instance_count; ++i)
+        instances_bbox.insert(m_instance_array.get_transform(i).to_parent(assembly_bbox));
+
+    return m_transform_sequence.to_parent(instances_bbox);
 }
 
 void AssemblyInstance::unbind_assembly()
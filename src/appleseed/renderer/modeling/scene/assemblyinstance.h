@@ -34,6 +34,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/modeling/entity/entity.h"
 #include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/instancearray.h"
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
@@ -77,6 +78,12 @@ class DLLSYMBOL AssemblyInstance
     TransformSequence& transform_sequence();
     const TransformSequence& transform_sequence() const;
 
+    // Access the instance array of the instance. If the array is not empty, the
+    // assembly is placed once per element of the array, each element transform
+    // being applied before the transform sequence of the instance.
+    InstanceArray& instance_array();
+    const InstanceArray& instance_array() const;
+
     // Find the assembly bound to this instance.
     Assembly* find_assembly() const;
 
@@ -108,6 +115,7 @@ class DLLSYMBOL AssemblyInstance
 
     Assembly*                       m_assembly;
     TransformSequence               m_transform_sequence;
+    InstanceArray                   m_instance_array;
 
     // Constructor.
     AssemblyInstance(
@@ -149,6 +157,16 @@ inline const TransformSequence& AssemblyInstance::transform_sequence() const
     return m_transform_sequence;
 }
 
+inline InstanceArray& AssemblyInstance::instance_array()
+{
+    return m_instance_array;
+}
+
+inline const InstanceArray& AssemblyInstance::instance_array() const
+{
+    return m_instance_array;
+}
+
 inline Assembly& AssemblyInstance::get_assembly() const
 {
     assert(m_assembly);
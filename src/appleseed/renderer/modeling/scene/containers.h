@@ -62,6 +62,7 @@ namespace renderer  { class ShaderParam; }
 namespace renderer  { class SurfaceShader; }
 namespace renderer  { class Texture; }
 namespace renderer  { class TextureInstance; }
+namespace renderer  { class Volume; }
 
 namespace renderer
 {
@@ -90,6 +91,7 @@ typedef TypedEntityVector<ShaderParam>          ShaderParamContainer;
 typedef TypedEntityVector<SurfaceShader>        SurfaceShaderContainer;
 typedef TypedEntityVector<Texture>              TextureContainer;
 typedef TypedEntityVector<TextureInstance>      TextureInstanceContainer;
+typedef TypedEntityVector<Volume>               VolumeContainer;
 
 
 //
@@ -0,0 +1,226 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "instancearray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+
+// Standard headers.
+#include <cassert>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// InstanceArray class implementation.
+//
+
+namespace
+{
+    // Number of floats used to store the transform of an instance.
+    const size_t TransformSize = 12;
+}
+
+struct InstanceArray::Impl
+{
+    vector<float>   m_transforms;       // row-major 3x4 local-to-parent matrices
+    vector<uint32>  m_ids;              // empty if no user IDs were provided
+};
+
+InstanceArray::InstanceArray()
+  : impl(new Impl())
+{
+}
+
+InstanceArray::~InstanceArray()
+{
+    delete impl;
+}
+
+bool InstanceArray::empty() const
+{
+    return impl->m_transforms.empty();
+}
+
+size_t InstanceArray::size() const
+{
+    return impl->m_transforms.size() / TransformSize;
+}
+
+void InstanceArray::clear()
+{
+    impl->m_transforms.clear();
+    impl->m_ids.clear();
+}
+
+void InstanceArray::reserve(const size_t size)
+{
+    impl->m_transforms.reserve(size * TransformSize);
+}
+
+size_t InstanceArray::push_back(const Transformd& transform)
+{
+    const size_t index = size();
+    const Matrix4d& m = transform.get_local_to_parent();
+
+    assert(m(3, 0) == 0.0 && m(3, 1) == 0.0 && m(3, 2) == 0.0 && m(3, 3) == 1.0);
+
+    for (size_t i = 0; i < TransformSize; ++i)
+        impl->m_transforms.push_back(static_cast<float>(m[i]));
+
+    if (!impl->m_ids.empty())
+        impl->m_ids.push_back(static_cast<uint32>(index));
+
+    return index;
+}
+
+size_t InstanceArray::push_back(
+    const Transformd&   transform,
+    const uint32        id)
+{
+    // Instances added without an ID so far are identified by their index.
+    if (impl->m_ids.empty())
+    {
+        const size_t count = size();
+        impl->m_ids.reserve(impl->m_transforms.capacity() / TransformSize);
+
+        for (size_t i = 0; i < count; ++i)
+            impl->m_ids.push_back(static_cast<uint32>(i));
+    }
+
+    const size_t index = size();
+    const Matrix4d& m = transform.get_local_to_parent();
+
+    assert(m(3, 0) == 0.0 && m(3, 1) == 0.0 && m(3, 2) == 0.0 && m(3, 3) == 1.0);
+
+    for (size_t i = 0; i < TransformSize; ++i)
+        impl->m_transforms.push_back(static_cast<float>(m[i]));
+
+    impl->m_ids.push_back(id);
+
+    return index;
+}
+
+bool InstanceArray::has_ids() const
+{
+    return !impl->m_ids.empty();
+}
+
+uint32 InstanceArray::get_id(const size_t index) const
+{
+    assert(index < size());
+
+    return impl->m_ids.empty() ? static_cast<uint32>(index) : impl->m_ids[index];
+}
+
+Transformd InstanceArray::get_transform(const size_t index) const
+{
+    assert(index < size());
+
+    const float* m = &impl->m_transforms[index * TransformSize];
+
+    // Decode the local-to-parent matrix.
+    Matrix4d local_to_parent;
+    for (size_t i = 0; i < TransformSize; ++i)
+        local_to_parent[i] = static_cast<double>(m[i]);
+    local_to_parent(3, 0) = 0.0;
+    local_to_parent(3, 1) = 0.0;
+    local_to_parent(3, 2) = 0.0;
+    local_to_parent(3, 3) = 1.0;
+
+    // Invert the linear part using cofactors.
+    const double a = local_to_parent(0, 0), b = local_to_parent(0, 1), c = local_to_parent(0, 2);
+    const double d = local_to_parent(1, 0), e = local_to_parent(1, 1), f = local_to_parent(1, 2);
+    const double g = local_to_parent(2, 0), h = local_to_parent(2, 1), k = local_to_parent(2, 2);
+
+    const double c00 = e * k - f * h;
+    const double c01 = c * h - b * k;
+    const double c02 = b * f - c * e;
+    const double det = a * c00 + d * c01 + g * c02;
+    assert(det != 0.0);
+    const double rcp_det = 1.0 / det;
+
+    Matrix4d parent_to_local;
+    parent_to_local(0, 0) = c00 * rcp_det;
+    parent_to_local(0, 1) = c01 * rcp_det;
+    parent_to_local(0, 2) = c02 * rcp_det;
+    parent_to_local(1, 0) = (f * g - d * k) * rcp_det;
+    parent_to_local(1, 1) = (a * k - c * g) * rcp_det;
+    parent_to_local(1, 2) = (c * d - a * f) * rcp_det;
+    parent_to_local(2, 0) = (d * h - e * g) * rcp_det;
+    parent_to_local(2, 1) = (b * g - a * h) * rcp_det;
+    parent_to_local(2, 2) = (a * e - b * d) * rcp_det;
+
+    // The translation of the inverse is the negated translation mapped by the inverse linear part.
+    const double tx = local_to_parent(0, 3);
+    const double ty = local_to_parent(1, 3);
+    const double tz = local_to_parent(2, 3);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        parent_to_local(i, 3) =
+            -(parent_to_local(i, 0) * tx + parent_to_local(i, 1) * ty + parent_to_local(i, 2) * tz);
+    }
+
+    parent_to_local(3, 0) = 0.0;
+    parent_to_local(3, 1) = 0.0;
+    parent_to_local(3, 2) = 0.0;
+    parent_to_local(3, 3) = 1.0;
+
+    return Transformd(local_to_parent, parent_to_local);
+}
+
+TransformSequence InstanceArray::get_transform_sequence(
+    const size_t                index,
+    const TransformSequence&    parent_transform_seq) const
+{
+    TransformSequence instance_transform_seq;
+    instance_transform_seq.set_transform(0.0, get_transform(index));
+    instance_transform_seq.prepare();
+
+    TransformSequence result = instance_transform_seq * parent_transform_seq;
+    result.prepare();
+
+    return result;
+}
+
+size_t InstanceArray::get_memory_size() const
+{
+    return
+          sizeof(*this)
+        + sizeof(*impl)
+        + impl->m_transforms.capacity() * sizeof(float)
+        + impl->m_ids.capacity() * sizeof(uint32);
+}
+
+}   // namespace renderer
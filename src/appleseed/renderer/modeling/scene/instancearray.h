@@ -0,0 +1,116 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_SCENE_INSTANCEARRAY_H
+#define APPLESEED_RENDERER_MODELING_SCENE_INSTANCEARRAY_H
+
+// appleseed.renderer headers.
+#include "renderer/utility/transformsequence.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/transform.h"
+#include "foundation/platform/types.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// A compact array of placements of an assembly instance.
+//
+// Each placement (or instance) is defined by an affine transform stored as a 3x4
+// matrix of single precision floats, and by an optional 32-bit user ID that can
+// be used to vary the appearance of instances. The transform of an instance maps
+// its local space to the space of the assembly instance owning the array.
+//
+// Transforms are decoded on the fly, no per-instance entity is ever created.
+//
+
+class DLLSYMBOL InstanceArray
+  : public foundation::NonCopyable
+{
+  public:
+    // Index designating the absence of instance array.
+    static const foundation::uint32 InvalidIndex = ~foundation::uint32(0);
+
+    // Constructor.
+    InstanceArray();
+
+    // Destructor.
+    ~InstanceArray();
+
+    // Return true if the array is empty.
+    bool empty() const;
+
+    // Return the number of instances in the array.
+    size_t size() const;
+
+    // Remove all instances from the array.
+    void clear();
+
+    // Reserve memory for a given number of instances.
+    void reserve(const size_t size);
+
+    // Append an instance and return its index. The transform must be affine.
+    size_t push_back(const foundation::Transformd& transform);
+    size_t push_back(
+        const foundation::Transformd&   transform,
+        const foundation::uint32        id);
+
+    // Return true if user IDs were provided for the instances.
+    bool has_ids() const;
+
+    // Return the user ID of a given instance, or its index if no IDs were provided.
+    foundation::uint32 get_id(const size_t index) const;
+
+    // Decode the transform of a given instance.
+    foundation::Transformd get_transform(const size_t index) const;
+
+    // Compose the transform of a given instance with a transform sequence.
+    // The returned sequence is ready for evaluation.
+    TransformSequence get_transform_sequence(
+        const size_t                    index,
+        const TransformSequence&        parent_transform_seq) const;
+
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_SCENE_INSTANCEARRAY_H
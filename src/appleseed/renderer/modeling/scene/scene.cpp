@@ -36,6 +36,7 @@
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
 #include "renderer/modeling/scene/textureinstance.h"
+#include "renderer/modeling/volume/volume.h"
 #include "renderer/utility/bbox.h"
 
 // appleseed.foundation headers.
@@ -75,10 +76,12 @@ struct Scene::Impl
     auto_release_ptr<Environment>   m_environment;
     EnvironmentEDFContainer         m_environment_edfs;
     EnvironmentShaderContainer      m_environment_shaders;
+    VolumeContainer                 m_volumes;
 
     explicit Impl(Entity* parent)
       : m_environment_edfs(parent)
       , m_environment_shaders(parent)
+      , m_volumes(parent)
     {
     }
 };
@@ -137,6 +140,11 @@ EnvironmentShaderContainer& Scene::environment_shaders() const
     return impl->m_environment_shaders;
 }
 
+VolumeContainer& Scene::volumes() const
+{
+    return impl->m_volumes;
+}
+
 GAABB3 Scene::compute_bbox() const
 {
     const AssemblyInstanceContainer& instances = assembly_instances();
@@ -239,6 +247,8 @@ bool Scene::on_frame_begin(
     if (impl->m_environment.get())
         success = success && impl->m_environment->on_frame_begin(project, abort_switch);
 
+    success = success && invoke_on_frame_begin(project, volumes(), abort_switch);
+
 #ifdef WITH_OSL
     success = success && invoke_on_frame_begin(project, assemblies(), shading_system, abort_switch);
 #else
@@ -254,6 +264,7 @@ void Scene::on_frame_end(const Project& project)
 {
     invoke_on_frame_end(project, assembly_instances());
     invoke_on_frame_end(project, assemblies());
+    invoke_on_frame_end(project, volumes());
 
     if (impl->m_environment.get())
         impl->m_environment->on_frame_end(project);
@@ -93,6 +93,9 @@ class DLLSYMBOL Scene
     // Access the environment shaders.
     EnvironmentShaderContainer& environment_shaders() const;
 
+    // Access the volumes.
+    VolumeContainer& volumes() const;
+
     // Compute and return the bounding box of the scene.
     GAABB3 compute_bbox() const;
 
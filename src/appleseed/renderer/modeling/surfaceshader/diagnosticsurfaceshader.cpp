@@ -356,8 +356,14 @@ void DiagnosticSurfaceShader::evaluate(
         break;
 
       case AssemblyInstances:
-        shading_result.set_main_to_linear_rgb(
-            integer_to_color(shading_point.get_assembly_instance().get_uid()));
+        {
+            // Elements of instance arrays are told apart by their user ID.
+            const uint32 h =
+                mix_uint32(
+                    static_cast<uint32>(shading_point.get_assembly_instance().get_uid()),
+                    shading_point.get_instance_id());
+            shading_result.set_main_to_linear_rgb(integer_to_color(h));
+        }
         break;
 
       case ObjectInstances:
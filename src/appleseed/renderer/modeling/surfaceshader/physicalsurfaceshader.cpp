@@ -368,7 +368,9 @@ namespace
                 if (environment_shader)
                 {
                     // Execute the environment shader to obtain the sky color in the direction of the ray.
-                    InputEvaluator input_evaluator(shading_context.get_texture_cache());
+                    InputEvaluator input_evaluator(
+                        shading_context.get_texture_cache(),
+                        shading_context.get_arena());
                     const ShadingRay& ray = shading_point.get_ray();
                     const Vector3d direction = normalize(ray.m_dir);
                     ShadingResult sky;
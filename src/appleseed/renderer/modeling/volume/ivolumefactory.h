@@ -0,0 +1,75 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_VOLUME_IVOLUMEFACTORY_H
+#define APPLESEED_RENDERER_MODELING_VOLUME_IVOLUMEFACTORY_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/utility/autoreleaseptr.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Forward declarations.
+namespace foundation    { class DictionaryArray; }
+namespace renderer      { class ParamArray; }
+namespace renderer      { class Volume; }
+
+namespace renderer
+{
+
+//
+// Volume factory interface.
+//
+
+class DLLSYMBOL IVolumeFactory
+  : public foundation::NonCopyable
+{
+  public:
+    // Destructor.
+    virtual ~IVolumeFactory() {}
+
+    // Return a string identifying this volume model.
+    virtual const char* get_model() const = 0;
+
+    // Return a human-readable string identifying this volume model.
+    virtual const char* get_human_readable_model() const = 0;
+
+    // Return a set of input metadata for this volume model.
+    virtual foundation::DictionaryArray get_input_metadata() const = 0;
+
+    // Create a new volume instance.
+    virtual foundation::auto_release_ptr<Volume> create(
+        const char*         name,
+        const ParamArray&   params) const = 0;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_VOLUME_IVOLUMEFACTORY_H
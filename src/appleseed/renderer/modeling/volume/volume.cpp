@@ -0,0 +1,94 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "volume.h"
+
+using namespace foundation;
+
+namespace renderer
+{
+
+//
+// Volume class implementation.
+//
+
+namespace
+{
+    const UniqueID g_class_uid = new_guid();
+}
+
+UniqueID Volume::get_class_uid()
+{
+    return g_class_uid;
+}
+
+Volume::Volume(
+    const char*         name,
+    const ParamArray&   params)
+  : Entity(g_class_uid, params)
+  , m_transform(Transformd::identity())
+  , m_medium_version_id(InvalidVersionID)
+{
+    set_name(name);
+}
+
+Volume::~Volume()
+{
+}
+
+void Volume::set_transform(const Transformd& transform)
+{
+    // The transform is applied when tracing: the medium does not need to be rebuilt.
+    m_transform = transform;
+}
+
+const Transformd& Volume::get_transform() const
+{
+    return m_transform;
+}
+
+bool Volume::on_frame_begin(
+    const Project&      project,
+    AbortSwitch*        abort_switch)
+{
+    // Only rebuild the medium if the volume changed since it was last built.
+    if (m_medium.get() && m_medium_version_id == get_version_id())
+        return true;
+
+    m_medium = create_medium(project);
+    m_medium_version_id = get_version_id();
+
+    return m_medium.get() != 0;
+}
+
+void Volume::on_frame_end(const Project& project)
+{
+}
+
+}   // namespace renderer
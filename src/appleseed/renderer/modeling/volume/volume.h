@@ -0,0 +1,211 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_VOLUME_VOLUME_H
+#define APPLESEED_RENDERER_MODELING_VOLUME_VOLUME_H
+
+// appleseed.renderer headers.
+#include "renderer/kernel/volume/fluidvolume.h"
+#include "renderer/modeling/entity/entity.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/uid.h"
+#include "foundation/utility/version.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cassert>
+#include <memory>
+
+// Forward declarations.
+namespace foundation    { class AbortSwitch; }
+namespace renderer      { class ParamArray; }
+namespace renderer      { class Project; }
+
+namespace renderer
+{
+
+//
+// A participating medium placed in the scene by a transform.
+//
+// The medium is built in volume space by the concrete volume model. It is built in
+// on_frame_begin() the first time the volume is rendered, then kept across frames
+// until the version ID of the volume changes; bump the version ID after modifying
+// its parameters. The transform is applied when tracing and can be changed freely.
+//
+
+class DLLSYMBOL Volume
+  : public Entity
+{
+  public:
+    // Return the unique ID of this class of entities.
+    static foundation::UniqueID get_class_uid();
+
+    // Constructor.
+    Volume(
+        const char*                     name,
+        const ParamArray&               params);
+
+    // Destructor.
+    ~Volume();
+
+    // Return a string identifying the model of this entity.
+    virtual const char* get_model() const = 0;
+
+    // Set the volume space to world space transformation.
+    void set_transform(const foundation::Transformd& transform);
+
+    // Get the volume space to world space transformation.
+    const foundation::Transformd& get_transform() const;
+
+    // This method is called once before rendering each frame.
+    // Returns true on success, false otherwise.
+    virtual bool on_frame_begin(
+        const Project&                  project,
+        foundation::AbortSwitch*        abort_switch = 0);
+
+    // This method is called once after rendering each frame.
+    virtual void on_frame_end(const Project& project);
+
+    // Return the single-scattering albedo of the medium.
+    float get_albedo() const;
+
+    // Compute the transmittance along the segment [tmin, tmax] of a world space ray.
+    double evaluate_transmittance(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        const double                    tmin,
+        const double                    tmax) const;
+
+    // Sample a collision along the segment [tmin, tmax] of a world space ray.
+    // Returns true and the ray parameter of the collision if a real collision occurred.
+    template <typename RNG>
+    bool sample_distance(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        const double                    tmin,
+        const double                    tmax,
+        RNG&                            rng,
+        double&                         distance) const;
+
+  protected:
+    // Build the medium in volume space. Returns 0 on failure.
+    virtual std::auto_ptr<FluidVolume> create_medium(const Project& project) const = 0;
+
+  private:
+    foundation::Transformd              m_transform;
+    std::auto_ptr<FluidVolume>          m_medium;
+    foundation::VersionID               m_medium_version_id;
+
+    // Transform a world space ray to volume space. Returns the extinction scale that
+    // converts distances along the volume space ray to world space distances.
+    double transform_to_local(
+        const foundation::Vector3d&     origin,
+        const foundation::Vector3d&     direction,
+        foundation::Vector3d&           local_origin,
+        foundation::Vector3d&           local_direction) const;
+};
+
+
+//
+// Volume class implementation.
+//
+
+inline float Volume::get_albedo() const
+{
+    assert(m_medium.get());
+    return m_medium->get_albedo();
+}
+
+inline double Volume::transform_to_local(
+    const foundation::Vector3d&         origin,
+    const foundation::Vector3d&         direction,
+    foundation::Vector3d&               local_origin,
+    foundation::Vector3d&               local_direction) const
+{
+    local_origin = m_transform.point_to_local(origin);
+    local_direction = m_transform.vector_to_local(direction);
+
+    // Ray parameters are preserved by affine transforms: only distances need scaling.
+    return foundation::norm(direction) / foundation::norm(local_direction);
+}
+
+inline double Volume::evaluate_transmittance(
+    const foundation::Vector3d&         origin,
+    const foundation::Vector3d&         direction,
+    const double                        tmin,
+    const double                        tmax) const
+{
+    assert(m_medium.get());
+
+    foundation::Vector3d local_origin, local_direction;
+    const double extinction_scale =
+        transform_to_local(origin, direction, local_origin, local_direction);
+
+    return
+        m_medium->evaluate_transmittance(
+            local_origin,
+            local_direction,
+            tmin,
+            tmax,
+            extinction_scale);
+}
+
+template <typename RNG>
+bool Volume::sample_distance(
+    const foundation::Vector3d&         origin,
+    const foundation::Vector3d&         direction,
+    const double                        tmin,
+    const double                        tmax,
+    RNG&                                rng,
+    double&                             distance) const
+{
+    assert(m_medium.get());
+
+    foundation::Vector3d local_origin, local_direction;
+    const double extinction_scale =
+        transform_to_local(origin, direction, local_origin, local_direction);
+
+    return
+        m_medium->sample_distance(
+            local_origin,
+            local_direction,
+            tmin,
+            tmax,
+            extinction_scale,
+            rng,
+            distance);
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_VOLUME_VOLUME_H
@@ -0,0 +1,213 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "voxelgridvolume.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/kernel/volume/fluidvolume.h"
+#include "renderer/kernel/volume/volume.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/volume/volume.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/searchpaths.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <memory>
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    //
+    // Voxel grid volume.
+    //
+
+    const char* Model = "voxel_grid_volume";
+
+    class VoxelGridVolume
+      : public Volume
+    {
+      public:
+        VoxelGridVolume(
+            const char*         name,
+            const ParamArray&   params)
+          : Volume(name, params)
+        {
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual const char* get_model() const OVERRIDE
+        {
+            return Model;
+        }
+
+      protected:
+        virtual auto_ptr<FluidVolume> create_medium(const Project& project) const OVERRIDE
+        {
+            const string filepath =
+                project.search_paths().qualify(m_params.get_required<string>("filename", ""));
+
+            FluidChannels channels;
+            const auto_ptr<VoxelGrid> grid = read_fluid_file(filepath.c_str(), channels);
+
+            if (grid.get() == 0)
+            {
+                RENDERER_LOG_ERROR(
+                    "while defining volume \"%s\": failed to load fluid file %s.",
+                    get_path().c_str(),
+                    filepath.c_str());
+                return auto_ptr<FluidVolume>(0);
+            }
+
+            if (channels.m_density_index == FluidChannels::NotPresent)
+            {
+                RENDERER_LOG_ERROR(
+                    "while defining volume \"%s\": fluid file %s does not have a density channel.",
+                    get_path().c_str(),
+                    filepath.c_str());
+                return auto_ptr<FluidVolume>(0);
+            }
+
+            const AABB3d bbox(
+                m_params.get_optional<Vector3d>("bbox_min", Vector3d(-0.5)),
+                m_params.get_optional<Vector3d>("bbox_max", Vector3d(0.5)));
+
+            auto_ptr<FluidVolume> medium(
+                new FluidVolume(
+                    *grid,
+                    channels.m_density_index,
+                    bbox,
+                    m_params.get_optional<double>("density_scale", 1.0),
+                    m_params.get_optional<float>("albedo", 0.8f)));
+
+            RENDERER_LOG_INFO(
+                "loaded fluid file %s (%s x %s x %s voxels, %s occupied cells).",
+                filepath.c_str(),
+                pretty_uint(grid->get_xres()).c_str(),
+                pretty_uint(grid->get_yres()).c_str(),
+                pretty_uint(grid->get_zres()).c_str(),
+                pretty_uint(medium->get_occupied_cell_count()).c_str());
+
+            return medium;
+        }
+    };
+}
+
+
+//
+// VoxelGridVolumeFactory class implementation.
+//
+
+const char* VoxelGridVolumeFactory::get_model() const
+{
+    return Model;
+}
+
+const char* VoxelGridVolumeFactory::get_human_readable_model() const
+{
+    return "Voxel Grid Volume";
+}
+
+DictionaryArray VoxelGridVolumeFactory::get_input_metadata() const
+{
+    DictionaryArray metadata;
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "filename")
+            .insert("label", "File Path")
+            .insert("type", "file")
+            .insert("file_picker_mode", "open")
+            .insert("file_picker_filter", "Fluid Files (*.fld)")
+            .insert("default", "")
+            .insert("use", "required"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "bbox_min")
+            .insert("label", "Bounding Box Min")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", "-0.5 -0.5 -0.5"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "bbox_max")
+            .insert("label", "Bounding Box Max")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", "0.5 0.5 0.5"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "density_scale")
+            .insert("label", "Density Scale")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", "1.0"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "albedo")
+            .insert("label", "Albedo")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", "0.8"));
+
+    return metadata;
+}
+
+auto_release_ptr<Volume> VoxelGridVolumeFactory::create(
+    const char*         name,
+    const ParamArray&   params) const
+{
+    return
+        auto_release_ptr<Volume>(
+            new VoxelGridVolume(name, params));
+}
+
+}   // namespace renderer
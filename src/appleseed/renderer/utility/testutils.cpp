@@ -33,14 +33,25 @@
 // appleseed.renderer headers.
 #include "renderer/modeling/color/colorentity.h"
 #include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/modeling/scene/textureinstance.h"
 #include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+#include "foundation/math/rng.h"
 #include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/containers/dictionary.h"
+
+// Standard headers.
+#include <cassert>
 
 using namespace foundation;
 using namespace std;
@@ -190,4 +201,70 @@ const char* BoundingBoxObject::get_material_slot(const size_t index) const
     return 0;
 }
 
+
+//
+// create_scaled_cornell_box_project() function implementation.
+//
+
+auto_release_ptr<Project> create_scaled_cornell_box_project(const size_t resolution)
+{
+    assert(resolution > 0);
+
+    auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+    Assembly* assembly = project->get_scene()->assemblies().get_by_name("assembly");
+    assert(assembly);
+
+    auto_release_ptr<MeshObject> object(
+        MeshObjectFactory::create("bumpy_floor", ParamArray()));
+
+    // Vertices. Like the rest of the Cornell Box, they are expressed in millimeters.
+    MersenneTwister rng;
+    object->reserve_vertices((resolution + 1) * (resolution + 1));
+    for (size_t j = 0; j <= resolution; ++j)
+    {
+        for (size_t i = 0; i <= resolution; ++i)
+        {
+            object->push_vertex(
+                GVector3(
+                    static_cast<GScalar>(549.6 * i / resolution),
+                    static_cast<GScalar>(rand_double1(rng, 1.0, 10.0)),
+                    static_cast<GScalar>(559.2 * j / resolution)));
+        }
+    }
+
+    // Vertex normals.
+    object->push_vertex_normal(GVector3(0.0f, 1.0f, 0.0f));
+
+    // Material slots.
+    const size_t mat_slot = object->push_material_slot("white_material");
+
+    // Triangles.
+    object->reserve_triangles(2 * resolution * resolution);
+    for (size_t j = 0; j < resolution; ++j)
+    {
+        for (size_t i = 0; i < resolution; ++i)
+        {
+            const size_t v0 = j * (resolution + 1) + i;
+            const size_t v1 = v0 + 1;
+            const size_t v2 = v1 + resolution + 1;
+            const size_t v3 = v0 + resolution + 1;
+            object->push_triangle(Triangle(v0, v2, v1,  0, 0, 0,  mat_slot));
+            object->push_triangle(Triangle(v0, v3, v2,  0, 0, 0,  mat_slot));
+        }
+    }
+
+    assembly->objects().insert(auto_release_ptr<Object>(object));
+
+    assembly->object_instances().insert(
+        ObjectInstanceFactory::create(
+            "bumpy_floor_inst",
+            ParamArray(),
+            "bumpy_floor",
+            Transformd::from_local_to_parent(Matrix4d::scaling(Vector3d(0.001))),
+            StringDictionary()
+                .insert("white_material", "white_material")));
+
+    return project;
+}
+
 }   // namespace renderer
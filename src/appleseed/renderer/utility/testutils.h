@@ -153,6 +153,10 @@ class BoundingBoxObject
     foundation::Lazy<RegionKit>     m_lazy_region_kit;
 };
 
+// Create an instance of the built-in Cornell Box project whose floor is covered by an
+// additional, procedurally generated bumpy mesh of 2 * resolution * resolution triangles.
+foundation::auto_release_ptr<Project> create_scaled_cornell_box_project(const size_t resolution);
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_UTILITY_TESTUTILS_H
@@ -113,6 +113,14 @@ class DLLSYMBOL TransformSequence
     template <typename T>
     foundation::AABB<T, 3> to_parent(const foundation::AABB<T, 3>& bbox) const;
 
+    // Transform a 3D axis-aligned bounding box over a given time interval.
+    // If the bounding box is invalid, it is returned unmodified.
+    template <typename T>
+    foundation::AABB<T, 3> to_parent(
+        const foundation::AABB<T, 3>&   bbox,
+        const double                    time_begin,
+        const double                    time_end) const;
+
   private:
     struct TransformKey
     {
@@ -216,6 +224,45 @@ foundation::AABB<T, 3> TransformSequence::to_parent(const foundation::AABB<T, 3>
     return result;
 }
 
+template <typename T>
+foundation::AABB<T, 3> TransformSequence::to_parent(
+    const foundation::AABB<T, 3>&   bbox,
+    const double                    time_begin,
+    const double                    time_end) const
+{
+    assert(time_begin <= time_end);
+
+    if (m_size == 0 || !bbox.is_valid())
+        return bbox;
+
+    if (m_size == 1)
+        return m_keys[0].m_transform.to_parent(bbox);
+
+    const foundation::AABB3d bbox_d(bbox);
+
+    // Start with the transform at the beginning of the interval.
+    foundation::Transformd from = evaluate(time_begin);
+    foundation::AABB3d result = from.to_parent(bbox_d);
+
+    // Insert the bounding boxes of the paths between the key frames inside the interval.
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        if (m_keys[i].m_time <= time_begin)
+            continue;
+
+        if (m_keys[i].m_time >= time_end)
+            break;
+
+        result.insert(compute_motion_segment_bbox(bbox_d, from, m_keys[i].m_transform));
+        from = m_keys[i].m_transform;
+    }
+
+    // Insert the bounding box of the path to the end of the interval.
+    result.insert(compute_motion_segment_bbox(bbox_d, from, evaluate(time_end)));
+
+    return foundation::AABB<T, 3>(result);
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_UTILITY_TRANSFORMSEQUENCE_H
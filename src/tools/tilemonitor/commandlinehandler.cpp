@@ -0,0 +1,86 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "commandlinehandler.h"
+
+// appleseed.shared headers.
+#include "application/superlogger.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/log.h"
+
+using namespace appleseed::shared;
+using namespace foundation;
+using namespace std;
+
+namespace appleseed {
+namespace tilemonitor {
+
+CommandLineHandler::CommandLineHandler()
+  : CommandLineHandlerBase("tilemonitor")
+{
+    add_default_options();
+
+    m_progress_messages.add_name("--progress");
+    m_progress_messages.add_name("-p");
+    m_progress_messages.set_description("print progress messages");
+    parser().add_option_handler(&m_progress_messages);
+
+    m_filenames.set_exact_value_count(2);
+    parser().set_default_option_handler(&m_filenames);
+
+    m_plane.add_name("--plane");
+    m_plane.set_description("select the image to save: 0 for the beauty image, n for the n'th AOV");
+    m_plane.set_syntax("n");
+    m_plane.set_exact_value_count(1);
+    parser().add_option_handler(&m_plane);
+
+    m_interval.add_name("--interval");
+    m_interval.add_name("-i");
+    m_interval.set_description("set the minimum time between two consecutive writes of the output image");
+    m_interval.set_syntax("seconds");
+    m_interval.set_exact_value_count(1);
+    parser().add_option_handler(&m_interval);
+}
+
+void CommandLineHandler::print_program_usage(
+    const char*     program_name,
+    SuperLogger&    logger) const
+{
+    SaveLogFormatterConfig save_config(logger);
+    logger.set_format(LogMessage::Info, "{message}");
+
+    LOG_INFO(logger, "usage: %s [options] segment-name output-image", program_name);
+    LOG_INFO(logger, "options:");
+
+    parser().print_usage(logger);
+}
+
+}   // namespace tilemonitor
+}   // namespace appleseed
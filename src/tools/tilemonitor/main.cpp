@@ -0,0 +1,353 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Project headers.
+#include "commandlinehandler.h"
+
+// appleseed.shared headers.
+#include "application/application.h"
+#include "application/superlogger.h"
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/sharedmemorytileprotocol.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exception.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/genericimagefilewriter.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/stopwatch.h"
+
+// Boost headers.
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+// Standard headers.
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace appleseed::shared;
+using namespace appleseed::tilemonitor;
+using namespace boost::interprocess;
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+
+//
+// A reference client for renderer::SharedMemoryTileCallbackFactory: attaches to a shared
+// memory segment, reassembles one of the published images and periodically saves it.
+//
+
+namespace
+{
+    class TileMonitor
+    {
+      public:
+        TileMonitor(
+            SuperLogger&            logger,
+            const string&           segment_name,
+            const size_t            plane)
+          : m_logger(logger)
+          , m_plane(plane)
+          , m_region(
+                shared_memory_object(open_only, segment_name.c_str(), read_write),
+                read_write)
+          , m_header(static_cast<SharedMemoryTileHeader*>(m_region.get_address()))
+          , m_consumed_count(0)
+          , m_received_tile_count(0)
+          , m_dropped_tile_count(0)
+        {
+            if (m_region.get_size() < sizeof(SharedMemoryTileHeader) ||
+                m_header->m_magic != SharedMemoryTileMagic ||
+                m_header->m_version != SharedMemoryTileVersion)
+                throw ExceptionUnsupportedSegment();
+
+            m_image.reset(
+                new Image(
+                    m_header->m_canvas_width,
+                    m_header->m_canvas_height,
+                    m_header->m_tile_width,
+                    m_header->m_tile_height,
+                    m_header->m_channel_count,
+                    PixelFormatFloat));
+
+            m_scratch.resize(m_header->m_slot_size);
+        }
+
+        const Image& image() const
+        {
+            return *m_image;
+        }
+
+        size_t get_received_tile_count() const
+        {
+            return m_received_tile_count;
+        }
+
+        size_t get_dropped_tile_count() const
+        {
+            return m_dropped_tile_count;
+        }
+
+        // Wait for new tiles and copy them into the image. Return false once the renderer detached.
+        bool update(const uint32 timeout_ms)
+        {
+            uint64 acquired_count;
+            uint64 published_count;
+            bool closed;
+
+            {
+                scoped_lock<interprocess_mutex> lock(m_header->m_mutex);
+
+                if (m_header->m_published_count == m_consumed_count && !m_header->m_closed)
+                {
+                    m_header->m_tile_published.timed_wait(
+                        lock,
+                        boost::posix_time::microsec_clock::universal_time() +
+                        boost::posix_time::milliseconds(timeout_ms));
+                }
+
+                acquired_count = m_header->m_acquired_count;
+                published_count = m_header->m_published_count;
+                closed = m_header->m_closed;
+            }
+
+            // Skip the tiles whose slots have already been reserved again by the renderer.
+            const uint64 slot_count = m_header->m_slot_count;
+            if (acquired_count - m_consumed_count > slot_count)
+            {
+                const uint64 skipped = acquired_count - slot_count - m_consumed_count;
+                m_dropped_tile_count += static_cast<size_t>(skipped);
+                m_consumed_count += skipped;
+            }
+
+            while (m_consumed_count < published_count)
+                read_tile(m_consumed_count++);
+
+            return !closed;
+        }
+
+      private:
+        struct ExceptionUnsupportedSegment
+          : public Exception
+        {
+            ExceptionUnsupportedSegment()
+              : Exception("unsupported shared memory segment")
+            {
+            }
+        };
+
+        SuperLogger&                m_logger;
+        const size_t                m_plane;
+        mapped_region               m_region;
+        SharedMemoryTileHeader*     m_header;
+        auto_ptr<Image>             m_image;
+        vector<uint8>               m_scratch;
+        uint64                      m_consumed_count;
+        size_t                      m_received_tile_count;
+        size_t                      m_dropped_tile_count;
+
+        void read_tile(const uint64 sequence)
+        {
+            SharedMemoryTileSlot* slot =
+                get_shared_memory_tile_slot(
+                    m_header,
+                    static_cast<size_t>(sequence % m_header->m_slot_count));
+
+            // Copy the tile out of the slot before the renderer gets a chance to reuse it.
+            const SharedMemoryTileSlot slot_header = *slot;
+            if (slot_header.m_plane != m_plane)
+                return;
+
+            const size_t tile_size =
+                slot_header.m_width * slot_header.m_height * m_header->m_channel_count * sizeof(float);
+            if (tile_size > m_scratch.size())
+            {
+                ++m_dropped_tile_count;
+                return;
+            }
+
+            memcpy(&m_scratch[0], get_shared_memory_tile_pixels(slot), tile_size);
+
+            // Make sure the slot was not overwritten while we were copying it.
+            {
+                scoped_lock<interprocess_mutex> lock(m_header->m_mutex);
+
+                if (slot_header.m_sequence != sequence ||
+                    m_header->m_acquired_count > sequence + m_header->m_slot_count)
+                {
+                    ++m_dropped_tile_count;
+                    return;
+                }
+            }
+
+            const CanvasProperties& props = m_image->properties();
+            const size_t tile_x = slot_header.m_x / props.m_tile_width;
+            const size_t tile_y = slot_header.m_y / props.m_tile_height;
+            if (tile_x >= props.m_tile_count_x || tile_y >= props.m_tile_count_y)
+            {
+                ++m_dropped_tile_count;
+                return;
+            }
+
+            Tile& tile = m_image->tile(tile_x, tile_y);
+            if (tile.get_size() != tile_size)
+            {
+                ++m_dropped_tile_count;
+                return;
+            }
+
+            memcpy(tile.get_storage(), &m_scratch[0], tile_size);
+            ++m_received_tile_count;
+        }
+    };
+
+    void write_image(
+        SuperLogger&                logger,
+        const Image&                image,
+        const string&               filepath)
+    {
+        try
+        {
+            GenericImageFileWriter writer;
+            writer.write(filepath.c_str(), image);
+        }
+        catch (const exception& e)
+        {
+            LOG_ERROR(logger, "failed to write image file %s: %s.", filepath.c_str(), e.what());
+        }
+    }
+}
+
+
+//
+// Entry point of tilemonitor.
+//
+
+int main(int argc, const char* argv[])
+{
+    SuperLogger logger;
+    Application::check_installation(logger);
+
+    CommandLineHandler cl;
+    cl.parse(argc, argv, logger);
+
+    // Retrieve the segment name and the output file path.
+    const string& segment_name = cl.m_filenames.values()[0];
+    const string& output_filepath = cl.m_filenames.values()[1];
+
+    // Retrieve the index of the image to save.
+    size_t plane = 0;
+    if (cl.m_plane.is_set())
+    {
+        if (cl.m_plane.values()[0] >= 0)
+            plane = static_cast<size_t>(cl.m_plane.values()[0]);
+        else LOG_ERROR(logger, "invalid plane index, saving the beauty image.");
+    }
+
+    // Retrieve the time between two writes of the output image.
+    double interval = 5.0;
+    if (cl.m_interval.is_set())
+    {
+        if (cl.m_interval.values()[0] >= 0.0)
+            interval = cl.m_interval.values()[0];
+        else LOG_ERROR(logger, "invalid interval, using default interval of %f seconds.", interval);
+    }
+
+    try
+    {
+        TileMonitor monitor(logger, segment_name, plane);
+
+        LOG_INFO(
+            logger,
+            "attached to shared memory segment \"%s\" (" FMT_SIZE_T "x" FMT_SIZE_T " pixels).",
+            segment_name.c_str(),
+            monitor.image().properties().m_canvas_width,
+            monitor.image().properties().m_canvas_height);
+
+        Stopwatch<DefaultWallclockTimer> stopwatch;
+        stopwatch.start();
+
+        size_t written_tile_count = 0;
+        bool attached = true;
+
+        while (attached)
+        {
+            attached = monitor.update(100);
+
+            if (!attached || stopwatch.measure().get_seconds() >= interval)
+            {
+                if (monitor.get_received_tile_count() > written_tile_count)
+                {
+                    written_tile_count = monitor.get_received_tile_count();
+                    write_image(logger, monitor.image(), output_filepath);
+
+                    if (cl.m_progress_messages.is_set())
+                    {
+                        LOG_INFO(
+                            logger,
+                            "wrote %s (" FMT_SIZE_T " tiles received, " FMT_SIZE_T " dropped).",
+                            output_filepath.c_str(),
+                            monitor.get_received_tile_count(),
+                            monitor.get_dropped_tile_count());
+                    }
+                }
+
+                stopwatch.start();
+            }
+        }
+
+        LOG_INFO(
+            logger,
+            "renderer detached, " FMT_SIZE_T " tiles received, " FMT_SIZE_T " dropped.",
+            monitor.get_received_tile_count(),
+            monitor.get_dropped_tile_count());
+    }
+    catch (const exception& e)
+    {
+        LOG_FATAL(
+            logger,
+            "failed to attach to shared memory segment \"%s\" (%s).",
+            segment_name.c_str(),
+            e.what());
+    }
+
+    return 0;
+}